@@ -0,0 +1,120 @@
+/*! This file is part of davids91/Rafko.
+ *
+ *    Rafko is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    (at your option) any later version.
+ *
+ *    Rafko is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with Rafko.  If not, see <https://www.gnu.org/licenses/> or
+ *    <https://github.com/davids91/rafko/blob/master/LICENSE>
+ */
+
+#ifndef RAFKO_BENCHMARK_H
+#define RAFKO_BENCHMARK_H
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace rafko_benchmark {
+
+using Parameters = std::vector<std::pair<std::string, double>>;
+
+/**
+ * @brief      The timing statistics of one benchmark with one set of
+ * parameters. Every duration is for a single execution of the measured
+ * function, in nanoseconds.
+ */
+struct Measurement {
+  std::string name;
+  Parameters parameters;
+  std::uint32_t samples = 0u;
+  std::uint32_t iterations_per_sample = 0u;
+  double mean_ns = 0.0;
+  double median_ns = 0.0;
+  double min_ns = 0.0;
+  double max_ns = 0.0;
+  double stddev_ns = 0.0;
+};
+
+/**
+ * @brief      Runs the registered benchmarks and collects their measurements.
+ * Every benchmark function is called with the same random seed, so the
+ * generated networks and data are the same between runs.
+ */
+class Suite {
+public:
+  Suite(std::uint32_t samples, std::uint32_t warmup_samples,
+        std::uint32_t seed)
+      : m_samples(samples), m_warmupSamples(warmup_samples), m_seed(seed) {}
+
+  /**
+   * @brief      Measures the given function and stores the result under the
+   * given name and parameters
+   *
+   * @param[in]  name                    The name of the measured case
+   * @param[in]  parameters              The parameters of the measured case
+   * @param[in]  function                The function to measure
+   * @param[in]  iterations_per_sample   The number of times the function is
+   * called in one sample; to be used with functions which run too short to
+   * be measured alone
+   */
+  void measure(const std::string &name, Parameters parameters,
+               const std::function<void()> &function,
+               std::uint32_t iterations_per_sample = 1u);
+
+  /**
+   * @brief      Writes the collected measurements as JSON
+   */
+  void export_json(std::ostream &stream) const;
+
+  std::uint32_t get_seed() const { return m_seed; }
+  const std::vector<Measurement> &get_measurements() const {
+    return m_measurements;
+  }
+
+private:
+  const std::uint32_t m_samples;
+  const std::uint32_t m_warmupSamples;
+  const std::uint32_t m_seed;
+  std::vector<Measurement> m_measurements;
+};
+
+using BenchmarkFunction = void (*)(Suite &);
+
+/**
+ * @brief      Provides every benchmark registered through @RAFKO_BENCHMARK
+ */
+std::vector<std::pair<std::string, BenchmarkFunction>> &get_benchmarks();
+
+struct Registrar {
+  Registrar(const std::string &name, BenchmarkFunction function) {
+    get_benchmarks().push_back({name, function});
+  }
+};
+
+#define RAFKO_BENCHMARK_CONCAT_INNER(a, b) a##b
+#define RAFKO_BENCHMARK_CONCAT(a, b) RAFKO_BENCHMARK_CONCAT_INNER(a, b)
+/**
+ * @brief      Defines a benchmark function under the given name, taking the
+ * @Suite as the parameter `suite`
+ */
+#define RAFKO_BENCHMARK(name, function)                                        \
+  static void function(rafko_benchmark::Suite &suite);                         \
+  static const rafko_benchmark::Registrar RAFKO_BENCHMARK_CONCAT(              \
+      rafko_benchmark_registrar_, __LINE__)(name, &function);                  \
+  static void function(rafko_benchmark::Suite &suite)
+
+} /* namespace rafko_benchmark */
+
+#endif /* RAFKO_BENCHMARK_H */
@@ -0,0 +1,309 @@
+/*! This file is part of davids91/Rafko.
+ *
+ *    Rafko is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    (at your option) any later version.
+ *
+ *    Rafko is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with Rafko.  If not, see <https://www.gnu.org/licenses/> or
+ *    <https://github.com/davids91/rafko/blob/master/LICENSE>
+ */
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+#include "rafko_gym/models/rafko_cost.hpp"
+#include "rafko_gym/models/rafko_dataset_implementation.hpp"
+#include "rafko_gym/models/rafq_environment.hpp"
+#include "rafko_gym/models/rafq_set.hpp"
+#include "rafko_gym/services/cost_function_mse.hpp"
+#include "rafko_gym/services/rafko_autodiff_optimizer.hpp"
+#include "rafko_gym/services/rafko_data_parallel_optimizer.hpp"
+#include "rafko_gym/services/rafko_hogwild_optimizer.hpp"
+#include "rafko_gym/services/rafko_weight_adapter.hpp"
+#include "rafko_gym/services/updater_factory.hpp"
+#include "rafko_mainframe/models/rafko_settings.hpp"
+#include "rafko_net/services/rafko_net_builder.hpp"
+#include "rafko_net/services/solution_builder.hpp"
+#include "rafko_protocol/rafko_net.pb.h"
+#include "rafko_protocol/solution.pb.h"
+
+#include "benchmark/rafko_benchmark.hpp"
+
+namespace rafko_gym_bench {
+
+namespace {
+std::vector<std::vector<double>> random_vectors(std::uint32_t count,
+                                                std::uint32_t size) {
+  std::vector<std::vector<double>> result(count, std::vector<double>(size));
+  for (std::vector<double> &vector : result)
+    for (double &value : vector)
+      value = static_cast<double>(rand() % 1000) / 1000.0;
+  return result;
+}
+
+/**
+ * @brief      An environment without any transitions, only its sizes are used
+ * when filling up a @RafQSet directly
+ */
+class StatelessEnvironment : public rafko_gym::RafQEnvironment {
+public:
+  StatelessEnvironment(std::uint32_t state_size, std::uint32_t action_size)
+      : rafko_gym::RafQEnvironment(state_size, action_size) {}
+  void reset() override {}
+  StateTransition current_state() const override { return {}; }
+  StateTransition next(FeatureView) override { return {}; }
+  StateTransition next(FeatureView, FeatureView,
+                       const AnyData &) const override {
+    return {};
+  }
+};
+} /* namespace */
+
+RAFKO_BENCHMARK("autodiff_optimizer/iterate", autodiff_optimizer_iterate) {
+  constexpr std::uint32_t input_size = 4u;
+  constexpr std::uint32_t sequences = 64u;
+  for (std::uint32_t layer_size : {8u, 32u, 64u}) {
+    for (std::uint32_t memory_size : {1u, 2u, 4u}) {
+      for (bool parallel_sequences : {false, true}) {
+        std::shared_ptr<rafko_mainframe::RafkoSettings> settings =
+            std::make_shared<rafko_mainframe::RafkoSettings>(
+                rafko_mainframe::RafkoSettings()
+                    .set_learning_rate(0.0001)
+                    .set_minibatch_size(16)
+                    .set_memory_truncation(memory_size)
+                    .set_parallel_sequences(parallel_sequences));
+        rafko_net::RafkoNetBuilder builder(*settings);
+        builder.input_size(input_size).expected_input_range(1.0);
+        for (std::uint32_t neuron_index = 0u;
+             (1u < memory_size) && (neuron_index < layer_size); ++neuron_index)
+          builder.add_neuron_recurrence(0u, neuron_index, memory_size - 1u);
+        std::unique_ptr<rafko_net::RafkoNet> network(
+            builder.create_layers(nullptr, {layer_size, layer_size, 1u}));
+
+        std::shared_ptr<rafko_gym::RafkoDatasetImplementation> data_set =
+            std::make_shared<rafko_gym::RafkoDatasetImplementation>(
+                random_vectors(sequences * memory_size, input_size),
+                random_vectors(sequences * memory_size, 1u), memory_size);
+        std::shared_ptr<rafko_gym::RafkoObjective> objective =
+            std::make_shared<rafko_gym::RafkoCost>(
+                *settings, rafko_gym::cost_function_mse);
+        rafko_gym::RafkoAutodiffOptimizer optimizer(settings, *network);
+        optimizer.build(data_set, objective);
+        suite.measure("autodiff_optimizer/iterate",
+                      {{"layer_size", layer_size},
+                       {"memory_size", memory_size},
+                       {"parallel_sequences", parallel_sequences},
+                       {"weights", network->weight_table_size()}},
+                      [&optimizer, &data_set]() {
+                        optimizer.iterate(*data_set);
+                      });
+      }
+    }
+  }
+}
+
+RAFKO_BENCHMARK("data_parallel_optimizer/iterate", data_parallel_iterate) {
+  constexpr std::uint32_t input_size = 4u;
+  constexpr std::uint32_t sequences = 64u;
+  constexpr std::uint32_t memory_size = 2u;
+  /* every iteration trains the same number of sequences, split between the
+   * replicas, so the durations show how the throughput scales with them */
+  constexpr std::uint32_t sequences_per_iteration = 32u;
+  for (std::uint32_t layer_size : {8u, 32u}) {
+    for (std::uint32_t replica_count : {1u, 2u, 4u}) {
+      std::shared_ptr<rafko_mainframe::RafkoSettings> settings =
+          std::make_shared<rafko_mainframe::RafkoSettings>(
+              rafko_mainframe::RafkoSettings()
+                  .set_learning_rate(0.0001)
+                  .set_minibatch_size(sequences_per_iteration / replica_count)
+                  .set_memory_truncation(memory_size)
+                  .set_parallel_sequences(true));
+      std::unique_ptr<rafko_net::RafkoNet> network(
+          rafko_net::RafkoNetBuilder(*settings)
+              .input_size(input_size)
+              .expected_input_range(1.0)
+              .create_layers({layer_size, layer_size, 1u}));
+      std::shared_ptr<rafko_gym::RafkoDatasetImplementation> data_set =
+          std::make_shared<rafko_gym::RafkoDatasetImplementation>(
+              random_vectors(sequences * memory_size, input_size),
+              random_vectors(sequences * memory_size, 1u), memory_size);
+      std::shared_ptr<rafko_gym::RafkoObjective> objective =
+          std::make_shared<rafko_gym::RafkoCost>(*settings,
+                                                 rafko_gym::cost_function_mse);
+      rafko_gym::RafkoDataParallelOptimizer optimizer(settings, *network,
+                                                      replica_count);
+      optimizer.build(data_set, objective);
+      suite.measure("data_parallel_optimizer/iterate",
+                    {{"layer_size", layer_size},
+                     {"replicas", replica_count},
+                     {"sequences_per_iteration", sequences_per_iteration},
+                     {"weights", network->weight_table_size()}},
+                    [&optimizer, &data_set]() {
+                      optimizer.iterate(*data_set);
+                    });
+    }
+  }
+}
+
+RAFKO_BENCHMARK("hogwild_optimizer/iterate", hogwild_iterate) {
+  constexpr std::uint32_t input_size = 4u;
+  constexpr std::uint32_t sequences = 64u;
+  constexpr std::uint32_t memory_size = 2u;
+  for (std::uint32_t layer_size : {8u, 32u}) {
+    for (std::uint32_t worker_count : {1u, 2u, 4u}) {
+      std::shared_ptr<rafko_mainframe::RafkoSettings> settings =
+          std::make_shared<rafko_mainframe::RafkoSettings>(
+              rafko_mainframe::RafkoSettings()
+                  .set_learning_rate(0.0001)
+                  .set_minibatch_size(16u / worker_count)
+                  .set_memory_truncation(memory_size));
+      std::unique_ptr<rafko_net::RafkoNet> network(
+          rafko_net::RafkoNetBuilder(*settings)
+              .input_size(input_size)
+              .expected_input_range(1.0)
+              .create_layers({layer_size, layer_size, 1u}));
+      std::shared_ptr<rafko_gym::RafkoDatasetImplementation> data_set =
+          std::make_shared<rafko_gym::RafkoDatasetImplementation>(
+              random_vectors(sequences * memory_size, input_size),
+              random_vectors(sequences * memory_size, 1u), memory_size);
+      std::shared_ptr<rafko_gym::RafkoObjective> objective =
+          std::make_shared<rafko_gym::RafkoCost>(*settings,
+                                                 rafko_gym::cost_function_mse);
+      rafko_gym::RafkoHogwildOptimizer optimizer(settings, *network,
+                                                 worker_count);
+      optimizer.build(data_set, objective);
+      suite.measure("hogwild_optimizer/iterate",
+                    {{"layer_size", layer_size},
+                     {"workers", worker_count},
+                     {"weights", network->weight_table_size()}},
+                    [&optimizer, &data_set]() {
+                      optimizer.iterate(*data_set);
+                    });
+    }
+  }
+}
+
+RAFKO_BENCHMARK("cost_function/get_feature_errors", cost_function_errors) {
+  rafko_mainframe::RafkoSettings settings;
+  rafko_gym::CostFunctionMSE cost_function(settings);
+  for (std::uint32_t feature_size : {4u, 64u}) {
+    for (std::uint32_t label_count : {256u, 4096u}) {
+      const std::vector<std::vector<double>> labels =
+          random_vectors(label_count, feature_size);
+      const std::vector<std::vector<double>> neuron_data =
+          random_vectors(label_count, feature_size);
+      std::vector<double> errors(label_count);
+      suite.measure("cost_function/get_feature_errors",
+                    {{"feature_size", feature_size}, {"labels", label_count}},
+                    [&]() {
+                      cost_function.get_feature_errors(
+                          labels, neuron_data, errors, 0u /*label_start*/,
+                          0u /*error_start*/, label_count, 0u /*neuron_start*/,
+                          label_count);
+                    });
+    }
+  }
+}
+
+RAFKO_BENCHMARK("weight_adapter/update_solution_with_weights",
+                weight_adapter_update) {
+  rafko_mainframe::RafkoSettings settings;
+  for (std::uint32_t layer_size : {32u, 128u}) {
+    std::unique_ptr<rafko_net::RafkoNet> network(
+        rafko_net::RafkoNetBuilder(settings)
+            .input_size(16u)
+            .expected_input_range(1.0)
+            .create_layers({layer_size, layer_size, layer_size}));
+    std::unique_ptr<rafko_net::Solution> solution(
+        rafko_net::SolutionBuilder(settings).build(*network));
+    rafko_gym::RafkoWeightAdapter weight_adapter(*network, *solution,
+                                                 settings);
+    const std::uint32_t weight_number = network->weight_table_size();
+    for (std::uint32_t changed_weights : {1u, weight_number}) {
+      suite.measure("weight_adapter/update_solution_with_weights",
+                    {{"layer_size", layer_size},
+                     {"weights", weight_number},
+                     {"changed_weights", changed_weights}},
+                    [&]() {
+                      for (std::uint32_t change = 0u; change < changed_weights;
+                           ++change) {
+                        const std::uint32_t weight_index =
+                            rand() % weight_number;
+                        network->set_weight_table(
+                            weight_index,
+                            network->weight_table(weight_index) + 0.1);
+                      }
+                      weight_adapter.update_solution_with_weights();
+                    });
+    }
+  }
+}
+
+RAFKO_BENCHMARK("weight_updater/iterate", weight_updater_iterate) {
+  for (std::uint32_t layer_size : {32u, 256u}) {
+    for (std::uint32_t threads : {1u, 4u}) {
+      rafko_mainframe::RafkoSettings settings =
+          rafko_mainframe::RafkoSettings().set_max_solve_threads(threads);
+      std::unique_ptr<rafko_net::RafkoNet> network(
+          rafko_net::RafkoNetBuilder(settings)
+              .input_size(16u)
+              .expected_input_range(1.0)
+              .create_layers({layer_size, layer_size, layer_size}));
+      const std::vector<double> gradients =
+          random_vectors(1u, network->weight_table_size())[0];
+      for (rafko_gym::Weight_updaters updater_type :
+           {rafko_gym::weight_updater_default,
+            rafko_gym::weight_updater_momentum,
+            rafko_gym::weight_updater_nesterovs, rafko_gym::weight_updater_adam,
+            rafko_gym::weight_updater_amsgrad}) {
+        std::unique_ptr<rafko_gym::RafkoWeightUpdater> weight_updater =
+            rafko_gym::UpdaterFactory::build_weight_updater(
+                *network, updater_type, settings);
+        suite.measure("weight_updater/iterate",
+                      {{"updater", updater_type},
+                       {"threads", threads},
+                       {"weights", network->weight_table_size()}},
+                      [&weight_updater, &gradients]() {
+                        if (weight_updater->is_finished())
+                          weight_updater->start();
+                        weight_updater->iterate(gradients);
+                      });
+      }
+    }
+  }
+}
+
+RAFKO_BENCHMARK("rafq_set/look_up", rafq_set_look_up) {
+  constexpr std::uint32_t state_size = 8u;
+  constexpr std::uint32_t action_size = 2u;
+  rafko_mainframe::RafkoSettings settings;
+  StatelessEnvironment environment(state_size, action_size);
+  for (std::uint32_t set_size : {64u, 512u, 4096u}) {
+    rafko_gym::RafQSet q_set(settings, environment, 1u /*action_count*/,
+                             set_size, 0.0 /*overwrite_q_threshold*/);
+    /*!Note: States closer than the configured delta would be merged in the
+     * set, so they are generated far apart from each other */
+    std::vector<std::vector<double>> states =
+        random_vectors(set_size, state_size);
+    for (std::uint32_t state_index = 0u; state_index < set_size; ++state_index)
+      states[state_index][0] += 10.0 * state_index;
+    q_set.incorporate(
+        states,
+        random_vectors(set_size, rafko_gym::RafQSetItemView::feature_size(
+                                     action_size, 1u /*action_count*/)));
+    const std::vector<double> &searched_state = states[set_size / 2u];
+    suite.measure(
+        "rafq_set/look_up", {{"set_size", q_set.get_number_of_sequences()}},
+        [&q_set, &searched_state]() { q_set.look_up(searched_state); },
+        100u /*iterations_per_sample*/);
+  }
+}
+
+} /* namespace rafko_gym_bench */
@@ -0,0 +1,35 @@
+/*! This file is part of davids91/Rafko.
+ *
+ *    Rafko is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    (at your option) any later version.
+ *
+ *    Rafko is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with Rafko.  If not, see <https://www.gnu.org/licenses/> or
+ *    <https://github.com/davids91/rafko/blob/master/LICENSE>
+ */
+#include "rafko_mainframe/services/rafko_profiler.hpp"
+
+#include "benchmark/rafko_benchmark.hpp"
+
+namespace rafko_mainframe_bench {
+
+RAFKO_BENCHMARK("profiler/scope", profiler_scope) {
+  for (bool enabled : {true, false}) {
+    rafko_mainframe::RafkoProfiler::set_enabled(enabled);
+    suite.measure(
+        "profiler/scope", {{"enabled", enabled}},
+        []() { RFPROFILE_SCOPE("profiler_bench::scope"); },
+        1000u /*iterations_per_sample*/);
+  }
+  rafko_mainframe::RafkoProfiler::set_enabled(true);
+  rafko_mainframe::RafkoProfiler::reset();
+}
+
+} /* namespace rafko_mainframe_bench */
@@ -0,0 +1,155 @@
+/*! This file is part of davids91/Rafko.
+ *
+ *    Rafko is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    (at your option) any later version.
+ *
+ *    Rafko is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with Rafko.  If not, see <https://www.gnu.org/licenses/> or
+ *    <https://github.com/davids91/rafko/blob/master/LICENSE>
+ */
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "rafko_gym/models/rafko_dataset_implementation.hpp"
+#include "rafko_mainframe/models/rafko_settings.hpp"
+#include "rafko_net/services/rafko_net_builder.hpp"
+#include "rafko_net/services/solution_builder.hpp"
+#include "rafko_net/services/solution_quantizer.hpp"
+#include "rafko_net/services/solution_solver.hpp"
+#include "rafko_protocol/rafko_net.pb.h"
+#include "rafko_protocol/solution.pb.h"
+
+#include "benchmark/rafko_benchmark.hpp"
+
+namespace rafko_net_bench {
+
+namespace {
+constexpr std::uint32_t s_inputSize = 16u;
+
+/**
+ * @brief      Builds a network of the given neurons evenly divided into the
+ * given number of fully connected layers. Since every layer is only connected
+ * to the previous one, deeper networks of the same size are sparser.
+ */
+std::unique_ptr<rafko_net::RafkoNet>
+build_network(const rafko_mainframe::RafkoSettings &settings,
+              std::uint32_t neuron_count, std::uint32_t layer_count) {
+  return std::unique_ptr<rafko_net::RafkoNet>(
+      rafko_net::RafkoNetBuilder(settings)
+          .input_size(s_inputSize)
+          .expected_input_range(1.0)
+          .create_layers(nullptr, std::vector<std::uint32_t>(
+                                      layer_count, neuron_count / layer_count)));
+}
+
+std::vector<double> random_input() {
+  std::vector<double> input(s_inputSize);
+  for (double &value : input)
+    value = static_cast<double>(rand() % 100) / 100.0;
+  return input;
+}
+
+/**
+ * @brief      Builds a data set of independent random samples; only the
+ * inputs are used, so the labels are left at zero
+ */
+rafko_gym::RafkoDatasetImplementation
+random_data_set(std::uint32_t sample_count) {
+  std::vector<std::vector<double>> inputs;
+  for (std::uint32_t sample = 0u; sample < sample_count; ++sample)
+    inputs.push_back(random_input());
+  return rafko_gym::RafkoDatasetImplementation(
+      std::move(inputs), std::vector<std::vector<double>>(
+                             sample_count, std::vector<double>(1u)));
+}
+} /* namespace */
+
+RAFKO_BENCHMARK("solution_solver/solve", solution_solver_solve) {
+  constexpr std::uint32_t accuracy_samples = 16u;
+  rafko_mainframe::RafkoSettings settings;
+  for (std::uint32_t neuron_count : {64u, 256u, 1024u}) {
+    for (std::uint32_t layer_count : {2u, 4u, 8u}) {
+      std::unique_ptr<rafko_net::RafkoNet> network =
+          build_network(settings, neuron_count, layer_count);
+      std::unique_ptr<rafko_net::Solution> solution(
+          rafko_net::SolutionBuilder(settings).build(*network));
+      rafko_net::SolutionQuantizer::calibrate(
+          *solution, random_data_set(accuracy_samples), settings);
+      const rafko_gym::RafkoDatasetImplementation validation_set =
+          random_data_set(accuracy_samples);
+      rafko_net::SolutionSolver reference_solver(solution.get(), settings);
+      for (rafko_net::Inference_precision precision :
+           {rafko_net::inference_precision_double,
+            rafko_net::inference_precision_single_rounding,
+            rafko_net::inference_precision_mixed_rounding,
+            rafko_net::inference_precision_int8}) {
+        const rafko_mainframe::RafkoSettings precision_settings =
+            rafko_mainframe::RafkoSettings(settings).set_inference_precision(
+                precision);
+        rafko_net::SolutionSolver solver(solution.get(), precision_settings);
+
+        /* The accuracy of the precision is reported next to its speed,
+         * measured on samples held out from the calibration */
+        double max_error = 0.0;
+        for (std::uint32_t sample = 0u;
+             sample < validation_set.get_number_of_input_samples(); ++sample) {
+          const std::vector<double> &input =
+              validation_set.get_input_sample(sample);
+          rafko_utilities::ConstVectorSubrange<> result =
+              solver.solve(input, true /*reset_neuron_data*/, 0u);
+          rafko_utilities::ConstVectorSubrange<> reference_result =
+              reference_solver.solve(input, true /*reset_neuron_data*/, 0u);
+          for (std::uint32_t output_index = 0u; output_index < result.size();
+               ++output_index)
+            max_error = std::max(max_error,
+                                 std::abs(result[output_index] -
+                                          reference_result[output_index]));
+        }
+
+        const std::vector<double> input = random_input();
+        suite.measure(
+            "solution_solver/solve",
+            {{"neurons", neuron_count},
+             {"layers", layer_count},
+             {"weights", network->weight_table_size()},
+             {"precision", precision},
+             {"max_abs_error", max_error}},
+            [&solver, &input]() {
+              solver.solve(input, true /*reset_neuron_data*/, 0u);
+            });
+      }
+    }
+  }
+}
+
+RAFKO_BENCHMARK("solution_builder/build", solution_builder_build) {
+  rafko_mainframe::RafkoSettings settings;
+  for (std::uint32_t neuron_count : {64u, 256u, 1024u}) {
+    for (std::uint32_t layer_count : {2u, 4u, 8u}) {
+      std::unique_ptr<rafko_net::RafkoNet> network =
+          build_network(settings, neuron_count, layer_count);
+      suite.measure("solution_builder/build",
+                    {{"neurons", neuron_count},
+                     {"layers", layer_count},
+                     {"weights", network->weight_table_size()}},
+                    [&settings, &network]() {
+                      std::unique_ptr<rafko_net::Solution> solution(
+                          rafko_net::SolutionBuilder(settings).build(
+                              *network, nullptr /*arena_ptr*/));
+                    });
+    }
+  }
+}
+
+} /* namespace rafko_net_bench */
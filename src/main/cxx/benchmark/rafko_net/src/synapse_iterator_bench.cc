@@ -0,0 +1,65 @@
+/*! This file is part of davids91/Rafko.
+ *
+ *    Rafko is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    (at your option) any later version.
+ *
+ *    Rafko is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with Rafko.  If not, see <https://www.gnu.org/licenses/> or
+ *    <https://github.com/davids91/rafko/blob/master/LICENSE>
+ */
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+
+#include "rafko_net/services/synapse_iterator.hpp"
+#include "rafko_protocol/rafko_net.pb.h"
+
+#include "benchmark/rafko_benchmark.hpp"
+
+namespace rafko_net_bench {
+
+RAFKO_BENCHMARK("synapse_iterator/iterate", synapse_iterator_iterate) {
+  for (std::uint32_t synapse_count : {1000u, 100000u}) {
+    google::protobuf::RepeatedPtrField<rafko_net::IndexSynapseInterval>
+        synapses;
+    std::uint32_t index_count = 0u;
+    for (std::uint32_t synapse_index = 0u; synapse_index < synapse_count;
+         ++synapse_index) {
+      rafko_net::IndexSynapseInterval &synapse = *synapses.Add();
+      synapse.set_starts(index_count);
+      synapse.set_interval_size(1u + rand() % 20u);
+      index_count += synapse.interval_size();
+    }
+    rafko_net::SynapseIterator<> iterator(synapses);
+    std::uint64_t sum = 0u;
+
+    /* The same callable once behind a std::function, once as a lambda */
+    std::function<void(std::int32_t)> type_erased = [&sum](std::int32_t index) {
+      sum += index;
+    };
+    suite.measure("synapse_iterator/iterate",
+                  {{"synapses", synapse_count},
+                   {"indices", index_count},
+                   {"std_function", 1.0}},
+                  [&iterator, &type_erased]() {
+                    iterator.iterate(type_erased);
+                  });
+    suite.measure("synapse_iterator/iterate",
+                  {{"synapses", synapse_count},
+                   {"indices", index_count},
+                   {"std_function", 0.0}},
+                  [&iterator, &sum]() {
+                    iterator.iterate(
+                        [&sum](std::int32_t index) { sum += index; });
+                  });
+  }
+}
+
+} /* namespace rafko_net_bench */
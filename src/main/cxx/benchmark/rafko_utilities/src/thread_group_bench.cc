@@ -0,0 +1,40 @@
+/*! This file is part of davids91/Rafko.
+ *
+ *    Rafko is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    (at your option) any later version.
+ *
+ *    Rafko is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with Rafko.  If not, see <https://www.gnu.org/licenses/> or
+ *    <https://github.com/davids91/rafko/blob/master/LICENSE>
+ */
+#include "rafko_utilities/services/thread_group.hpp"
+
+#include "benchmark/rafko_benchmark.hpp"
+
+namespace rafko_utilities_bench {
+
+RAFKO_BENCHMARK("thread_group/start_and_block", thread_group_dispatch) {
+  for (rafko_utilities::ThreadGroup::synchronization_t synchronization :
+       {rafko_utilities::ThreadGroup::Blocking,
+        rafko_utilities::ThreadGroup::SpinThenPark}) {
+    for (std::uint32_t thread_count : {1u, 2u, 4u, 8u}) {
+      rafko_utilities::ThreadGroup threads(thread_count, synchronization);
+      suite.measure(
+          "thread_group/start_and_block",
+          {{"threads", thread_count},
+           {"spin_then_park",
+            (rafko_utilities::ThreadGroup::SpinThenPark == synchronization)}},
+          [&threads]() { threads.start_and_block([](std::uint32_t) {}); },
+          100u /*iterations_per_sample*/);
+    }
+  }
+}
+
+} /* namespace rafko_utilities_bench */
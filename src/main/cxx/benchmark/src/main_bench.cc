@@ -0,0 +1,72 @@
+/*! This file is part of davids91/Rafko.
+ *
+ *    Rafko is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    (at your option) any later version.
+ *
+ *    Rafko is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with Rafko.  If not, see <https://www.gnu.org/licenses/> or
+ *    <https://github.com/davids91/rafko/blob/master/LICENSE>
+ */
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include "benchmark/rafko_benchmark.hpp"
+
+/**
+ * Usage: rafko_bench [--output <file>] [--filter <text>] [--samples <count>]
+ *                    [--warmup <count>] [--seed <seed>]
+ * Only the benchmarks whose name contains the filter text are run; the
+ * results are written to the output file as JSON ( "rafko_bench.json" by
+ * default ).
+ */
+int main(int argc, char **argv) {
+  std::string output_file = "rafko_bench.json";
+  std::string filter;
+  std::uint32_t samples = 20u;
+  std::uint32_t warmup_samples = 3u;
+  std::uint32_t seed = 42u;
+  for (int arg_index = 1; arg_index < argc; ++arg_index) {
+    const std::string argument = argv[arg_index];
+    if ((arg_index + 1) >= argc) {
+      std::cerr << "Missing value for argument: " << argument << std::endl;
+      return EXIT_FAILURE;
+    }
+    const std::string value = argv[++arg_index];
+    if ("--output" == argument)
+      output_file = value;
+    else if ("--filter" == argument)
+      filter = value;
+    else if ("--samples" == argument)
+      samples = std::stoul(value);
+    else if ("--warmup" == argument)
+      warmup_samples = std::stoul(value);
+    else if ("--seed" == argument)
+      seed = std::stoul(value);
+    else {
+      std::cerr << "Unknown argument: " << argument << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  rafko_benchmark::Suite suite(samples, warmup_samples, seed);
+  for (const auto &[name, benchmark] : rafko_benchmark::get_benchmarks()) {
+    if (std::string::npos == name.find(filter))
+      continue;
+    srand(seed);
+    benchmark(suite);
+  }
+
+  std::ofstream output(output_file);
+  suite.export_json(output);
+  std::cout << "Results written to " << output_file << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,109 @@
+/*! This file is part of davids91/Rafko.
+ *
+ *    Rafko is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    (at your option) any later version.
+ *
+ *    Rafko is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with Rafko.  If not, see <https://www.gnu.org/licenses/> or
+ *    <https://github.com/davids91/rafko/blob/master/LICENSE>
+ */
+#include "benchmark/rafko_benchmark.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <numeric>
+
+namespace rafko_benchmark {
+
+std::vector<std::pair<std::string, BenchmarkFunction>> &get_benchmarks() {
+  static std::vector<std::pair<std::string, BenchmarkFunction>> benchmarks;
+  return benchmarks;
+}
+
+void Suite::measure(const std::string &name, Parameters parameters,
+                    const std::function<void()> &function,
+                    std::uint32_t iterations_per_sample) {
+  iterations_per_sample = std::max(1u, iterations_per_sample);
+  std::vector<double> durations;
+  durations.reserve(m_samples);
+  for (std::uint32_t sample = 0u; sample < (m_warmupSamples + m_samples);
+       ++sample) {
+    const auto start = std::chrono::steady_clock::now();
+    for (std::uint32_t iteration = 0u; iteration < iterations_per_sample;
+         ++iteration)
+      function();
+    const double duration =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start)
+            .count();
+    if (m_warmupSamples <= sample)
+      durations.push_back(duration / iterations_per_sample);
+  }
+
+  Measurement result;
+  result.name = name;
+  result.parameters = std::move(parameters);
+  result.samples = durations.size();
+  result.iterations_per_sample = iterations_per_sample;
+  if (0u < durations.size()) {
+    std::sort(durations.begin(), durations.end());
+    result.min_ns = durations.front();
+    result.max_ns = durations.back();
+    result.median_ns = durations[durations.size() / 2u];
+    result.mean_ns =
+        std::accumulate(durations.begin(), durations.end(), 0.0) /
+        durations.size();
+    double variance = 0.0;
+    for (double duration : durations)
+      variance += (duration - result.mean_ns) * (duration - result.mean_ns);
+    result.stddev_ns = std::sqrt(variance / durations.size());
+  }
+
+  std::cout << name;
+  for (const auto &[parameter, value] : result.parameters)
+    std::cout << " " << parameter << "=" << value;
+  std::cout << " | median: " << result.median_ns << "ns" << std::endl;
+  m_measurements.push_back(std::move(result));
+}
+
+void Suite::export_json(std::ostream &stream) const {
+  /*!Note: Every double is written precise enough to be read back unchanged */
+  const auto previous_precision = stream.precision(
+      std::numeric_limits<double>::max_digits10);
+  stream << "{\"seed\":" << m_seed << ",\"samples\":" << m_samples
+         << ",\"warmup_samples\":" << m_warmupSamples
+         << ",\"benchmarks\":[";
+  bool first_measurement = true;
+  for (const Measurement &measurement : m_measurements) {
+    stream << (first_measurement ? "" : ",") << "{\"name\":\""
+           << measurement.name << "\",\"parameters\":{";
+    bool first_parameter = true;
+    for (const auto &[parameter, value] : measurement.parameters) {
+      stream << (first_parameter ? "" : ",") << "\"" << parameter
+             << "\":" << value;
+      first_parameter = false;
+    }
+    stream << "},\"samples\":" << measurement.samples
+           << ",\"iterations_per_sample\":" << measurement.iterations_per_sample
+           << ",\"mean_ns\":" << measurement.mean_ns
+           << ",\"median_ns\":" << measurement.median_ns
+           << ",\"min_ns\":" << measurement.min_ns
+           << ",\"max_ns\":" << measurement.max_ns
+           << ",\"stddev_ns\":" << measurement.stddev_ns << "}";
+    first_measurement = false;
+  }
+  stream << "]}";
+  stream.precision(previous_precision);
+}
+
+} /* namespace rafko_benchmark */
@@ -21,10 +21,15 @@
 #include "rafko_global.hpp"
 
 #include <algorithm>
+#include <iterator>
+#include <memory>
+#include <optional>
 #include <vector>
 
+#include "rafko_gym/models/rafko_dataset.hpp"
 #include "rafko_mainframe/services/rafko_assertion_logger.hpp"
 #include "rafko_protocol/rafko_net.pb.h"
+#include "rafko_utilities/models/contiguous_ringbuffer.hpp"
 #include "rafko_utilities/models/data_ringbuffer.hpp"
 
 namespace rafko_gym {
@@ -40,9 +45,9 @@ class RAFKO_EXPORT RafkoBackpropagationData {
   using NetworkValueBuffer = rafko_utilities::DataRingbuffer<>;
 
   /* For every run the network remembers, the per weight derivative value of
-   * every operation  is stored */
-  using NetworkDerivativeBuffer =
-      rafko_utilities::DataRingbuffer<std::vector<std::vector<double>>>;
+   * every operation is stored in one slot: {operations, tracked d_w values} */
+  template <typename T>
+  using NetworkDerivativeBuffer = rafko_utilities::ContiguousRingbuffer<T>;
 
   /* For every sequence */
   using SequenceDerivativeBuffer = rafko_utilities::DataRingbuffer<>;
@@ -54,6 +59,7 @@ public:
                              because of the Spike function */
         ,
         m_weightTableSize(network.weight_table_size()),
+        m_inputSize(network.input_data_size()),
         m_weightRelevantOperationCount(0u), m_calculatedDerivatives(),
         m_calculatedValues(), m_sequenceDerivatives() {}
 
@@ -61,16 +67,24 @@ public:
    * @brief   Constructs ( or re-constructs ) the buffers based on the provided
    * information
    *
-   * @param[in]     number_of_operations        The number of backpropagation
-   * operations to store inside the buffers
+   * @param[in]     operation_weights           The sorted indices of the
+   * weights each backpropagation operation depends on; Derivatives are only
+   * stored for these weights, for any other weight they are implied to be zero
    * @param[in]     relevant_operation_count    The number of backpropagation
    * operations to relevant to weights, i.e. not only used internally
    * @param[in]     sequence_size               The size of a sequence the
    * network is going to be running in
+   * @param[in]     adjoint_window              The number of past runs the
+   * adjoints are propagated back to in reverse mode; 0 means forward mode,
+   * where the per weight derivatives of every operation are stored instead
+   * @param[in]     single_precision            Whether the per weight
+   * derivatives of the operations are stored as floats instead of doubles,
+   * halving their memory footprint at the cost of precision
    */
-  void build(std::uint32_t number_of_operations,
+  void build(std::vector<std::vector<std::uint32_t>> operation_weights,
              std::uint32_t relevant_operation_count,
-             std::uint32_t sequence_size);
+             std::uint32_t sequence_size, std::uint32_t adjoint_window = 0u,
+             bool single_precision = false);
 
   /**
    * @brief Erases the data stored in the data buffers
@@ -97,6 +111,25 @@ public:
     m_updateWeightDerivative = update;
   }
 
+  /**
+   * @brief   Tells if sequence derivatives are updated in the current run
+   *
+   * @return  true, if sequence_derivatives are to be updated
+   */
+  constexpr bool is_weight_derivative_updated() const {
+    return m_updateWeightDerivative;
+  }
+
+  /**
+   * @brief   Tells the number of operations at the start of the operations
+   * array, which derivatives are directly relevant to the weight updates
+   *
+   * @return  The number of weight relevant operations
+   */
+  constexpr std::uint32_t get_weight_relevant_operation_count() const {
+    return m_weightRelevantOperationCount;
+  }
+
   /**
    * @brief     Stores the provided value as a result of an operation inside the
    * network for the current iteration of the bufffers
@@ -156,15 +189,6 @@ public:
     return m_calculatedValues->get_element(past_index, operation_index);
   }
 
-  /**
-   * @brief provides access to the underlying buffer for the network operation
-   * derivatives
-   */
-  const NetworkDerivativeBuffer &get_actual_derivative() {
-    RFASSERT(m_built);
-    return *m_calculatedDerivatives;
-  }
-
   /**
    * @brief     queries the network operation calculated derivative under the
    * given parameters
@@ -179,25 +203,48 @@ public:
   double get_derivative(std::uint32_t past_index, std::uint32_t operation_index,
                         std::uint32_t weight_index) {
     RFASSERT(m_built);
-    if (m_calculatedDerivatives->get_sequence_size() <= past_index)
+    RFASSERT(!is_reverse_mode());
+    RFASSERT(operation_index < m_operationCount);
+    RFASSERT(weight_index < m_weightTableSize);
+    if (m_memorySlots <= past_index)
       return 0.0;
-    RFASSERT(operation_index < m_calculatedDerivatives->get_element(0).size());
-    RFASSERT(weight_index <
-             m_calculatedDerivatives->get_element(past_index, operation_index)
-                 .size());
-    return m_calculatedDerivatives->get_element(past_index,
-                                                operation_index)[weight_index];
+    const std::optional<std::size_t> derivative_index =
+        get_derivative_index(operation_index, weight_index);
+    if (!derivative_index.has_value())
+      return 0.0;
+    if (m_singlePrecision)
+      return m_calculatedDerivativesF32->get_slot(
+          past_index)[*derivative_index];
+    return m_calculatedDerivatives->get_slot(past_index)[*derivative_index];
   }
 
   /**
-   * @brief     provides access to the underlying buffer for the network
-   * operation derivatives stored explicitly to base weight updates upon.
+   * @brief     Provides the indices of the weights the derivatives are stored
+   * for in the given operation
+   *
+   * @param[in]    operation_index   The index of the operation
+   *
+   * @return    The sorted weight indices
    */
-  const NetworkDerivativeBuffer &get_sequence_derivative() {
-    RFASSERT(m_built);
-    return *m_calculatedDerivatives;
+  const std::vector<std::uint32_t> &
+  get_tracked_weights(std::uint32_t operation_index) const {
+    RFASSERT(operation_index < m_operationWeights.size());
+    return m_operationWeights[operation_index];
   }
 
+  /**
+   * @brief     Provides the number of derivative values stored for one run
+   */
+  std::size_t get_tracked_derivative_count() const {
+    return m_derivativeOffsets.empty() ? 0u : m_derivativeOffsets.back();
+  }
+
+  /**
+   * @brief     Tells if the per weight derivatives of the operations are stored
+   * in single precision
+   */
+  constexpr bool is_single_precision() const { return m_singlePrecision; }
+
   /**
    * @brief     queries the calculated derivative for the given sequence and
    * weight
@@ -227,18 +274,168 @@ public:
     return *m_sequenceDerivatives;
   }
 
+  /**
+   * @brief     Tells if the buffers are built for reverse mode autodiff, i.e.
+   * adjoints are stored instead of per weight derivatives of every operation
+   *
+   * @return    true, if the buffers are built for reverse mode
+   */
+  constexpr bool is_reverse_mode() const { return (0u < m_adjointWindow); }
+
+  /**
+   * @brief     Stores the network input of the current run, so the adjoints of
+   * past runs can be calculated from it. Only used in reverse mode.
+   *
+   * @param[in]    network_input     The input the network is evaluated with
+   */
+  void set_network_input(const RafkoDataSet::SampleView &network_input) {
+    RFASSERT(m_built);
+    RFASSERT(is_reverse_mode());
+    RFASSERT(network_input.size() == m_networkInputs->get_element(0).size());
+    std::copy(network_input.begin(), network_input.end(),
+              m_networkInputs->get_element(0u /*past_index*/).begin());
+  }
+
+  /**
+   * @brief     Provides the network input stored for a past run
+   *
+   * @param[in]    past_index        The past_index of the run
+   *
+   * @return    Const reference to the stored input
+   */
+  const std::vector<double> &get_network_input(std::uint32_t past_index) const {
+    RFASSERT(m_built);
+    RFASSERT(is_reverse_mode());
+    return m_networkInputs->get_element(past_index);
+  }
+
+  /**
+   * @brief     Registers that the derivatives are calculated for the current
+   * run. Runs without derivatives ( e.g. prefill ) break the chain of runs the
+   * adjoints may be propagated back into.
+   */
+  constexpr void register_derivative_run() {
+    m_derivativeRunRegistered = true;
+    ++m_derivativeRunCount;
+  }
+
+  /**
+   * @brief     Provides the number of past runs ( including the current one )
+   * the adjoints can be propagated back to in the current run
+   *
+   * @return    The number of usable adjoint runs
+   */
+  constexpr std::uint32_t get_adjoint_run_count() const {
+    return std::min(m_derivativeRunCount, m_adjointWindow);
+  }
+
+  /**
+   * @brief     Sets every stored adjoint value to zero, both for the
+   * operations and for the weights
+   */
+  void reset_adjoints() {
+    std::fill(m_operationAdjoints.begin(), m_operationAdjoints.end(), 0.0);
+    std::fill(m_weightAdjoints.begin(), m_weightAdjoints.end(), 0.0);
+  }
+
+  /**
+   * @brief     Provides the collected adjoint of an operation in the given run
+   *
+   * @param[in]    past_index        The past_index of the run
+   * @param[in]    operation_index   The index of the operation
+   *
+   * @return    The adjoint value collected for the operation
+   */
+  double get_adjoint(std::uint32_t past_index,
+                     std::uint32_t operation_index) const {
+    RFASSERT(past_index < m_adjointWindow);
+    RFASSERT(operation_index < m_operationCount);
+    return m_operationAdjoints[(past_index * m_operationCount) +
+                               operation_index];
+  }
+
+  /**
+   * @brief     Accumulates the given value into the adjoint of an operation in
+   * the given run. Values reaching beyond the usable runs are truncated.
+   *
+   * @param[in]    past_index        The past_index of the run
+   * @param[in]    operation_index   The index of the operation
+   * @param[in]    value             The value to add
+   */
+  void add_adjoint(std::uint32_t past_index, std::uint32_t operation_index,
+                   double value) {
+    RFASSERT(operation_index < m_operationCount);
+    if (past_index < get_adjoint_run_count())
+      m_operationAdjoints[(past_index * m_operationCount) + operation_index] +=
+          value;
+  }
+
+  /**
+   * @brief     Accumulates the given value into the adjoint of a weight
+   *
+   * @param[in]    d_w_index         The index of the weight
+   * @param[in]    value             The value to add
+   */
+  void add_weight_adjoint(std::uint32_t d_w_index, double value) {
+    RFASSERT(d_w_index < m_weightAdjoints.size());
+    m_weightAdjoints[d_w_index] += value;
+  }
+
+  /**
+   * @brief     Stores the collected weight adjoints as the derivatives of the
+   * current run, should sequence derivatives be updated
+   */
+  void apply_weight_adjoints();
+
 private:
   const std::uint32_t m_memorySlots;
   const std::uint32_t m_weightTableSize;
+  const std::uint32_t m_inputSize;
   std::uint32_t m_weightRelevantOperationCount;
-  std::unique_ptr<NetworkDerivativeBuffer>
+  std::uint32_t m_operationCount = 0u;
+  std::uint32_t m_adjointWindow = 0u;
+  std::uint32_t m_derivativeRunCount = 0u;
+  bool m_derivativeRunRegistered = false;
+  std::vector<double> m_operationAdjoints; /* {adjoint runs, operations} */
+  std::vector<double> m_weightAdjoints;
+  std::unique_ptr<NetworkValueBuffer> m_networkInputs; /* {runs, inputs} */
+  std::vector<std::vector<std::uint32_t>>
+      m_operationWeights; /* {operations, tracked weight indices} */
+  std::vector<std::size_t>
+      m_derivativeOffsets; /* {operations + 1}: start of each operation */
+  bool m_singlePrecision = false;
+  std::unique_ptr<NetworkDerivativeBuffer<double>>
       m_calculatedDerivatives; /* {runs, operations, d_w values} */
+  std::unique_ptr<NetworkDerivativeBuffer<float>>
+      m_calculatedDerivativesF32; /* the same in single precision */
   std::unique_ptr<NetworkValueBuffer>
       m_calculatedValues; /* {runs, operations} */
   std::unique_ptr<SequenceDerivativeBuffer>
       m_sequenceDerivatives; /* past_sequences_index, average d_w_values */
   bool m_built = false;
   bool m_updateWeightDerivative = true;
+
+  /**
+   * @brief     Provides the position of the derivative value inside a slot of
+   * the derivative buffers
+   *
+   * @param[in]    operation_index   The index of the operation
+   * @param[in]    weight_index      The index of the weight
+   *
+   * @return    The position of the value, or std::nullopt if the derivative is
+   * not tracked because it's always zero
+   */
+  std::optional<std::size_t>
+  get_derivative_index(std::uint32_t operation_index,
+                       std::uint32_t weight_index) const {
+    const std::vector<std::uint32_t> &weights =
+        m_operationWeights[operation_index];
+    auto found = std::lower_bound(weights.begin(), weights.end(), weight_index);
+    if ((found == weights.end()) || (*found != weight_index))
+      return std::nullopt;
+    return m_derivativeOffsets[operation_index] +
+           static_cast<std::size_t>(std::distance(weights.begin(), found));
+  }
 };
 
 } /* namespace rafko_gym */
@@ -27,7 +27,7 @@
 #include "rafko_gym/services/function_factory.hpp"
 #include "rafko_mainframe/models/rafko_settings.hpp"
 #include "rafko_utilities/models/data_pool.hpp"
-#include "rafko_utilities/services/thread_group.hpp"
+#include "rafko_utilities/services/work_stealing_pool.hpp"
 #if (RAFKO_USES_OPENCL)
 #include "rafko_mainframe/models/rafko_gpu_strategy.hpp"
 #include "rafko_mainframe/models/rafko_nbuf_shape.hpp"
@@ -47,14 +47,14 @@ public:
   RafkoCost(rafko_mainframe::RafkoSettings &settings,
             std::shared_ptr<rafko_gym::CostFunction> cost_function)
       : m_settings(settings), m_costFunction(cost_function),
-        m_errorCalculationThreads(settings.get_sqrt_of_solve_threads()) {}
+        m_threadPool(rafko_utilities::WorkStealingPool::shared()) {}
 
   RafkoCost(rafko_mainframe::RafkoSettings &settings,
             rafko_gym::Cost_functions the_function)
       : m_settings(settings),
         m_costFunction(rafko_gym::FunctionFactory::build_cost_function(
             the_function, settings)),
-        m_errorCalculationThreads(settings.get_sqrt_of_solve_threads()) {}
+        m_threadPool(rafko_utilities::WorkStealingPool::shared()) {}
 
   ~RafkoCost() = default;
 
@@ -174,7 +174,7 @@ private:
 
   rafko_mainframe::RafkoSettings &m_settings;
   std::shared_ptr<rafko_gym::CostFunction> m_costFunction;
-  rafko_utilities::ThreadGroup m_errorCalculationThreads;
+  rafko_utilities::WorkStealingPool &m_threadPool;
 #if (RAFKO_USES_OPENCL)
   std::uint32_t m_pairsToEvaluate = 1u;
 #endif /*(RAFKO_USES_OPENCL)*/
@@ -190,8 +190,8 @@ private:
    * @param[in]      length         The number of elements to take from @source
    * into @target
    * @param          error_mutex    The mutex guarding the update of @target
-   * @param[in]      thread_index   The index of the thread the function is
-   * called from
+   * @param[in]      thread_index   The index of the part of @source to
+   * accumulate, one for each solve thread
    */
   void accumulate_error_sum(std::vector<double> &source, double &target,
                             std::uint32_t length, std::mutex &error_mutex,
@@ -25,6 +25,8 @@
 #include <CL/opencl.hpp>
 #endif /*(RAFKO_USES_OPENCL)*/
 
+#include "rafko_utilities/models/const_vector_subrange.hpp"
+
 namespace RAFKO_EXPORT rafko_gym {
 
 /**
@@ -34,6 +36,7 @@ namespace RAFKO_EXPORT rafko_gym {
 class RAFKO_EXPORT RafkoDataSet {
 public:
   using FeatureVector = std::vector<double>;
+  using SampleView = rafko_utilities::ConstVectorSubrange<const double *>;
 
   /**
    * @brief      Gets an input sample from the set
@@ -69,6 +72,32 @@ public:
    */
   virtual const std::vector<FeatureVector> &get_label_samples() const = 0;
 
+  /**
+   * @brief      Gets a read-only view of an input sample, without requiring the
+   * sample to be stored in a vector. Implementations not storing their samples
+   * in vectors should prefer this over @get_input_sample.
+   *
+   * @param[in]  raw_input_index  The sample index
+   *
+   * @return     A view of the input sample, valid as long as the data set is
+   */
+  virtual SampleView get_input_view(std::uint32_t raw_input_index) const {
+    return get_input_sample(raw_input_index);
+  }
+
+  /**
+   * @brief      Gets a read-only view of a label sample, without requiring the
+   * sample to be stored in a vector. Implementations not storing their samples
+   * in vectors should prefer this over @get_label_sample.
+   *
+   * @param[in]  raw_label_index  The sample index
+   *
+   * @return     A view of the label sample, valid as long as the data set is
+   */
+  virtual SampleView get_label_view(std::uint32_t raw_label_index) const {
+    return get_label_sample(raw_label_index);
+  }
+
   /**
    * @brief      Gets the number of floating point values the evaluation accepts
    * to produce the label values
@@ -136,6 +165,14 @@ public:
     return get_prefill_inputs_number() + get_sequence_size();
   }
 
+  /**
+   * @brief     Moves on to the next minibatch in data sets exposing only a part
+   * of their data at once, like streams; The optimizers call it after every
+   * iteration, from the thread calling iterate, while no other thread uses
+   * the data set. Data sets holding all of their samples don't change.
+   */
+  virtual void next_minibatch() const {}
+
   virtual ~RafkoDataSet() = default;
 
 #if (RAFKO_USES_OPENCL)
@@ -0,0 +1,152 @@
+/*! This file is part of davids91/Rafko.
+ *
+ *    Rafko is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    (at your option) any later version.
+ *
+ *    Rafko is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with Rafko.  If not, see <https://www.gnu.org/licenses/> or
+ *    <https://github.com/davids91/rafko/blob/master/LICENSE>
+ */
+
+#ifndef RAFKO_MAPPED_DATASET_H
+#define RAFKO_MAPPED_DATASET_H
+
+#include "rafko_global.hpp"
+
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "rafko_gym/models/rafko_dataset.hpp"
+#include "rafko_protocol/training.pb.h"
+
+namespace rafko_gym {
+
+/**
+ * @brief      A data set served directly from a memory mapped binary file, so
+ * the samples are only loaded into memory by the operating system when they
+ * are accessed, and are never parsed or copied. The structure of the data is
+ * the same as in @RafkoDatasetImplementation, stored in columns after a fixed
+ * size header:
+ *             ================================================
+ *             - Header: magic, version, input size, feature size, sequence
+ *               size, prefill inputs per sequence, number of sequences
+ *             - Inputs: every input sample, one after another
+ *             - Labels: every label sample, one after another
+ *             ================================================
+ *             Values are stored as doubles in the byte order of the machine
+ * writing the file. Files can be created from @DataSetPackages or other data
+ * sets through the static @write functions.
+ */
+class RAFKO_EXPORT RafkoMappedDataSet : public RafkoDataSet {
+public:
+  explicit RafkoMappedDataSet(const std::string &file_name);
+  ~RafkoMappedDataSet();
+  RafkoMappedDataSet(const RafkoMappedDataSet &other) = delete;
+  RafkoMappedDataSet &operator=(const RafkoMappedDataSet &other) = delete;
+  RafkoMappedDataSet(RafkoMappedDataSet &&other) = delete;
+  RafkoMappedDataSet &operator=(RafkoMappedDataSet &&other) = delete;
+
+  SampleView get_input_view(std::uint32_t raw_input_index) const override;
+  SampleView get_label_view(std::uint32_t raw_label_index) const override;
+
+  /**
+   * @brief      Serves the input sample from the copy of the samples made by
+   * @get_input_samples, so the reference stays valid for the lifetime of the
+   * object. @get_input_view should be preferred instead.
+   */
+  const FeatureVector &
+  get_input_sample(std::uint32_t raw_input_index) const override;
+
+  /**
+   * @brief      Serves the label sample from the copy of the samples made by
+   * @get_label_samples, so the reference stays valid for the lifetime of the
+   * object. @get_label_view should be preferred instead.
+   */
+  const FeatureVector &
+  get_label_sample(std::uint32_t raw_label_index) const override;
+
+  /**
+   * @brief      Copies every input and label sample into memory on the first
+   * call, as the mapped file can not be served as vectors; Only provided for
+   * compatibility.
+   */
+  const std::vector<FeatureVector> &get_input_samples() const override;
+  const std::vector<FeatureVector> &get_label_samples() const override;
+
+  std::uint32_t get_input_size() const override { return m_inputSize; }
+  std::uint32_t get_feature_size() const override { return m_featureSize; }
+  std::uint32_t get_number_of_input_samples() const override {
+    return m_numberOfInputSamples;
+  }
+  std::uint32_t get_number_of_label_samples() const override {
+    return m_numberOfLabelSamples;
+  }
+  std::uint32_t get_number_of_sequences() const override {
+    return m_numberOfSequences;
+  }
+  std::uint32_t get_sequence_size() const override { return m_sequenceSize; }
+  std::uint32_t get_prefill_inputs_number() const override {
+    return m_prefillInputs;
+  }
+
+  /**
+   * @brief      Writes the given data set into a file readable by this class
+   *
+   * @param[in]  data_set     The data set to store
+   * @param[in]  file_name    The path of the file to (over)write
+   */
+  static void write(const RafkoDataSet &data_set, const std::string &file_name);
+
+  /**
+   * @brief      Writes the given data set package into a file readable by this
+   * class, without converting it to any intermediate format
+   *
+   * @param[in]  samples      The data set to store
+   * @param[in]  file_name    The path of the file to (over)write
+   */
+  static void write(const DataSetPackage &samples,
+                    const std::string &file_name);
+
+  /**
+   * @brief      Converts a file containing a serialized @DataSetPackage into a
+   * file readable by this class
+   *
+   * @param[in]  package_file_name    The path of the serialized package
+   * @param[in]  file_name            The path of the file to (over)write
+   */
+  static void convert(const std::string &package_file_name,
+                      const std::string &file_name);
+
+private:
+  std::uint32_t m_inputSize = 0u;
+  std::uint32_t m_featureSize = 0u;
+  std::uint32_t m_sequenceSize = 0u;
+  std::uint32_t m_prefillInputs = 0u;
+  std::uint32_t m_numberOfSequences = 0u;
+  std::uint32_t m_numberOfInputSamples = 0u;
+  std::uint32_t m_numberOfLabelSamples = 0u;
+  void *m_mapping = nullptr;
+  std::size_t m_mappingSize = 0u;
+  const double *m_inputs = nullptr;
+  const double *m_labels = nullptr;
+
+  mutable std::once_flag m_samplesCopied;
+  mutable std::vector<FeatureVector> m_inputSamples;
+  mutable std::vector<FeatureVector> m_labelSamples;
+
+  void copy_samples() const;
+  void unmap();
+};
+
+} /* namespace rafko_gym */
+
+#endif /* RAFKO_MAPPED_DATASET_H */
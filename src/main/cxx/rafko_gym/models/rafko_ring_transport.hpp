@@ -0,0 +1,80 @@
+/*! This file is part of davids91/Rafko.
+ *
+ *    Rafko is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    (at your option) any later version.
+ *
+ *    Rafko is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with Rafko.  If not, see <https://www.gnu.org/licenses/> or
+ *    <https://github.com/davids91/rafko/blob/master/LICENSE>
+ */
+
+#ifndef RAFKO_RING_TRANSPORT_H
+#define RAFKO_RING_TRANSPORT_H
+
+#include "rafko_global.hpp"
+
+#include <cstdint>
+#include <string>
+
+namespace rafko_gym {
+
+/**
+ * @brief      An interface for the connections of one worker inside a ring of
+ * workers, each of them identified by its rank: every worker sends messages to
+ * the next rank and receives them from the previous one. Failures of the
+ * connections are signaled by throwing std::runtime_error, after which the
+ * connections can be established again with @connect.
+ */
+class RAFKO_EXPORT RafkoRingTransport {
+public:
+  virtual ~RafkoRingTransport() = default;
+
+  /**
+   * @brief      Provides the index of the worker inside the ring
+   */
+  virtual std::uint32_t get_rank() const = 0;
+
+  /**
+   * @brief      Provides the number of workers inside the ring
+   */
+  virtual std::uint32_t get_world_size() const = 0;
+
+  /**
+   * @brief      Closes the existing connections, and establishes them again
+   * with the neighbours of the worker; Blocks until both of them are available
+   */
+  virtual void connect() = 0;
+
+  /**
+   * @brief      Shuts down the connections, so calls blocked on them fail,
+   * and the neighbours waiting on them do so as well. Can be called from
+   * another thread while the connections are in use.
+   */
+  virtual void interrupt() = 0;
+
+  /**
+   * @brief      Sends a message to the next worker inside the ring
+   *
+   * @param[in]  message    The bytes to send
+   */
+  virtual void send_to_next(const std::string &message) = 0;
+
+  /**
+   * @brief      Receives the next message from the previous worker inside the
+   * ring, blocking until it arrives
+   *
+   * @return     The bytes of the message
+   */
+  virtual std::string receive_from_previous() = 0;
+};
+
+} /* namespace rafko_gym */
+
+#endif /* RAFKO_RING_TRANSPORT_H */
@@ -0,0 +1,192 @@
+/*! This file is part of davids91/Rafko.
+ *
+ *    Rafko is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    (at your option) any later version.
+ *
+ *    Rafko is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with Rafko.  If not, see <https://www.gnu.org/licenses/> or
+ *    <https://github.com/davids91/rafko/blob/master/LICENSE>
+ */
+
+#ifndef RAFKO_STREAMING_DATASET_H
+#define RAFKO_STREAMING_DATASET_H
+
+#include "rafko_global.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "rafko_gym/models/rafko_dataset.hpp"
+#include "rafko_mainframe/models/rafko_settings.hpp"
+#include "rafko_mainframe/services/rafko_assertion_logger.hpp"
+
+namespace rafko_gym {
+
+/**
+ * @brief      A data set streamed from shards on disk, for training on data
+ * which doesn't fit into memory. Shards are files in the format of
+ * @RafkoMappedDataSet, with the same sample sizes in each. A background thread
+ * reads the sequences of the shards one after another, shuffles them inside a
+ * window of the given size, and collects them into minibatches of
+ * settings.get_minibatch_size() sequences, keeping a bounded number of them
+ * ready in advance. Once every shard is read, reading starts over again, so
+ * minibatches are always full and the stream never ends.
+ *             The data set only ever exposes the current minibatch: the number
+ * of sequences equals the minibatch size, and sample indices are relative to
+ * it. @next_minibatch replaces it with the next one, so it can't be called
+ * while the data set is being used by other threads. The optimizers call it
+ * after every iteration, so a training loop only needs to iterate:
+ *             ================================================
+ *             optimizer.iterate(*data_set);
+ *             ================================================
+ */
+class RAFKO_EXPORT RafkoStreamingDataSet : public RafkoDataSet {
+public:
+  /**
+   * @param[in]  settings             The settings providing the minibatch size
+   * @param[in]  shard_files          The paths of the shards to read from
+   * @param[in]  prefetched_batches   The maximum number of minibatches to
+   * prepare in advance
+   * @param[in]  shuffle_window       The number of sequences to choose the
+   * next one randomly from; 1 keeps the order of the shards
+   * @param[in]  seed                 The seed for shuffling the sequences
+   */
+  RafkoStreamingDataSet(const rafko_mainframe::RafkoSettings &settings,
+                        std::vector<std::string> shard_files,
+                        std::uint32_t prefetched_batches = 4u,
+                        std::uint32_t shuffle_window = 1024u,
+                        std::uint32_t seed = 0u);
+  ~RafkoStreamingDataSet();
+  RafkoStreamingDataSet(const RafkoStreamingDataSet &other) = delete;
+  RafkoStreamingDataSet &operator=(const RafkoStreamingDataSet &other) = delete;
+  RafkoStreamingDataSet(RafkoStreamingDataSet &&other) = delete;
+  RafkoStreamingDataSet &operator=(RafkoStreamingDataSet &&other) = delete;
+
+  /**
+   * @brief      Replaces the current minibatch with the next prepared one,
+   * waiting for the background thread if there are none ready. Rethrows any
+   * exception the background thread encountered while reading the shards.
+   */
+  void next_minibatch() const override;
+
+  /**
+   * @brief      Provides the overall time @next_minibatch had to wait for the
+   * background thread; If it keeps growing, the number of prefetched batches
+   * should be increased, or the shards need to be stored on faster storage.
+   */
+  std::chrono::nanoseconds get_prefetch_stall_time() const {
+    std::lock_guard<std::mutex> my_lock(m_bufferMutex);
+    return m_stallTime;
+  }
+
+  /**
+   * @brief      Provides the number of times @next_minibatch had to wait for
+   * the background thread
+   */
+  std::uint32_t get_prefetch_stalls() const {
+    std::lock_guard<std::mutex> my_lock(m_bufferMutex);
+    return m_stalls;
+  }
+
+  /**
+   * @brief      Provides the number of sequences stored in all the shards
+   */
+  std::uint32_t get_number_of_sequences_overall() const {
+    return m_sequencesOverall;
+  }
+
+  const FeatureVector &
+  get_input_sample(std::uint32_t raw_input_index) const override {
+    RFASSERT(raw_input_index < m_current.inputs.size());
+    return m_current.inputs[raw_input_index];
+  }
+
+  const std::vector<FeatureVector> &get_input_samples() const override {
+    return m_current.inputs;
+  }
+
+  const FeatureVector &
+  get_label_sample(std::uint32_t raw_label_index) const override {
+    RFASSERT(raw_label_index < m_current.labels.size());
+    return m_current.labels[raw_label_index];
+  }
+
+  const std::vector<FeatureVector> &get_label_samples() const override {
+    return m_current.labels;
+  }
+
+  std::uint32_t get_input_size() const override { return m_inputSize; }
+  std::uint32_t get_feature_size() const override { return m_featureSize; }
+  std::uint32_t get_number_of_input_samples() const override {
+    return m_current.inputs.size();
+  }
+  std::uint32_t get_number_of_label_samples() const override {
+    return m_current.labels.size();
+  }
+  std::uint32_t get_number_of_sequences() const override {
+    return m_sequencesInBatch;
+  }
+  std::uint32_t get_sequence_size() const override { return m_sequenceSize; }
+  std::uint32_t get_prefill_inputs_number() const override {
+    return m_prefillInputs;
+  }
+
+private:
+  struct Minibatch {
+    std::vector<FeatureVector> inputs;
+    std::vector<FeatureVector> labels;
+  };
+
+  const std::vector<std::string> m_shardFiles;
+  const std::uint32_t m_sequencesInBatch;
+  const std::uint32_t m_prefetchedBatches;
+  const std::uint32_t m_seed;
+  std::uint32_t m_shuffleWindow;
+  std::uint32_t m_inputSize = 0u;
+  std::uint32_t m_featureSize = 0u;
+  std::uint32_t m_sequenceSize = 0u;
+  std::uint32_t m_prefillInputs = 0u;
+  std::uint32_t m_sequencesOverall = 0u;
+
+  /*!Note: The optimizers move the stream on through const references */
+  mutable Minibatch m_current;
+  mutable std::deque<Minibatch> m_readyBatches;
+  mutable std::mutex m_bufferMutex;
+  mutable std::condition_variable m_batchReady;
+  mutable std::condition_variable m_slotFree;
+  bool m_stopping = false;
+  std::exception_ptr m_loaderError;
+  mutable std::chrono::nanoseconds m_stallTime{0};
+  mutable std::uint32_t m_stalls = 0u;
+  std::thread m_loader;
+
+  /**
+   * @brief      The loop of the background thread reading the shards
+   */
+  void load();
+
+  /**
+   * @brief      Hands over a complete minibatch to be served, waiting for
+   * space in the buffer if needed
+   *
+   * @return     false if the data set is being destroyed
+   */
+  bool publish(Minibatch &&batch);
+};
+
+} /* namespace rafko_gym */
+
+#endif /* RAFKO_STREAMING_DATASET_H */
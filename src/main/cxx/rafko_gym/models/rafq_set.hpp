@@ -30,7 +30,7 @@
 #include "rafko_gym/models/rafq_environment.hpp"
 #include "rafko_gym/services/cost_function_mse.hpp"
 #include "rafko_mainframe/services/rafko_assertion_logger.hpp"
-#include "rafko_utilities/services/thread_group.hpp"
+#include "rafko_utilities/services/work_stealing_pool.hpp"
 
 namespace rafko_gym {
 
@@ -629,7 +629,7 @@ private:
   CostFunctionMSE m_costFunction;
   double m_overwriteQThreshold;
   std::uint32_t m_maxSetSize;
-  rafko_utilities::ThreadGroup m_lookupThreads;
+  rafko_utilities::WorkStealingPool &m_threadPool;
   mutable std::mutex m_searchResultMutex;
 
   /**
@@ -18,33 +18,80 @@
 
 namespace rafko_gym {
 
-void RafkoBackpropagationData::build(std::uint32_t number_of_operations,
-                                     std::uint32_t relevant_operation_count,
-                                     std::uint32_t sequence_size) {
+void RafkoBackpropagationData::build(
+    std::vector<std::vector<std::uint32_t>> operation_weights,
+    std::uint32_t relevant_operation_count,
+    std::uint32_t sequence_size, std::uint32_t adjoint_window,
+    bool single_precision) {
+  const std::uint32_t number_of_operations = operation_weights.size();
+  m_operationCount = number_of_operations;
+  m_adjointWindow = adjoint_window;
+  m_singlePrecision = single_precision;
+  m_calculatedDerivatives.reset();
+  m_calculatedDerivativesF32.reset();
+  /*!Note: In reverse mode the values of every run inside the adjoint window
+   * are needed, along with the values those runs reach into the past */
   m_calculatedValues = std::make_unique<NetworkValueBuffer>(
-      m_memorySlots, [number_of_operations](std::vector<double> &element) {
+      (m_memorySlots + ((0u < adjoint_window) ? (adjoint_window - 1u) : 0u)),
+      [number_of_operations](std::vector<double> &element) {
         element.resize(number_of_operations);
       });
-  m_calculatedDerivatives = std::make_unique<NetworkDerivativeBuffer>(
-      m_memorySlots,
-      [this, &number_of_operations](std::vector<std::vector<double>> &element) {
-        element = std::vector<std::vector<double>>(
-            number_of_operations, std::vector<double>(m_weightTableSize));
-      });
+  if (is_reverse_mode()) {
+    m_networkInputs = std::make_unique<NetworkValueBuffer>(
+        adjoint_window,
+        [this](std::vector<double> &element) { element.resize(m_inputSize); });
+    m_operationAdjoints = std::vector<double>(
+        static_cast<std::size_t>(adjoint_window) * number_of_operations);
+    m_weightAdjoints = std::vector<double>(m_weightTableSize);
+    m_operationWeights.clear();
+    m_derivativeOffsets.clear();
+  } else {
+    m_operationWeights = std::move(operation_weights);
+    m_derivativeOffsets = std::vector<std::size_t>(number_of_operations + 1u);
+    for (std::uint32_t operation_index = 0u;
+         operation_index < number_of_operations; ++operation_index) {
+      RFASSERT(std::is_sorted(m_operationWeights[operation_index].begin(),
+                              m_operationWeights[operation_index].end()));
+      m_derivativeOffsets[operation_index + 1u] =
+          m_derivativeOffsets[operation_index] +
+          m_operationWeights[operation_index].size();
+    }
+    const std::size_t slot_size = m_derivativeOffsets.back();
+    if (single_precision)
+      m_calculatedDerivativesF32 =
+          std::make_unique<NetworkDerivativeBuffer<float>>(m_memorySlots,
+                                                           slot_size);
+    else
+      m_calculatedDerivatives =
+          std::make_unique<NetworkDerivativeBuffer<double>>(m_memorySlots,
+                                                            slot_size);
+    m_networkInputs.reset();
+    m_operationAdjoints.clear();
+    m_weightAdjoints.clear();
+  }
   m_sequenceDerivatives = std::make_unique<SequenceDerivativeBuffer>(
       sequence_size, [this](std::vector<double> &element) {
         element.resize(m_weightTableSize);
       });
   m_built = true;
   m_weightRelevantOperationCount = relevant_operation_count;
+  m_derivativeRunCount = 0u;
+  m_derivativeRunRegistered = false;
 }
 
 void RafkoBackpropagationData::reset() {
   if (m_built) {
     m_calculatedValues->reset();
-    m_calculatedDerivatives->reset();
+    if (m_calculatedDerivatives)
+      m_calculatedDerivatives->reset();
+    if (m_calculatedDerivativesF32)
+      m_calculatedDerivativesF32->reset();
+    if (m_networkInputs)
+      m_networkInputs->reset();
     m_sequenceDerivatives->reset();
   }
+  m_derivativeRunCount = 0u;
+  m_derivativeRunRegistered = false;
 }
 
 void RafkoBackpropagationData::step() {
@@ -53,25 +100,49 @@ void RafkoBackpropagationData::step() {
    * anyway.. */
   m_calculatedValues->shallow_step();
   /* using clean step, because the at each step the values depend on being
-   * clean (0.0).. */
-  m_calculatedDerivatives
-      ->clean_step(); /* ..so sequence truncation would have 0.0 if sequence
-                         is excluded and not calculated */
+   * clean (0.0), so sequence truncation would have 0.0 if sequence is excluded
+   * and not calculated */
+  if (m_calculatedDerivatives)
+    m_calculatedDerivatives->clean_step();
+  if (m_calculatedDerivativesF32)
+    m_calculatedDerivativesF32->clean_step();
+  if (m_networkInputs)
+    m_networkInputs->shallow_step();
   m_sequenceDerivatives->clean_step(); /* ..and so the averages would start
                                           with 0.0 as initial value */
+
+  /* A run without derivatives breaks the chain of runs adjoints can reach */
+  if (!m_derivativeRunRegistered)
+    m_derivativeRunCount = 0u;
+  m_derivativeRunRegistered = false;
+}
+
+void RafkoBackpropagationData::apply_weight_adjoints() {
+  RFASSERT(m_built);
+  RFASSERT(is_reverse_mode());
+  if (m_updateWeightDerivative)
+    std::copy(m_weightAdjoints.begin(), m_weightAdjoints.end(),
+              m_sequenceDerivatives->get_element(0u /*past_index*/).begin());
 }
 
 void RafkoBackpropagationData::set_derivative(std::uint32_t operation_index,
                                               std::uint32_t d_w_index,
                                               double value) {
   RFASSERT(m_built);
-  RFASSERT(operation_index <
-           m_calculatedDerivatives->get_element(0u /*past_index*/).size());
-  RFASSERT(d_w_index < m_calculatedDerivatives
-                           ->get_element(0u /*past_index*/, operation_index)
-                           .size());
-  m_calculatedDerivatives->get_element(0u /*past_index*/,
-                                       operation_index)[d_w_index] = value;
+  RFASSERT(!is_reverse_mode());
+  RFASSERT(operation_index < m_operationCount);
+  RFASSERT(d_w_index < m_weightTableSize);
+  const std::optional<std::size_t> derivative_index =
+      get_derivative_index(operation_index, d_w_index);
+  /*!Note: Untracked derivatives are only set by the weight relevant
+   * operations, to keep the sequence derivatives consistent */
+  RFASSERT(derivative_index.has_value() || (0.0 == value));
+  if (derivative_index.has_value() && m_singlePrecision)
+    m_calculatedDerivativesF32->get_slot(0u /*past_index*/)[*derivative_index] =
+        static_cast<float>(value);
+  else if (derivative_index.has_value())
+    m_calculatedDerivatives->get_slot(0u /*past_index*/)[*derivative_index] =
+        value;
   if ((m_updateWeightDerivative) &&
       (operation_index < m_weightRelevantOperationCount)) {
     /*!Note: The first operations are the objective operations for the
@@ -40,7 +40,7 @@ RafkoCost::set_feature_for_label(const rafko_gym::RafkoDataSet &environment,
                                  const std::vector<double> &neuron_data) const {
   RFASSERT(environment.get_number_of_label_samples() > sample_index);
   return m_costFunction->get_feature_error(
-      environment.get_label_sample(sample_index), neuron_data,
+      environment.get_label_view(sample_index), neuron_data,
       environment.get_number_of_label_samples());
 }
 
@@ -57,13 +57,17 @@ double RafkoCost::set_features_for_labels(
   /*!Note: No need to fill the reserved buffer with initial values because every
    * element of it will be overwritten */
   m_costFunction->get_feature_errors(
-      environment.get_label_samples(), neuron_data, error_labels,
+      [&environment](std::uint32_t label_index) {
+        return environment.get_label_view(label_index);
+      },
+      neuron_data, error_labels,
       raw_start_index, 0 /* error start */, labels_to_evaluate,
       neuron_buffer_start_index, environment.get_number_of_label_samples());
 
   double error_sum = (0.0);
   std::mutex sum_mutex;
-  m_errorCalculationThreads.start_and_block(
+  m_threadPool.parallel_for(
+      0u, m_settings.get_sqrt_of_solve_threads(),
       std::bind(&RafkoCost::accumulate_error_sum, this, std::ref(error_labels),
                 std::ref(error_sum), labels_to_evaluate, std::ref(sum_mutex),
                 std::placeholders::_1));
@@ -110,7 +114,10 @@ double RafkoCost::set_features_for_sequences(
   std::fill(error_labels.begin(), error_labels.end(), (0.0));
 
   m_costFunction->get_feature_errors(
-      environment.get_label_samples(), neuron_data, tmp_data, raw_start_index,
+      [&environment](std::uint32_t label_index) {
+        return environment.get_label_view(label_index);
+      },
+      neuron_data, tmp_data, raw_start_index,
       0 /* error_start */, labels_to_evaluate, neuron_buffer_start_index,
       environment.get_number_of_label_samples());
 
@@ -126,7 +133,8 @@ double RafkoCost::set_features_for_sequences(
 
   double error_sum = (0.0);
   std::mutex sum_mutex;
-  m_errorCalculationThreads.start_and_block(
+  m_threadPool.parallel_for(
+      0u, m_settings.get_sqrt_of_solve_threads(),
       std::bind(&RafkoCost::accumulate_error_sum, this, std::ref(error_labels),
                 std::ref(error_sum), labels_to_evaluate, std::ref(sum_mutex),
                 std::placeholders::_1));
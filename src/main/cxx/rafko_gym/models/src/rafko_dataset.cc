@@ -53,14 +53,13 @@ std::vector<cl::Event> RafkoDataSet::upload_inputs_to_buffer(
   for (std::uint32_t raw_input_index = raw_input_start;
        raw_input_index < (raw_input_start + raw_input_num); ++raw_input_index) {
     RFASSERT_LOG("Input buffer byte offset: {}", input_buffer_byte_offset);
+    const SampleView input = get_input_view(raw_input_index);
     return_value = opencl_queue.enqueueWriteBuffer(
         buffer, CL_FALSE /*blocking*/, input_buffer_byte_offset /*offset*/,
-        (sizeof(double) * get_input_sample(raw_input_index).size()) /*size*/,
-        get_input_sample(raw_input_index).data(), NULL,
+        (sizeof(double) * input.size()) /*size*/, input.begin(), NULL,
         &events[raw_input_index - raw_input_start]);
     RFASSERT(return_value == CL_SUCCESS);
-    input_buffer_byte_offset +=
-        (sizeof(double) * get_input_sample(raw_input_index).size());
+    input_buffer_byte_offset += (sizeof(double) * input.size());
   }
   return events;
 }
@@ -126,7 +125,7 @@ std::vector<cl::Event> RafkoDataSet::upload_labels_to_buffer(
       return_value = opencl_queue.enqueueWriteBuffer(
           buffer, CL_FALSE /*blocking*/,
           (buffer_byte_offset + labels_byte_offset) /*offset*/,
-          label_byte_size /*size*/, get_label_sample(truncated_index).data(),
+          label_byte_size /*size*/, get_label_view(truncated_index).begin(),
           NULL,
           &events[uploaded_label_index + truncated_index - truncated_start]);
       RFASSERT(return_value == CL_SUCCESS);
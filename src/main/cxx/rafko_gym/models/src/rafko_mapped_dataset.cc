@@ -0,0 +1,300 @@
+/*! This file is part of davids91/Rafko.
+ *
+ *    Rafko is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    (at your option) any later version.
+ *
+ *    Rafko is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with Rafko.  If not, see <https://www.gnu.org/licenses/> or
+ *    <https://github.com/davids91/rafko/blob/master/LICENSE>
+ */
+#include "rafko_gym/models/rafko_mapped_dataset.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+
+#if defined(_WIN32)
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif /*defined(_WIN32)*/
+
+#include "rafko_mainframe/services/rafko_assertion_logger.hpp"
+
+namespace {
+constexpr char s_magic[8] = {'R', 'A', 'F', 'K', 'O', 'D', 'S', '\0'};
+constexpr std::uint32_t s_version = 1u;
+
+/*!Note: The header is padded to 64 bytes, so the data following it is aligned
+ * well enough to be read as doubles directly from the mapping */
+struct FileHeader {
+  char magic[8];
+  std::uint32_t version;
+  std::uint32_t input_size;
+  std::uint32_t feature_size;
+  std::uint32_t sequence_size;
+  std::uint32_t prefill_inputs;
+  std::uint32_t number_of_sequences;
+  std::uint32_t reserved[8];
+};
+static_assert(64u == sizeof(FileHeader), "Unexpected data set header size!");
+
+FileHeader make_header(std::uint32_t input_size, std::uint32_t feature_size,
+                       std::uint32_t sequence_size,
+                       std::uint32_t prefill_inputs,
+                       std::uint32_t number_of_sequences) {
+  FileHeader header{};
+  std::memcpy(header.magic, s_magic, sizeof(s_magic));
+  header.version = s_version;
+  header.input_size = input_size;
+  header.feature_size = feature_size;
+  header.sequence_size = sequence_size;
+  header.prefill_inputs = prefill_inputs;
+  header.number_of_sequences = number_of_sequences;
+  return header;
+}
+
+void write_values(std::ofstream &file, const double *values,
+                  std::size_t count) {
+  file.write(reinterpret_cast<const char *>(values),
+             static_cast<std::streamsize>(count * sizeof(double)));
+}
+} /* namespace */
+
+namespace rafko_gym {
+
+RafkoMappedDataSet::RafkoMappedDataSet(const std::string &file_name) {
+#if defined(_WIN32)
+  HANDLE file = CreateFileA(file_name.c_str(), GENERIC_READ, FILE_SHARE_READ,
+                            nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL,
+                            nullptr);
+  if (INVALID_HANDLE_VALUE == file)
+    throw std::runtime_error("Unable to open data set file: " + file_name);
+  LARGE_INTEGER file_size;
+  if (!GetFileSizeEx(file, &file_size)) {
+    CloseHandle(file);
+    throw std::runtime_error("Unable to query data set file: " + file_name);
+  }
+  m_mappingSize = static_cast<std::size_t>(file_size.QuadPart);
+  HANDLE mapping_handle = (0u < m_mappingSize)
+                              ? CreateFileMappingA(file, nullptr, PAGE_READONLY,
+                                                   0, 0, nullptr)
+                              : nullptr;
+  /*!Note: The view keeps the file mapped after the handles are closed */
+  CloseHandle(file);
+  if (nullptr != mapping_handle) {
+    m_mapping = MapViewOfFile(mapping_handle, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping_handle);
+  }
+#else
+  int file = open(file_name.c_str(), O_RDONLY);
+  if (file < 0)
+    throw std::runtime_error("Unable to open data set file: " + file_name);
+  struct stat file_stats;
+  if (0 != fstat(file, &file_stats)) {
+    close(file);
+    throw std::runtime_error("Unable to query data set file: " + file_name);
+  }
+  m_mappingSize = static_cast<std::size_t>(file_stats.st_size);
+  if (0u < m_mappingSize) {
+    m_mapping = mmap(nullptr, m_mappingSize, PROT_READ, MAP_SHARED, file, 0);
+    if (MAP_FAILED == m_mapping)
+      m_mapping = nullptr;
+  }
+  /*!Note: The mapping stays valid after the file descriptor is closed */
+  close(file);
+#endif /*defined(_WIN32)*/
+  if (nullptr == m_mapping)
+    throw std::runtime_error("Unable to map data set file: " + file_name);
+
+  FileHeader header;
+  if (m_mappingSize >= sizeof(FileHeader))
+    std::memcpy(&header, m_mapping, sizeof(FileHeader));
+  if ((m_mappingSize < sizeof(FileHeader)) ||
+      (0 != std::memcmp(header.magic, s_magic, sizeof(s_magic))) ||
+      (s_version != header.version) || (0u == header.input_size) ||
+      (0u == header.feature_size) || (0u == header.sequence_size)) {
+    unmap();
+    throw std::runtime_error("Invalid data set file header: " + file_name);
+  }
+  m_inputSize = header.input_size;
+  m_featureSize = header.feature_size;
+  m_sequenceSize = header.sequence_size;
+  m_prefillInputs = header.prefill_inputs;
+  m_numberOfSequences = header.number_of_sequences;
+
+  /*!Note: The sizes in the header are multiplied in 64 bits, so a corrupt
+   * header can't wrap them around into sizes which seem to fit the file */
+  const std::uint64_t inputs_in_sequence =
+      static_cast<std::uint64_t>(m_prefillInputs) + m_sequenceSize;
+  if ((0u < m_numberOfSequences) &&
+      ((std::numeric_limits<std::uint32_t>::max() / m_numberOfSequences) <
+       inputs_in_sequence)) {
+    unmap();
+    throw std::runtime_error("Invalid data set file header: " + file_name);
+  }
+  m_numberOfInputSamples =
+      static_cast<std::uint32_t>(m_numberOfSequences * inputs_in_sequence);
+  m_numberOfLabelSamples = m_numberOfSequences * m_sequenceSize;
+  const std::uint64_t input_values =
+      static_cast<std::uint64_t>(m_numberOfInputSamples) * m_inputSize;
+  const std::uint64_t label_values =
+      static_cast<std::uint64_t>(m_numberOfLabelSamples) * m_featureSize;
+  const std::uint64_t stored_values =
+      (static_cast<std::uint64_t>(m_mappingSize) - sizeof(FileHeader)) /
+      sizeof(double);
+  if ((stored_values < input_values) ||
+      ((stored_values - input_values) < label_values)) {
+    unmap();
+    throw std::runtime_error("Data set file is truncated: " + file_name);
+  }
+  m_inputs = reinterpret_cast<const double *>(
+      static_cast<const char *>(m_mapping) + sizeof(FileHeader));
+  m_labels = m_inputs + input_values;
+}
+
+RafkoMappedDataSet::~RafkoMappedDataSet() { unmap(); }
+
+void RafkoMappedDataSet::unmap() {
+  if (nullptr == m_mapping)
+    return;
+#if defined(_WIN32)
+  UnmapViewOfFile(m_mapping);
+#else
+  munmap(m_mapping, m_mappingSize);
+#endif /*defined(_WIN32)*/
+  m_mapping = nullptr;
+}
+
+RafkoDataSet::SampleView
+RafkoMappedDataSet::get_input_view(std::uint32_t raw_input_index) const {
+  RFASSERT_LOG("Input sample {} / {}", raw_input_index,
+               get_number_of_input_samples());
+  RFASSERT(raw_input_index < get_number_of_input_samples());
+  return {m_inputs + (static_cast<std::size_t>(raw_input_index) * m_inputSize),
+          m_inputSize};
+}
+
+RafkoDataSet::SampleView
+RafkoMappedDataSet::get_label_view(std::uint32_t raw_label_index) const {
+  RFASSERT_LOG("label_sample sample {} / {}", raw_label_index,
+               get_number_of_label_samples());
+  RFASSERT(raw_label_index < get_number_of_label_samples());
+  return {m_labels +
+              (static_cast<std::size_t>(raw_label_index) * m_featureSize),
+          m_featureSize};
+}
+
+const RafkoDataSet::FeatureVector &
+RafkoMappedDataSet::get_input_sample(std::uint32_t raw_input_index) const {
+  RFASSERT(raw_input_index < get_number_of_input_samples());
+  return get_input_samples()[raw_input_index];
+}
+
+const RafkoDataSet::FeatureVector &
+RafkoMappedDataSet::get_label_sample(std::uint32_t raw_label_index) const {
+  RFASSERT(raw_label_index < get_number_of_label_samples());
+  return get_label_samples()[raw_label_index];
+}
+
+const std::vector<RafkoDataSet::FeatureVector> &
+RafkoMappedDataSet::get_input_samples() const {
+  std::call_once(m_samplesCopied, &RafkoMappedDataSet::copy_samples, this);
+  return m_inputSamples;
+}
+
+const std::vector<RafkoDataSet::FeatureVector> &
+RafkoMappedDataSet::get_label_samples() const {
+  std::call_once(m_samplesCopied, &RafkoMappedDataSet::copy_samples, this);
+  return m_labelSamples;
+}
+
+void RafkoMappedDataSet::copy_samples() const {
+  m_inputSamples.reserve(get_number_of_input_samples());
+  for (std::uint32_t index = 0; index < get_number_of_input_samples(); ++index)
+    m_inputSamples.push_back(get_input_view(index).acquire());
+  m_labelSamples.reserve(get_number_of_label_samples());
+  for (std::uint32_t index = 0; index < get_number_of_label_samples(); ++index)
+    m_labelSamples.push_back(get_label_view(index).acquire());
+}
+
+void RafkoMappedDataSet::write(const RafkoDataSet &data_set,
+                               const std::string &file_name) {
+  std::ofstream file(file_name, std::ios::binary | std::ios::trunc);
+  const FileHeader header = make_header(
+      data_set.get_input_size(), data_set.get_feature_size(),
+      data_set.get_sequence_size(), data_set.get_prefill_inputs_number(),
+      data_set.get_number_of_sequences());
+  file.write(reinterpret_cast<const char *>(&header), sizeof(FileHeader));
+  for (std::uint32_t index = 0; index < data_set.get_number_of_input_samples();
+       ++index) {
+    SampleView sample = data_set.get_input_view(index);
+    RFASSERT(sample.size() == data_set.get_input_size());
+    write_values(file, sample.begin(), sample.size());
+  }
+  for (std::uint32_t index = 0; index < data_set.get_number_of_label_samples();
+       ++index) {
+    SampleView sample = data_set.get_label_view(index);
+    RFASSERT(sample.size() == data_set.get_feature_size());
+    write_values(file, sample.begin(), sample.size());
+  }
+  if (!file)
+    throw std::runtime_error("Unable to write data set file: " + file_name);
+}
+
+void RafkoMappedDataSet::write(const DataSetPackage &samples,
+                               const std::string &file_name) {
+  if ((0u == samples.input_size()) || (0u == samples.feature_size()) ||
+      (0 != (samples.inputs_size() % samples.input_size())) ||
+      (0 != (samples.labels_size() % samples.feature_size())))
+    throw std::runtime_error("Data set package has invalid sample sizes!");
+
+  const std::uint32_t sequence_size = std::max(1u, samples.sequence_size());
+  const std::uint32_t input_samples =
+      samples.inputs_size() / samples.input_size();
+  const std::uint32_t label_samples =
+      samples.labels_size() / samples.feature_size();
+  const std::uint32_t number_of_sequences = label_samples / sequence_size;
+  if ((0u == number_of_sequences) ||
+      (0u != (label_samples % sequence_size)) ||
+      (input_samples < label_samples) ||
+      (0u != ((input_samples - label_samples) % number_of_sequences)))
+    throw std::runtime_error("Data set package has an invalid structure!");
+
+  std::ofstream file(file_name, std::ios::binary | std::ios::trunc);
+  const FileHeader header = make_header(
+      samples.input_size(), samples.feature_size(), sequence_size,
+      ((input_samples - label_samples) / number_of_sequences),
+      number_of_sequences);
+  file.write(reinterpret_cast<const char *>(&header), sizeof(FileHeader));
+  write_values(file, samples.inputs().data(), samples.inputs_size());
+  write_values(file, samples.labels().data(), samples.labels_size());
+  if (!file)
+    throw std::runtime_error("Unable to write data set file: " + file_name);
+}
+
+void RafkoMappedDataSet::convert(const std::string &package_file_name,
+                                 const std::string &file_name) {
+  DataSetPackage samples;
+  std::ifstream package_file(package_file_name, std::ios::binary);
+  if (!package_file || !samples.ParseFromIstream(&package_file))
+    throw std::runtime_error("Unable to read data set package: " +
+                             package_file_name);
+  write(samples, file_name);
+}
+
+} /* namespace rafko_gym */
@@ -0,0 +1,183 @@
+/*! This file is part of davids91/Rafko.
+ *
+ *    Rafko is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    (at your option) any later version.
+ *
+ *    Rafko is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with Rafko.  If not, see <https://www.gnu.org/licenses/> or
+ *    <https://github.com/davids91/rafko/blob/master/LICENSE>
+ */
+#include "rafko_gym/models/rafko_streaming_dataset.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+
+#include "rafko_gym/models/rafko_mapped_dataset.hpp"
+
+namespace rafko_gym {
+
+RafkoStreamingDataSet::RafkoStreamingDataSet(
+    const rafko_mainframe::RafkoSettings &settings,
+    std::vector<std::string> shard_files, std::uint32_t prefetched_batches,
+    std::uint32_t shuffle_window, std::uint32_t seed)
+    : m_shardFiles(std::move(shard_files)),
+      m_sequencesInBatch(std::max(1u, settings.get_minibatch_size())),
+      m_prefetchedBatches(std::max(1u, prefetched_batches)), m_seed(seed) {
+  if (m_shardFiles.empty())
+    throw std::runtime_error("No shards provided to stream the data set from!");
+
+  /*!Note: Mapping a shard doesn't read its data, so every shard is checked in
+   * advance to avoid failing in the middle of the training */
+  for (const std::string &shard_file : m_shardFiles) {
+    RafkoMappedDataSet shard(shard_file);
+    if (0u == m_sequencesOverall) {
+      m_inputSize = shard.get_input_size();
+      m_featureSize = shard.get_feature_size();
+      m_sequenceSize = shard.get_sequence_size();
+      m_prefillInputs = shard.get_prefill_inputs_number();
+    } else if ((m_inputSize != shard.get_input_size()) ||
+               (m_featureSize != shard.get_feature_size()) ||
+               (m_sequenceSize != shard.get_sequence_size()) ||
+               (m_prefillInputs != shard.get_prefill_inputs_number())) {
+      throw std::runtime_error("Shard structure mismatch: " + shard_file);
+    }
+    m_sequencesOverall += shard.get_number_of_sequences();
+  }
+  if (0u == m_sequencesOverall)
+    throw std::runtime_error("The provided shards contain no sequences!");
+  m_shuffleWindow = std::clamp(shuffle_window, 1u, m_sequencesOverall);
+
+  m_loader = std::thread(&RafkoStreamingDataSet::load, this);
+  try {
+    next_minibatch();
+  } catch (...) { /* The loader thread already stopped because of the error */
+    m_loader.join();
+    throw;
+  }
+
+  /* Waiting for the first minibatch doesn't count as a stall in training */
+  std::lock_guard<std::mutex> my_lock(m_bufferMutex);
+  m_stallTime = std::chrono::nanoseconds(0);
+  m_stalls = 0u;
+}
+
+RafkoStreamingDataSet::~RafkoStreamingDataSet() {
+  {
+    std::lock_guard<std::mutex> my_lock(m_bufferMutex);
+    m_stopping = true;
+  }
+  m_slotFree.notify_all();
+  m_loader.join();
+}
+
+void RafkoStreamingDataSet::next_minibatch() const {
+  std::unique_lock<std::mutex> my_lock(m_bufferMutex);
+  if (m_readyBatches.empty() && !m_loaderError) {
+    const auto wait_start = std::chrono::steady_clock::now();
+    m_batchReady.wait(my_lock, [this]() {
+      return (!m_readyBatches.empty()) || static_cast<bool>(m_loaderError);
+    });
+    m_stallTime += std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - wait_start);
+    ++m_stalls;
+  }
+  if (m_readyBatches.empty())
+    std::rethrow_exception(m_loaderError);
+  m_current = std::move(m_readyBatches.front());
+  m_readyBatches.pop_front();
+  my_lock.unlock();
+  m_slotFree.notify_one();
+}
+
+bool RafkoStreamingDataSet::publish(Minibatch &&batch) {
+  {
+    std::unique_lock<std::mutex> my_lock(m_bufferMutex);
+    m_slotFree.wait(my_lock, [this]() {
+      return m_stopping || (m_readyBatches.size() < m_prefetchedBatches);
+    });
+    if (m_stopping)
+      return false;
+    m_readyBatches.push_back(std::move(batch));
+  }
+  m_batchReady.notify_one();
+  return true;
+}
+
+void RafkoStreamingDataSet::load() {
+  try {
+    std::mt19937 generator(m_seed);
+    std::vector<std::uint32_t> shard_order(m_shardFiles.size());
+    std::iota(shard_order.begin(), shard_order.end(), 0u);
+    std::vector<Minibatch> window;
+    window.reserve(m_shuffleWindow);
+    Minibatch batch;
+    std::uint32_t sequences_in_batch = 0u;
+    const std::uint32_t inputs_in_sequence = m_prefillInputs + m_sequenceSize;
+
+    while (true) { /* The data set is read over and over again */
+      if (1u < m_shuffleWindow)
+        std::shuffle(shard_order.begin(), shard_order.end(), generator);
+      for (std::uint32_t shard_index : shard_order) {
+        RafkoMappedDataSet shard(m_shardFiles[shard_index]);
+        for (std::uint32_t sequence_index = 0u;
+             sequence_index < shard.get_number_of_sequences();
+             ++sequence_index) {
+          Minibatch sequence;
+          for (std::uint32_t input_index = 0u;
+               input_index < inputs_in_sequence; ++input_index)
+            sequence.inputs.push_back(
+                shard
+                    .get_input_view((sequence_index * inputs_in_sequence) +
+                                    input_index)
+                    .acquire());
+          for (std::uint32_t label_index = 0u; label_index < m_sequenceSize;
+               ++label_index)
+            sequence.labels.push_back(
+                shard
+                    .get_label_view((sequence_index * m_sequenceSize) +
+                                    label_index)
+                    .acquire());
+
+          /*!Note: The sequence to be batched is chosen randomly from the
+           * window, the new one taking its place */
+          if (window.size() < m_shuffleWindow) {
+            window.push_back(std::move(sequence));
+            continue;
+          }
+          std::uniform_int_distribution<std::uint32_t> pick(0u,
+                                                            window.size() - 1u);
+          std::swap(sequence, window[pick(generator)]);
+
+          std::move(sequence.inputs.begin(), sequence.inputs.end(),
+                    std::back_inserter(batch.inputs));
+          std::move(sequence.labels.begin(), sequence.labels.end(),
+                    std::back_inserter(batch.labels));
+          if (m_sequencesInBatch == ++sequences_in_batch) {
+            if (!publish(std::move(batch)))
+              return;
+            batch = Minibatch();
+            sequences_in_batch = 0u;
+          }
+        }
+      }
+    }
+  } catch (...) {
+    {
+      std::lock_guard<std::mutex> my_lock(m_bufferMutex);
+      m_loaderError = std::current_exception();
+    }
+    m_batchReady.notify_all();
+  }
+}
+
+} /* namespace rafko_gym */
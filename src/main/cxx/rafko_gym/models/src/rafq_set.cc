@@ -28,10 +28,7 @@ RafQSet::RafQSet(const rafko_mainframe::RafkoSettings &settings,
     : m_settings(settings), m_actionCount(action_count),
       m_environment(environment), m_costFunction(m_settings),
       m_overwriteQThreshold(overwrite_q_threshold), m_maxSetSize(max_set_size),
-      m_lookupThreads(
-          m_settings.get_max_solve_threads()) /* because cost function uses
-                                                 get_max_solve_threads */
-{
+      m_threadPool(rafko_utilities::WorkStealingPool::shared()) {
   RFASSERT(0 < m_actionCount);
   m_statesBuffer.reserve(m_maxSetSize);
   m_actionsBuffer.reserve(m_maxSetSize);
@@ -42,7 +39,7 @@ RafQSet::RafQSet(const RafQSet &other, std::uint32_t action_count)
       m_environment(other.m_environment), m_costFunction(m_settings),
       m_overwriteQThreshold(other.m_overwriteQThreshold),
       m_maxSetSize(other.m_maxSetSize),
-      m_lookupThreads(m_settings.get_max_solve_threads()) {
+      m_threadPool(rafko_utilities::WorkStealingPool::shared()) {
   RFASSERT(m_actionCount <= action_count);
   m_statesBuffer.reserve(m_maxSetSize);
   m_actionsBuffer.reserve(m_maxSetSize);
@@ -136,8 +133,8 @@ RafQSet::generate_best_sequences(std::uint32_t preferred_sequence_size) const {
           const std::size_t i = index_sequence[index];
           FeatureView action_slot = RafQSetItemConstView::best_action_slot(
               get_label_sample(i), m_environment.action_size());
-          result.mutable_inputs()->Add(get_input_sample(i).begin(),
-                                       get_input_sample(i).end());
+          const SampleView input = get_input_view(i);
+          result.mutable_inputs()->Add(input.begin(), input.end());
           result.mutable_labels()->Add(action_slot.begin(), action_slot.end());
         }
         sequence_start_index += preferred_sequence_size;
@@ -154,43 +151,28 @@ RafQSet::look_up(FeatureView state, std::uint32_t *result_index_buffer) const {
   RFASSERT(state.size() == m_environment.state_size());
   MaybeFeatureVector result;
   const std::uint32_t item_count = get_number_of_sequences();
-  const std::uint32_t items_in_one_thread =
-      1u + (item_count / m_lookupThreads.get_number_of_threads());
-  m_lookupThreads.start_and_block([this, &state, &result, &result_index_buffer,
-                                   item_count, items_in_one_thread](
-                                      std::uint32_t thread_index) {
-    static std::atomic_bool someone_found_it = false;
-    const std::uint32_t items_start_index = thread_index * items_in_one_thread;
-    const std::uint32_t items_in_this_thread =
-        std::min(items_in_one_thread,
-                 (item_count - std::min(item_count, items_start_index)));
-    for (std::uint32_t item_index = items_start_index;
-         item_index < (items_start_index + items_in_this_thread);
-         ++item_index) {
-      /*!Note: this is needed here in case any insertion inside the states
-       * buffer would cause a race condition */
-      if ((!someone_found_it) /* If there are multiple matches, there might be
-                                 interference */
-          && (m_costFunction.get_feature_error(
-                  state, get_input_sample(item_index),
-                  m_environment.state_size()) <= m_settings.get_delta())) {
-        std::lock_guard<std::mutex> my_lock(m_searchResultMutex);
-        if (!someone_found_it) {
-          result.emplace(get_input_sample(item_index));
-          if (result_index_buffer)
-            *result_index_buffer = item_index;
-          someone_found_it = true;
+  std::atomic_bool someone_found_it = false;
+  m_threadPool.parallel_for(
+      0u, item_count,
+      [this, &state, &result, &result_index_buffer,
+       &someone_found_it](std::uint32_t item_index) {
+        /*!Note: this is needed here in case any insertion inside the states
+         * buffer would cause a race condition */
+        if ((!someone_found_it) /* If there are multiple matches, there might
+                                   be interference */
+            && (m_costFunction.get_feature_error(
+                    state, get_input_view(item_index),
+                    m_environment.state_size()) <= m_settings.get_delta())) {
+          std::lock_guard<std::mutex> my_lock(m_searchResultMutex);
+          if (!someone_found_it) {
+            result.emplace(get_input_sample(item_index));
+            if (result_index_buffer)
+              *result_index_buffer = item_index;
+            someone_found_it = true;
+          }
         }
-      }
-      if (someone_found_it)
-        break;
-    }
-
-    if (someone_found_it) {
-      std::lock_guard<std::mutex> my_lock(m_searchResultMutex);
-      someone_found_it = false; /* restore state for the next run */
-    }
-  });
+      },
+      1u + (item_count / (4u * m_threadPool.get_concurrency())));
   RFASSERT_LOG("Result value is {}",
                (result.has_value()) ? "set!" : "not set!");
   return result;
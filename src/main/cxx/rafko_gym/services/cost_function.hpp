@@ -20,6 +20,7 @@
 
 #include "rafko_global.hpp"
 
+#include <functional>
 #include <thread>
 #include <vector>
 #if (RAFKO_USES_OPENCL)
@@ -31,7 +32,7 @@
 
 #include "rafko_mainframe/models/rafko_settings.hpp"
 #include "rafko_utilities/models/const_vector_subrange.hpp"
-#include "rafko_utilities/services/thread_group.hpp"
+#include "rafko_utilities/services/work_stealing_pool.hpp"
 #if (RAFKO_USES_OPENCL)
 #include "rafko_mainframe/models/rafko_gpu_strategy.hpp"
 #include "rafko_mainframe/models/rafko_nbuf_shape.hpp"
@@ -49,19 +50,13 @@ class RAFKO_EXPORT CostFunction
 #endif /*(RAFKO_USES_OPENCL)*/
 {
 public:
-  using FeatureView = rafko_utilities::ConstVectorSubrange<>;
+  using FeatureView = rafko_utilities::ConstVectorSubrange<const double *>;
+  using LabelAccessor = std::function<FeatureView(std::uint32_t)>;
 
   CostFunction(Cost_functions the_function,
-               const rafko_mainframe::RafkoSettings &settings,
-               std::uint32_t inner_thread_count = 0u,
-               std::uint32_t outer_thread_count = 0u)
+               const rafko_mainframe::RafkoSettings &settings)
       : m_settings(settings), m_theFunction(the_function),
-        m_outerThreads((0 < outer_thread_count)
-                           ? outer_thread_count
-                           : settings.get_sqrt_of_solve_threads()),
-        m_innerThreads((0 < inner_thread_count)
-                           ? inner_thread_count
-                           : settings.get_sqrt_of_solve_threads()) {}
+        m_threadPool(rafko_utilities::WorkStealingPool::shared()) {}
 
   /**
    * @brief      Gets the error for a feature-label pair under the given index
@@ -106,6 +101,36 @@ public:
                           std::uint32_t neuron_start,
                           std::uint32_t sample_number) const;
 
+  /**
+   * @brief      Gets the error produced by the sequences of the given
+   * label-data pair, with the labels provided by an accessor function, so they
+   * don't need to reside in a vector
+   *
+   * @param[in]  labels              Provides the label under the given index;
+   * Every index in [@label_start, @label_start + @labels_to_evaluate) needs to
+   * be valid
+   * @param[in]  neuron_data         The neuron data to compare for the given
+   * labels array
+   * @param      errors_for_labels   The vector to load the resulting errors in,
+   * size shall equal @labels_to_evaluate
+   * @param[in]  label_start         The index of the label to start evaluating
+   * the pairs from
+   * @param[in]  error_start         The starting index inside the vector for
+   * the output errors @errors_for_labels
+   * @param[in]  labels_to_evaluate  The number of labels to evaluate
+   * @param[in]  neuron_start        The starting index of the neuron data outer
+   * buffer
+   * @param[in]  sample_number       The number of overall samples, required for
+   * post-processing
+   */
+  void get_feature_errors(const LabelAccessor &labels,
+                          const std::vector<std::vector<double>> &neuron_data,
+                          std::vector<double> &errors_for_labels,
+                          std::uint32_t label_start, std::uint32_t error_start,
+                          std::uint32_t labels_to_evaluate,
+                          std::uint32_t neuron_start,
+                          std::uint32_t sample_number) const;
+
   /**
    * @brief      Gets the type of the implemented cost function.
    *
@@ -231,49 +256,11 @@ protected:
 
 private:
   Cost_functions m_theFunction; /* cost function type */
-  rafko_utilities::ThreadGroup m_outerThreads;
-  rafko_utilities::ThreadGroup m_innerThreads;
+  rafko_utilities::WorkStealingPool &m_threadPool;
 #if (RAFKO_USES_OPENCL)
   std::uint32_t m_pairsToEvaluate = 1u;
   std::uint32_t m_featureSize = 1u;
 #endif /*(RAFKO_USES_OPENCL)*/
-
-  /**
-   * @brief      A Thread being used to sum up the error for each label-data
-   * pair and load the result into the provided error vector
-   *
-   * @param[in]  labels                                 The label arrays to
-   * compare the data to
-   * @param[in]  neuron_data                            The neuron data to
-   * compare to the labels
-   * @param      errors_for_labels                      The vector to load the
-   * resulting errors in, size shall equal @labels_to_evaluate
-   * @param[in]  label_start                            The index of the label
-   * to start evaluating the pairs from
-   * @param[in]  error_start                            The starting index in
-   * the label error vector this thread starts
-   * @param[in]  neuron_data_start_index                The index inside the
-   * neuron data corresponding to the start index defined for @labels
-   * @param[in]  labels_to_evaluate_in_one_thread       The maximum number of
-   * label-data pairs to process in one thread ( thread might process less,
-   * based on the size of @labels)
-   * @param[in]  labels_evaluating_overall              The number of label-data
-   * pairs to process in the parent function call overall ( neuron data buffer
-   * array might not necessarily indicate the maximum size, as there might be
-   * other data cached next to it )
-   * @param[in]  sample_number                          The number of overall
-   * samples, required for post-processing
-   * @param[in]  thread_index                           The index of the thread
-   * the errors are accumulated in
-   */
-  void feature_errors_thread(
-      const std::vector<std::vector<double>> &labels,
-      const std::vector<std::vector<double>> &neuron_data,
-      std::vector<double> &errors_for_labels, std::uint32_t label_start,
-      std::uint32_t error_start, std::uint32_t neuron_data_start_index,
-      std::uint32_t labels_to_evaluate_in_one_thread,
-      std::uint32_t labels_evaluating_overall, std::uint32_t sample_number,
-      std::uint32_t thread_index) const;
 };
 
 } /* namespace rafko_gym */
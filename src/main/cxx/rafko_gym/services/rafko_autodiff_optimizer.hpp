@@ -36,6 +36,7 @@
 #include "rafko_mainframe/services/rafko_context.hpp"
 #include "rafko_utilities/models/const_vector_subrange.hpp"
 #include "rafko_utilities/models/subscript_proxy.hpp"
+#include "rafko_utilities/services/work_stealing_pool.hpp"
 
 #include "rafko_gym/services/rafko_backprop_spike_fn_operation.hpp"
 #include "rafko_gym/services/rafko_backpropagation_operation.hpp"
@@ -53,25 +54,32 @@ class RAFKO_EXPORT RafkoAutodiffOptimizer
       std::vector<std::vector<double>>::const_iterator>;
 
 public:
+  /**
+   * @brief      Class Constructor
+   *
+   * @param      settings             The settings of the training
+   * @param      network              The network to train
+   * @param      training_evaluator   The context to produce the training error
+   * values with
+   * @param      test_evaluator       The context to produce the testing error
+   * values with
+   * @param      thread_pool          The pool to calculate the gradients in
+   */
   RafkoAutodiffOptimizer(
       std::shared_ptr<rafko_mainframe::RafkoSettings> settings,
       rafko_net::RafkoNet &network,
       std::shared_ptr<rafko_mainframe::RafkoContext> training_evaluator = {},
-      std::shared_ptr<rafko_mainframe::RafkoContext> test_evaluator = {})
+      std::shared_ptr<rafko_mainframe::RafkoContext> test_evaluator = {},
+      rafko_utilities::WorkStealingPool &thread_pool =
+          rafko_utilities::WorkStealingPool::shared())
       : rafko_mainframe::RafkoAutonomousEntity(settings), m_network(network),
         m_data(network), m_weightUpdater(UpdaterFactory::build_weight_updater(
                              m_network, weight_updater_default, *m_settings)),
         m_neuronIndexToSpikeOperationIndex(m_network.neuron_array_size()),
-        m_executionThreads(), m_trainingEvaluator(training_evaluator),
+        m_threadPool(thread_pool),
+        m_trainingEvaluator(training_evaluator),
         m_testEvaluator(test_evaluator),
-        m_tmpAvgD(m_network.weight_table_size()) {
-    for (std::uint32_t thread_index = 0;
-         thread_index < m_settings->get_max_processing_threads();
-         ++thread_index)
-      m_executionThreads.push_back(
-          std::make_unique<rafko_utilities::ThreadGroup>(
-              m_settings->get_max_solve_threads()));
-  }
+        m_tmpAvgD(m_network.weight_table_size()) {}
 
   /**
    * @brief     Provides information on when to stop the training according to
@@ -98,7 +106,7 @@ public:
    * @param[in]      objective    An objective function ready to be moved inside
    * the context
    */
-  void set_weight_updater(rafko_gym::Weight_updaters updater) {
+  virtual void set_weight_updater(rafko_gym::Weight_updaters updater) {
     RFASSERT_LOG("Setting weight updater in Autodiff optimizer to {}",
                  rafko_gym::Weight_updaters_Name(updater));
     m_weightUpdater.reset();
@@ -153,7 +161,7 @@ public:
 
   /**
    * @brief   calculate the values and derivatives and update the weights based
-   * on them
+   * on them, then move the data set on to its next minibatch
    *
    * @param[in]   data_set            The data set the network is evaluated on
    * @param[in]   force_gpu_upload    Force upload inpuat and label data to GPU,
@@ -162,6 +170,60 @@ public:
   virtual void iterate(const RafkoDataSet &data_set,
                        bool force_gpu_upload = false);
 
+  /**
+   * @brief   calculate the values and derivatives of the given minibatch and
+   * update the weights based on them
+   *
+   * @param[in]   data_set                      The data set the network is
+   * evaluated on
+   * @param[in]   sequence_start_index          The index of the first sequence
+   * of the minibatch inside the data set
+   * @param[in]   start_index_inside_sequence   The start of the window inside
+   * the sequences the derivatives are calculated in
+   * @param[in]   force_gpu_upload              Force upload inpuat and label
+   * data to GPU, should it be relevant in used test/training contexts
+   */
+  void iterate_on_minibatch(const RafkoDataSet &data_set,
+                            std::uint32_t sequence_start_index,
+                            std::uint32_t start_index_inside_sequence,
+                            bool force_gpu_upload = false);
+
+  /**
+   * @brief   calculate the values and derivatives of one minibatch, and
+   * average them into the gradients of the weights without updating them
+   *
+   * @param[in]   data_set                      The data set the network is
+   * evaluated on
+   * @param[in]   sequence_start_index          The index of the first sequence
+   * of the minibatch inside the data set
+   * @param[in]   start_index_inside_sequence   The start of the window inside
+   * the sequences the derivatives are calculated in
+   *
+   * @return      const reference to the gradient of every weight
+   */
+  const std::vector<double> &
+  calculate_gradients(const RafkoDataSet &data_set,
+                      std::uint32_t sequence_start_index,
+                      std::uint32_t start_index_inside_sequence);
+
+  /**
+   * @brief     Provides the weight gradients of the last calculated minibatch
+   *
+   * @return    const reference to the gradient of every weight
+   */
+  const std::vector<double> &get_gradients() const { return m_tmpAvgD; }
+
+  /**
+   * @brief     Provides the weights the network outputs depend on, in
+   * ascending order; Derivatives of any other weight are always zero, and
+   * their values are not used while training.
+   *
+   * @return    const reference to the indices of the reachable weights
+   */
+  const std::vector<std::uint32_t> &get_reachable_weights() const {
+    return m_reachableWeights;
+  }
+
   /**
    * @brief     provides a const reference to the calculated values of the
    * network output
@@ -278,7 +340,7 @@ protected:
       m_unplacedSpikes;
   std::unordered_map<std::uint32_t, std::uint32_t> m_spikeSolvesFeatureMap;
   std::vector<std::shared_ptr<RafkoBackpropagationOperation>> m_operations;
-  std::vector<std::unique_ptr<rafko_utilities::ThreadGroup>> m_executionThreads;
+  rafko_utilities::WorkStealingPool &m_threadPool;
 
   std::shared_ptr<rafko_mainframe::RafkoContext> m_trainingEvaluator;
   std::shared_ptr<rafko_mainframe::RafkoContext> m_testEvaluator;
@@ -291,6 +353,16 @@ protected:
   double m_lastTestingError = std::numeric_limits<double>::quiet_NaN();
   bool m_built = false;
   std::vector<double> m_tmpAvgD;
+  std::vector<std::vector<std::uint32_t>>
+      m_weightOperations; /* {weights, operations to calculate the derivative
+                             for it in} */
+  std::vector<std::uint32_t> m_reachableWeights;
+  /* Parallel sequences: one optimizer for each processing thread, with its own
+   * operations and buffers, built for the same network */
+  std::vector<std::unique_ptr<RafkoAutodiffOptimizer>> m_sequenceWorkers;
+  std::vector<std::vector<double>>
+      m_minibatchDerivatives; /* {minibatch sequences, d_w values}; only one
+                                 sequence without parallel sequences */
 
   /**
    * @brief     Queries the index of the output operation of the given neuron
@@ -341,23 +413,101 @@ protected:
   std::uint32_t build_without_data(const std::shared_ptr<RafkoDataSet> data_set,
                                    std::shared_ptr<RafkoObjective> objective);
 
+  /**
+   * @brief   Collects the weights each operation depends on, either directly
+   * or through its dependencies, including ones used from past runs; The
+   * derivatives for any other weight are always zero, so they are neither
+   * calculated nor stored. Also collects the operations to be calculated for
+   * each weight into @m_weightOperations, and the weights any operation
+   * depends on into @m_reachableWeights.
+   *
+   * @param[in]   weight_relevant_operation_count   The number of operations at
+   * the start of the array directly relevant to weight derivatives; these are
+   * calculated for every weight, as they are part of the sequence derivatives
+   *
+   * @return  The sorted weight indices for each operation
+   */
+  std::vector<std::vector<std::uint32_t>>
+  collect_operation_weights(std::uint32_t weight_relevant_operation_count);
+
+  /**
+   * @brief   Builds only what the weight updates and the evaluating contexts
+   * need, without the operations to calculate gradients with; for optimizers
+   * which calculate the gradients with other optimizers they own
+   *
+   * @param[in]   data_set      The data set the network is evaluated on
+   * @param       objective     The objective function evaluating the network
+   * output
+   */
+  void build_for_weight_updates(const std::shared_ptr<RafkoDataSet> data_set,
+                                std::shared_ptr<RafkoObjective> objective);
+
+  /**
+   * @brief   Builds an optimizer for every processing thread to run the
+   * sequences of a minibatch in parallel with, if the settings require it
+   *
+   * @param[in]   data_set      The data set the network is evaluated on
+   * @param       objective     The objective function evaluating the network
+   * output
+   */
+  void build_sequence_workers(const std::shared_ptr<RafkoDataSet> data_set,
+                              std::shared_ptr<RafkoObjective> objective);
+
+  /**
+   * @brief   Evaluates a sequence of the data set from a reset state, and
+   * calculates the derivatives for it inside the truncation window
+   *
+   * @param[in]   data_set                      The data set the network is
+   * evaluated on
+   * @param[in]   sequence_index                The index of the sequence
+   * @param[in]   start_index_inside_sequence   The start of the window inside
+   * the sequence the derivatives are calculated in
+   */
+  void calculate_sequence(const RafkoDataSet &data_set,
+                          std::uint32_t sequence_index,
+                          std::uint32_t start_index_inside_sequence);
+
+  /**
+   * @brief   Averages the derivatives calculated inside the truncation window
+   * of the last evaluated sequence
+   *
+   * @param[in]   start_index_inside_sequence   The start of the window inside
+   * the sequence the derivatives are calculated in
+   * @param       derivative                    The vector to store the
+   * average derivative for every weight in
+   */
+  void collect_sequence_derivative(std::uint32_t start_index_inside_sequence,
+                                   std::vector<double> &derivative);
+
   /**
    * @brief   calculate network value based on the given inputs
    *
    * @param[in]   network_input     the values the network takes as input
    */
-  void calculate_value(const std::vector<double> &network_input);
+  void calculate_value(const RafkoDataSet::SampleView &network_input);
 
   /**
    * @brief   calculate network derivative value for all weights based on the
-   * given inputs
+   * given inputs; the weights are split into at most max_solve_threads tasks
+   * of the shared pool, and calculated inline when that is 1
    *
    * @param[in]   network_input     the values the network takes as input
    * @param[in]   label_data        the values the network output is compared to
    * by the objective function
    */
-  void calculate_derivative(const std::vector<double> &network_input,
-                            const std::vector<double> &label_data);
+  void calculate_derivative(const RafkoDataSet::SampleView &network_input,
+                            const RafkoDataSet::SampleView &label_data);
+
+  /**
+   * @brief   Propagates the adjoints of the weight relevant operations back
+   * through the operations and the stored past runs, and collects the weight
+   * derivatives from them. Used instead of the per-weight derivative
+   * calculation in reverse autodiff mode.
+   *
+   * @param[in]   label_data        the values the network output is compared to
+   * by the objective function
+   */
+  void calculate_adjoints(const RafkoDataSet::SampleView &label_data);
 
   /**
    * @brief   Inserts the spike function operation to teh operations map for the
@@ -92,11 +92,17 @@ public:
     }
   }
 
-  void calculate_value(const std::vector<double> &network_input) override;
+  void
+  calculate_value(const RafkoDataSet::SampleView &network_input) override;
 
-  void calculate_derivative(std::uint32_t d_w_index,
-                            const std::vector<double> &network_input,
-                            const std::vector<double> &label_data) override;
+  void
+  calculate_derivative(std::uint32_t d_w_index,
+                       const RafkoDataSet::SampleView &network_input,
+                       const RafkoDataSet::SampleView &label_data) override;
+
+  void calculate_adjoint(std::uint32_t past_index, double adjoint,
+                         const RafkoDataSet::SampleView &network_input,
+                         const RafkoDataSet::SampleView &label_data) override;
 
 #if (RAFKO_USES_OPENCL)
   std::string local_declaration_operation() const override { return ""; }
@@ -148,6 +154,10 @@ public:
       return {};
   }
 
+  std::vector<std::uint32_t> get_own_weight_indices() const override {
+    return {m_weightIndex};
+  }
+
 private:
   const std::uint32_t m_neuronIndex;
   const std::uint32_t m_neuronWeightIndex;
@@ -63,14 +63,23 @@ public:
    *
    * @return    list of all stored dependency pointers
    */
-  std::vector<DependencyPointer> get_own_dependencies_past_included();
+  std::vector<DependencyPointer> get_own_dependencies_past_included() override;
+
+  std::vector<std::uint32_t> get_own_weight_indices() const override {
+    return {m_weightIndex};
+  }
 
   DependencyRequest request_dependencies() override;
 
-  void calculate_value(const std::vector<double> &network_input) override;
-  void calculate_derivative(std::uint32_t d_w_index,
-                            const std::vector<double> &network_input,
-                            const std::vector<double> &label_data) override;
+  void
+  calculate_value(const RafkoDataSet::SampleView &network_input) override;
+  void
+  calculate_derivative(std::uint32_t d_w_index,
+                       const RafkoDataSet::SampleView &network_input,
+                       const RafkoDataSet::SampleView &label_data) override;
+  void calculate_adjoint(std::uint32_t past_index, double adjoint,
+                         const RafkoDataSet::SampleView &network_input,
+                         const RafkoDataSet::SampleView &label_data) override;
 
 #if (RAFKO_USES_OPENCL)
 
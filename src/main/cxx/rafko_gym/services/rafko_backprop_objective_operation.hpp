@@ -68,7 +68,8 @@ public:
              }}};
   }
 
-  void calculate_value(const std::vector<double> & /*network_input*/) override {
+  void
+  calculate_value(const RafkoDataSet::SampleView & /*network_input*/) override {
     RFASSERT(are_dependencies_registered());
     RFASSERT(static_cast<bool>(m_featureDependency));
     RFASSERT(m_featureDependency->is_value_processed());
@@ -77,9 +78,10 @@ public:
     set_value_processed();
   }
 
-  void calculate_derivative(std::uint32_t d_w_index,
-                            const std::vector<double> & /*network_input*/,
-                            const std::vector<double> &label_data) override {
+  void
+  calculate_derivative(std::uint32_t d_w_index,
+                       const RafkoDataSet::SampleView & /*network_input*/,
+                       const RafkoDataSet::SampleView &label_data) override {
     RFASSERT(is_value_processed());
     RFASSERT(are_dependencies_registered());
     RFASSERT(m_outputIndex < label_data.size());
@@ -104,6 +106,21 @@ public:
     set_derivative_processed();
   }
 
+  void calculate_adjoint(std::uint32_t past_index, double adjoint,
+                         const RafkoDataSet::SampleView & /*network_input*/,
+                         const RafkoDataSet::SampleView &label_data) override {
+    RFASSERT(0u == past_index); /* Objectives are only seeded for the current run */
+    RFASSERT(m_outputIndex < label_data.size());
+    RFASSERT(static_cast<bool>(m_featureDependency));
+    /*!Note: The objective derivative is linear in the feature derivative */
+    propagate_adjoint(
+        m_featureDependency, past_index,
+        adjoint * m_objective.get_derivative(
+                      label_data[m_outputIndex],
+                      m_featureDependency->get_value(past_index),
+                      1.0 /*feature_d*/, static_cast<double>(m_sampleNumber)));
+  }
+
 #if (RAFKO_USES_OPENCL)
   std::string local_declaration_operation() const override { return ""; }
 
@@ -33,7 +33,6 @@
 #include "rafko_net/services/rafko_network_feature.hpp"
 #include "rafko_protocol/rafko_net.pb.h"
 #include "rafko_utilities/models/subscript_proxy.hpp"
-#include "rafko_utilities/services/thread_group.hpp"
 
 #include "rafko_gym/services/rafko_backpropagation_operation.hpp"
 
@@ -53,20 +52,28 @@ public:
       const rafko_net::FeatureGroup &feature_group,
       rafko_utilities::SubscriptProxy<>::AssociationVector
           neuronSpikeToOperationIndex,
-      std::vector<std::unique_ptr<rafko_utilities::ThreadGroup>>
-          &execution_threads);
+      rafko_utilities::WorkStealingPool &thread_pool =
+          rafko_utilities::WorkStealingPool::shared());
   ~RafkoBackPropSolutionFeatureOperation() = default;
 
   DependencyRequest request_dependencies() override;
 
-  void calculate_value(const std::vector<double> & /*network_input*/) override;
+  void
+  calculate_value(const RafkoDataSet::SampleView & /*network_input*/) override;
   void calculate_derivative(std::uint32_t /*d_w_index*/,
-                            const std::vector<double> & /*network_input*/,
-                            const std::vector<double> & /*label_data*/
+                            const RafkoDataSet::SampleView & /*network_input*/,
+                            const RafkoDataSet::SampleView & /*label_data*/
                             ) override {
     set_derivative_processed();
   }
 
+  /*!Note: Solution features modify the values in place, derivatives are not
+   * affected by them, so there is nothing to propagate */
+  void calculate_adjoint(std::uint32_t /*past_index*/, double /*adjoint*/,
+                         const RafkoDataSet::SampleView & /*network_input*/,
+                         const RafkoDataSet::SampleView & /*label_data*/
+                         ) override {}
+
 #if (RAFKO_USES_OPENCL)
   std::string local_declaration_operation() const override {
     return rafko_net::RafkoNetworkFeature::get_kernel_locals();
@@ -82,8 +89,6 @@ private:
   const rafko_mainframe::RafkoSettings &m_settings;
   const rafko_net::FeatureGroup &m_featureGroup;
   rafko_utilities::SubscriptProxy<> m_networkDataProxy;
-  std::vector<std::unique_ptr<rafko_utilities::ThreadGroup>>
-      &m_executionThreads;
   rafko_net::RafkoNetworkFeature m_featureExecutor;
   std::vector<std::uint32_t> m_relevantIndexValues;
   std::vector<double> m_dummyVector;
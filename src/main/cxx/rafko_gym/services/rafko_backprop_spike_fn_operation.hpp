@@ -83,11 +83,17 @@ public:
              }}};
   }
 
-  void calculate_value(const std::vector<double> &network_input) override;
+  void
+  calculate_value(const RafkoDataSet::SampleView &network_input) override;
 
-  void calculate_derivative(std::uint32_t d_w_index,
-                            const std::vector<double> &network_input,
-                            const std::vector<double> &label_data) override;
+  void
+  calculate_derivative(std::uint32_t d_w_index,
+                       const RafkoDataSet::SampleView &network_input,
+                       const RafkoDataSet::SampleView &label_data) override;
+
+  void calculate_adjoint(std::uint32_t past_index, double adjoint,
+                         const RafkoDataSet::SampleView &network_input,
+                         const RafkoDataSet::SampleView &label_data) override;
 
 #if (RAFKO_USES_OPENCL)
   std::string local_declaration_operation() const override;
@@ -139,6 +145,10 @@ public:
     return {m_presentValueDependency};
   }
 
+  std::vector<std::uint32_t> get_own_weight_indices() const override {
+    return {get_weight_index()};
+  }
+
 private:
   const std::uint32_t m_neuronIndex;
   std::shared_ptr<RafkoBackpropagationOperation> m_presentValueDependency;
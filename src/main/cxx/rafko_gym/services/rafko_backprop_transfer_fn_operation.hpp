@@ -65,7 +65,8 @@ public:
              }}};
   }
 
-  void calculate_value(const std::vector<double> & /*network_input*/) override {
+  void
+  calculate_value(const RafkoDataSet::SampleView & /*network_input*/) override {
     RFASSERT(are_dependencies_registered());
     RFASSERT(static_cast<bool>(m_neededInputDependency));
     RFASSERT(m_neededInputDependency->is_value_processed());
@@ -74,31 +75,45 @@ public:
                  Transfer_functions_Name(get_transfer_function()),
                  m_neededInputDependency->get_value(0u /*past_index*/),
                  m_neededInputDependency->get_operation_index());
-    set_value(m_transferFunction.get_value(
-        get_transfer_function(),
-        m_neededInputDependency->get_value(0u /*past_index*/)));
+    const rafko_net::Transfer_functions transfer_function =
+        get_transfer_function();
+    const double input = m_neededInputDependency->get_value(0u /*past_index*/);
+    set_value(m_transferFunction.get_value(transfer_function, input));
+    /*!Note: the derivative is linear in the input derivative, so t'(f(w)) is
+     * calculated once per run instead of once for every weight */
+    m_derivativeCoefficient = m_transferFunction.get_derivative(
+        transfer_function, input, 1.0 /*input_dw*/);
     set_value_processed();
   }
 
   void calculate_derivative(std::uint32_t d_w_index,
-                            const std::vector<double> & /*network_input*/,
-                            const std::vector<double> & /*label_data*/
+                            const RafkoDataSet::SampleView & /*network_input*/,
+                            const RafkoDataSet::SampleView & /*label_data*/
                             ) override {
     RFASSERT(is_value_processed());
     RFASSERT(are_dependencies_registered());
     RFASSERT(static_cast<bool>(m_neededInputDependency));
     RFASSERT(m_neededInputDependency->is_processed());
-    set_derivative(d_w_index,
-                   m_transferFunction
-                       .get_derivative(/* d t(f(w))/dx = f'(w) * t'(f(w))*/
-                                       get_transfer_function(),
-                                       m_neededInputDependency->get_value(
-                                           0u /*past_index*/),
-                                       m_neededInputDependency->get_derivative(
-                                           0u /*past_index*/, d_w_index)));
+    set_derivative(d_w_index, /* d t(f(w))/dx = f'(w) * t'(f(w))*/
+                   m_neededInputDependency->get_derivative(0u /*past_index*/,
+                                                           d_w_index) *
+                       m_derivativeCoefficient);
     set_derivative_processed();
   }
 
+  void calculate_adjoint(std::uint32_t past_index, double adjoint,
+                         const RafkoDataSet::SampleView & /*network_input*/,
+                         const RafkoDataSet::SampleView & /*label_data*/
+                         ) override {
+    RFASSERT(static_cast<bool>(m_neededInputDependency));
+    propagate_adjoint(m_neededInputDependency, past_index,
+                      adjoint * m_transferFunction.get_derivative(
+                                    get_transfer_function(),
+                                    m_neededInputDependency->get_value(
+                                        past_index),
+                                    1.0 /*input_dw*/));
+  }
+
 #if (RAFKO_USES_OPENCL)
   std::string local_declaration_operation() const override { return ""; }
 
@@ -161,6 +176,7 @@ private:
   const rafko_net::TransferFunction m_transferFunction;
   const std::uint32_t m_neuronIndex;
   std::shared_ptr<RafkoBackpropagationOperation> m_neededInputDependency;
+  double m_derivativeCoefficient = 0.0;
 };
 
 } /* namespace rafko_gym */
@@ -60,7 +60,8 @@ public:
     return {};
   }
 
-  void calculate_value(const std::vector<double> & /*network_input*/) override {
+  void
+  calculate_value(const RafkoDataSet::SampleView & /*network_input*/) override {
     /*!Note: Calculated value is not exactly important here, but avg_derivatives
      * need only be calculated once for weight regularization logic, so they are
      * calculated here
@@ -75,8 +76,8 @@ public:
   }
 
   void calculate_derivative(std::uint32_t d_w_index,
-                            const std::vector<double> & /*network_input*/,
-                            const std::vector<double> & /*label_data*/
+                            const RafkoDataSet::SampleView & /*network_input*/,
+                            const RafkoDataSet::SampleView & /*label_data*/
                             ) override {
     RFASSERT(is_value_processed());
     RFASSERT(are_dependencies_registered());
@@ -87,6 +88,18 @@ public:
     set_derivative_processed();
   }
 
+  void calculate_adjoint(std::uint32_t /*past_index*/, double adjoint,
+                         const RafkoDataSet::SampleView & /*network_input*/,
+                         const RafkoDataSet::SampleView & /*label_data*/
+                         ) override {
+    for (std::uint32_t weight_index = 0u;
+         weight_index < m_eachWeightDerivative.size(); ++weight_index) {
+      if (0.0 != m_eachWeightDerivative[weight_index])
+        add_weight_adjoint(weight_index,
+                           adjoint * m_eachWeightDerivative[weight_index]);
+    }
+  }
+
 #if (RAFKO_USES_OPENCL)
   std::string local_declaration_operation() const override {
     return rafko_net::RafkoNetworkFeature::get_kernel_locals();
@@ -98,6 +111,20 @@ public:
     return {};
   }
 
+  std::vector<std::uint32_t> get_own_weight_indices() const override {
+    std::vector<std::uint32_t> weight_indices;
+    rafko_net::SynapseIterator<>::iterate(
+        m_featureGroup.relevant_neurons(),
+        [this, &weight_indices](std::uint32_t neuron_index) {
+          rafko_net::SynapseIterator<>::iterate(
+              m_network.neuron_array(neuron_index).input_weights(),
+              [&weight_indices](std::uint32_t weight_index) {
+                weight_indices.push_back(weight_index);
+              });
+        });
+    return weight_indices;
+  }
+
 private:
   const rafko_mainframe::RafkoSettings &m_settings;
   const rafko_net::FeatureGroup &m_featureGroup;
@@ -78,7 +78,8 @@ public:
    * @param[in]     network_input     Const access to the provided network input
    * array
    */
-  virtual void calculate_value(const std::vector<double> &network_input) = 0;
+  virtual void
+  calculate_value(const RafkoDataSet::SampleView &network_input) = 0;
 
   /**
    * @brief     Calculates the backward propagation value ( derivative) for this
@@ -90,9 +91,30 @@ public:
    * array
    * @param[in]     label_data        Const access to the provided labels array
    */
-  virtual void calculate_derivative(std::uint32_t d_w_index,
-                                    const std::vector<double> &network_input,
-                                    const std::vector<double> &label_data) = 0;
+  virtual void
+  calculate_derivative(std::uint32_t d_w_index,
+                       const RafkoDataSet::SampleView &network_input,
+                       const RafkoDataSet::SampleView &label_data) = 0;
+
+  /**
+   * @brief     Reverse mode counterpart of @calculate_derivative: propagates
+   * the adjoint of this operation ( the derivative of the objective with
+   * respect to the operation value ) to its dependencies and to the weights it
+   * uses directly
+   *
+   * @param[in]     past_index        The index of the past run the adjoint
+   * belongs to
+   * @param[in]     adjoint           The adjoint value of this operation in
+   * the given run
+   * @param[in]     network_input     Const access to the network input array
+   * of the given run
+   * @param[in]     label_data        Const access to the labels array of the
+   * current run
+   */
+  virtual void
+  calculate_adjoint(std::uint32_t past_index, double adjoint,
+                    const RafkoDataSet::SampleView &network_input,
+                    const RafkoDataSet::SampleView &label_data) = 0;
 
 #if (RAFKO_USES_OPENCL)
   /**
@@ -215,6 +237,36 @@ public:
    */
   virtual std::vector<Dependency> get_own_dependencies() = 0;
 
+  /**
+   * @brief   Provides every dependency of the operation, including the ones
+   * only used with their values from past runs. Past dependencies don't define
+   * the order of the operations, but they affect the derivatives.
+   *
+   * @return  The Operation dependencies including past ones
+   */
+  virtual std::vector<Dependency> get_own_dependencies_past_included() {
+    return get_own_dependencies();
+  }
+
+  /**
+   * @brief   Provides the indices of the weights the operation uses directly,
+   * i.e. not through its dependencies
+   *
+   * @return  The weight indices of the operation
+   */
+  virtual std::vector<std::uint32_t> get_own_weight_indices() const {
+    return {};
+  }
+
+  /**
+   * @brief     Marks the derivative of the operation as available for weights
+   * it doesn't depend on, whose derivatives are never calculated, as they are
+   * implied to be zero
+   */
+  void constexpr set_untracked_derivatives_processed() {
+    set_derivative_processed();
+  }
+
   /**
    * @brief     Returns with the maximum of the index values of its dependencies
    *
@@ -300,6 +352,28 @@ protected:
    */
   void set_value(double value);
 
+  /**
+   * @brief   Accumulates an adjoint value into the given dependency
+   *
+   * @brief   dependency    The operation to propagate the adjoint to
+   * @brief   past_index    The past run of the dependency the value belongs to
+   * @brief   value         The value to add
+   */
+  void propagate_adjoint(const Dependency &dependency,
+                         std::uint32_t past_index, double value) {
+    m_data.add_adjoint(past_index, dependency->get_operation_index(), value);
+  }
+
+  /**
+   * @brief   Accumulates an adjoint value into the given weight
+   *
+   * @brief   d_w_index     The index of the weight
+   * @brief   value         The value to add
+   */
+  void add_weight_adjoint(std::uint32_t d_w_index, double value) {
+    m_data.add_weight_adjoint(d_w_index, value);
+  }
+
 private:
   const Autodiff_operations m_type;
   bool m_valueProcessed = false;
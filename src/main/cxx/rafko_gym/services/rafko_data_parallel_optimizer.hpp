@@ -0,0 +1,106 @@
+/*! This file is part of davids91/Rafko.
+ *
+ *    Rafko is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    (at your option) any later version.
+ *
+ *    Rafko is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with Rafko.  If not, see <https://www.gnu.org/licenses/> or
+ *    <https://github.com/davids91/rafko/blob/master/LICENSE>
+ */
+
+#ifndef RAFKO_DATA_PARALLEL_OPTIMIZER_H
+#define RAFKO_DATA_PARALLEL_OPTIMIZER_H
+
+#include "rafko_global.hpp"
+
+#include <memory>
+#include <vector>
+
+#include "rafko_gym/models/rafko_dataset.hpp"
+#include "rafko_gym/models/rafko_objective.hpp"
+#include "rafko_gym/services/rafko_autodiff_optimizer.hpp"
+#include "rafko_mainframe/models/rafko_settings.hpp"
+#include "rafko_mainframe/services/rafko_context.hpp"
+#include "rafko_protocol/rafko_net.pb.h"
+#include "rafko_utilities/services/thread_group.hpp"
+#include "rafko_utilities/services/work_stealing_pool.hpp"
+
+namespace rafko_gym {
+
+/**
+ * @brief A class to train a Network synchronously with multiple replicas of it.
+ * Every replica is a copy of the Network with its own autodiff optimizer and
+ * share of the threads, and calculates the gradients of a minibatch from its
+ * own shard of the data set. The gradients of the replicas are averaged before
+ * one weight update of the Network, which is then copied back into every
+ * replica. Every replica is driven by its own thread and calculates its
+ * gradients in its own pool; where the platform supports it, both are pinned
+ * to a disjoint set of the available CPUs so the replicas don't compete for
+ * the same cores. The phases of an iteration follow each other closely, so
+ * the replica threads spin for a short while before going to sleep between
+ * them.
+ */
+class RAFKO_EXPORT RafkoDataParallelOptimizer : public RafkoAutodiffOptimizer {
+public:
+  /**
+   * @brief      Class Constructor
+   *
+   * @param      settings             The settings of the training; the
+   * processing and solve threads are divided between the replicas
+   * @param      network              The network to train
+   * @param[in]  replica_count        The number of replicas to train with
+   * @param      training_evaluator   The context to produce the training error
+   * values with
+   * @param      test_evaluator       The context to produce the testing error
+   * values with
+   */
+  RafkoDataParallelOptimizer(
+      std::shared_ptr<rafko_mainframe::RafkoSettings> settings,
+      rafko_net::RafkoNet &network, std::uint32_t replica_count,
+      std::shared_ptr<rafko_mainframe::RafkoContext> training_evaluator = {},
+      std::shared_ptr<rafko_mainframe::RafkoContext> test_evaluator = {});
+
+  void build(const std::shared_ptr<RafkoDataSet> data_set,
+             std::shared_ptr<RafkoObjective> objective = {}) override;
+
+  void iterate(const RafkoDataSet &data_set,
+               bool force_gpu_upload = false) override;
+
+  /**
+   * @brief     Provides the number of replicas the Network is trained with
+   *
+   * @return    The number of replicas
+   */
+  std::uint32_t get_replica_count() const { return m_replicas.size(); }
+
+private:
+  std::shared_ptr<rafko_mainframe::RafkoSettings> m_replicaSettings;
+  std::vector<std::vector<std::uint32_t>> m_replicaCpus;
+  std::vector<std::unique_ptr<rafko_utilities::WorkStealingPool>>
+      m_replicaPools;
+  std::vector<std::unique_ptr<rafko_net::RafkoNet>> m_replicaNetworks;
+  std::vector<std::unique_ptr<RafkoAutodiffOptimizer>> m_replicas;
+  rafko_utilities::ThreadGroup m_replicaThreads;
+  std::uint32_t m_shardSize = 0u;
+  std::uint32_t m_replicaMinibatchSize = 0u;
+  std::vector<std::uint32_t> m_replicaSequenceStart;
+
+  /**
+   * @brief     Averages the gradients calculated by the replicas into
+   * @m_tmpAvgD; every thread averages its own range of the weights
+   *
+   * @param[in]  thread_index     The index of the reducing thread
+   */
+  void reduce_gradients(std::uint32_t thread_index);
+};
+
+} /* namespace rafko_gym */
+
+#endif /* RAFKO_DATA_PARALLEL_OPTIMIZER_H */
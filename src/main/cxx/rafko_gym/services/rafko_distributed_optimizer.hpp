@@ -0,0 +1,111 @@
+/*! This file is part of davids91/Rafko.
+ *
+ *    Rafko is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    (at your option) any later version.
+ *
+ *    Rafko is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with Rafko.  If not, see <https://www.gnu.org/licenses/> or
+ *    <https://github.com/davids91/rafko/blob/master/LICENSE>
+ */
+
+#ifndef RAFKO_DISTRIBUTED_OPTIMIZER_H
+#define RAFKO_DISTRIBUTED_OPTIMIZER_H
+
+#include "rafko_global.hpp"
+
+#include <memory>
+#include <vector>
+
+#include "rafko_gym/models/rafko_dataset.hpp"
+#include "rafko_gym/models/rafko_objective.hpp"
+#include "rafko_gym/models/rafko_ring_transport.hpp"
+#include "rafko_gym/services/rafko_autodiff_optimizer.hpp"
+#include "rafko_gym/services/rafko_ring_all_reduce.hpp"
+#include "rafko_mainframe/models/rafko_settings.hpp"
+#include "rafko_mainframe/services/rafko_context.hpp"
+#include "rafko_protocol/rafko_net.pb.h"
+
+namespace rafko_gym {
+
+/**
+ * @brief A class to train one Network with multiple workers, e.g. processes on
+ * one or more hosts, connected in a ring by a @RafkoRingTransport. Every
+ * worker calculates the gradients of a minibatch from its own shard of the
+ * data set, which are averaged among the workers with a ring all-reduce before
+ * the same weight update is applied by every worker; The sequences not
+ * divisible among the workers belong to the shards of the first workers.
+ * Whenever the ring breaks, the workers connect again and continue from the
+ * weights and the weight updater state of the worker with the most
+ * iterations, so a restarted worker can rejoin the training.
+ */
+class RAFKO_EXPORT RafkoDistributedOptimizer : public RafkoAutodiffOptimizer {
+public:
+  /**
+   * @brief      Class Constructor
+   *
+   * @param      settings             The settings of the training
+   * @param      network              The network to train
+   * @param      transport            The connections of the worker in the ring
+   * @param      training_evaluator   The context to produce the training error
+   * values with
+   * @param      test_evaluator       The context to produce the testing error
+   * values with
+   */
+  RafkoDistributedOptimizer(
+      std::shared_ptr<rafko_mainframe::RafkoSettings> settings,
+      rafko_net::RafkoNet &network,
+      std::shared_ptr<RafkoRingTransport> transport,
+      std::shared_ptr<rafko_mainframe::RafkoContext> training_evaluator = {},
+      std::shared_ptr<rafko_mainframe::RafkoContext> test_evaluator = {})
+      : RafkoAutodiffOptimizer(settings, network, training_evaluator,
+                               test_evaluator),
+        m_transport(transport), m_allReduce(*m_transport) {
+    RFASSERT(static_cast<bool>(m_transport));
+  }
+
+  /**
+   * @brief      Builds the optimizer, then connects to the other workers and
+   * takes over the weights and the weight updater state of the worker with the
+   * most iterations. The weight updater needs to be set before, as it is
+   * synchronized here too.
+   */
+  void build(const std::shared_ptr<RafkoDataSet> data_set,
+             std::shared_ptr<RafkoObjective> objective = {}) override;
+
+  void iterate(const RafkoDataSet &data_set,
+               bool force_gpu_upload = false) override;
+
+  /**
+   * @brief      Connects to the other workers again, and takes over the
+   * weights, the weight updater state and the iteration count of the worker
+   * with the most iterations.
+   * Every worker of the ring needs to call it, which happens automatically
+   * inside @iterate whenever the ring breaks.
+   */
+  void rejoin();
+
+private:
+  std::shared_ptr<RafkoRingTransport> m_transport;
+  RafkoRingAllReduce m_allReduce;
+  std::uint32_t m_shardStart = 0u;
+  std::uint32_t m_shardSize = 0u;
+
+  /**
+   * @brief      Copies the weights and the weight updater state of the worker
+   * with the most iterations into every worker, so every worker continues
+   * with the same update, and refreshes the weights of the evaluating
+   * contexts. The workers need to use the same type of weight updater.
+   */
+  void synchronize_weights();
+};
+
+} /* namespace rafko_gym */
+
+#endif /* RAFKO_DISTRIBUTED_OPTIMIZER_H */
@@ -0,0 +1,172 @@
+/*! This file is part of davids91/Rafko.
+ *
+ *    Rafko is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    (at your option) any later version.
+ *
+ *    Rafko is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with Rafko.  If not, see <https://www.gnu.org/licenses/> or
+ *    <https://github.com/davids91/rafko/blob/master/LICENSE>
+ */
+
+#ifndef RAFKO_HOGWILD_OPTIMIZER_H
+#define RAFKO_HOGWILD_OPTIMIZER_H
+
+#include "rafko_global.hpp"
+
+#include <atomic>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "rafko_gym/models/rafko_dataset.hpp"
+#include "rafko_gym/models/rafko_objective.hpp"
+#include "rafko_gym/services/rafko_autodiff_optimizer.hpp"
+#include "rafko_mainframe/models/rafko_settings.hpp"
+#include "rafko_mainframe/services/rafko_context.hpp"
+#include "rafko_protocol/rafko_net.pb.h"
+#include "rafko_protocol/training.pb.h"
+#include "rafko_utilities/services/thread_group.hpp"
+
+namespace rafko_gym {
+
+/**
+ * @brief A class to train a Network asynchronously with multiple workers
+ * sharing one weight table, without any locks or barriers between their
+ * updates ( Hogwild! ). Every worker is an autodiff optimizer with its own
+ * weight updater and copy of the Network: before every update it reads the
+ * current values of the shared weights, which might be changed by other
+ * workers while reading them, then adds the change its weight updater made to
+ * the shared weights. Only the weights the Network outputs depend on are
+ * read, and only the ones the update changed are written, so with sparse
+ * Networks the updates of the workers rarely collide.
+ */
+class RAFKO_EXPORT RafkoHogwildOptimizer : public RafkoAutodiffOptimizer {
+public:
+  /**
+   * @brief      Class Constructor
+   *
+   * @param      settings             The settings of the training; the
+   * processing and solve threads are divided between the workers
+   * @param      network              The network to train
+   * @param[in]  worker_count         The number of workers to train with
+   * @param      training_evaluator   The context to produce the training error
+   * values with
+   * @param      test_evaluator       The context to produce the testing error
+   * values with
+   */
+  RafkoHogwildOptimizer(
+      std::shared_ptr<rafko_mainframe::RafkoSettings> settings,
+      rafko_net::RafkoNet &network, std::uint32_t worker_count,
+      std::shared_ptr<rafko_mainframe::RafkoContext> training_evaluator = {},
+      std::shared_ptr<rafko_mainframe::RafkoContext> test_evaluator = {});
+
+  void build(const std::shared_ptr<RafkoDataSet> data_set,
+             std::shared_ptr<RafkoObjective> objective = {}) override;
+
+  void set_weight_updater(rafko_gym::Weight_updaters updater) override;
+
+  /**
+   * @brief      Every worker updates the weights once
+   */
+  void iterate(const RafkoDataSet &data_set,
+               bool force_gpu_upload = false) override {
+    train(data_set, 1u, force_gpu_upload);
+  }
+
+  /**
+   * @brief      Every worker updates the weights the given number of times,
+   * without waiting for the others in between; the weights of the Network are
+   * updated from the shared weights after all of the workers finished
+   *
+   * @param      data_set             The data set to train on
+   * @param[in]  updates_per_worker   The number of updates each worker makes
+   * @param[in]  force_gpu_upload     If set true, data in stored objects are
+   * uploaded to GPU regardless of previous uploads
+   */
+  void train(const RafkoDataSet &data_set, std::uint32_t updates_per_worker,
+             bool force_gpu_upload = false);
+
+  /**
+   * @brief     Provides the number of workers the Network is trained with
+   */
+  std::uint32_t get_worker_count() const { return m_workers.size(); }
+
+  /**
+   * @brief     Provides the number of weight updates of every worker so far
+   */
+  std::uint64_t get_update_count() const { return m_updateCount; }
+
+  /**
+   * @brief     Provides the average staleness of the updates so far: the
+   * number of updates other workers made to the shared weights between a worker
+   * reading them and adding its own update to them
+   */
+  double get_average_staleness() const {
+    return ((0u < m_updateCount) ? (static_cast<double>(m_totalStaleness) /
+                                    static_cast<double>(m_updateCount))
+                                 : 0.0);
+  }
+
+  /**
+   * @brief     Provides the highest staleness of any update so far
+   */
+  std::uint64_t get_max_staleness() const { return m_maxStaleness; }
+
+  /**
+   * @brief     Provides the number of weight updates per second of training,
+   * to compare convergence in wall-clock time with other optimizers
+   */
+  double get_updates_per_second() const {
+    return ((0.0 < m_trainingSeconds)
+                ? (static_cast<double>(m_updateCount) / m_trainingSeconds)
+                : 0.0);
+  }
+
+  /**
+   * @brief     Restarts the collection of the staleness and throughput metrics
+   */
+  void reset_statistics() {
+    m_updateCount = 0u;
+    m_totalStaleness = 0u;
+    m_maxStaleness = 0u;
+    m_trainingSeconds = 0.0;
+  }
+
+private:
+  std::shared_ptr<rafko_mainframe::RafkoSettings> m_workerSettings;
+  std::vector<std::unique_ptr<rafko_net::RafkoNet>> m_workerNetworks;
+  std::vector<std::unique_ptr<RafkoAutodiffOptimizer>> m_workers;
+  rafko_utilities::ThreadGroup m_workerThreads;
+  std::vector<std::atomic<double>> m_sharedWeights;
+  std::vector<std::vector<double>> m_workerSnapshots;
+  std::vector<std::pair<std::uint32_t, std::uint32_t>>
+      m_minibatchStarts; /* {sequence start index, start index inside the
+                            sequences} of every update, by worker */
+  std::atomic<std::uint64_t> m_updateCount{0u};
+  std::atomic<std::uint64_t> m_totalStaleness{0u};
+  std::atomic<std::uint64_t> m_maxStaleness{0u};
+  double m_trainingSeconds = 0.0;
+
+  /**
+   * @brief     Makes one weight update with the given worker
+   *
+   * @param      data_set         The data set to train on
+   * @param[in]  worker_index     The index of the worker to update with
+   * @param[in]  minibatch_start  The index of the first sequence of the
+   * minibatch, and the start of the window inside the sequences
+   */
+  void update_with_worker(
+      const RafkoDataSet &data_set, std::uint32_t worker_index,
+      const std::pair<std::uint32_t, std::uint32_t> &minibatch_start);
+};
+
+} /* namespace rafko_gym */
+
+#endif /* RAFKO_HOGWILD_OPTIMIZER_H */
@@ -28,6 +28,7 @@
 #include "rafko_mainframe/models/rafko_autonomous_entity.hpp"
 #include "rafko_mainframe/models/rafko_settings.hpp"
 #include "rafko_mainframe/services/rafko_context.hpp"
+#include "rafko_utilities/services/work_stealing_pool.hpp"
 
 namespace rafko_gym {
 
@@ -61,10 +62,10 @@ public:
         m_weight_exclude_chance_filter(
             m_training_contexts[0]->expose_network().weight_table_size(), 0.0),
         m_stochastic_evaluation_loops(stochastic_evaluation_loops),
-        m_execution_threads(
-            std::min(m_training_contexts.size(),
-                     static_cast<std::size_t>(
-                         m_settings->get_max_processing_threads()))),
+        m_threadPool(rafko_utilities::WorkStealingPool::shared()),
+        m_usedContexts(std::min(m_training_contexts.size(),
+                                static_cast<std::size_t>(
+                                    m_settings->get_max_processing_threads()))),
         m_tmpDataPool(
             2u, m_training_contexts[0]->expose_network().weight_table_size()) {}
   RafkoNumericOptimizer(const RafkoNumericOptimizer &other) =
@@ -284,7 +285,8 @@ private:
   std::vector<double> m_weight_exclude_chance_filter;
   NetworkWeightVectorDelta m_gradient_fragment;
   std::uint32_t m_stochastic_evaluation_loops;
-  rafko_utilities::ThreadGroup m_execution_threads;
+  rafko_utilities::WorkStealingPool &m_threadPool;
+  std::uint32_t m_usedContexts; /* One for every parallel evaluation */
 
   std::mutex m_networkMutex;
   std::uint32_t m_iteration = 1u;
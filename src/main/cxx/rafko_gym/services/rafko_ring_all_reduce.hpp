@@ -0,0 +1,136 @@
+/*! This file is part of davids91/Rafko.
+ *
+ *    Rafko is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    (at your option) any later version.
+ *
+ *    Rafko is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with Rafko.  If not, see <https://www.gnu.org/licenses/> or
+ *    <https://github.com/davids91/rafko/blob/master/LICENSE>
+ */
+
+#ifndef RAFKO_RING_ALL_REDUCE_H
+#define RAFKO_RING_ALL_REDUCE_H
+
+#include "rafko_global.hpp"
+
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "rafko_gym/models/rafko_ring_transport.hpp"
+#include "rafko_protocol/training.pb.h"
+
+namespace rafko_gym {
+
+/**
+ * @brief      Collective operations on vectors of the same size among the
+ * workers of a @RafkoRingTransport. Every worker needs to call the same
+ * operations in the same order. The vectors are split into one chunk for
+ * every worker, which are passed around the ring as @NetworkWeightVectorDelta
+ * messages, so every worker sends and receives about 2 * (size of the vector)
+ * values regardless of the number of workers. Failures of the transport are
+ * forwarded as std::runtime_error. The chunks are sent by a sender thread kept
+ * for the lifetime of the object, while the calling thread receives.
+ */
+class RAFKO_EXPORT RafkoRingAllReduce {
+public:
+  RafkoRingAllReduce(RafkoRingTransport &transport)
+      : m_transport(transport),
+        m_sender(&RafkoRingAllReduce::send_messages, this) {}
+  ~RafkoRingAllReduce();
+
+  /**
+   * @brief      Sums up the vectors of every worker element-wise; Every worker
+   * ends up with the same values.
+   *
+   * @param      values   The vector to sum up, and to store the result in
+   */
+  void sum(std::vector<double> &values);
+
+  /**
+   * @brief      Averages the vectors of every worker element-wise; Every
+   * worker ends up with the same values.
+   *
+   * @param      values   The vector to average, and to store the result in
+   */
+  void average(std::vector<double> &values);
+
+  /**
+   * @brief      Overwrites the vector of every worker with the one of the
+   * given worker
+   *
+   * @param      values         The vector to send or overwrite
+   * @param[in]  source_rank    The rank of the worker sending its vector
+   */
+  void broadcast(std::vector<double> &values, std::uint32_t source_rank);
+
+private:
+  RafkoRingTransport &m_transport;
+  NetworkWeightVectorDelta m_message;
+  std::string m_sendBuffer;
+  std::mutex m_senderMutex;
+  std::condition_variable m_senderSignal;
+  bool m_sendPending = false;
+  bool m_stopping = false;
+  std::exception_ptr m_sendError;
+  std::thread m_sender; /* started last, after the state it uses */
+
+  /**
+   * @brief      The loop of the sender thread: sends @m_sendBuffer to the next
+   * worker whenever @m_sendPending is set, then clears it
+   */
+  void send_messages();
+
+  /**
+   * @brief      Blocks until the sender thread finished sending the message
+   * handed over to it
+   *
+   * @return     The exception the transport threw while sending, if any
+   */
+  std::exception_ptr wait_for_sender();
+
+  /**
+   * @brief      Sends a chunk of the vector to the next worker while receiving
+   * one from the previous worker, so neither side waits on the other to read
+   * its message
+   *
+   * @param[in]  values         The vector to send a chunk of
+   * @param[in]  send_chunk     The index of the chunk to send
+   * @param[in]  receive_chunk  The index of the chunk to receive
+   *
+   * @return     The received message
+   */
+  const NetworkWeightVectorDelta &exchange(const std::vector<double> &values,
+                                           std::uint32_t send_chunk,
+                                           std::uint32_t receive_chunk);
+
+  /**
+   * @brief      Provides the first index of a chunk inside the vector
+   */
+  std::uint32_t chunk_start(std::uint32_t size, std::uint32_t chunk) const {
+    return static_cast<std::uint64_t>(size) * chunk /
+           m_transport.get_world_size();
+  }
+
+  /**
+   * @brief      Provides the number of elements inside a chunk of the vector
+   */
+  std::uint32_t chunk_size(std::uint32_t size, std::uint32_t chunk) const {
+    return chunk_start(size, chunk + 1u) - chunk_start(size, chunk);
+  }
+};
+
+} /* namespace rafko_gym */
+
+#endif /* RAFKO_RING_ALL_REDUCE_H */
@@ -0,0 +1,110 @@
+/*! This file is part of davids91/Rafko.
+ *
+ *    Rafko is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    (at your option) any later version.
+ *
+ *    Rafko is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with Rafko.  If not, see <https://www.gnu.org/licenses/> or
+ *    <https://github.com/davids91/rafko/blob/master/LICENSE>
+ */
+
+#ifndef RAFKO_SOCKET_TRANSPORT_H
+#define RAFKO_SOCKET_TRANSPORT_H
+
+#include "rafko_global.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "rafko_gym/models/rafko_ring_transport.hpp"
+
+namespace rafko_gym {
+
+/**
+ * @brief      A ring transport over stream sockets: every worker listens on
+ * its own address, connects to the address of the next rank and accepts the
+ * connection of the previous one. Messages are framed by their size, which is
+ * checked against a configured maximum before anything is allocated for them.
+ * Workers may be in different processes, or on different hosts in case of
+ * TCP. Only available on POSIX systems.
+ */
+class RAFKO_EXPORT RafkoSocketTransport : public RafkoRingTransport {
+public:
+  enum protocol_t {
+    UnixDomain, /* addresses are paths of socket files */
+    TCP         /* addresses are in "host:port" format */
+  };
+
+  /**
+   * @brief      Constructs the transport and starts listening on the address
+   * of the given rank; The connections are established in @connect.
+   *
+   * @param[in]  protocol           The type of sockets to use
+   * @param[in]  addresses          The address of every worker inside the ring
+   * in order of their ranks
+   * @param[in]  rank               The rank of this worker
+   * @param[in]  connect_timeout    The time @connect waits for the neighbours
+   * before failing
+   * @param[in]  max_message_size   The size of the largest message in bytes
+   * which can be sent or received
+   */
+  RafkoSocketTransport(
+      protocol_t protocol, std::vector<std::string> addresses,
+      std::uint32_t rank,
+      std::chrono::milliseconds connect_timeout = std::chrono::seconds(30),
+      std::uint32_t max_message_size = 256u * 1024u * 1024u);
+  ~RafkoSocketTransport();
+  RafkoSocketTransport(const RafkoSocketTransport &other) = delete;
+  RafkoSocketTransport &operator=(const RafkoSocketTransport &other) = delete;
+  RafkoSocketTransport(RafkoSocketTransport &&other) = delete;
+  RafkoSocketTransport &operator=(RafkoSocketTransport &&other) = delete;
+
+  std::uint32_t get_rank() const override { return m_rank; }
+  std::uint32_t get_world_size() const override { return m_addresses.size(); }
+  void connect() override;
+  void interrupt() override;
+  void send_to_next(const std::string &message) override;
+  std::string receive_from_previous() override;
+
+private:
+  const protocol_t m_protocol;
+  const std::vector<std::string> m_addresses;
+  const std::uint32_t m_rank;
+  const std::chrono::milliseconds m_connectTimeout;
+  const std::uint32_t m_maxMessageSize;
+  int m_listener = -1;
+  /*!Note: The connections are only changed by the thread using the transport,
+   * but interrupt() might shut them down from any other thread, so they are
+   * only changed and read from other threads under this mutex */
+  std::mutex m_connectionsMutex;
+  int m_next = -1;
+  int m_previous = -1;
+
+  /**
+   * @brief      Closes the connections to the neighbours
+   */
+  void disconnect();
+
+  /**
+   * @brief      Opens a socket connected to the given address
+   *
+   * @param[in]  address    The address to connect to
+   *
+   * @return     The file descriptor of the socket, or -1 on failure
+   */
+  int open_connection(const std::string &address) const;
+};
+
+} /* namespace rafko_gym */
+
+#endif /* RAFKO_SOCKET_TRANSPORT_H */
@@ -26,35 +26,58 @@
 #include <vector>
 
 #include "rafko_mainframe/models/rafko_settings.hpp"
+#include "rafko_mainframe/services/rafko_assertion_logger.hpp"
 #include "rafko_protocol/rafko_net.pb.h"
 #include "rafko_protocol/solution.pb.h"
-#include "rafko_utilities/services/thread_group.hpp"
+#include "rafko_utilities/services/work_stealing_pool.hpp"
 
 namespace rafko_gym {
 
+using PartialWeightPairs = std::vector<std::pair<std::uint32_t, std::uint32_t>>;
+
+/**
+ * @brief      A continuous range of elements inside the weight table of a
+ * @PartialSolution
+ */
+struct WeightTableRange {
+  std::uint32_t partial_index;
+  std::uint32_t start; /* index inside the weight table of the partial */
+  std::uint32_t size;
+  std::uint32_t global_start; /* index inside the weight tables of every
+                                 partial placed after one another */
+};
+using WeightTableRanges = std::vector<WeightTableRange>;
+
 /**
  * @brief      Base implementation for updating weights for netowrks based on
  * weight gradients
  */
-using PartialWeightPairs = std::vector<std::pair<std::uint32_t, std::uint32_t>>;
 class RAFKO_EXPORT RafkoWeightAdapter {
 public:
   RafkoWeightAdapter(const rafko_net::RafkoNet &rafko_net,
                      rafko_net::Solution &solution,
                      const rafko_mainframe::RafkoSettings &settings)
       : m_settings(settings),
-        m_executionThreads(m_settings.get_max_solve_threads()),
+        m_threadPool(rafko_utilities::WorkStealingPool::shared()),
         m_net(rafko_net), m_solution(solution),
         m_weightsInPartials(rafko_net.weight_table_size()),
-        m_neuronsInPartials(m_solution.partial_solutions_size()) {}
+        m_neuronsInPartials(m_solution.partial_solutions_size()) {
+    build_weight_slots();
+  }
 
   /**
    * @brief      Copies the weights in the stored @RafkoNet reference into the
    * provided solution. It supposes that the solution is one already built, and
-   * it is built from the same @RafkoNet referenced in the updater. Uses a
-   * different thread for every partial solution.
+   * it is built from the same @RafkoNet referenced in the updater. Only the
+   * weights changed since the last call are copied, unless most of them
+   * changed, in which case every partial solution is updated in a different
+   * thread. The first call always updates every weight.
+   *
+   * @return     The ranges inside the weight tables of the partial solutions
+   * which were changed by the call, in ascending order; Valid until the next
+   * call
    */
-  void update_solution_with_weights();
+  const WeightTableRanges &update_solution_with_weights();
 
   /**
    * @brief      Copies the weights in the stored @RafkoNet reference into the
@@ -67,6 +90,23 @@ public:
    */
   void update_solution_with_weight(std::uint32_t weight_index);
 
+  /**
+   * @brief      Provides every element of the partial weight tables the given
+   * network weight is copied into
+   *
+   * @param[in]  network_weight_index   The Weight index inside the @RafkoNet
+   *
+   * @return     A vector of {partial index, weight index in partial} pairs, in
+   * ascending order
+   */
+  PartialWeightPairs
+  get_weight_slots_for(std::uint32_t network_weight_index) const {
+    RFASSERT(network_weight_index < (m_weightSlotStarts.size() - 1u));
+    return {m_weightSlots.begin() + m_weightSlotStarts[network_weight_index],
+            m_weightSlots.begin() +
+                m_weightSlotStarts[network_weight_index + 1u]};
+  }
+
   /**
    * @brief      Provides a list of partials and index values pointing to their
    * weight tables for the given network weight_index Each weight might be
@@ -127,6 +167,20 @@ public:
       std::unordered_map<std::uint32_t, std::uint32_t>
           &weight_synapse_starts_in_partial);
 
+  /**
+   * @brief      Provides the source of every element inside the weight table
+   * of the given partial solution
+   *
+   * @param[in]  partial      The partial solution built from the network
+   * @param[in]  network      The network the partial solution was built from
+   *
+   * @return     The index inside the weight table of the network for every
+   * element inside the weight table of the partial solution
+   */
+  static std::vector<std::uint32_t>
+  get_weight_sources(const rafko_net::PartialSolution &partial,
+                     const rafko_net::RafkoNet &network);
+
 #if (RAFKO_USES_OPENCL)
   /**
    * @brief      Provides the start index of the weight table for the given
@@ -149,7 +203,7 @@ public:
 
 private:
   const rafko_mainframe::RafkoSettings &m_settings;
-  rafko_utilities::ThreadGroup m_executionThreads;
+  rafko_utilities::WorkStealingPool &m_threadPool;
   const rafko_net::RafkoNet &m_net;
   rafko_net::Solution &m_solution;
 
@@ -161,22 +215,39 @@ private:
       m_neuronsInPartials; /* key: Neuron index; value :Partial index */
   mutable std::mutex m_referenceMutex;
 
+  std::vector<std::vector<std::uint32_t>>
+      m_partialWeightSources; /* for each partial: the network weight index of
+                                 each element in its weight table */
+  std::vector<std::uint32_t>
+      m_partialWeightStarts; /* for each partial: the start of its weight table
+                                inside every weight table placed after one
+                                another */
+  std::vector<std::uint32_t>
+      m_weightSlotStarts; /* for each network weight: the start of its slots
+                             inside @m_weightSlots; one extra element closes
+                             the last weight */
+  PartialWeightPairs m_weightSlots; /* {partial_index, weight_index},
+                                       ordered by network weight index */
+  std::vector<double>
+      m_propagatedWeights; /* The network weights as last copied into the
+                              solution; empty until the first full copy */
+  std::vector<std::uint32_t> m_changedWeights;
+  PartialWeightPairs m_changedSlots;
+  WeightTableRanges m_changedRanges;
+
+  /**
+   * @brief      Collects the source of every element inside the weight tables
+   * of the referenced @Solution, and the element of every network weight
+   * inside them
+   */
+  void build_weight_slots();
+
   /**
-   * @brief      Copies the weights of a Neuron from the referenced @RafkoNet
-   *             into the partial solution reference provided as an argument.
-   *             The @PartialSolution must be built from the RafkoNet, as a
-   * pre-requisite.
-   *
-   * @param[in]  neuron_index                      The index of the Neuron
-   * inside the @SparsNet
-   * @param      partial                           The partial solution to
-   * update
-   * @param[in]  inner_neuron_weight_index_starts  The index in the weight table
-   * (of the @PartialSolution) where the inner neuron weights start
+   * @brief      Copies every weight of the referenced @RafkoNet into the
+   * partial solutions, using a different thread for every partial solution
+   * if efficient
    */
-  void copy_weights_of_neuron_to_partial_solution(
-      std::uint32_t neuron_index, rafko_net::PartialSolution &partial,
-      std::uint32_t inner_neuron_weight_index_starts) const;
+  void copy_all_weights();
 };
 
 } /* namespace rafko_gym */
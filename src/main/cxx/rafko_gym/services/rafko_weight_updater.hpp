@@ -28,7 +28,7 @@
 #include "rafko_mainframe/models/rafko_settings.hpp"
 #include "rafko_protocol/rafko_net.pb.h"
 #include "rafko_protocol/solution.pb.h"
-#include "rafko_utilities/services/thread_group.hpp"
+#include "rafko_utilities/services/work_stealing_pool.hpp"
 
 namespace rafko_gym {
 
@@ -47,7 +47,7 @@ public:
                                           m_network.weight_table_size() /
                                           m_settings.get_max_solve_threads())),
         m_currentVelocity(m_network.weight_table_size(), (0.0)),
-        m_executionThreads(m_settings.get_max_solve_threads()) {}
+        m_threadPool(rafko_utilities::WorkStealingPool::shared()) {}
 
   /**
    * @brief      The function to signal the weight updater that an iteration
@@ -61,10 +61,10 @@ public:
   /**
    * @brief      Do an iteration of weight updates. An actual weight update
    *             shall count as valid when @required_iterations_for_step taken
-   * place.
+   * place. The weights are updated in one pass through @update_weights, which
+   * is split between the execution threads for larger weight tables.
    *
    * @param      gradients           The gradients
-   * @param      solution            The solution
    */
   virtual void iterate(const std::vector<double> &gradients);
 
@@ -98,6 +98,23 @@ public:
     return m_currentVelocity;
   }
 
+  /**
+   * @brief      Provides every value the updater carries between iterations,
+   * e.g. the velocity and the moments of the gradients, so another updater of
+   * the same type can continue the training from the same state
+   *
+   * @return     The state of the updater
+   */
+  virtual std::vector<double> get_state() const;
+
+  /**
+   * @brief      Overwrites the state of the updater with the one provided by
+   * @get_state of an updater of the same type, built for the same network
+   *
+   * @param[in]  state    The state to continue the training from
+   */
+  virtual void set_state(const std::vector<double> &state);
+
   virtual ~RafkoWeightUpdater() = default;
 
 protected:
@@ -108,81 +125,37 @@ protected:
   std::uint32_t m_iteration = 0u;
   bool m_finished = false;
   std::vector<double> m_currentVelocity;
+  double m_learningRate = 0.0; /* of the running iteration */
 
   /**
-   * @brief      Gets the new value for one weight based on the velocity.
-   *
-   * @param[in]  weight_index        The weight index
-   *
-   * @return     The new weight.
+   * @brief      Provides the number of values the base class stores in the
+   * front of the state; The derived classes append their own after it
    */
-  virtual double get_new_weight(std::uint32_t weight_index) const {
-    return (m_network.weight_table(weight_index) +
-            get_current_velocity(weight_index));
+  std::uint32_t get_base_state_size() const {
+    return 2u + m_currentVelocity.size();
   }
 
   /**
-   * @brief      Returns with a velocity value for a weight based on the
-   * provided gradients
-   *
-   * @param[in]  weight_index  The weight index
-   * @param[in]  gradients     The gradients
+   * @brief      Updates a range of weights in one pass: calculates the state of
+   * the updater and the velocity of every weight in it, then writes the new
+   * weight. The loop invariant parameters of the update are to be collected
+   * before @iterate starts the pass, because the ranges are updated in
+   * parallel, so only the state of the weights inside the range may change.
    *
-   * @return     The new velocity.
+   * @param[in]  gradients      The gradients for every weight
+   * @param      weights        The weight table of the network
+   * @param[in]  weight_start   The first weight index in the range
+   * @param[in]  weight_end     The weight index after the range
    */
-  virtual double get_new_velocity(std::uint32_t weight_index,
-                                  const std::vector<double> &gradients) const {
-    return (-gradients[weight_index] * m_settings.get_learning_rate());
-  }
+  virtual void update_weights(const std::vector<double> &gradients,
+                              double *weights, std::uint32_t weight_start,
+                              std::uint32_t weight_end);
 
 private:
-  rafko_utilities::ThreadGroup m_executionThreads;
+  /* Smaller weight tables are updated in the calling thread */
+  static constexpr std::uint32_t s_minWeightsForThreads = 16384u;
+  rafko_utilities::WorkStealingPool &m_threadPool;
   mutable std::mutex m_referenceMutex;
-
-  /**
-   * @brief      Calculates and stroes the required velocity for a weight based
-   * on the provided gradients
-   *
-   * @param[in]  gradients  The gradients array of size equal to the weights of
-   * the configured net
-   */
-  void calculate_velocity(const std::vector<double> &gradients);
-
-  /**
-   * @brief      The function to update every weight of the referenced @RafkoNet
-   *             based on the values provided by @get_new_weight.
-   *             It starts multiple threads, dividing almost equally the number
-   * of weights to be updated in each thread.
-   */
-  void update_weights_with_velocity();
-
-  /**
-   * @brief      A thread to calculate the latest velocity based on the
-   * gradients
-   *
-   * @param      gradients      The gradients
-   * @param[in]  weight_index   The weight index
-   * @param[in]  weight_number  The weight number
-   */
-  void update_weight_with_velocity(std::uint32_t weight_index,
-                                   std::uint32_t weight_number);
-
-  /**
-   * @brief      Copies the weights of a Neuron from the referenced @RafkoNet
-   *             into the partial solution reference provided as an argument.
-   *             The @PartialSolution must be built from the RafkoNet, as a
-   * pre-requisite.
-   *
-   * @param[in]  neuron_index                      The index of the Neuron
-   * inside the @SparsNet
-   * @param      partial                           The partial solution to
-   * update
-   * @param[in]  inner_neuron_weight_index_starts  The index in the weight table
-   * (of the @PartialSolution) where the inner neuron weights start
-   */
-  void copy_weights_of_neuron_to_partial_solution(
-      std::uint32_t neuron_index, rafko_net::PartialSolution &partial,
-      std::uint32_t inner_neuron_weight_index_starts) const;
 };
 
 } /* namespace rafko_gym */
@@ -16,8 +16,9 @@
  */
 #include "rafko_gym/services/cost_function.hpp"
 
-#include <atomic>
+#include <algorithm>
 #include <math.h>
+#include <numeric>
 #include <utility>
 
 #if (RAFKO_USES_OPENCL)
@@ -25,6 +26,12 @@
 #endif /*(RAFKO_USES_OPENCL)*/
 #include "rafko_mainframe/services/rafko_assertion_logger.hpp"
 
+namespace {
+/* The number of parts the work is split into for every available thread, so
+ * idle threads have something to steal */
+constexpr std::uint32_t s_tasksPerThread = 4u;
+} /* namespace */
+
 namespace rafko_gym {
 
 void CostFunction::get_feature_errors(
@@ -36,91 +43,68 @@ void CostFunction::get_feature_errors(
   if ((label_start + labels_to_evaluate) > labels.size())
     throw std::runtime_error("Label index out of bounds with Neuron data!");
 
-  if ((neuron_data.size() < labels_to_evaluate) || (0 == neuron_data.size()))
-    throw std::runtime_error(
-        "Can't evaluate more labels, than there is data provided!");
-
-  const std::uint32_t labels_to_do_in_a_thread =
-      1u + static_cast<std::uint32_t>(labels_to_evaluate /
-                                      m_settings.get_sqrt_of_solve_threads());
-  m_outerThreads.start_and_block(
-      std::bind(&CostFunction::feature_errors_thread, this, std::ref(labels),
-                std::ref(neuron_data), std::ref(errors_for_labels), label_start,
-                error_start, neuron_start, labels_to_do_in_a_thread,
-                labels_to_evaluate, sample_number, std::placeholders::_1));
+  get_feature_errors(
+      [&labels](std::uint32_t label_index) -> FeatureView {
+        return labels[label_index];
+      },
+      neuron_data, errors_for_labels, label_start, error_start,
+      labels_to_evaluate, neuron_start, sample_number);
 }
 
-void CostFunction::feature_errors_thread(
-    const std::vector<std::vector<double>> &labels,
+void CostFunction::get_feature_errors(
+    const LabelAccessor &labels,
     const std::vector<std::vector<double>> &neuron_data,
     std::vector<double> &errors_for_labels, std::uint32_t label_start,
-    std::uint32_t error_start, std::uint32_t neuron_data_start_index,
-    std::uint32_t labels_to_evaluate_in_one_thread,
-    std::uint32_t labels_evaluating_overall, std::uint32_t sample_number,
-    std::uint32_t thread_index) const {
-  std::uint32_t neuron_data_start_index_in_thread =
-      neuron_data_start_index +
-      (thread_index * labels_to_evaluate_in_one_thread);
-  std::uint32_t label_start_in_thread =
-      label_start + (thread_index * labels_to_evaluate_in_one_thread);
-  std::uint32_t error_start_in_thread =
-      error_start + (thread_index * labels_to_evaluate_in_one_thread);
-  std::int32_t labels_to_evaluate_in_this_thread =
-      std::min(/* Because of the alignment, one thread might include more, .. */
-               labels_to_evaluate_in_one_thread, /* ..than the actual size of
-                                                    the labels/neurons, so
-                                                    labels to evaluate in this
-                                                    thread might.. */
-               std::min(/* ..go under 0. No labels are evaluated in this case.
-                         */
-                        static_cast<std::uint32_t>(
-                            neuron_data.size() -
-                            neuron_data_start_index_in_thread),
-                        std::min(static_cast<std::uint32_t>(
-                                     (label_start + labels_evaluating_overall) -
-                                     label_start_in_thread),
-                                 static_cast<std::uint32_t>(
-                                     labels.size() - label_start_in_thread))));
-  for (std::int32_t label_iterator = 0;
-       label_iterator < labels_to_evaluate_in_this_thread; ++label_iterator) {
-    errors_for_labels[error_start_in_thread + label_iterator] =
-        get_feature_error(
-            labels[label_start_in_thread + label_iterator],
-            neuron_data[neuron_data_start_index_in_thread + label_iterator],
-            sample_number);
-  }
+    std::uint32_t error_start, std::uint32_t labels_to_evaluate,
+    std::uint32_t neuron_start, std::uint32_t sample_number) const {
+  if ((neuron_data.size() < labels_to_evaluate) || (0 == neuron_data.size()))
+    throw std::runtime_error(
+        "Can't evaluate more labels, than there is data provided!");
+
+  /*!Note: Neuron data might not necessarily indicate the maximum size, as
+   * there might be other data cached next to it */
+  const std::uint32_t labels_to_do = std::min(
+      labels_to_evaluate,
+      static_cast<std::uint32_t>(
+          neuron_data.size() -
+          std::min(static_cast<std::size_t>(neuron_start), neuron_data.size())));
+  m_threadPool.parallel_for(
+      0u, labels_to_do,
+      [this, &labels, &neuron_data, &errors_for_labels, label_start,
+       error_start, neuron_start, sample_number](std::uint32_t label_index) {
+        errors_for_labels[error_start + label_index] = get_feature_error(
+            labels(label_start + label_index),
+            neuron_data[neuron_start + label_index], sample_number);
+      },
+      1u + (labels_to_do / (s_tasksPerThread * m_threadPool.get_concurrency())));
 }
 
 double CostFunction::get_feature_error(FeatureView label,
                                        FeatureView neuron_data,
                                        std::uint32_t sample_number) const {
   RFASSERT(label.size() == neuron_data.size());
-  const std::uint32_t count_in_one_thread =
-      1u + static_cast<std::uint32_t>(label.size() /
-                                      m_innerThreads.get_number_of_threads());
-  if (count_in_one_thread > m_innerThreads.get_number_of_threads()) {
-    std::atomic<double> error_value = 0.0;
-    m_innerThreads.start_and_block([this, &label, &neuron_data, &error_value,
-                                    count_in_one_thread](
-                                       std::uint32_t thread_index) {
-      const std::uint32_t start_index = count_in_one_thread * thread_index;
-      const std::uint32_t count_in_this_thread = std::min(
-          static_cast<std::size_t>(count_in_one_thread),
-          (label.size() -
-           std::min(label.size(), static_cast<std::size_t>(start_index))));
-
-      for (std::uint32_t feature_index = start_index;
-           feature_index < (start_index + count_in_this_thread);
-           ++feature_index) {
-        double current_error = error_value;
-        const double cell_error =
-            get_cell_error(label[feature_index], neuron_data[feature_index]);
-        while (!error_value.compare_exchange_weak(current_error,
-                                                  (current_error + cell_error)))
-          current_error = error_value;
-      }
-    });
-    return error_post_process(error_value, sample_number);
+  const std::uint32_t number_of_chunks = m_threadPool.get_concurrency();
+  const std::uint32_t count_in_one_chunk =
+      1u + static_cast<std::uint32_t>(label.size() / number_of_chunks);
+  if (count_in_one_chunk > number_of_chunks) {
+    /*!Note: Partial sums are collected separately and summed in order, so the
+     * result doesn't depend on which thread finishes first */
+    std::vector<double> partial_errors(number_of_chunks, 0.0);
+    m_threadPool.parallel_for(
+        0u, number_of_chunks,
+        [this, &label, &neuron_data, &partial_errors,
+         count_in_one_chunk](std::uint32_t chunk_index) {
+          const std::size_t start_index = count_in_one_chunk * chunk_index;
+          const std::size_t end_index = std::min(
+              label.size(), (start_index + count_in_one_chunk));
+          for (std::size_t feature_index = start_index;
+               feature_index < end_index; ++feature_index)
+            partial_errors[chunk_index] += get_cell_error(
+                label[feature_index], neuron_data[feature_index]);
+        });
+    return error_post_process(std::accumulate(partial_errors.begin(),
+                                              partial_errors.end(), 0.0),
+                              sample_number);
   } else { /* label size does not justify multiple threads */
     double error_value = 0.0;
     for (std::uint32_t feature_index = 0; feature_index < label.size();
@@ -16,7 +16,10 @@
  */
 #include "rafko_gym/services/rafko_autodiff_optimizer.hpp"
 
+#include <algorithm>
 #include <deque>
+#include <functional>
+#include <iterator>
 #include <limits>
 
 #include "rafko_gym/services/rafko_backprop_neuron_bias_operation.hpp"
@@ -25,6 +28,7 @@
 #include "rafko_gym/services/rafko_backprop_solution_feature_operation.hpp"
 #include "rafko_gym/services/rafko_backprop_transfer_fn_operation.hpp"
 #include "rafko_gym/services/rafko_backprop_weight_reg_operation.hpp"
+#include "rafko_mainframe/services/rafko_profiler.hpp"
 #include "rafko_net/models/neuron_info.hpp"
 #include "rafko_net/services/neuron_router.hpp"
 
@@ -41,11 +45,71 @@ void RafkoAutodiffOptimizer::build(const std::shared_ptr<RafkoDataSet> data_set,
   if (m_trainingEvaluator)
     m_trainingEvaluator->set_data_set(data_set);
   std::uint32_t w_relevant_op_count = build_without_data(data_set, objective);
-  m_data.build(m_operations.size(), w_relevant_op_count,
-               data_set->get_sequence_size());
+  std::uint32_t adjoint_window = 0u;
+  if (autodiff_mode_reverse == m_settings->get_autodiff_mode()) {
+    adjoint_window = m_settings->get_backpropagation_truncation();
+    if ((0u == adjoint_window) ||
+        (data_set->get_sequence_size() < adjoint_window))
+      adjoint_window = data_set->get_sequence_size();
+  }
+  m_data.build(collect_operation_weights(w_relevant_op_count),
+               w_relevant_op_count, data_set->get_sequence_size(),
+               adjoint_window, m_settings->get_single_precision_derivatives());
+  build_sequence_workers(data_set, objective);
   m_built = true;
 }
 
+void RafkoAutodiffOptimizer::build_for_weight_updates(
+    const std::shared_ptr<RafkoDataSet> data_set,
+    std::shared_ptr<RafkoObjective> objective) {
+  RFASSERT(static_cast<bool>(data_set));
+  RFASSERT(static_cast<bool>(objective));
+  m_usedSequenceTruncation = std::min(m_settings->get_memory_truncation(),
+                                      data_set->get_sequence_size());
+  m_usedMinibatchSize = std::min(m_settings->get_minibatch_size(),
+                                 data_set->get_number_of_sequences());
+  if (m_trainingEvaluator) {
+    m_trainingEvaluator->set_data_set(data_set);
+    m_trainingEvaluator->set_objective(objective);
+  }
+  if (m_testEvaluator)
+    m_testEvaluator->set_objective(objective);
+  m_built = true;
+}
+
+void RafkoAutodiffOptimizer::build_sequence_workers(
+    const std::shared_ptr<RafkoDataSet> data_set,
+    std::shared_ptr<RafkoObjective> objective) {
+  m_sequenceWorkers.clear();
+  /*!Note: Serially processed sequences are added to the gradients one by one,
+   * so only one of them is stored at a time */
+  m_minibatchDerivatives = std::vector<std::vector<double>>(
+      1u, std::vector<double>(m_network.weight_table_size()));
+  if (!m_settings->get_parallel_sequences())
+    return;
+
+  /*!Note: The workers calculate the derivatives of every weight in their own
+   * thread, so they don't need solve threads of their own */
+  std::shared_ptr<rafko_mainframe::RafkoSettings> worker_settings =
+      std::make_shared<rafko_mainframe::RafkoSettings>(
+          rafko_mainframe::RafkoSettings(*m_settings)
+              .set_max_solve_threads(1u)
+              .set_max_processing_threads(1u)
+              .set_parallel_sequences(false));
+  const std::uint32_t worker_count = std::max(
+      1u, std::min(static_cast<std::uint32_t>(
+                       m_settings->get_max_processing_threads()),
+                   m_usedMinibatchSize));
+  for (std::uint32_t worker_index = 0u; worker_index < worker_count;
+       ++worker_index) {
+    m_sequenceWorkers.push_back(std::make_unique<RafkoAutodiffOptimizer>(
+        worker_settings, m_network, nullptr, nullptr, m_threadPool));
+    m_sequenceWorkers.back()->build(data_set, objective);
+  }
+  m_minibatchDerivatives = std::vector<std::vector<double>>(
+      m_usedMinibatchSize, std::vector<double>(m_network.weight_table_size()));
+}
+
 std::uint32_t RafkoAutodiffOptimizer::build_without_data(
     const std::shared_ptr<RafkoDataSet> data_set,
     std::shared_ptr<RafkoObjective> objective) {
@@ -153,7 +217,7 @@ std::uint32_t RafkoAutodiffOptimizer::build_without_data(
             std::make_shared<RafkoBackPropSolutionFeatureOperation>(
                 m_data, m_network, m_operations.size(), *m_settings,
                 m_network.neuron_group_features(found_feature->second),
-                m_neuronIndexToSpikeOperationIndex, m_executionThreads);
+                m_neuronIndexToSpikeOperationIndex, m_threadPool);
         m_operations.push_back(feature_operation);
         RFASSERT_LOG(
             "operation[{}]:  {} for feature_group[{}], triggered by Neuron[{}]",
@@ -211,8 +275,80 @@ std::uint32_t RafkoAutodiffOptimizer::build_without_data(
   return weight_relevant_operation_count;
 }
 
+std::vector<std::vector<std::uint32_t>>
+RafkoAutodiffOptimizer::collect_operation_weights(
+    std::uint32_t weight_relevant_operation_count) {
+  std::vector<std::vector<std::uint32_t>> operation_weights(
+      m_operations.size());
+  for (std::uint32_t operation_index = 0u;
+       operation_index < m_operations.size(); ++operation_index) {
+    RFASSERT(operation_index ==
+             m_operations[operation_index]->get_operation_index());
+    operation_weights[operation_index] =
+        m_operations[operation_index]->get_own_weight_indices();
+    std::sort(operation_weights[operation_index].begin(),
+              operation_weights[operation_index].end());
+  }
+
+  /*!Note: Past dependencies may point to any operation, so the weight sets
+   * are merged until none of them changes. Dependencies are mostly after
+   * their dependents in the array, so merging from the end converges fast. */
+  bool changed = true;
+  std::vector<std::uint32_t> merged;
+  while (changed) {
+    changed = false;
+    for (std::int32_t operation_index = m_operations.size() - 1;
+         operation_index >= 0; --operation_index) {
+      std::vector<std::uint32_t> &weights = operation_weights[operation_index];
+      for (const RafkoBackpropagationOperation::Dependency &dependency :
+           m_operations[operation_index]
+               ->get_own_dependencies_past_included()) {
+        const std::vector<std::uint32_t> &dependency_weights =
+            operation_weights[dependency->get_operation_index()];
+        merged.clear();
+        std::set_union(weights.begin(), weights.end(),
+                       dependency_weights.begin(), dependency_weights.end(),
+                       std::back_inserter(merged));
+        if (merged.size() != weights.size()) {
+          weights.swap(merged);
+          changed = true;
+        }
+      }
+    }
+  }
+
+  m_weightOperations = std::vector<std::vector<std::uint32_t>>(
+      m_network.weight_table_size());
+  std::vector<bool> weight_reachable(m_network.weight_table_size(), false);
+  for (std::int32_t operation_index = m_operations.size() - 1;
+       operation_index >= 0; --operation_index) {
+    for (std::uint32_t weight_index : operation_weights[operation_index])
+      weight_reachable[weight_index] = true;
+    if (static_cast<std::int32_t>(operation_weights[operation_index].size()) <
+        m_network.weight_table_size())
+      m_operations[operation_index]->set_untracked_derivatives_processed();
+    if (static_cast<std::uint32_t>(operation_index) <
+        weight_relevant_operation_count) {
+      for (std::vector<std::uint32_t> &weight_operations : m_weightOperations)
+        weight_operations.push_back(operation_index);
+    } else {
+      for (std::uint32_t weight_index : operation_weights[operation_index])
+        m_weightOperations[weight_index].push_back(operation_index);
+    }
+  }
+  m_reachableWeights.clear();
+  for (std::uint32_t weight_index = 0u;
+       weight_index < weight_reachable.size(); ++weight_index)
+    if (weight_reachable[weight_index])
+      m_reachableWeights.push_back(weight_index);
+  return operation_weights;
+}
+
 void RafkoAutodiffOptimizer::calculate_value(
-    const std::vector<double> &network_input) {
+    const RafkoDataSet::SampleView &network_input) {
+  RFPROFILE_SCOPE("RafkoAutodiffOptimizer::calculate_value");
+  if (m_data.is_reverse_mode())
+    m_data.set_network_input(network_input);
   for (std::int32_t operation_index = m_operations.size() - 1;
        operation_index >= 0; --operation_index) {
     m_operations[operation_index]->calculate_value(network_input);
@@ -220,28 +356,83 @@ void RafkoAutodiffOptimizer::calculate_value(
 }
 
 void RafkoAutodiffOptimizer::calculate_derivative(
-    const std::vector<double> &network_input,
-    const std::vector<double> &label_data) {
-  m_executionThreads[0]->start_and_block([this, &network_input, &label_data](
-                                             std::uint32_t thread_index) {
-    const std::int32_t weights_in_one_thread =
-        1 + (m_network.weight_table_size() /
-             m_executionThreads[0]->get_number_of_threads());
-    const std::int32_t weight_start_in_thread =
-        (weights_in_one_thread * thread_index);
-    const std::int32_t weights_to_do_in_this_thread =
-        std::min(weights_in_one_thread,
-                 (m_network.weight_table_size() - weight_start_in_thread));
-    for (std::int32_t weight_index = weight_start_in_thread;
-         weight_index < (weight_start_in_thread + weights_to_do_in_this_thread);
+    const RafkoDataSet::SampleView &network_input,
+    const RafkoDataSet::SampleView &label_data) {
+  RFPROFILE_SCOPE("RafkoAutodiffOptimizer::calculate_derivative");
+  if (m_data.is_reverse_mode()) {
+    calculate_adjoints(label_data);
+    return;
+  }
+  const std::uint32_t weight_count = m_network.weight_table_size();
+  const auto calculate_weights = [this, &network_input, &label_data](
+                                     std::uint32_t weight_start,
+                                     std::uint32_t weight_end) {
+    for (std::uint32_t weight_index = weight_start; weight_index < weight_end;
          ++weight_index) {
-      for (std::int32_t operation_index = m_operations.size() - 1;
-           operation_index >= 0; --operation_index)
+      for (std::uint32_t operation_index : m_weightOperations[weight_index])
         m_operations[operation_index]->calculate_derivative(
-            static_cast<std::uint32_t>(weight_index), network_input,
-            label_data);
+            weight_index, network_input, label_data);
+    }
+  };
+  const std::uint32_t max_tasks =
+      std::min(static_cast<std::uint32_t>(m_settings->get_max_solve_threads()),
+               m_threadPool.get_concurrency());
+  if (max_tasks <= 1u) { /* e.g. the sequence workers */
+    calculate_weights(0u, weight_count);
+    return;
+  }
+  const std::uint32_t weights_in_one_task = 1u + (weight_count / max_tasks);
+  const std::uint32_t number_of_tasks =
+      (weight_count + weights_in_one_task - 1u) / weights_in_one_task;
+  m_threadPool.parallel_for(
+      0u, number_of_tasks,
+      [weight_count, weights_in_one_task,
+       &calculate_weights](std::uint32_t task_index) {
+        const std::uint32_t weight_start_in_task =
+            (weights_in_one_task * task_index);
+        calculate_weights(
+            weight_start_in_task,
+            std::min((weight_start_in_task + weights_in_one_task),
+                     weight_count));
+      });
+}
+
+void RafkoAutodiffOptimizer::calculate_adjoints(
+    const RafkoDataSet::SampleView &label_data) {
+  m_data.register_derivative_run();
+  if (!m_data.is_weight_derivative_updated())
+    return;
+
+  /*!Note: The sequence derivative is the running average of the weight relevant
+   * operation derivatives, processed from the last one towards the first, so
+   * the operation at index k contributes with a weight of 2^-(k+1)
+   */
+  m_data.reset_adjoints();
+  double seed = 0.5;
+  for (std::uint32_t operation_index = 0u;
+       operation_index < m_data.get_weight_relevant_operation_count();
+       ++operation_index) {
+    m_data.add_adjoint(0u /*past_index*/, operation_index, seed);
+    seed /= 2.0;
+  }
+
+  /*!Note: dependencies always have a greater index than their dependents, and
+   * past values only depend on values further in the past, so iterating the
+   * runs and the operations forward visits every adjoint after it is complete
+   */
+  for (std::uint32_t past_index = 0u;
+       past_index < m_data.get_adjoint_run_count(); ++past_index) {
+    const RafkoDataSet::SampleView network_input =
+        m_data.get_network_input(past_index);
+    for (std::uint32_t operation_index = 0u;
+         operation_index < m_operations.size(); ++operation_index) {
+      const double adjoint = m_data.get_adjoint(past_index, operation_index);
+      if (0.0 != adjoint)
+        m_operations[operation_index]->calculate_adjoint(
+            past_index, adjoint, network_input, label_data);
     }
-  });
+  }
+  m_data.apply_weight_adjoints();
 }
 
 void RafkoAutodiffOptimizer::calculate(BackpropDataBufferRange network_input,
@@ -277,7 +468,6 @@ void RafkoAutodiffOptimizer::update_context_errors(bool force_gpu_upload) {
 
 void RafkoAutodiffOptimizer::iterate(const RafkoDataSet &data_set,
                                      bool force_gpu_upload) {
-  RFASSERT_SCOPE(AUTODIFF_ITERATE);
   std::uint32_t sequence_start_index =
       (rand() % (data_set.get_number_of_sequences() - m_usedMinibatchSize + 1));
   std::uint32_t start_index_inside_sequence =
@@ -286,47 +476,116 @@ void RafkoAutodiffOptimizer::iterate(const RafkoDataSet &data_set,
                  1u  /* ..not all result output values are evaluated.. */
                  )); /* ..only settings.get_memory_truncation(), starting at a
                         random index inside bounds */
+  iterate_on_minibatch(data_set, sequence_start_index,
+                       start_index_inside_sequence, force_gpu_upload);
+  data_set.next_minibatch();
+}
 
-  for (std::uint32_t sequence_index = sequence_start_index;
-       sequence_index < m_usedMinibatchSize; ++sequence_index) {
-    std::uint32_t raw_inputs_index =
-        sequence_index *
-        (data_set.get_sequence_size() + data_set.get_prefill_inputs_number());
-    std::uint32_t raw_labels_index =
-        sequence_index * data_set.get_sequence_size();
-
-    /* Evaluate the current sequence step by step */
-    reset();
-    for (std::uint32_t prefill_iterator = 0;
-         prefill_iterator < data_set.get_prefill_inputs_number();
-         ++prefill_iterator) {
-      m_data.step();
-      calculate_value(data_set.get_input_sample(raw_inputs_index));
-      ++raw_inputs_index;
-    } /* The first few inputs are there to set an initial state to the network
-       */
+void RafkoAutodiffOptimizer::iterate_on_minibatch(
+    const RafkoDataSet &data_set, std::uint32_t sequence_start_index,
+    std::uint32_t start_index_inside_sequence, bool force_gpu_upload) {
+  RFASSERT_SCOPE(AUTODIFF_ITERATE);
+  calculate_gradients(data_set, sequence_start_index,
+                      start_index_inside_sequence);
+  if (static_cast<std::int32_t>(m_tmpAvgD.size()) >
+      std::count(m_tmpAvgD.begin(), m_tmpAvgD.end(), 0.0))
+    apply_weight_update(m_tmpAvgD);
 
-    /* Solve the data and store the result after the inital "prefill" */
-    for (std::uint32_t sequence_index = 0;
-         sequence_index < data_set.get_sequence_size(); ++sequence_index) {
-      m_data.step();
-      m_data
-          .set_weight_derivative_update(/* Add to the relevant derivatives only
+  ++m_iteration;
+  update_context_errors(force_gpu_upload);
+}
+
+const std::vector<double> &RafkoAutodiffOptimizer::calculate_gradients(
+    const RafkoDataSet &data_set, std::uint32_t sequence_start_index,
+    std::uint32_t start_index_inside_sequence) {
+  /*!Note: The derivatives of the sequences are summed in order on both paths,
+   * so the result doesn't depend on the number of workers */
+  std::fill(m_tmpAvgD.begin(), m_tmpAvgD.end(), 0.0);
+  auto add_to_gradients = [this](const std::vector<double> &derivative) {
+    std::transform(derivative.begin(), derivative.end(), m_tmpAvgD.begin(),
+                   m_tmpAvgD.begin(), std::plus<double>());
+  };
+  if (m_sequenceWorkers.empty()) {
+    std::vector<double> &sequence_derivative = m_minibatchDerivatives.front();
+    for (std::uint32_t batch_index = 0u; batch_index < m_usedMinibatchSize;
+         ++batch_index) {
+      calculate_sequence(data_set, sequence_start_index + batch_index,
+                         start_index_inside_sequence);
+      collect_sequence_derivative(start_index_inside_sequence,
+                                  sequence_derivative);
+      add_to_gradients(sequence_derivative);
+    }
+  } else {
+    m_threadPool.parallel_for(
+        0u, m_sequenceWorkers.size(),
+        [this, &data_set, sequence_start_index,
+         start_index_inside_sequence](std::uint32_t worker_index) {
+          RafkoAutodiffOptimizer &worker = *m_sequenceWorkers[worker_index];
+          for (std::uint32_t batch_index = worker_index;
+               batch_index < m_usedMinibatchSize;
+               batch_index += m_sequenceWorkers.size()) {
+            worker.calculate_sequence(data_set,
+                                      sequence_start_index + batch_index,
+                                      start_index_inside_sequence);
+            worker.collect_sequence_derivative(
+                start_index_inside_sequence,
+                m_minibatchDerivatives[batch_index]);
+          }
+        });
+    for (const std::vector<double> &sequence_derivative :
+         m_minibatchDerivatives)
+      add_to_gradients(sequence_derivative);
+  }
+  const double minibatch_size = static_cast<double>(m_usedMinibatchSize);
+  for (double &derivative : m_tmpAvgD)
+    derivative /= minibatch_size;
+  return m_tmpAvgD;
+}
+
+void RafkoAutodiffOptimizer::calculate_sequence(
+    const RafkoDataSet &data_set, std::uint32_t sequence_index,
+    std::uint32_t start_index_inside_sequence) {
+  std::uint32_t raw_inputs_index =
+      sequence_index *
+      (data_set.get_sequence_size() + data_set.get_prefill_inputs_number());
+  std::uint32_t raw_labels_index =
+      sequence_index * data_set.get_sequence_size();
+
+  /* Evaluate the current sequence step by step */
+  reset();
+  for (std::uint32_t prefill_iterator = 0;
+       prefill_iterator < data_set.get_prefill_inputs_number();
+       ++prefill_iterator) {
+    m_data.step();
+    calculate_value(data_set.get_input_view(raw_inputs_index));
+    ++raw_inputs_index;
+  } /* The first few inputs are there to set an initial state to the network
+     */
+
+  /* Solve the data and store the result after the inital "prefill" */
+  for (std::uint32_t step_index = 0; step_index < data_set.get_sequence_size();
+       ++step_index) {
+    m_data.step();
+    m_data.set_weight_derivative_update(/* Add to the relevant derivatives only
                                            when truncation parameters match */
-                                        (sequence_index >=
+                                        (step_index >=
                                          start_index_inside_sequence) &&
-                                        (sequence_index <
+                                        (step_index <
                                          (start_index_inside_sequence +
                                           m_usedSequenceTruncation)));
-      calculate_value(data_set.get_input_sample(raw_inputs_index));
-      calculate_derivative(data_set.get_input_sample(raw_inputs_index),
-                           data_set.get_label_sample(raw_labels_index));
-      ++raw_inputs_index;
-      ++raw_labels_index;
-    } /*for(relevant sequences)*/
-  }
+    const RafkoDataSet::SampleView input =
+        data_set.get_input_view(raw_inputs_index);
+    calculate_value(input);
+    calculate_derivative(input, data_set.get_label_view(raw_labels_index));
+    ++raw_inputs_index;
+    ++raw_labels_index;
+  } /*for(relevant sequences)*/
+}
 
-  std::fill(m_tmpAvgD.begin(), m_tmpAvgD.end(), 0.0);
+void RafkoAutodiffOptimizer::collect_sequence_derivative(
+    std::uint32_t start_index_inside_sequence,
+    std::vector<double> &derivative) {
+  std::fill(derivative.begin(), derivative.end(), 0.0);
   for (std::uint32_t past_sequence_index = start_index_inside_sequence;
        past_sequence_index <
        (start_index_inside_sequence + m_usedSequenceTruncation);
@@ -335,16 +594,9 @@ void RafkoAutodiffOptimizer::iterate(const RafkoDataSet &data_set,
         m_data.get_average_derivative().get_element(past_sequence_index);
     std::transform(
         sequence_derivative.begin(), sequence_derivative.end(),
-        m_tmpAvgD.begin(), m_tmpAvgD.begin(),
+        derivative.begin(), derivative.begin(),
         [](const double &a, const double &b) { return (a + b) / 2.0; });
   }
-
-  if (static_cast<std::int32_t>(m_tmpAvgD.size()) >
-      std::count(m_tmpAvgD.begin(), m_tmpAvgD.end(), 0.0))
-    apply_weight_update(m_tmpAvgD);
-
-  ++m_iteration;
-  update_context_errors(force_gpu_upload);
 }
 
 double RafkoAutodiffOptimizer::get_avg_gradient(std::uint32_t d_w_index) const {
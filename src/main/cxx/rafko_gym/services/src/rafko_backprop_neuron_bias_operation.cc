@@ -25,7 +25,7 @@
 namespace rafko_gym {
 
 void RafkoBackpropNeuronBiasOperation::calculate_value(
-    const std::vector<double> & /*network_input*/) {
+    const RafkoDataSet::SampleView & /*network_input*/) {
   RFASSERT(are_dependencies_registered());
   if (m_neuronWeightIndex < (m_weightsIterator.cached_size() - 1u)) {
     RFASSERT(static_cast<bool>(m_nextBiasDependency));
@@ -41,8 +41,8 @@ void RafkoBackpropNeuronBiasOperation::calculate_value(
 }
 
 void RafkoBackpropNeuronBiasOperation::calculate_derivative(
-    std::uint32_t d_w_index, const std::vector<double> & /*network_input*/,
-    const std::vector<double> & /*label_data*/
+    std::uint32_t d_w_index, const RafkoDataSet::SampleView & /*network_input*/,
+    const RafkoDataSet::SampleView & /*label_data*/
 ) {
   RFASSERT(is_value_processed());
   RFASSERT(are_dependencies_registered());
@@ -76,6 +76,31 @@ void RafkoBackpropNeuronBiasOperation::calculate_derivative(
   set_derivative_processed();
 }
 
+void RafkoBackpropNeuronBiasOperation::calculate_adjoint(
+    std::uint32_t past_index, double adjoint,
+    const RafkoDataSet::SampleView & /*network_input*/,
+    const RafkoDataSet::SampleView & /*label_data*/
+) {
+  RFASSERT(are_dependencies_registered());
+  if (m_neuronWeightIndex < (m_weightsIterator.cached_size() - 1u)) {
+    RFASSERT(static_cast<bool>(m_nextBiasDependency));
+    const rafko_net::Input_functions input_function =
+        m_network.neuron_array(m_neuronIndex).input_function();
+    const double weight = m_network.weight_table(m_weightIndex);
+    const double next_value = m_nextBiasDependency->get_value(past_index);
+    add_weight_adjoint(m_weightIndex,
+                       adjoint * rafko_net::InputFunction::get_derivative(
+                                     input_function, weight, 1.0 /*a_dw*/,
+                                     next_value, 0.0 /*b_dw*/));
+    propagate_adjoint(m_nextBiasDependency, past_index,
+                      adjoint * rafko_net::InputFunction::get_derivative(
+                                    input_function, weight, 0.0 /*a_dw*/,
+                                    next_value, 1.0 /*b_dw*/));
+  } else { /* no additional bias values are present as dependencies */
+    add_weight_adjoint(m_weightIndex, adjoint);
+  }
+}
+
 #if (RAFKO_USES_OPENCL)
 std::string RafkoBackpropNeuronBiasOperation::generic_value_kernel_operation(
     std::string weight_array, std::string operations_value_array,
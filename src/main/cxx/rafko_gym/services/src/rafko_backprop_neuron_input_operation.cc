@@ -154,7 +154,7 @@ RafkoBackpropNeuronInputOperation::get_own_dependencies_past_included() {
 }
 
 void RafkoBackpropNeuronInputOperation::calculate_value(
-    const std::vector<double> &network_input) {
+    const RafkoDataSet::SampleView &network_input) {
   /* i(w) = w * f(w) ¤ u(w) | f(w) = network_input or internal_neuron_input */
   RFASSERT(are_dependencies_registered());
 
@@ -213,8 +213,8 @@ void RafkoBackpropNeuronInputOperation::calculate_value(
 }
 
 void RafkoBackpropNeuronInputOperation::calculate_derivative(
-    std::uint32_t d_w_index, const std::vector<double> &network_input,
-    const std::vector<double> & /*label_data*/
+    std::uint32_t d_w_index, const RafkoDataSet::SampleView &network_input,
+    const RafkoDataSet::SampleView & /*label_data*/
 ) {
   RFASSERT(is_value_processed());
   RFASSERT(are_dependencies_registered());
@@ -309,6 +309,48 @@ void RafkoBackpropNeuronInputOperation::calculate_derivative(
   set_derivative_processed();
 }
 
+void RafkoBackpropNeuronInputOperation::calculate_adjoint(
+    std::uint32_t past_index, double adjoint,
+    const RafkoDataSet::SampleView &network_input,
+    const RafkoDataSet::SampleView & /*label_data*/
+) {
+  RFASSERT(are_dependencies_registered());
+  /* i(w) = w * f(w) ¤ u(w) | f(w) = network_input or internal_neuron_input */
+  /*!Note: f_x_value follows the same convention as in @calculate_derivative */
+  double f_x_value;
+  if (!m_inputPastIndex.has_value()) {
+    f_x_value = get_value(past_index);
+  } else {
+    RFASSERT(static_cast<bool>(m_neuronDataDependency));
+    f_x_value =
+        m_neuronDataDependency->get_value(past_index + *m_inputPastIndex);
+  }
+
+  /* split the adjoint between f(x) and u(x) */
+  double f_x_adjoint = adjoint;
+  if (m_isNextDepBias.has_value()) {
+    RFASSERT(static_cast<bool>(m_nextDependency));
+    const double u_x_value = m_nextDependency->get_value(past_index);
+    f_x_adjoint = adjoint * rafko_net::InputFunction::get_derivative(
+                                get_input_function(), f_x_value, 1.0 /*a_dw*/,
+                                u_x_value, 0.0 /*b_dw*/);
+    propagate_adjoint(m_nextDependency, past_index,
+                      adjoint * rafko_net::InputFunction::get_derivative(
+                                    get_input_function(), f_x_value,
+                                    0.0 /*a_dw*/, u_x_value, 1.0 /*b_dw*/));
+  }
+
+  /* f(x) = w * input */
+  if (!m_inputPastIndex.has_value()) {
+    add_weight_adjoint(m_weightIndex,
+                       f_x_adjoint * network_input[m_inputIndex]);
+  } else {
+    add_weight_adjoint(m_weightIndex, f_x_adjoint * f_x_value);
+    propagate_adjoint(m_neuronDataDependency, past_index + *m_inputPastIndex,
+                      f_x_adjoint * m_network.weight_table(m_weightIndex));
+  }
+}
+
 #if (RAFKO_USES_OPENCL)
 std::string
 RafkoBackpropNeuronInputOperation::local_declaration_operation() const {
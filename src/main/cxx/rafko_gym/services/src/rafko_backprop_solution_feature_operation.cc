@@ -27,14 +27,12 @@ RafkoBackPropSolutionFeatureOperation::RafkoBackPropSolutionFeatureOperation(
     const rafko_net::FeatureGroup &feature_group,
     rafko_utilities::SubscriptProxy<>::AssociationVector
         neuronSpikeToOperationIndex,
-    std::vector<std::unique_ptr<rafko_utilities::ThreadGroup>>
-        &execution_threads)
+    rafko_utilities::WorkStealingPool &thread_pool)
     : RafkoBackpropagationOperation(data, network, operation_index,
                                     ad_operation_network_feature),
       m_settings(settings), m_featureGroup(feature_group),
       m_networkDataProxy(m_dummyVector, neuronSpikeToOperationIndex),
-      m_executionThreads(execution_threads),
-      m_featureExecutor(m_executionThreads) {
+      m_featureExecutor(thread_pool) {
 #if (RAFKO_USES_OPENCL)
   /* Calculate relevant index values */
   switch (m_featureGroup.feature()) {
@@ -63,11 +61,10 @@ RafkoBackPropSolutionFeatureOperation::RafkoBackPropSolutionFeatureOperation(
 }
 
 void RafkoBackPropSolutionFeatureOperation::calculate_value(
-    const std::vector<double> & /*network_input*/) {
+    const RafkoDataSet::SampleView & /*network_input*/) {
   m_networkDataProxy.update(m_data.get_mutable_value().get_element(0));
-  m_featureExecutor.execute_solution_relevant(
-      m_featureGroup, m_settings, m_networkDataProxy, 0u /*thread_index*/
-  );
+  m_featureExecutor.execute_solution_relevant(m_featureGroup, m_settings,
+                                              m_networkDataProxy);
   set_value_processed();
 }
 
@@ -19,7 +19,7 @@
 namespace rafko_gym {
 
 void RafkoBackpropSpikeFnOperation::calculate_value(
-    const std::vector<double> & /*network_input*/) {
+    const RafkoDataSet::SampleView & /*network_input*/) {
   RFASSERT(are_dependencies_registered());
   RFASSERT(static_cast<bool>(m_presentValueDependency));
   RFASSERT(m_presentValueDependency->is_value_processed());
@@ -39,8 +39,8 @@ void RafkoBackpropSpikeFnOperation::calculate_value(
 }
 
 void RafkoBackpropSpikeFnOperation::calculate_derivative(
-    std::uint32_t d_w_index, const std::vector<double> & /*network_input*/,
-    const std::vector<double> & /*label_data*/
+    std::uint32_t d_w_index, const RafkoDataSet::SampleView & /*network_input*/,
+    const RafkoDataSet::SampleView & /*label_data*/
 ) {
   RFASSERT(is_value_processed());
   RFASSERT(are_dependencies_registered());
@@ -90,6 +90,35 @@ void RafkoBackpropSpikeFnOperation::calculate_derivative(
   set_derivative_processed();
 }
 
+void RafkoBackpropSpikeFnOperation::calculate_adjoint(
+    std::uint32_t past_index, double adjoint,
+    const RafkoDataSet::SampleView & /*network_input*/,
+    const RafkoDataSet::SampleView & /*label_data*/
+) {
+  RFASSERT(are_dependencies_registered());
+  RFASSERT(static_cast<bool>(m_presentValueDependency));
+  const double weight = m_network.weight_table(get_weight_index());
+  /*!Note: Spike functions are linear in the dependency derivatives,
+   * so the coefficients are extracted by using unit derivatives */
+  propagate_adjoint(m_presentValueDependency, past_index,
+                    adjoint * rafko_net::SpikeFunction::get_derivative_not_for_w(
+                                  get_spike_function(), weight,
+                                  0.0 /*previous_data_d*/,
+                                  1.0 /*new_data_d*/));
+  m_data.add_adjoint(past_index + 1u, get_operation_index(),
+                     adjoint * rafko_net::SpikeFunction::get_derivative_not_for_w(
+                                   get_spike_function(), weight,
+                                   1.0 /*previous_data_d*/,
+                                   0.0 /*new_data_d*/));
+  add_weight_adjoint(
+      get_weight_index(),
+      adjoint * rafko_net::SpikeFunction::get_derivative_for_w(
+                    get_spike_function(), weight,
+                    get_value(past_index + 1u), 0.0 /*previous_data_d*/,
+                    m_presentValueDependency->get_value(past_index),
+                    0.0 /*new_data_d*/));
+}
+
 #if (RAFKO_USES_OPENCL)
 std::string RafkoBackpropSpikeFnOperation::local_declaration_operation() const {
   return R"( /* Spike Function Operation locals */
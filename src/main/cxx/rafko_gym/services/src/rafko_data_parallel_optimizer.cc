@@ -0,0 +1,147 @@
+/*! This file is part of davids91/Rafko.
+ *
+ *    Rafko is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    (at your option) any later version.
+ *
+ *    Rafko is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with Rafko.  If not, see <https://www.gnu.org/licenses/> or
+ *    <https://github.com/davids91/rafko/blob/master/LICENSE>
+ */
+
+#include "rafko_gym/services/rafko_data_parallel_optimizer.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "rafko_utilities/services/rafko_thread_affinity.hpp"
+
+namespace rafko_gym {
+
+RafkoDataParallelOptimizer::RafkoDataParallelOptimizer(
+    std::shared_ptr<rafko_mainframe::RafkoSettings> settings,
+    rafko_net::RafkoNet &network, std::uint32_t replica_count,
+    std::shared_ptr<rafko_mainframe::RafkoContext> training_evaluator,
+    std::shared_ptr<rafko_mainframe::RafkoContext> test_evaluator)
+    : RafkoAutodiffOptimizer(settings, network, training_evaluator,
+                             test_evaluator),
+      m_replicaCpus(
+          rafko_utilities::divide_cpus(std::max(1u, replica_count))),
+      m_replicaThreads(std::max(1u, replica_count),
+                       rafko_utilities::ThreadGroup::SpinThenPark,
+                       m_replicaCpus),
+      m_replicaSequenceStart(std::max(1u, replica_count)) {
+  replica_count = std::max(1u, replica_count);
+  /*!Note: Every replica processes its minibatch sequences on its own share of
+   * the threads */
+  m_replicaSettings = std::make_shared<rafko_mainframe::RafkoSettings>(
+      rafko_mainframe::RafkoSettings(*m_settings)
+          .set_max_processing_threads(std::max(
+              1u, m_settings->get_max_processing_threads() / replica_count))
+          .set_max_solve_threads(std::max(
+              1u, m_settings->get_max_solve_threads() / replica_count)));
+  for (std::uint32_t replica_index = 0u; replica_index < replica_count;
+       ++replica_index) {
+    /*!Note: The thread of the replica also works in its pool while it waits
+     * for it, so the pool needs one worker less than the CPUs of the replica */
+    std::uint32_t replica_threads =
+        m_replicaSettings->get_max_processing_threads();
+    std::vector<std::uint32_t> replica_cpus;
+    if (replica_index < m_replicaCpus.size()) {
+      replica_cpus = m_replicaCpus[replica_index];
+      replica_threads = replica_cpus.size();
+    }
+    m_replicaPools.push_back(
+        std::make_unique<rafko_utilities::WorkStealingPool>(
+            std::max(1u, replica_threads - 1u), replica_cpus));
+    m_replicaNetworks.push_back(std::make_unique<rafko_net::RafkoNet>(network));
+    m_replicas.push_back(std::make_unique<RafkoAutodiffOptimizer>(
+        m_replicaSettings, *m_replicaNetworks.back(), nullptr, nullptr,
+        *m_replicaPools.back()));
+  }
+}
+
+void RafkoDataParallelOptimizer::build(
+    const std::shared_ptr<RafkoDataSet> data_set,
+    std::shared_ptr<RafkoObjective> objective) {
+  RFASSERT(static_cast<bool>(data_set));
+  if (data_set->get_number_of_sequences() < m_replicas.size())
+    throw std::runtime_error(
+        "Data set has less sequences than the number of replicas to train!");
+  m_shardSize = data_set->get_number_of_sequences() / m_replicas.size();
+  m_replicaMinibatchSize =
+      std::min(m_shardSize, m_settings->get_minibatch_size());
+  m_replicaSettings->set_minibatch_size(m_replicaMinibatchSize);
+  /*!Note: The gradients are calculated by the replicas only */
+  build_for_weight_updates(data_set, objective);
+  for (std::unique_ptr<RafkoAutodiffOptimizer> &replica : m_replicas)
+    replica->build(data_set, objective);
+}
+
+void RafkoDataParallelOptimizer::iterate(const RafkoDataSet &data_set,
+                                         bool force_gpu_upload) {
+  RFASSERT(0u < m_shardSize);
+  /*!Note: the random numbers are drawn in the calling thread, so the
+   * minibatches only depend on the seed */
+  for (std::uint32_t replica_index = 0u; replica_index < m_replicas.size();
+       ++replica_index)
+    m_replicaSequenceStart[replica_index] =
+        (replica_index * m_shardSize) +
+        (rand() % (m_shardSize - m_replicaMinibatchSize + 1u));
+  const std::uint32_t start_index_inside_sequence =
+      (rand() %
+       (data_set.get_sequence_size() - m_usedSequenceTruncation + 1u));
+
+  m_replicaThreads.start_and_block(
+      [this, &data_set, start_index_inside_sequence](
+          std::uint32_t thread_index) {
+        m_replicas[thread_index]->calculate_gradients(
+            data_set, m_replicaSequenceStart[thread_index],
+            start_index_inside_sequence);
+      });
+  m_replicaThreads.start_and_block(
+      [this](std::uint32_t thread_index) { reduce_gradients(thread_index); });
+
+  if (static_cast<std::int32_t>(m_tmpAvgD.size()) >
+      std::count(m_tmpAvgD.begin(), m_tmpAvgD.end(), 0.0)) {
+    apply_weight_update(m_tmpAvgD);
+    m_replicaThreads.start_and_block([this](std::uint32_t thread_index) {
+      *m_replicaNetworks[thread_index]->mutable_weight_table() =
+          m_network.weight_table();
+    });
+  }
+
+  ++m_iteration;
+  update_context_errors(force_gpu_upload);
+  data_set.next_minibatch();
+}
+
+void RafkoDataParallelOptimizer::reduce_gradients(std::uint32_t thread_index) {
+  const std::uint32_t weight_number = m_tmpAvgD.size();
+  const std::uint32_t weights_in_one_thread =
+      1u + (weight_number / m_replicas.size());
+  const std::uint32_t weight_start =
+      std::min(weight_number, (weights_in_one_thread * thread_index));
+  const std::uint32_t weight_end =
+      std::min(weight_number, (weight_start + weights_in_one_thread));
+  const double replica_count = static_cast<double>(m_replicas.size());
+  std::fill(m_tmpAvgD.begin() + weight_start, m_tmpAvgD.begin() + weight_end,
+            0.0);
+  for (const std::unique_ptr<RafkoAutodiffOptimizer> &replica : m_replicas) {
+    const std::vector<double> &gradients = replica->get_gradients();
+    for (std::uint32_t weight_index = weight_start; weight_index < weight_end;
+         ++weight_index)
+      m_tmpAvgD[weight_index] += gradients[weight_index];
+  }
+  for (std::uint32_t weight_index = weight_start; weight_index < weight_end;
+       ++weight_index)
+    m_tmpAvgD[weight_index] /= replica_count;
+}
+
+} /* namespace rafko_gym */
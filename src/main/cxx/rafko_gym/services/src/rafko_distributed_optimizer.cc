@@ -0,0 +1,125 @@
+/*! This file is part of davids91/Rafko.
+ *
+ *    Rafko is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    (at your option) any later version.
+ *
+ *    Rafko is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with Rafko.  If not, see <https://www.gnu.org/licenses/> or
+ *    <https://github.com/davids91/rafko/blob/master/LICENSE>
+ */
+
+#include "rafko_gym/services/rafko_distributed_optimizer.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace rafko_gym {
+
+void RafkoDistributedOptimizer::build(
+    const std::shared_ptr<RafkoDataSet> data_set,
+    std::shared_ptr<RafkoObjective> objective) {
+  RFASSERT(static_cast<bool>(data_set));
+  RafkoAutodiffOptimizer::build(data_set, objective);
+  /*!Note: The sequences not divisible among the workers are given to the
+   * first workers, one each */
+  const std::uint32_t world_size = m_transport->get_world_size();
+  const std::uint32_t rank = m_transport->get_rank();
+  const std::uint32_t base_shard_size =
+      data_set->get_number_of_sequences() / world_size;
+  const std::uint32_t remainder =
+      data_set->get_number_of_sequences() % world_size;
+  m_shardStart = (rank * base_shard_size) + std::min(rank, remainder);
+  m_shardSize = base_shard_size + ((rank < remainder) ? 1u : 0u);
+  if (base_shard_size < m_usedMinibatchSize)
+    throw std::runtime_error("The shard of the data set of a worker is smaller "
+                             "than the minibatch size!");
+  rejoin();
+}
+
+void RafkoDistributedOptimizer::iterate(const RafkoDataSet &data_set,
+                                        bool force_gpu_upload) {
+  RFASSERT(0u < m_shardSize);
+  const std::uint32_t sequence_start_index =
+      m_shardStart + (rand() % (m_shardSize - m_usedMinibatchSize + 1u));
+  const std::uint32_t start_index_inside_sequence =
+      (rand() %
+       (data_set.get_sequence_size() - m_usedSequenceTruncation + 1u));
+  while (true) {
+    calculate_gradients(data_set, sequence_start_index,
+                        start_index_inside_sequence);
+    try {
+      m_allReduce.average(m_tmpAvgD);
+      break;
+    } catch (const std::runtime_error &) {
+      /*!Note: the weights might have changed while rejoining, and the
+       * gradients might have been partially reduced, so they are calculated
+       * again */
+      rejoin();
+    }
+  }
+
+  if (static_cast<std::int32_t>(m_tmpAvgD.size()) >
+      std::count(m_tmpAvgD.begin(), m_tmpAvgD.end(), 0.0))
+    apply_weight_update(m_tmpAvgD);
+
+  ++m_iteration;
+  update_context_errors(force_gpu_upload);
+  data_set.next_minibatch();
+}
+
+void RafkoDistributedOptimizer::rejoin() {
+  while (true) {
+    m_transport->connect(); /* failing to connect in time is not recovered */
+    try {
+      synchronize_weights();
+      return;
+    } catch (const std::runtime_error &) {
+      /* Another worker left while synchronizing, so the ring is built again */
+    }
+  }
+}
+
+void RafkoDistributedOptimizer::synchronize_weights() {
+  const std::uint32_t world_size = m_transport->get_world_size();
+  const std::uint32_t rank = m_transport->get_rank();
+  std::vector<double> updater_state = m_weightUpdater->get_state();
+
+  /* The iteration count and the updater state size of every worker */
+  std::vector<double> worker_info(2u * world_size, 0.0);
+  worker_info[rank] = static_cast<double>(m_iteration);
+  worker_info[world_size + rank] = static_cast<double>(updater_state.size());
+  m_allReduce.sum(worker_info);
+  if (std::any_of(worker_info.begin() + world_size, worker_info.end(),
+                  [&updater_state](double state_size) {
+                    return (state_size !=
+                            static_cast<double>(updater_state.size()));
+                  }))
+    throw std::logic_error("The workers are using different weight updaters!");
+  const std::uint32_t source_rank = std::distance(
+      worker_info.begin(),
+      std::max_element(worker_info.begin(), worker_info.begin() + world_size));
+
+  std::vector<double> weights(m_network.weight_table().begin(),
+                              m_network.weight_table().end());
+  m_allReduce.broadcast(weights, source_rank);
+  m_allReduce.broadcast(updater_state, source_rank);
+  std::copy(weights.begin(), weights.end(),
+            m_network.mutable_weight_table()->begin());
+  m_weightUpdater->set_state(updater_state);
+  m_iteration = static_cast<std::uint32_t>(worker_info[source_rank]);
+
+  /* The contexts are refreshed the same way as after a weight update */
+  if (m_trainingEvaluator)
+    m_trainingEvaluator->refresh_solution_weights();
+  if (m_testEvaluator)
+    m_testEvaluator->refresh_solution_weights();
+}
+
+} /* namespace rafko_gym */
@@ -0,0 +1,156 @@
+/*! This file is part of davids91/Rafko.
+ *
+ *    Rafko is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    (at your option) any later version.
+ *
+ *    Rafko is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with Rafko.  If not, see <https://www.gnu.org/licenses/> or
+ *    <https://github.com/davids91/rafko/blob/master/LICENSE>
+ */
+
+#include "rafko_gym/services/rafko_hogwild_optimizer.hpp"
+
+#include <algorithm>
+#include <chrono>
+
+namespace rafko_gym {
+
+RafkoHogwildOptimizer::RafkoHogwildOptimizer(
+    std::shared_ptr<rafko_mainframe::RafkoSettings> settings,
+    rafko_net::RafkoNet &network, std::uint32_t worker_count,
+    std::shared_ptr<rafko_mainframe::RafkoContext> training_evaluator,
+    std::shared_ptr<rafko_mainframe::RafkoContext> test_evaluator)
+    : RafkoAutodiffOptimizer(settings, network, training_evaluator,
+                             test_evaluator),
+      m_workerThreads(std::max(1u, worker_count)),
+      m_sharedWeights(network.weight_table_size()),
+      m_workerSnapshots(std::max(1u, worker_count)) {
+  worker_count = std::max(1u, worker_count);
+  m_workerSettings = std::make_shared<rafko_mainframe::RafkoSettings>(
+      rafko_mainframe::RafkoSettings(*m_settings)
+          .set_max_processing_threads(std::max(
+              1u, m_settings->get_max_processing_threads() / worker_count))
+          .set_max_solve_threads(std::max(
+              1u, m_settings->get_max_solve_threads() / worker_count)));
+  for (std::uint32_t worker_index = 0u; worker_index < worker_count;
+       ++worker_index) {
+    m_workerNetworks.push_back(std::make_unique<rafko_net::RafkoNet>(network));
+    m_workers.push_back(std::make_unique<RafkoAutodiffOptimizer>(
+        m_workerSettings, *m_workerNetworks.back()));
+  }
+}
+
+void RafkoHogwildOptimizer::build(const std::shared_ptr<RafkoDataSet> data_set,
+                                  std::shared_ptr<RafkoObjective> objective) {
+  /*!Note: The gradients are calculated by the workers only */
+  build_for_weight_updates(data_set, objective);
+  for (std::unique_ptr<RafkoAutodiffOptimizer> &worker : m_workers)
+    worker->build(data_set, objective);
+}
+
+void RafkoHogwildOptimizer::set_weight_updater(
+    rafko_gym::Weight_updaters updater) {
+  RafkoAutodiffOptimizer::set_weight_updater(updater);
+  for (std::unique_ptr<RafkoAutodiffOptimizer> &worker : m_workers)
+    worker->set_weight_updater(updater);
+}
+
+void RafkoHogwildOptimizer::train(const RafkoDataSet &data_set,
+                                  std::uint32_t updates_per_worker,
+                                  bool force_gpu_upload) {
+  for (std::int32_t weight_index = 0;
+       weight_index < m_network.weight_table_size(); ++weight_index)
+    m_sharedWeights[weight_index].store(m_network.weight_table(weight_index),
+                                        std::memory_order_relaxed);
+
+  /*!Note: the random numbers are drawn in the calling thread, as rand() is
+   * not thread-safe */
+  m_minibatchStarts.resize(m_workers.size() * updates_per_worker);
+  for (std::pair<std::uint32_t, std::uint32_t> &minibatch_start :
+       m_minibatchStarts)
+    minibatch_start = {
+        (rand() %
+         (data_set.get_number_of_sequences() - m_usedMinibatchSize + 1u)),
+        (rand() %
+         (data_set.get_sequence_size() - m_usedSequenceTruncation + 1u))};
+
+  const std::chrono::steady_clock::time_point start =
+      std::chrono::steady_clock::now();
+  m_workerThreads.start_and_block(
+      [this, &data_set, updates_per_worker](std::uint32_t thread_index) {
+        for (std::uint32_t update = 0u; update < updates_per_worker; ++update)
+          update_with_worker(
+              data_set, thread_index,
+              m_minibatchStarts[(thread_index * updates_per_worker) + update]);
+      });
+  m_trainingSeconds += std::chrono::duration<double>(
+                           std::chrono::steady_clock::now() - start)
+                           .count();
+
+  for (std::int32_t weight_index = 0;
+       weight_index < m_network.weight_table_size(); ++weight_index)
+    m_network.set_weight_table(
+        weight_index,
+        m_sharedWeights[weight_index].load(std::memory_order_relaxed));
+  m_iteration += updates_per_worker;
+  update_context_errors(force_gpu_upload);
+  data_set.next_minibatch();
+}
+
+void RafkoHogwildOptimizer::update_with_worker(
+    const RafkoDataSet &data_set, std::uint32_t worker_index,
+    const std::pair<std::uint32_t, std::uint32_t> &minibatch_start) {
+  rafko_net::RafkoNet &network = *m_workerNetworks[worker_index];
+  double *weights = network.mutable_weight_table()->mutable_data();
+  const std::vector<std::uint32_t> &reachable_weights =
+      m_workers[worker_index]->get_reachable_weights();
+
+  /*!Note: Only the weights the outputs depend on are read and written, as the
+   * derivatives of the others are always zero. The weights are read one by
+   * one, so they might be from different updates of the other workers */
+  const std::uint64_t read_version =
+      m_updateCount.load(std::memory_order_acquire);
+  std::vector<double> &snapshot = m_workerSnapshots[worker_index];
+  snapshot.resize(reachable_weights.size());
+  for (std::uint32_t reachable_index = 0u;
+       reachable_index < reachable_weights.size(); ++reachable_index) {
+    const std::uint32_t weight_index = reachable_weights[reachable_index];
+    weights[weight_index] =
+        m_sharedWeights[weight_index].load(std::memory_order_relaxed);
+    snapshot[reachable_index] = weights[weight_index];
+  }
+
+  m_workers[worker_index]->iterate_on_minibatch(data_set, minibatch_start.first,
+                                                minibatch_start.second);
+
+  for (std::uint32_t reachable_index = 0u;
+       reachable_index < reachable_weights.size(); ++reachable_index) {
+    const std::uint32_t weight_index = reachable_weights[reachable_index];
+    const double delta = weights[weight_index] - snapshot[reachable_index];
+    if (0.0 == delta)
+      continue;
+    std::atomic<double> &shared_weight = m_sharedWeights[weight_index];
+    double current = shared_weight.load(std::memory_order_relaxed);
+    while (!shared_weight.compare_exchange_weak(current, current + delta,
+                                                std::memory_order_relaxed))
+      ;
+  }
+
+  const std::uint64_t staleness =
+      m_updateCount.fetch_add(1u, std::memory_order_acq_rel) - read_version;
+  m_totalStaleness.fetch_add(staleness, std::memory_order_relaxed);
+  std::uint64_t max_staleness = m_maxStaleness.load(std::memory_order_relaxed);
+  while ((max_staleness < staleness) &&
+         (!m_maxStaleness.compare_exchange_weak(max_staleness, staleness,
+                                                std::memory_order_relaxed)))
+    ;
+}
+
+} /* namespace rafko_gym */
@@ -32,38 +32,41 @@ void RafkoNumericOptimizer::collect_approximates_from_weight_gradients() {
         m_training_contexts[0]->expose_network().weight_table_size());
     m_used_weight_filter = m_weight_filter;
     for (std::uint32_t weight_index = 0; weight_index < used_gradients.size();
-         weight_index += m_execution_threads.get_number_of_threads()) {
-      m_execution_threads.start_and_block([this, weight_index, &used_gradients,
-                                           &greatest_gradient_value,
-                                           &weight_stats_mutex,
-                                           &used_weight_filter_sum](
-                                              std::uint32_t thread_index) {
-        const std::uint32_t actual_weight_index = (weight_index + thread_index);
-        if (actual_weight_index < used_gradients.size()) {
-          if ((0 < m_excludeChanceSum) &&
-              (m_weight_exclude_chance_filter[actual_weight_index] >=
-               (static_cast<double>(rand() % 100 + 1) / 100.0))) {
-            m_used_weight_filter[actual_weight_index] = 0.0;
-          }
-
-          if (0.0 != m_used_weight_filter[actual_weight_index]) {
-            used_gradients[actual_weight_index] =
-                get_single_weight_gradient(actual_weight_index,
-                                           *m_training_contexts[thread_index]) *
-                m_used_weight_filter[actual_weight_index];
-            if (greatest_gradient_value <
-                std::abs(used_gradients[actual_weight_index])) {
-              std::lock_guard<std::mutex> my_lock(weight_stats_mutex);
-              greatest_gradient_value =
-                  std::abs(used_gradients[actual_weight_index]);
-            }
-            std::lock_guard<std::mutex> my_lock(weight_stats_mutex);
-            used_weight_filter_sum += m_used_weight_filter[actual_weight_index];
-          } else {
-            used_gradients[actual_weight_index] = 0.0;
-          }
-        } /*if(actual_weight_index inside bounds)*/
-      });
+         weight_index += m_usedContexts) {
+      m_threadPool.parallel_for(
+          0u, m_usedContexts,
+          [this, weight_index, &used_gradients, &greatest_gradient_value,
+           &weight_stats_mutex,
+           &used_weight_filter_sum](std::uint32_t thread_index) {
+            const std::uint32_t actual_weight_index =
+                (weight_index + thread_index);
+            if (actual_weight_index < used_gradients.size()) {
+              if ((0 < m_excludeChanceSum) &&
+                  (m_weight_exclude_chance_filter[actual_weight_index] >=
+                   (static_cast<double>(rand() % 100 + 1) / 100.0))) {
+                m_used_weight_filter[actual_weight_index] = 0.0;
+              }
+
+              if (0.0 != m_used_weight_filter[actual_weight_index]) {
+                used_gradients[actual_weight_index] =
+                    get_single_weight_gradient(
+                        actual_weight_index,
+                        *m_training_contexts[thread_index]) *
+                    m_used_weight_filter[actual_weight_index];
+                if (greatest_gradient_value <
+                    std::abs(used_gradients[actual_weight_index])) {
+                  std::lock_guard<std::mutex> my_lock(weight_stats_mutex);
+                  greatest_gradient_value =
+                      std::abs(used_gradients[actual_weight_index]);
+                }
+                std::lock_guard<std::mutex> my_lock(weight_stats_mutex);
+                used_weight_filter_sum +=
+                    m_used_weight_filter[actual_weight_index];
+              } else {
+                used_gradients[actual_weight_index] = 0.0;
+              }
+            } /*if(actual_weight_index inside bounds)*/
+          });
     } /*for(all weights)*/
     double gradient_overview = 0.0;
     double weight_filter_accumulate = 0.0;
@@ -141,8 +144,9 @@ void RafkoNumericOptimizer::convert_direction_to_gradient(
       m_training_contexts[0]->expose_network().weight_table().begin(),
       m_training_contexts[0]->expose_network().weight_table().end()};
 
-  if (2 <= m_execution_threads.get_number_of_threads()) {
-    m_execution_threads.start_and_block(
+  if (2u <= m_usedContexts) {
+    m_threadPool.parallel_for(
+        0u, 2u,
         [this, &direction, &negative_direction, &error_positive_direction,
          &error_negative_direction,
          &network_original_weights](std::uint32_t thread_index) {
@@ -293,8 +297,9 @@ double RafkoNumericOptimizer::get_gradient_for_all_weights() {
       m_training_contexts[0]->expose_network().weight_table().begin(),
       m_training_contexts[0]->expose_network().weight_table().end()};
 
-  if (2 <= m_execution_threads.get_number_of_threads()) {
-    m_execution_threads.start_and_block(
+  if (2u <= m_usedContexts) {
+    m_threadPool.parallel_for(
+        0u, 2u,
         [this, current_epsilon, &error_positive_direction,
          &error_negative_direction,
          &network_original_weights](std::uint32_t thread_index) {
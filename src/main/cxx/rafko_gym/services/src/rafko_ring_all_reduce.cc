@@ -0,0 +1,187 @@
+/*! This file is part of davids91/Rafko.
+ *
+ *    Rafko is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    (at your option) any later version.
+ *
+ *    Rafko is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with Rafko.  If not, see <https://www.gnu.org/licenses/> or
+ *    <https://github.com/davids91/rafko/blob/master/LICENSE>
+ */
+
+#include "rafko_gym/services/rafko_ring_all_reduce.hpp"
+
+#include <exception>
+#include <stdexcept>
+
+#include "rafko_protocol/rafko_net.pb.h"
+
+namespace rafko_gym {
+
+RafkoRingAllReduce::~RafkoRingAllReduce() {
+  {
+    std::lock_guard<std::mutex> my_lock(m_senderMutex);
+    m_stopping = true;
+  }
+  m_senderSignal.notify_all();
+  m_sender.join();
+}
+
+void RafkoRingAllReduce::send_messages() {
+  std::unique_lock<std::mutex> my_lock(m_senderMutex);
+  while (true) {
+    m_senderSignal.wait(my_lock,
+                        [this]() { return (m_stopping || m_sendPending); });
+    if (m_stopping)
+      return;
+    my_lock.unlock();
+    std::exception_ptr send_error;
+    try {
+      m_transport.send_to_next(m_sendBuffer);
+    } catch (...) {
+      send_error = std::current_exception();
+      m_transport.interrupt(); /* the receive doesn't wait on a broken ring */
+    }
+    my_lock.lock();
+    m_sendError = send_error;
+    m_sendPending = false;
+    m_senderSignal.notify_all();
+  }
+}
+
+std::exception_ptr RafkoRingAllReduce::wait_for_sender() {
+  std::unique_lock<std::mutex> my_lock(m_senderMutex);
+  m_senderSignal.wait(my_lock, [this]() { return !m_sendPending; });
+  std::exception_ptr send_error;
+  std::swap(send_error, m_sendError);
+  return send_error;
+}
+
+const NetworkWeightVectorDelta &
+RafkoRingAllReduce::exchange(const std::vector<double> &values,
+                             std::uint32_t send_chunk,
+                             std::uint32_t receive_chunk) {
+  const std::uint32_t size = values.size();
+  m_message.Clear();
+  rafko_net::IndexSynapseInterval &interval = *m_message.add_weight_synapses();
+  interval.set_starts(chunk_start(size, send_chunk));
+  interval.set_interval_size(chunk_size(size, send_chunk));
+  m_message.mutable_values()->Add(values.begin() + interval.starts(),
+                                  values.begin() + interval.starts() +
+                                      interval.interval_size());
+  { /* The buffer is only touched by the sender while a send is pending */
+    std::lock_guard<std::mutex> my_lock(m_senderMutex);
+    m_message.SerializeToString(&m_sendBuffer);
+    m_sendPending = true;
+  }
+  m_senderSignal.notify_all();
+
+  std::string received;
+  try {
+    received = m_transport.receive_from_previous();
+  } catch (...) {
+    m_transport.interrupt(); /* so the sender doesn't wait on a broken ring */
+    wait_for_sender();
+    throw;
+  }
+  std::exception_ptr send_error = wait_for_sender();
+  if (send_error)
+    std::rethrow_exception(send_error);
+
+  if ((!m_message.ParseFromString(received)) ||
+      (1 != m_message.weight_synapses_size()) ||
+      (static_cast<std::int32_t>(chunk_start(size, receive_chunk)) !=
+       m_message.weight_synapses(0).starts()) ||
+      (chunk_size(size, receive_chunk) !=
+       m_message.weight_synapses(0).interval_size()) ||
+      (static_cast<std::int32_t>(chunk_size(size, receive_chunk)) !=
+       m_message.values_size()))
+    throw std::runtime_error("Unexpected vector fragment from the previous "
+                             "worker!");
+  return m_message;
+}
+
+void RafkoRingAllReduce::sum(std::vector<double> &values) {
+  const std::uint32_t world_size = m_transport.get_world_size();
+  const std::uint32_t rank = m_transport.get_rank();
+  if (1u == world_size)
+    return;
+
+  /* Reduce-scatter: after it, every worker has the sum of one chunk */
+  for (std::uint32_t step = 0u; step < (world_size - 1u); ++step) {
+    const std::uint32_t send_chunk = (rank + world_size - step) % world_size;
+    const std::uint32_t receive_chunk =
+        (rank + world_size - step - 1u) % world_size;
+    const NetworkWeightVectorDelta &received =
+        exchange(values, send_chunk, receive_chunk);
+    const std::uint32_t start = received.weight_synapses(0).starts();
+    for (std::int32_t index = 0; index < received.values_size(); ++index)
+      values[start + index] += received.values(index);
+  }
+
+  /* All-gather: the summed chunks are passed around the ring */
+  for (std::uint32_t step = 0u; step < (world_size - 1u); ++step) {
+    const std::uint32_t send_chunk =
+        (rank + 1u + world_size - step) % world_size;
+    const std::uint32_t receive_chunk = (rank + world_size - step) % world_size;
+    const NetworkWeightVectorDelta &received =
+        exchange(values, send_chunk, receive_chunk);
+    std::copy(received.values().begin(), received.values().end(),
+              values.begin() + received.weight_synapses(0).starts());
+  }
+}
+
+void RafkoRingAllReduce::average(std::vector<double> &values) {
+  sum(values);
+  const double world_size = static_cast<double>(m_transport.get_world_size());
+  for (double &value : values)
+    value /= world_size;
+}
+
+void RafkoRingAllReduce::broadcast(std::vector<double> &values,
+                                   std::uint32_t source_rank) {
+  const std::uint32_t world_size = m_transport.get_world_size();
+  const std::uint32_t rank = m_transport.get_rank();
+  const std::uint32_t next_rank = (rank + 1u) % world_size;
+  if (1u == world_size)
+    return;
+
+  m_message.Clear();
+  if (rank != source_rank) {
+    std::string received;
+    try {
+      received = m_transport.receive_from_previous();
+    } catch (...) {
+      m_transport.interrupt();
+      throw;
+    }
+    if ((!m_message.ParseFromString(received)) ||
+        (static_cast<std::int32_t>(values.size()) != m_message.values_size()))
+      throw std::runtime_error("Unexpected vector from the previous worker!");
+    std::copy(m_message.values().begin(), m_message.values().end(),
+              values.begin());
+  } else {
+    rafko_net::IndexSynapseInterval &interval =
+        *m_message.add_weight_synapses();
+    interval.set_starts(0);
+    interval.set_interval_size(values.size());
+    m_message.mutable_values()->Add(values.begin(), values.end());
+  }
+  if (next_rank != source_rank) {
+    m_message.SerializeToString(&m_sendBuffer);
+    try {
+      m_transport.send_to_next(m_sendBuffer);
+    } catch (...) {
+      m_transport.interrupt();
+      throw;
+    }
+  }
+}
+
+} /* namespace rafko_gym */
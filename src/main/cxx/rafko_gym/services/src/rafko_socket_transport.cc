@@ -0,0 +1,342 @@
+/*! This file is part of davids91/Rafko.
+ *
+ *    Rafko is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    (at your option) any later version.
+ *
+ *    Rafko is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with Rafko.  If not, see <https://www.gnu.org/licenses/> or
+ *    <https://github.com/davids91/rafko/blob/master/LICENSE>
+ */
+
+#include "rafko_gym/services/rafko_socket_transport.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+#if !defined(_WIN32)
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif /*!defined(_WIN32)*/
+
+namespace rafko_gym {
+
+#if defined(_WIN32)
+
+RafkoSocketTransport::RafkoSocketTransport(
+    protocol_t protocol, std::vector<std::string> addresses,
+    std::uint32_t rank, std::chrono::milliseconds connect_timeout,
+    std::uint32_t max_message_size)
+    : m_protocol(protocol), m_addresses(std::move(addresses)), m_rank(rank),
+      m_connectTimeout(connect_timeout), m_maxMessageSize(max_message_size) {
+  throw std::runtime_error(
+      "Socket transport is not available on this platform!");
+}
+
+RafkoSocketTransport::~RafkoSocketTransport() = default;
+void RafkoSocketTransport::connect() {}
+void RafkoSocketTransport::interrupt() {}
+void RafkoSocketTransport::disconnect() {}
+void RafkoSocketTransport::send_to_next(const std::string &) {}
+std::string RafkoSocketTransport::receive_from_previous() { return {}; }
+int RafkoSocketTransport::open_connection(const std::string &) const {
+  return -1;
+}
+
+#else
+
+namespace {
+/**
+ * @brief      Splits a "host:port" address into its parts
+ */
+std::pair<std::string, std::string>
+split_tcp_address(const std::string &address) {
+  const std::size_t separator = address.rfind(':');
+  if (std::string::npos == separator)
+    throw std::runtime_error("Invalid TCP address: " + address);
+  return {address.substr(0, separator), address.substr(separator + 1u)};
+}
+
+sockaddr_un unix_address(const std::string &path) {
+  sockaddr_un result{};
+  if (sizeof(result.sun_path) <= path.size())
+    throw std::runtime_error("Socket path is too long: " + path);
+  result.sun_family = AF_UNIX;
+  std::strncpy(result.sun_path, path.c_str(), sizeof(result.sun_path) - 1u);
+  return result;
+}
+
+void write_all(int socket, const char *data, std::size_t size) {
+  while (0u < size) {
+#if defined(MSG_NOSIGNAL)
+    const ssize_t written = ::send(socket, data, size, MSG_NOSIGNAL);
+#else
+    const ssize_t written = ::send(socket, data, size, 0);
+#endif /*defined(MSG_NOSIGNAL)*/
+    if ((0 > written) && (EINTR == errno))
+      continue;
+    if (written <= 0)
+      throw std::runtime_error("Lost connection to the next worker!");
+    data += written;
+    size -= static_cast<std::size_t>(written);
+  }
+}
+
+/**
+ * @brief      Limits the time a receive might block on the given socket;
+ * a zero timeout makes it block until data arrives
+ */
+void set_receive_timeout(int socket, std::chrono::milliseconds timeout) {
+  timeval time{};
+  time.tv_sec = static_cast<decltype(time.tv_sec)>(timeout.count() / 1000);
+  time.tv_usec =
+      static_cast<decltype(time.tv_usec)>((timeout.count() % 1000) * 1000);
+  ::setsockopt(socket, SOL_SOCKET, SO_RCVTIMEO, &time, sizeof(time));
+}
+
+void read_all(int socket, char *data, std::size_t size) {
+  while (0u < size) {
+    const ssize_t received = ::recv(socket, data, size, 0);
+    if ((0 > received) && (EINTR == errno))
+      continue;
+    if (received <= 0)
+      throw std::runtime_error("Lost connection to the previous worker!");
+    data += received;
+    size -= static_cast<std::size_t>(received);
+  }
+}
+} /* namespace */
+
+RafkoSocketTransport::RafkoSocketTransport(
+    protocol_t protocol, std::vector<std::string> addresses,
+    std::uint32_t rank, std::chrono::milliseconds connect_timeout,
+    std::uint32_t max_message_size)
+    : m_protocol(protocol), m_addresses(std::move(addresses)), m_rank(rank),
+      m_connectTimeout(connect_timeout), m_maxMessageSize(max_message_size) {
+  if (m_addresses.size() <= m_rank)
+    throw std::runtime_error("Rank is outside of the ring of workers!");
+  const std::string &own_address = m_addresses[m_rank];
+  if (UnixDomain == m_protocol) {
+    const sockaddr_un address = unix_address(own_address);
+    m_listener = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    ::unlink(own_address.c_str()); /* from previous runs of the same rank */
+    if ((0 > m_listener) ||
+        (0 != ::bind(m_listener, reinterpret_cast<const sockaddr *>(&address),
+                     sizeof(address)))) {
+      if (0 <= m_listener)
+        ::close(m_listener);
+      throw std::runtime_error("Unable to listen on socket: " + own_address);
+    }
+  } else {
+    auto [host, port] = split_tcp_address(own_address);
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = AI_PASSIVE;
+    addrinfo *found = nullptr;
+    if (0 != ::getaddrinfo(host.c_str(), port.c_str(), &hints, &found))
+      throw std::runtime_error("Unable to resolve address: " + own_address);
+    for (addrinfo *info = found; (nullptr != info) && (0 > m_listener);
+         info = info->ai_next) {
+      m_listener = ::socket(info->ai_family, info->ai_socktype,
+                            info->ai_protocol);
+      if (0 > m_listener)
+        continue;
+      const int reuse = 1;
+      ::setsockopt(m_listener, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+      if (0 != ::bind(m_listener, info->ai_addr, info->ai_addrlen)) {
+        ::close(m_listener);
+        m_listener = -1;
+      }
+    }
+    ::freeaddrinfo(found);
+    if (0 > m_listener)
+      throw std::runtime_error("Unable to listen on address: " + own_address);
+  }
+  if (0 != ::listen(m_listener, static_cast<int>(m_addresses.size()))) {
+    ::close(m_listener);
+    throw std::runtime_error("Unable to listen on address: " + own_address);
+  }
+}
+
+RafkoSocketTransport::~RafkoSocketTransport() {
+  /*!Note: The listener is closed first, so the other workers noticing the
+   * closed connections don't connect to it again */
+  ::close(m_listener);
+  disconnect();
+  if (UnixDomain == m_protocol)
+    ::unlink(m_addresses[m_rank].c_str());
+}
+
+int RafkoSocketTransport::open_connection(const std::string &address) const {
+  if (UnixDomain == m_protocol) {
+    const sockaddr_un socket_address = unix_address(address);
+    int result = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if ((0 <= result) &&
+        (0 != ::connect(result,
+                        reinterpret_cast<const sockaddr *>(&socket_address),
+                        sizeof(socket_address)))) {
+      ::close(result);
+      result = -1;
+    }
+    return result;
+  }
+  auto [host, port] = split_tcp_address(address);
+  addrinfo hints{};
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_STREAM;
+  addrinfo *found = nullptr;
+  if (0 != ::getaddrinfo(host.c_str(), port.c_str(), &hints, &found))
+    return -1;
+  int result = -1;
+  for (addrinfo *info = found; (nullptr != info) && (0 > result);
+       info = info->ai_next) {
+    result = ::socket(info->ai_family, info->ai_socktype, info->ai_protocol);
+    if ((0 <= result) && (0 != ::connect(result, info->ai_addr,
+                                         info->ai_addrlen))) {
+      ::close(result);
+      result = -1;
+    }
+  }
+  ::freeaddrinfo(found);
+  if (0 <= result) { /* Messages are sent in one piece, there's no need to wait
+                        for them to fill up a packet */
+    const int no_delay = 1;
+    ::setsockopt(result, IPPROTO_TCP, TCP_NODELAY, &no_delay,
+                 sizeof(no_delay));
+  }
+  return result;
+}
+
+void RafkoSocketTransport::connect() {
+  disconnect();
+  if (1u == m_addresses.size())
+    return;
+  const std::chrono::steady_clock::time_point deadline =
+      std::chrono::steady_clock::now() + m_connectTimeout;
+
+  /*!Note: Connecting first doesn't block, as the connection waits in the
+   * listening queue of the next worker until it is accepted */
+  const std::string &next_address =
+      m_addresses[(m_rank + 1u) % m_addresses.size()];
+  const std::uint32_t rank = htonl(m_rank);
+  while (true) {
+    const int next = open_connection(next_address);
+    if (0 <= next) {
+      try { /* The connection might have reached a worker about to stop */
+        write_all(next, reinterpret_cast<const char *>(&rank), sizeof(rank));
+        std::lock_guard<std::mutex> my_lock(m_connectionsMutex);
+        m_next = next;
+        break;
+      } catch (const std::runtime_error &) {
+        ::close(next);
+      }
+    }
+    if (std::chrono::steady_clock::now() > deadline)
+      throw std::runtime_error("Unable to connect to the next worker: " +
+                               next_address);
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+
+  /* Accept connections until the previous worker identifies itself; Others
+   * might be left in the queue from failed attempts, or might never send
+   * anything, so the rank is waited for only for a limited time */
+  const std::uint32_t previous_rank =
+      (m_rank + m_addresses.size() - 1u) % m_addresses.size();
+  while (0 > m_previous) {
+    const std::int64_t remaining_ms =
+        std::chrono::duration_cast<std::chrono::milliseconds>(
+            deadline - std::chrono::steady_clock::now())
+            .count();
+    pollfd listening{m_listener, POLLIN, 0};
+    if ((0 >= remaining_ms) ||
+        (0 >= ::poll(&listening, 1, static_cast<int>(remaining_ms)))) {
+      disconnect();
+      throw std::runtime_error("The previous worker did not connect in time!");
+    }
+    const int accepted = ::accept(m_listener, nullptr, nullptr);
+    if (0 > accepted)
+      continue;
+    std::uint32_t accepted_rank;
+    set_receive_timeout(accepted,
+                        std::min(std::chrono::milliseconds(remaining_ms),
+                                 std::chrono::milliseconds(1000)));
+    try {
+      read_all(accepted, reinterpret_cast<char *>(&accepted_rank),
+               sizeof(accepted_rank));
+    } catch (const std::runtime_error &) {
+      ::close(accepted);
+      continue;
+    }
+    if (previous_rank == ntohl(accepted_rank)) {
+      set_receive_timeout(accepted, std::chrono::milliseconds(0));
+      std::lock_guard<std::mutex> my_lock(m_connectionsMutex);
+      m_previous = accepted;
+    } else {
+      ::close(accepted);
+    }
+  }
+}
+
+void RafkoSocketTransport::interrupt() {
+  std::lock_guard<std::mutex> my_lock(m_connectionsMutex);
+  if (0 <= m_next)
+    ::shutdown(m_next, SHUT_RDWR);
+  if (0 <= m_previous)
+    ::shutdown(m_previous, SHUT_RDWR);
+}
+
+void RafkoSocketTransport::disconnect() {
+  std::lock_guard<std::mutex> my_lock(m_connectionsMutex);
+  if (0 <= m_next)
+    ::close(m_next);
+  if (0 <= m_previous)
+    ::close(m_previous);
+  m_next = -1;
+  m_previous = -1;
+}
+
+void RafkoSocketTransport::send_to_next(const std::string &message) {
+  if (0 > m_next)
+    throw std::runtime_error("Not connected to the next worker!");
+  if (m_maxMessageSize < message.size())
+    throw std::runtime_error("Message is larger than the allowed size!");
+  const std::uint32_t size = htonl(static_cast<std::uint32_t>(message.size()));
+  write_all(m_next, reinterpret_cast<const char *>(&size), sizeof(size));
+  write_all(m_next, message.data(), message.size());
+}
+
+std::string RafkoSocketTransport::receive_from_previous() {
+  if (0 > m_previous)
+    throw std::runtime_error("Not connected to the previous worker!");
+  std::uint32_t size;
+  read_all(m_previous, reinterpret_cast<char *>(&size), sizeof(size));
+  if (m_maxMessageSize < ntohl(size))
+    throw std::runtime_error(
+        "Message from the previous worker is larger than the allowed size!");
+  std::string message(ntohl(size), '\0');
+  read_all(m_previous, message.data(), message.size());
+  return message;
+}
+
+#endif /*defined(_WIN32)*/
+
+} /* namespace rafko_gym */
@@ -17,9 +17,11 @@
 
 #include "rafko_gym/services/rafko_weight_adapter.hpp"
 
+#include <algorithm>
 #include <set>
 
 #include "rafko_mainframe/services/rafko_assertion_logger.hpp"
+#include "rafko_mainframe/services/rafko_profiler.hpp"
 #include "rafko_net/services/synapse_iterator.hpp"
 
 namespace rafko_gym {
@@ -204,120 +206,169 @@ std::uint32_t RafkoWeightAdapter::get_weight_synapse_start_index_in_partial(
           partial.weight_synapse_number(inner_neuron_index));
 }
 
+std::vector<std::uint32_t> RafkoWeightAdapter::get_weight_sources(
+    const rafko_net::PartialSolution &partial,
+    const rafko_net::RafkoNet &network) {
+  /*!Note: The weight table of a partial contains the weights of its Neurons
+   * in the order of the Neurons and their weight synapses */
+  std::vector<std::uint32_t> sources;
+  sources.reserve(partial.weight_table_size());
+  for (std::uint32_t neuron_index = partial.output_data().starts();
+       neuron_index < (partial.output_data().starts() +
+                       partial.output_data().interval_size());
+       ++neuron_index) {
+    rafko_net::SynapseIterator<>::iterate(
+        network.neuron_array(neuron_index).input_weights(),
+        [&sources](std::int32_t network_weight_index) {
+          sources.push_back(network_weight_index);
+        });
+  }
+  RFASSERT(static_cast<std::int32_t>(sources.size()) ==
+           partial.weight_table_size());
+  return sources;
+}
+
+void RafkoWeightAdapter::build_weight_slots() {
+  std::vector<std::uint32_t> slot_count(m_net.weight_table_size(), 0u);
+  std::uint32_t weight_table_start = 0u;
+  m_partialWeightSources.resize(m_solution.partial_solutions_size());
+  m_partialWeightStarts.resize(m_solution.partial_solutions_size());
+  for (std::int32_t partial_index = 0;
+       partial_index < m_solution.partial_solutions_size(); ++partial_index) {
+    m_partialWeightSources[partial_index] =
+        get_weight_sources(m_solution.partial_solutions(partial_index), m_net);
+    for (std::uint32_t network_weight_index :
+         m_partialWeightSources[partial_index])
+      ++slot_count[network_weight_index];
+    m_partialWeightStarts[partial_index] = weight_table_start;
+    weight_table_start += m_partialWeightSources[partial_index].size();
+  }
+
+  m_weightSlotStarts.resize(m_net.weight_table_size() + 1u);
+  m_weightSlotStarts[0] = 0u;
+  for (std::int32_t weight_index = 0; weight_index < m_net.weight_table_size();
+       ++weight_index)
+    m_weightSlotStarts[weight_index + 1] =
+        m_weightSlotStarts[weight_index] + slot_count[weight_index];
+  m_weightSlots.resize(weight_table_start);
+  std::fill(slot_count.begin(), slot_count.end(), 0u);
+  for (std::uint32_t partial_index = 0u;
+       partial_index < m_partialWeightSources.size(); ++partial_index) {
+    const std::vector<std::uint32_t> &sources =
+        m_partialWeightSources[partial_index];
+    for (std::uint32_t weight_index = 0u; weight_index < sources.size();
+         ++weight_index) {
+      const std::uint32_t network_weight_index = sources[weight_index];
+      m_weightSlots[m_weightSlotStarts[network_weight_index] +
+                    slot_count[network_weight_index]] = {partial_index,
+                                                         weight_index};
+      ++slot_count[network_weight_index];
+    }
+  }
+}
+
 void RafkoWeightAdapter::update_solution_with_weight(
     std::uint32_t weight_index) {
   std::lock_guard<std::mutex> my_lock(m_referenceMutex);
   RFASSERT(static_cast<std::int32_t>(weight_index) < m_net.weight_table_size());
-  const std::vector<std::pair<std::uint32_t, std::uint32_t>>
-      &relevant_partial_weights =
-          get_relevant_partial_weight_indices_for(weight_index);
-  for (const std::pair<std::uint32_t, std::uint32_t> &relevant_partial_weight :
-       relevant_partial_weights) {
-    m_solution.mutable_partial_solutions(std::get<0>(relevant_partial_weight))
-        ->set_weight_table(std::get<1>(relevant_partial_weight),
-                           m_net.weight_table(weight_index));
+  /*!Note: The propagated weights are not updated here, so the weight is still
+   * reported as changed by the next call of @update_solution_with_weights */
+  const double weight_value = m_net.weight_table(weight_index);
+  for (std::uint32_t slot_index = m_weightSlotStarts[weight_index];
+       slot_index < m_weightSlotStarts[weight_index + 1u]; ++slot_index) {
+    const auto &[partial_index, weight_index_in_partial] =
+        m_weightSlots[slot_index];
+    m_solution.mutable_partial_solutions(partial_index)
+        ->set_weight_table(weight_index_in_partial, weight_value);
   }
 }
 
-void RafkoWeightAdapter::update_solution_with_weights() {
+const WeightTableRanges &RafkoWeightAdapter::update_solution_with_weights() {
   std::lock_guard<std::mutex> my_lock(m_referenceMutex);
-  std::int32_t partial_start_index = 0;
-  while (partial_start_index < m_solution.partial_solutions_size()) {
-    if ((static_cast<std::uint32_t>(m_solution.partial_solutions_size()) <
-         (m_settings.get_max_solve_threads() / 2)) ||
-        (m_solution.partial_solutions_size() < 2)) {
-      for (std::int32_t partial_index = 0;
-           partial_index < m_solution.partial_solutions_size();
-           ++partial_index) {
-        std::uint32_t neuron_weight_synapse_starts = 0;
-        std::uint32_t inner_neuron_weight_index_starts = 0;
-        for (std::uint32_t inner_neuron_index = 0;
-             inner_neuron_index < m_solution.partial_solutions(partial_index)
-                                      .output_data()
-                                      .interval_size();
-             ++inner_neuron_index) {
-          const std::uint32_t neuron_index =
-              m_solution.partial_solutions(partial_index)
-                  .output_data()
-                  .starts() +
-              inner_neuron_index;
-          copy_weights_of_neuron_to_partial_solution(/* Take over a weight from
-                                                        one Neuron */
-                                                     neuron_index,
-                                                     *m_solution
-                                                          .mutable_partial_solutions(
-                                                              partial_index),
-                                                     inner_neuron_weight_index_starts);
-          for (std::uint32_t i = 0;
-               i < m_solution.partial_solutions(partial_index)
-                       .weight_synapse_number(inner_neuron_index);
-               ++i)
-            inner_neuron_weight_index_starts +=
-                m_solution.partial_solutions(partial_index)
-                    .weight_indices(neuron_weight_synapse_starts + i)
-                    .interval_size();
-          neuron_weight_synapse_starts +=
-              m_solution.partial_solutions(partial_index)
-                  .weight_synapse_number(inner_neuron_index);
-        }
-      }
-    } else { /* It is efficient to use multithreading */
-      m_executionThreads.start_and_block([this, partial_start_index](
-                                             std::uint32_t thread_index) {
-        const std::int32_t partial_index = partial_start_index + thread_index;
-        if (partial_index < m_solution.partial_solutions_size()) {
-          std::uint32_t neuron_weight_synapse_starts = 0;
-          std::uint32_t inner_neuron_weight_index_starts = 0;
-          for (std::uint32_t inner_neuron_index = 0;
-               inner_neuron_index < m_solution.partial_solutions(partial_index)
-                                        .output_data()
-                                        .interval_size();
-               ++inner_neuron_index) {
-            const std::uint32_t neuron_index =
-                m_solution.partial_solutions(partial_index)
-                    .output_data()
-                    .starts() +
-                inner_neuron_index;
-            copy_weights_of_neuron_to_partial_solution(/* Take over a weight
-                                                          from one Neuron */
-                                                       neuron_index,
-                                                       *m_solution
-                                                            .mutable_partial_solutions(
-                                                                partial_index),
-                                                       inner_neuron_weight_index_starts);
-            for (std::uint32_t i = 0;
-                 i < m_solution.partial_solutions(partial_index)
-                         .weight_synapse_number(inner_neuron_index);
-                 ++i)
-              inner_neuron_weight_index_starts +=
-                  m_solution.partial_solutions(partial_index)
-                      .weight_indices(neuron_weight_synapse_starts + i)
-                      .interval_size();
-            neuron_weight_synapse_starts +=
-                m_solution.partial_solutions(partial_index)
-                    .weight_synapse_number(inner_neuron_index);
-          }
-        }
-      });
+  m_changedRanges.clear();
+  const std::uint32_t weight_number = m_net.weight_table_size();
+  bool copy_everything = (m_propagatedWeights.size() != weight_number);
+  if (!copy_everything) {
+    m_changedWeights.clear();
+    for (std::uint32_t weight_index = 0u; weight_index < weight_number;
+         ++weight_index) {
+      if (m_net.weight_table(weight_index) !=
+          m_propagatedWeights[weight_index])
+        m_changedWeights.push_back(weight_index);
+    }
+    copy_everything = ((weight_number / 2u) < m_changedWeights.size());
+  }
+
+  if (copy_everything) {
+    copy_all_weights();
+    m_propagatedWeights.assign(m_net.weight_table().begin(),
+                               m_net.weight_table().end());
+    for (std::uint32_t partial_index = 0u;
+         partial_index < m_partialWeightSources.size(); ++partial_index) {
+      if (0u < m_partialWeightSources[partial_index].size())
+        m_changedRanges.push_back(
+            {partial_index, 0u,
+             static_cast<std::uint32_t>(
+                 m_partialWeightSources[partial_index].size()),
+             m_partialWeightStarts[partial_index]});
+    }
+    return m_changedRanges;
+  }
+
+  m_changedSlots.clear();
+  for (std::uint32_t weight_index : m_changedWeights) {
+    const double weight_value = m_net.weight_table(weight_index);
+    m_propagatedWeights[weight_index] = weight_value;
+    for (std::uint32_t slot_index = m_weightSlotStarts[weight_index];
+         slot_index < m_weightSlotStarts[weight_index + 1u]; ++slot_index) {
+      const auto &[partial_index, weight_index_in_partial] =
+          m_weightSlots[slot_index];
+      m_solution.mutable_partial_solutions(partial_index)
+          ->set_weight_table(weight_index_in_partial, weight_value);
+      m_changedSlots.push_back(m_weightSlots[slot_index]);
+    }
+  }
+
+  /* Merge the changed elements into continuous ranges */
+  std::sort(m_changedSlots.begin(), m_changedSlots.end());
+  for (const auto &[partial_index, weight_index_in_partial] : m_changedSlots) {
+    if ((0u < m_changedRanges.size()) &&
+        (m_changedRanges.back().partial_index == partial_index) &&
+        ((m_changedRanges.back().start + m_changedRanges.back().size) ==
+         weight_index_in_partial)) {
+      ++m_changedRanges.back().size;
+    } else {
+      m_changedRanges.push_back(
+          {partial_index, weight_index_in_partial, 1u,
+           m_partialWeightStarts[partial_index] + weight_index_in_partial});
     }
-    partial_start_index += m_executionThreads.get_number_of_threads();
-  } /* while(partial_start_index < solution.partial_solutions_size()) */
+  }
+  return m_changedRanges;
 }
 
-void RafkoWeightAdapter::copy_weights_of_neuron_to_partial_solution(
-    std::uint32_t neuron_index, rafko_net::PartialSolution &partial,
-    std::uint32_t inner_neuron_weight_index_starts)
-    const { /*!Note: After shared weight optimization, this part is to be
-               re-worked */
-  std::uint32_t weights_copied = 0;
-  rafko_net::SynapseIterator<>::iterate(
-      m_net.neuron_array(neuron_index).input_weights(),
-      [&](std::int32_t network_weight_index) {
-        partial.set_weight_table(
-            (inner_neuron_weight_index_starts + weights_copied),
-            m_net.weight_table(network_weight_index));
-        ++weights_copied;
-      });
+void RafkoWeightAdapter::copy_all_weights() {
+  const auto copy_weights_of_partial = [this](std::uint32_t partial_index) {
+    const std::vector<std::uint32_t> &sources =
+        m_partialWeightSources[partial_index];
+    double *weight_table = m_solution.mutable_partial_solutions(partial_index)
+                               ->mutable_weight_table()
+                               ->mutable_data();
+    for (std::uint32_t weight_index = 0u; weight_index < sources.size();
+         ++weight_index)
+      weight_table[weight_index] = m_net.weight_table(sources[weight_index]);
+  };
+
+  const std::uint32_t partial_number = m_partialWeightSources.size();
+  if ((partial_number < (m_settings.get_max_solve_threads() / 2u)) ||
+      (partial_number < 2u)) {
+    for (std::uint32_t partial_index = 0u; partial_index < partial_number;
+         ++partial_index)
+      copy_weights_of_partial(partial_index);
+    return;
+  }
+
+  /* It is efficient to use multithreading */
+  m_threadPool.parallel_for(0u, partial_number, copy_weights_of_partial);
 }
 
 } /* namespace rafko_gym */
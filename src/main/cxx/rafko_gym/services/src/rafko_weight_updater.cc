@@ -17,61 +17,72 @@
 
 #include "rafko_gym/services/rafko_weight_updater.hpp"
 
-#include <set>
+#include <algorithm>
+#include <stdexcept>
 
 #include "rafko_mainframe/services/rafko_assertion_logger.hpp"
-#include "rafko_net/services/synapse_iterator.hpp"
+#include "rafko_mainframe/services/rafko_profiler.hpp"
 
 namespace rafko_gym {
 
 void RafkoWeightUpdater::iterate(const std::vector<double> &gradients) {
-  calculate_velocity(gradients);
-  update_weights_with_velocity();
+  RFPROFILE_SCOPE("RafkoWeightUpdater::iterate");
+  RFASSERT(static_cast<std::int32_t>(gradients.size()) ==
+           m_network.weight_table_size());
+  std::lock_guard<std::mutex> my_lock(m_referenceMutex);
+  m_learningRate = m_settings.get_learning_rate();
+  double *weights = m_network.mutable_weight_table()->mutable_data();
+  const std::uint32_t weight_number = m_network.weight_table_size();
+  if (weight_number < s_minWeightsForThreads) {
+    update_weights(gradients, weights, 0u, weight_number);
+  } else {
+    const std::uint32_t number_of_tasks =
+        (weight_number + m_weightsToDoInOneThread - 1u) /
+        m_weightsToDoInOneThread;
+    m_threadPool.parallel_for(
+        0u, number_of_tasks,
+        [this, &gradients, weights, weight_number](std::uint32_t task_index) {
+          const std::uint32_t weight_start =
+              m_weightsToDoInOneThread * task_index;
+          const std::uint32_t weight_end = std::min(
+              (weight_start + m_weightsToDoInOneThread), weight_number);
+          update_weights(gradients, weights, weight_start, weight_end);
+        });
+  }
   m_iteration = (m_iteration + 1) % m_requiredIterationsForStep;
   m_finished = (0u == m_iteration);
 }
 
-void RafkoWeightUpdater::update_weight_with_velocity(
-    std::uint32_t weight_index, std::uint32_t weight_number) {
-  for (std::uint32_t weight_iterator = 0; weight_iterator < weight_number;
-       ++weight_iterator) {
-    m_network.set_weight_table(weight_index + weight_iterator,
-                               get_new_weight(weight_index + weight_iterator));
-  }
+std::vector<double> RafkoWeightUpdater::get_state() const {
+  std::lock_guard<std::mutex> my_lock(m_referenceMutex);
+  std::vector<double> state = {static_cast<double>(m_iteration),
+                               (m_finished ? 1.0 : 0.0)};
+  state.insert(state.end(), m_currentVelocity.begin(),
+               m_currentVelocity.end());
+  return state;
 }
 
-void RafkoWeightUpdater::calculate_velocity(
-    const std::vector<double> &gradients) {
-  m_executionThreads.start_and_block([this,
-                                      &gradients](std::uint32_t thread_index) {
-    const std::uint32_t weight_index_start =
-        m_weightsToDoInOneThread * thread_index;
-    const std::uint32_t weights_to_do_in_this_thread =
-        std::min(m_weightsToDoInOneThread,
-                 static_cast<std::uint32_t>(
-                     m_network.weight_table_size() -
-                     std::min(m_network.weight_table_size(),
-                              static_cast<std::int32_t>(weight_index_start))));
-    for (std::uint32_t weight_iterator = 0;
-         weight_iterator < weights_to_do_in_this_thread; ++weight_iterator) {
-      m_currentVelocity[weight_index_start + weight_iterator] =
-          get_new_velocity(weight_index_start + weight_iterator, gradients);
-    }
-  });
+void RafkoWeightUpdater::set_state(const std::vector<double> &state) {
+  std::lock_guard<std::mutex> my_lock(m_referenceMutex);
+  if (state.size() < get_base_state_size())
+    throw std::runtime_error("Weight updater state size mismatch!");
+  m_iteration = static_cast<std::uint32_t>(state[0]);
+  m_finished = (0.0 != state[1]);
+  std::copy(state.begin() + 2u, state.begin() + get_base_state_size(),
+            m_currentVelocity.begin());
 }
 
-void RafkoWeightUpdater::update_weights_with_velocity() {
-  std::lock_guard<std::mutex> my_lock(m_referenceMutex);
-  m_executionThreads.start_and_block([this](std::uint32_t thread_index) {
-    std::int32_t weight_index_start = m_weightsToDoInOneThread * thread_index;
-    if (weight_index_start < m_network.weight_table_size()) {
-      std::uint32_t weight_index = (m_weightsToDoInOneThread * thread_index);
-      update_weight_with_velocity(
-          weight_index,
-          std::min(m_weightsToDoInOneThread,
-                   (m_network.weight_table_size() - weight_index)));
-    }
-  });
+void RafkoWeightUpdater::update_weights(const std::vector<double> &gradients,
+                                        double *weights,
+                                        std::uint32_t weight_start,
+                                        std::uint32_t weight_end) {
+  const double learning_rate = m_learningRate;
+  double *velocity = m_currentVelocity.data();
+  for (std::uint32_t weight_index = weight_start; weight_index < weight_end;
+       ++weight_index) {
+    velocity[weight_index] = -gradients[weight_index] * learning_rate;
+    weights[weight_index] += velocity[weight_index];
+  }
 }
 
 } /* namespace rafko_gym */
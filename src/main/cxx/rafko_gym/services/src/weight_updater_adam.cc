@@ -16,37 +16,72 @@
  */
 #include "rafko_gym/services/weight_updater_adam.hpp"
 
+#include <algorithm>
+#include <stdexcept>
+
 namespace rafko_gym {
 
 void RafkoWeightUpdaterAdam::iterate(const std::vector<double> &gradients) {
-  for (std::int32_t weight_index = 0;
-       weight_index < m_network.weight_table_size(); ++weight_index) {
-    m_mean[weight_index] =
-        ((m_settings.get_beta() * m_mean[weight_index]) +
-         ((((1.0) - m_settings.get_beta()) * gradients[weight_index])));
-    m_variance[weight_index] =
-        ((m_settings.get_beta_2() * m_variance[weight_index]) +
-         ((((1.0) - m_settings.get_beta_2()) *
-           std::pow(gradients[weight_index], (2.0)))));
-  }
+  m_beta = m_settings.get_beta();
+  m_beta2 = m_settings.get_beta_2();
+  m_epsilon = m_settings.get_epsilon();
+  m_meanCorrection =
+      (1.0) - std::pow(m_beta2, static_cast<double>(m_iterationCount));
+  m_varianceCorrection =
+      (1.0) - std::pow(m_beta, static_cast<double>(m_iterationCount));
   RafkoWeightUpdater::iterate(gradients);
   ++m_iterationCount;
 }
 
-double RafkoWeightUpdaterAdam::get_new_velocity(
-    std::uint32_t weight_index,
-    const std::vector<double> & /*gradients*/) const {
-  /*!Note: the variable moment contains the processed value of the gradients, so
-   * no need to use it here again. */
-  return -(
-      (m_settings.get_learning_rate() /
-       (std::sqrt(m_variance[weight_index] /
-                  ((1.0) - std::pow(m_settings.get_beta(),
-                                    static_cast<double>(m_iterationCount)))) +
-        m_settings.get_epsilon())) *
-      (m_mean[weight_index] /
-       ((1.0) - std::pow(m_settings.get_beta_2(),
-                         static_cast<double>(m_iterationCount)))));
+std::vector<double> RafkoWeightUpdaterAdam::get_state() const {
+  std::vector<double> state = RafkoWeightUpdater::get_state();
+  state.push_back(static_cast<double>(m_iterationCount));
+  state.insert(state.end(), m_mean.begin(), m_mean.end());
+  state.insert(state.end(), m_variance.begin(), m_variance.end());
+  return state;
+}
+
+void RafkoWeightUpdaterAdam::set_state(const std::vector<double> &state) {
+  const std::uint32_t own_state_start = get_base_state_size();
+  if (state.size() !=
+      (own_state_start + 1u + m_mean.size() + m_variance.size()))
+    throw std::runtime_error("Weight updater state size mismatch!");
+  RafkoWeightUpdater::set_state(state);
+  m_iterationCount = static_cast<std::uint32_t>(state[own_state_start]);
+  std::vector<double>::const_iterator mean_start =
+      state.begin() + own_state_start + 1u;
+  std::copy(mean_start, mean_start + m_mean.size(), m_mean.begin());
+  std::copy(mean_start + m_mean.size(), state.end(), m_variance.begin());
+}
+
+void RafkoWeightUpdaterAdam::update_weights(
+    const std::vector<double> &gradients, double *weights,
+    std::uint32_t weight_start, std::uint32_t weight_end) {
+  const double beta = m_beta;
+  const double beta_2 = m_beta2;
+  const double epsilon = m_epsilon;
+  const double learning_rate = m_learningRate;
+  const double mean_correction = m_meanCorrection;
+  const double variance_correction = m_varianceCorrection;
+  double *mean = m_mean.data();
+  double *variance = m_variance.data();
+  double *velocity = m_currentVelocity.data();
+  for (std::uint32_t weight_index = weight_start; weight_index < weight_end;
+       ++weight_index) {
+    const double gradient = gradients[weight_index];
+    mean[weight_index] =
+        ((beta * mean[weight_index]) + ((1.0 - beta) * gradient));
+    variance[weight_index] = ((beta_2 * variance[weight_index]) +
+                              ((1.0 - beta_2) * (gradient * gradient)));
+    /*!Note: the variance moment contains the processed value of the gradients,
+     * so no need to use it here again. */
+    velocity[weight_index] =
+        -((learning_rate /
+           (std::sqrt(variance[weight_index] / variance_correction) +
+            epsilon)) *
+          (mean[weight_index] / mean_correction));
+    weights[weight_index] += velocity[weight_index];
+  }
 }
 
 } /* namespace rafko_gym */
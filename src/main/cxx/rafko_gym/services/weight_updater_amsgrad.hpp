@@ -33,13 +33,21 @@ public:
   ~RafkoWeightUpdaterAMSGrad() = default;
 
   void iterate(const std::vector<double> &gradients) override;
+  std::vector<double> get_state() const override;
+  void set_state(const std::vector<double> &state) override;
 
 protected:
-  double get_new_velocity(std::uint32_t weight_index,
-                          const std::vector<double> &gradients) const override;
+  void update_weights(const std::vector<double> &gradients, double *weights,
+                      std::uint32_t weight_start,
+                      std::uint32_t weight_end) override;
 
 private:
   std::uint32_t m_iterationCount = 1u;
+  double m_beta = 0.0;
+  double m_beta2 = 0.0;
+  double m_epsilon = 0.0;
+  double m_meanCorrection = 1.0;
+  double m_varianceCorrection = 1.0;
   std::vector<double> m_mean;
   std::vector<double> m_maxVariance;
 };
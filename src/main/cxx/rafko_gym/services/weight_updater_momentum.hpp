@@ -20,6 +20,8 @@
 
 #include "rafko_gym/services/rafko_weight_updater.hpp"
 
+#include <algorithm>
+#include <stdexcept>
 #include <vector>
 
 namespace rafko_gym {
@@ -32,27 +34,47 @@ public:
         m_previousUpdate(rafko_net.weight_table_size(), (0.0)) {}
 
   void iterate(const std::vector<double> &gradients) override {
-    std::uint32_t weight_index = 0;
-    std::transform(
-        m_previousUpdate.begin(), m_previousUpdate.end(),
-        m_previousUpdate.begin(),
-        [this, &gradients, &weight_index](const double &previous_update) {
-          return ((previous_update * m_settings.get_gamma()) +
-                  (gradients[weight_index++] *
-                   m_settings.get_learning_rate(m_iteration)));
-        });
+    m_gamma = m_settings.get_gamma();
+    m_iterationLearningRate = m_settings.get_learning_rate(m_iteration);
     RafkoWeightUpdater::iterate(gradients);
   }
 
+  std::vector<double> get_state() const override {
+    std::vector<double> state = RafkoWeightUpdater::get_state();
+    state.insert(state.end(), m_previousUpdate.begin(), m_previousUpdate.end());
+    return state;
+  }
+
+  void set_state(const std::vector<double> &state) override {
+    if (state.size() != (get_base_state_size() + m_previousUpdate.size()))
+      throw std::runtime_error("Weight updater state size mismatch!");
+    RafkoWeightUpdater::set_state(state);
+    std::copy(state.begin() + get_base_state_size(), state.end(),
+              m_previousUpdate.begin());
+  }
+
 protected:
-  double
-  get_new_velocity(std::uint32_t weight_index,
-                   const std::vector<double> & /*gradients*/) const override {
-    return -m_previousUpdate[weight_index];
+  void update_weights(const std::vector<double> &gradients, double *weights,
+                      std::uint32_t weight_start,
+                      std::uint32_t weight_end) override {
+    const double gamma = m_gamma;
+    const double learning_rate = m_iterationLearningRate;
+    double *previous_update = m_previousUpdate.data();
+    double *velocity = m_currentVelocity.data();
+    for (std::uint32_t weight_index = weight_start; weight_index < weight_end;
+         ++weight_index) {
+      previous_update[weight_index] =
+          ((previous_update[weight_index] * gamma) +
+           (gradients[weight_index] * learning_rate));
+      velocity[weight_index] = -previous_update[weight_index];
+      weights[weight_index] += velocity[weight_index];
+    }
   }
 
 private:
   std::vector<double> m_previousUpdate;
+  double m_gamma = 0.0;
+  double m_iterationLearningRate = 0.0;
 };
 
 } /* namespace rafko_gym */
@@ -20,6 +20,8 @@
 
 #include "rafko_gym/services/rafko_weight_updater.hpp"
 
+#include <algorithm>
+#include <stdexcept>
 #include <vector>
 
 namespace rafko_gym {
@@ -32,34 +34,39 @@ public:
         m_lookAheadWeightDelta(rafko_net.weight_table_size(), 0.0),
         m_previousUpdate(rafko_net.weight_table_size(), 0.0) {}
 
-  void iterate(const std::vector<double> &gradients) {
+  void iterate(const std::vector<double> &gradients) override {
+    /*!Note: The weights are updated based on the state before the iteration,
+     * while the momentum terms are updated based on the state after it */
+    const std::uint32_t next_iteration =
+        (m_iteration + 1u) % m_requiredIterationsForStep;
+    m_gamma = m_settings.get_gamma();
+    m_wasFinished = is_finished();
+    m_iterationLearningRate = m_settings.get_learning_rate(m_iteration);
+    m_willFinish = (0u == next_iteration);
+    m_nextLearningRate = m_settings.get_learning_rate(next_iteration);
     RafkoWeightUpdater::iterate(gradients);
+  }
 
-    std::uint32_t weight_index = 0;
-    if (!is_finished()) { /* Calculating the look ahead term, previous update is
-                             already available! */
-      std::transform(
-          m_previousUpdate.begin(), m_previousUpdate.end(),
-          m_lookAheadWeightDelta.begin(),
-          [this, &gradients, &weight_index](const double &previous_update) {
-            ++weight_index;
-            return -((previous_update * m_settings.get_gamma()) +
-                     (gradients[weight_index - 1u] *
-                      m_settings.get_learning_rate(m_iteration)));
-          });
-    } else {
-      /* Weight updater iteration is finished. gradient is for the "Look ahead"
-       * weight vector */
-      std::transform(
-          m_previousUpdate.begin(), m_previousUpdate.end(),
-          m_previousUpdate.begin(),
-          [this, &gradients, &weight_index](const double &previous_update) {
-            ++weight_index;
-            return -((previous_update * m_settings.get_gamma()) +
-                     (gradients[weight_index - 1u] *
-                      m_settings.get_learning_rate(m_iteration)));
-          });
-    }
+  std::vector<double> get_state() const override {
+    std::vector<double> state = RafkoWeightUpdater::get_state();
+    state.insert(state.end(), m_lookAheadWeightDelta.begin(),
+                 m_lookAheadWeightDelta.end());
+    state.insert(state.end(), m_previousUpdate.begin(), m_previousUpdate.end());
+    return state;
+  }
+
+  void set_state(const std::vector<double> &state) override {
+    if (state.size() != (get_base_state_size() + m_lookAheadWeightDelta.size() +
+                         m_previousUpdate.size()))
+      throw std::runtime_error("Weight updater state size mismatch!");
+    RafkoWeightUpdater::set_state(state);
+    std::vector<double>::const_iterator look_ahead_start =
+        state.begin() + get_base_state_size();
+    std::copy(look_ahead_start,
+              look_ahead_start + m_lookAheadWeightDelta.size(),
+              m_lookAheadWeightDelta.begin());
+    std::copy(look_ahead_start + m_lookAheadWeightDelta.size(), state.end(),
+              m_previousUpdate.begin());
   }
 
   /* void start() override{
@@ -68,27 +75,45 @@ public:
   } */
 
 protected:
-  double get_new_velocity(std::uint32_t weight_index,
-                          const std::vector<double> &gradients) const override {
-    if (!is_finished()) { /* Not finished yet, add the look ahead weight update
-                           */
-      return -((m_previousUpdate[weight_index] * m_settings.get_gamma()) +
-               (gradients[weight_index] *
-                m_settings.get_learning_rate(m_iteration)));
+  void update_weights(const std::vector<double> &gradients, double *weights,
+                      std::uint32_t weight_start,
+                      std::uint32_t weight_end) override {
+    const double gamma = m_gamma;
+    const double learning_rate = m_iterationLearningRate;
+    const double next_learning_rate = m_nextLearningRate;
+    /* Not finished yet, add the look ahead weight update; otherwise revert
+     * lookahead and apply its gradient update */
+    const double look_ahead_revert = (m_wasFinished ? 1.0 : 0.0);
+    double *look_ahead = m_lookAheadWeightDelta.data();
+    double *previous_update = m_previousUpdate.data();
+    double *velocity = m_currentVelocity.data();
+    for (std::uint32_t weight_index = weight_start; weight_index < weight_end;
+         ++weight_index) {
+      velocity[weight_index] =
+          -((-look_ahead[weight_index] * look_ahead_revert) +
+            (previous_update[weight_index] * gamma) +
+            (gradients[weight_index] * learning_rate));
+      weights[weight_index] += velocity[weight_index];
+    }
+    /* Calculating the look ahead term while the step is not finished,
+     * otherwise the gradient is for the "Look ahead" weight vector */
+    double *momentum_term = (m_willFinish ? previous_update : look_ahead);
+    for (std::uint32_t weight_index = weight_start; weight_index < weight_end;
+         ++weight_index) {
+      momentum_term[weight_index] =
+          -((previous_update[weight_index] * gamma) +
+            (gradients[weight_index] * next_learning_rate));
     }
-
-    return -(/* An iteration is finished! revert lookahead and apply its
-                gradient update  */
-             -m_lookAheadWeightDelta[weight_index] /* revert look ahead update
-                                                      and update the weights */
-             + (m_previousUpdate[weight_index] * m_settings.get_gamma()) +
-             (gradients[weight_index] *
-              m_settings.get_learning_rate(m_iteration)));
   }
 
 private:
   std::vector<double> m_lookAheadWeightDelta;
   std::vector<double> m_previousUpdate;
+  double m_gamma = 0.0;
+  bool m_wasFinished = false;
+  double m_iterationLearningRate = 0.0;
+  bool m_willFinish = false;
+  double m_nextLearningRate = 0.0;
 };
 
 } /* namespace rafko_gym */
@@ -1,7 +1,343 @@
 
 #include "rafko_global.hpp"
 
-int main() {
-  /* ___SOON___ */
+#include <pthread.h>
+#include <signal.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <grpcpp/grpcpp.h>
+
+#include "rafko_protocol/deep_learning_service.grpc.pb.h"
+#include "rafko_protocol/deep_learning_service.pb.h"
+#include "rafko_protocol/rafko_net.pb.h"
+
+#include "rafko_mainframe/services/rafko_slot_scheduler.hpp"
+
+namespace rafko_mainframe {
+
+/**
+ * @brief      The gRPC front end of the deep learning service. Calls are
+ * served asynchronously from completion queues, each polled by its own
+ * thread; every call is a handler object which is passed to gRPC as the tag of
+ * its operations, and advanced whenever one of them completes. The slots
+ * themselves are owned and scheduled by a @RafkoSlotScheduler.
+ */
+class RafkoDeepLearningMainframe {
+public:
+  /**
+   * @brief      Starts the server
+   *
+   * @param      address            The address to listen on
+   * @param      queue_count        The number of completion queues ( and
+   * threads polling them ) to serve the calls with
+   * @param      training_workers   The number of threads to train the
+   * optimizer slots with
+   */
+  RafkoDeepLearningMainframe(const std::string &address,
+                             std::uint32_t queue_count,
+                             std::uint32_t training_workers)
+      : m_scheduler(training_workers) {
+    grpc::ServerBuilder builder;
+    builder.AddListeningPort(address, grpc::InsecureServerCredentials());
+    builder.RegisterService(&m_service);
+    for (std::uint32_t queue_index = 0u; queue_index < queue_count;
+         ++queue_index)
+      m_queues.push_back(builder.AddCompletionQueue());
+    m_server = builder.BuildAndStart();
+    if (!m_server)
+      throw std::runtime_error("Unable to start the service on " + address);
+
+    for (std::unique_ptr<grpc::ServerCompletionQueue> &queue : m_queues) {
+      listen(*queue);
+      m_queueThreads.emplace_back(&RafkoDeepLearningMainframe::serve, this,
+                                  std::ref(*queue));
+    }
+  }
+
+  ~RafkoDeepLearningMainframe() { shutdown(); }
+
+  /**
+   * @brief      Cancels the ongoing calls and stops the server; the
+   * completion queues are drained before the function returns
+   */
+  void shutdown() {
+    if (m_queueThreads.empty())
+      return;
+    m_server->Shutdown();
+    for (std::unique_ptr<grpc::ServerCompletionQueue> &queue : m_queues)
+      queue->Shutdown();
+    for (std::thread &thread : m_queueThreads)
+      thread.join();
+    m_queueThreads.clear();
+  }
+
+private:
+  using AsyncService = RafkoDeepLearning::AsyncService;
+
+  /**
+   * @brief      A call in progress, advanced by the completion queue thread
+   * whenever an operation of the call completes
+   */
+  class CallHandler {
+  public:
+    virtual ~CallHandler() = default;
+
+    /**
+     * @brief      Continues the call after its last operation completed
+     *
+     * @param      ok    The result of the completed operation
+     */
+    virtual void proceed(bool ok) = 0;
+  };
+
+  /**
+   * @brief      Serves one call of an unary rpc; a new handler is created to
+   * wait for the next call as soon as this one arrives
+   *
+   * @tparam     Request    The request type of the rpc
+   * @tparam     Response   The response type of the rpc
+   */
+  template <typename Request, typename Response>
+  class UnaryCall : public CallHandler {
+  public:
+    using RequestMethod = void (AsyncService::*)(
+        grpc::ServerContext *, Request *,
+        grpc::ServerAsyncResponseWriter<Response> *, grpc::CompletionQueue *,
+        grpc::ServerCompletionQueue *, void *);
+    using Processor = std::function<Response(const Request &)>;
+
+    UnaryCall(AsyncService &service, grpc::ServerCompletionQueue &queue,
+              RequestMethod method, Processor processor)
+        : m_service(service), m_queue(queue), m_method(method),
+          m_processor(processor), m_writer(&m_context) {
+      (m_service.*m_method)(&m_context, &m_request, &m_writer, &m_queue,
+                            &m_queue, this);
+    }
+
+    void proceed(bool ok) override {
+      if (m_finished || !ok) {
+        delete this;
+        return;
+      }
+      new UnaryCall(m_service, m_queue, m_method, m_processor);
+      m_finished = true;
+      Response response;
+      try {
+        response = m_processor(m_request);
+      } catch (...) {
+        m_writer.FinishWithError(status_of(std::current_exception()), this);
+        return;
+      }
+      m_writer.Finish(response, grpc::Status::OK, this);
+    }
+
+  private:
+    AsyncService &m_service;
+    grpc::ServerCompletionQueue &m_queue;
+    const RequestMethod m_method;
+    const Processor m_processor;
+    grpc::ServerContext m_context;
+    grpc::ServerAsyncResponseWriter<Response> m_writer;
+    Request m_request;
+    bool m_finished = false;
+  };
+
+  /**
+   * @brief      Serves one stream of @request_action: the requests are read
+   * one after another, and the response of each is written back before the
+   * next one is read. Responses may be written from the dedicated thread of a
+   * slot, as the scheduler provides them.
+   */
+  class ActionStream : public CallHandler {
+  public:
+    ActionStream(AsyncService &service, grpc::ServerCompletionQueue &queue,
+                 RafkoSlotScheduler &scheduler)
+        : m_service(service), m_queue(queue), m_scheduler(scheduler),
+          m_stream(&m_context) {
+      m_service.Requestrequest_action(&m_context, &m_stream, &m_queue, &m_queue,
+                                      this);
+    }
+
+    void proceed(bool ok) override {
+      switch (m_state) {
+      case State::connecting:
+        if (!ok) {
+          delete this;
+          return;
+        }
+        new ActionStream(m_service, m_queue, m_scheduler);
+        read_next();
+        break;
+      case State::reading:
+        if (!ok) { /* The client finished sending requests */
+          finish(grpc::Status::OK);
+          break;
+        }
+        /*!Note: The object might be finished by the callback by the time
+         * the request returns, so it's not to be touched afterwards */
+        m_scheduler.request(
+            m_request, [this](const SlotResponse &response,
+                              std::exception_ptr error) {
+              if (error) {
+                finish(status_of(error));
+              } else {
+                m_state = State::writing;
+                m_response = response;
+                m_stream.Write(m_response, this);
+              }
+            });
+        break;
+      case State::writing:
+        if (ok)
+          read_next();
+        else
+          finish(grpc::Status(grpc::StatusCode::CANCELLED,
+                              "Unable to write response"));
+        break;
+      case State::finishing:
+        delete this;
+        break;
+      }
+    }
+
+  private:
+    enum class State { connecting, reading, writing, finishing };
+    AsyncService &m_service;
+    grpc::ServerCompletionQueue &m_queue;
+    RafkoSlotScheduler &m_scheduler;
+    grpc::ServerContext m_context;
+    grpc::ServerAsyncReaderWriter<SlotResponse, SlotRequest> m_stream;
+    SlotRequest m_request;
+    SlotResponse m_response;
+    State m_state = State::connecting;
+
+    void read_next() {
+      m_state = State::reading;
+      m_stream.Read(&m_request, this);
+    }
+
+    void finish(const grpc::Status &status) {
+      m_state = State::finishing;
+      m_stream.Finish(status, this);
+    }
+  };
+
+  RafkoSlotScheduler m_scheduler;
+  AsyncService m_service;
+  std::vector<std::unique_ptr<grpc::ServerCompletionQueue>> m_queues;
+  std::unique_ptr<grpc::Server> m_server;
+  std::vector<std::thread> m_queueThreads;
+
+  /**
+   * @brief      Translates the exception a call failed with into a status
+   */
+  static grpc::Status status_of(std::exception_ptr error) {
+    try {
+      std::rethrow_exception(error);
+    } catch (const std::exception &exception) {
+      return grpc::Status(grpc::StatusCode::FAILED_PRECONDITION,
+                          exception.what());
+    } catch (...) {
+      return grpc::Status(grpc::StatusCode::UNKNOWN, "Unknown error");
+    }
+  }
+
+  /**
+   * @brief      Creates a handler for every rpc of the service to wait for
+   * calls on the given completion queue
+   */
+  void listen(grpc::ServerCompletionQueue &queue) {
+    new UnaryCall<ServiceSlot, SlotResponse>(
+        m_service, queue, &AsyncService::Requestadd_slot,
+        [this](const ServiceSlot &request) {
+          return m_scheduler.add_slot(request);
+        });
+    new UnaryCall<ServiceSlot, SlotResponse>(
+        m_service, queue, &AsyncService::Requestupdate_slot,
+        [this](const ServiceSlot &request) {
+          return m_scheduler.update_slot(request);
+        });
+    new UnaryCall<SlotRequest, SlotResponse>(
+        m_service, queue, &AsyncService::Requestping,
+        [this](const SlotRequest &request) {
+          std::shared_ptr<RafkoServiceSlot> slot =
+              m_scheduler.get_slot(request.target_slot_id());
+          SlotResponse response;
+          response.set_slot_id(slot->get_id());
+          response.set_slot_state(slot->get_state());
+          return response;
+        });
+    new UnaryCall<BuildNetworkRequest, SlotResponse>(
+        m_service, queue, &AsyncService::Requestbuild_network,
+        [this](const BuildNetworkRequest &request) {
+          std::shared_ptr<RafkoServiceSlot> slot =
+              m_scheduler.get_slot(request.target_slot_id());
+          SlotResponse response;
+          response.set_slot_id(slot->get_id());
+          response.set_slot_state(slot->build_network(request));
+          return response;
+        });
+    new UnaryCall<SlotRequest, SlotInfo>(
+        m_service, queue, &AsyncService::Requestget_info,
+        [this](const SlotRequest &request) {
+          return m_scheduler.get_slot(request.target_slot_id())
+              ->get_info(request.request_bitstring());
+        });
+    new UnaryCall<SlotRequest, rafko_net::RafkoNet>(
+        m_service, queue, &AsyncService::Requestget_network,
+        [this](const SlotRequest &request) {
+          return m_scheduler.get_slot(request.target_slot_id())->get_network();
+        });
+    new ActionStream(m_service, queue, m_scheduler);
+  }
+
+  /**
+   * @brief      Advances the calls whenever one of their operations complete
+   * on the given queue, until the queue is shut down
+   */
+  void serve(grpc::ServerCompletionQueue &queue) {
+    void *tag;
+    bool ok;
+    while (queue.Next(&tag, &ok))
+      static_cast<CallHandler *>(tag)->proceed(ok);
+  }
+};
+
+} /* namespace rafko_mainframe */
+
+/**
+ * @brief      Starts the deep learning service and serves it until the process
+ * is interrupted or terminated.
+ *
+ * usage: rafko_deep_learning_mainframe [address] [training workers]
+ */
+int main(int argc, char **argv) {
+  const std::string address = (1 < argc) ? argv[1] : "0.0.0.0:50051";
+  const std::uint32_t training_workers =
+      (2 < argc) ? static_cast<std::uint32_t>(std::max(1, std::atoi(argv[2])))
+                 : std::max(1u, std::thread::hardware_concurrency());
+
+  /*!Note: The signals are blocked before any thread starts, so every thread
+   * inherits the mask and only the main thread receives them */
+  sigset_t signals;
+  sigemptyset(&signals);
+  sigaddset(&signals, SIGINT);
+  sigaddset(&signals, SIGTERM);
+  pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+  rafko_mainframe::RafkoDeepLearningMainframe mainframe(address, 2u,
+                                                        training_workers);
+  int received_signal;
+  sigwait(&signals, &received_signal);
+  mainframe.shutdown();
   return 0;
 }
@@ -68,6 +68,28 @@ public:
     return m_droputProbability;
   }
 
+  constexpr rafko_gym::Autodiff_modes get_autodiff_mode() const {
+    return m_autodiffMode;
+  }
+
+  constexpr std::uint32_t get_backpropagation_truncation() const {
+    return m_backpropagationTruncation;
+  }
+
+  constexpr bool get_single_precision_derivatives() const {
+    return m_singlePrecisionDerivatives;
+  }
+
+  constexpr bool get_shared_weight_storage() const {
+    return m_sharedWeightStorage;
+  }
+
+  constexpr bool get_parallel_sequences() const { return m_parallelSequences; }
+
+  constexpr rafko_net::Inference_precision get_inference_precision() const {
+    return m_inferencePrecision;
+  }
+
   std::uint32_t get_minibatch_size() const { return m_hypers.minibatch_size(); }
 
   std::uint32_t get_memory_truncation() const {
@@ -226,6 +248,72 @@ public:
     return *this;
   }
 
+  constexpr RafkoSettings &set_autodiff_mode(rafko_gym::Autodiff_modes mode) {
+    m_autodiffMode = mode;
+    return *this;
+  }
+
+  /**
+   * @brief      Sets the number of past runs the reverse mode autodiff
+   * propagates the adjoints back to in each run. 0 means the whole sequence.
+   */
+  constexpr RafkoSettings &
+  set_backpropagation_truncation(std::uint32_t backpropagation_truncation) {
+    m_backpropagationTruncation = backpropagation_truncation;
+    return *this;
+  }
+
+  /**
+   * @brief      Sets whether the forward mode autodiff stores the per weight
+   * derivatives of its operations in single precision, halving the memory
+   * needed for them at the cost of precision.
+   */
+  constexpr RafkoSettings &
+  set_single_precision_derivatives(bool single_precision) {
+    m_singlePrecisionDerivatives = single_precision;
+    return *this;
+  }
+
+  /**
+   * @brief      Sets whether the CPU solvers built afterwards read the weights
+   * directly from the network, so weight updates are visible to them without
+   * copying the weights into the partial solutions. The weight tables of the
+   * solution are then only updated on demand, e.g. before serializing it.
+   */
+  constexpr RafkoSettings &set_shared_weight_storage(bool shared) {
+    m_sharedWeightStorage = shared;
+    return *this;
+  }
+
+  /**
+   * @brief      Sets whether the autodiff optimizers built afterwards process
+   * the sequences of a minibatch in parallel. Every processing thread gets its
+   * own copy of the operations and their buffers, runs whole sequences with
+   * them, and the derivatives of every sequence in the minibatch are averaged
+   * at the end of the iteration. The values and derivatives of the last run
+   * are then not available from the optimizer itself.
+   */
+  constexpr RafkoSettings &set_parallel_sequences(bool parallel) {
+    m_parallelSequences = parallel;
+    return *this;
+  }
+
+  /**
+   * @brief      Sets the precision the CPU solvers built afterwards use for
+   * inference. Reduced precision solvers keep a single precision copy of the
+   * weights, which is refreshed through
+   * SolutionSolver::Factory::refresh_actual_solution_weights or
+   * SolutionSolver::refresh_weights after the weights change. The rounding
+   * modes keep the activations in double precision memory, only rounded to
+   * single precision, so they don't reduce the activation bandwidth;
+   * SolutionSolver::solve_batch always accumulates in double precision.
+   */
+  constexpr RafkoSettings &
+  set_inference_precision(rafko_net::Inference_precision precision) {
+    m_inferencePrecision = precision;
+    return *this;
+  }
+
   RafkoSettings() {
     m_hypers.set_learning_rate((1e-6));
     m_hypers.set_minibatch_size(64);
@@ -262,6 +350,14 @@ private:
   std::vector<std::pair<std::uint32_t, double>> m_learningRateWithDecay;
   std::vector<std::pair<std::uint32_t, double>> m_learningRateDecay;
   double m_droputProbability = (0.2);
+  rafko_gym::Autodiff_modes m_autodiffMode =
+      rafko_gym::Autodiff_modes::autodiff_mode_forward;
+  std::uint32_t m_backpropagationTruncation = 0u;
+  bool m_singlePrecisionDerivatives = false;
+  bool m_sharedWeightStorage = false;
+  bool m_parallelSequences = false;
+  rafko_net::Inference_precision m_inferencePrecision =
+      rafko_net::Inference_precision::inference_precision_double;
 
   /**
    * @brief      Calculates the learning rates for different iteration indices
@@ -27,6 +27,7 @@
 #include "rafko_gym/models/rafko_objective.hpp"
 #include "rafko_gym/services/updater_factory.hpp"
 #include "rafko_net/services/solution_solver.hpp"
+#include "rafko_utilities/services/work_stealing_pool.hpp"
 
 #include "rafko_mainframe/services/rafko_assertion_logger.hpp"
 #include "rafko_mainframe/services/rafko_context.hpp"
@@ -60,7 +61,11 @@ public:
 
   void refresh_solution_weights() override {
     RFASSERT_LOG("Refreshing Solution weights in CPU context..");
-    m_solverFactory.refresh_actual_solution_weights();
+    if (m_settings->get_shared_weight_storage()) /* the solver reads the
+                                                    network weights */
+      m_agent->refresh_weights();
+    else /* refreshes the weights of the built solvers too */
+      m_solverFactory.refresh_actual_solution_weights();
   }
 
   void set_network_weight(std::uint32_t weight_index,
@@ -141,7 +146,8 @@ private:
   std::shared_ptr<rafko_gym::RafkoObjective> m_objective;
   std::shared_ptr<rafko_gym::RafkoWeightUpdater> m_weightUpdater;
 
-  rafko_utilities::ThreadGroup m_executionThreads;
+  rafko_utilities::WorkStealingPool &m_threadPool;
+  const std::uint32_t m_threadNumber; /* The number of agent threads used */
   std::vector<std::vector<double>>
       m_neuronOutputsToEvaluate; /* for each feature array inside each sequence
                                     inside each thread in one evaluation
@@ -149,6 +155,62 @@ private:
 
   std::uint32_t m_usedSequenceTruncation;
   std::uint32_t m_usedMinibatchSize;
+  std::uint32_t m_sequencesInBatch; /* The maximum number of sequences solved
+                                       together in one thread */
+  std::vector<std::vector<double>> m_batchInputs;  /* One for each thread */
+  std::vector<std::vector<double>> m_batchOutputs; /* One for each thread */
+
+  /**
+   * @brief      Updates the size of the batches and the size of the buffers
+   * depending on them based on the data set and the settings
+   */
+  void refresh_batch_buffers();
+
+  /**
+   * @brief      Solves the given sequences of the data set in batches of the
+   * given size, distributed dynamically between the threads of the agent, so a
+   * slow batch doesn't hold back the others
+   *
+   * @param[in]  sequence_start     The first sequence to solve
+   * @param[in]  sequence_count     The number of sequences to solve
+   * @param      output             The buffer to store the network output into
+   * @param[in]  batch_size         The maximum number of sequences in a batch
+   */
+  void solve_sequences_in_parallel(std::uint32_t sequence_start,
+                                   std::uint32_t sequence_count,
+                                   std::vector<std::vector<double>> &output,
+                                   std::uint32_t batch_size);
+
+  /**
+   * @brief      Solves the given sequences of the data set in one batch
+   *
+   * @param[in]  sequence_start     The first sequence to solve
+   * @param[in]  sequence_count     The number of sequences to solve
+   * @param      output             The buffer to store the network output into
+   * @param[in]  output_start       The index inside @output to store the
+   * output of the first label of the first sequence into
+   * @param[in]  thread_index       The index of the thread to use
+   */
+  void solve_sequences(std::uint32_t sequence_start,
+                       std::uint32_t sequence_count,
+                       std::vector<std::vector<double>> &output,
+                       std::uint32_t output_start, std::uint32_t thread_index);
+
+  /**
+   * @brief      Solves the given sequence of the data set sample by sample in
+   * the Neuron memory of the given thread, so that the state of the run is
+   * available through the memory of the agent afterwards
+   *
+   * @param[in]  sequence_index     The sequence to solve
+   * @param      output             The buffer to store the network output into
+   * @param[in]  output_start       The index inside @output to store the
+   * output of the first label of the sequence into
+   * @param[in]  thread_index       The index of the thread to use
+   */
+  void solve_sequence_in_memory(std::uint32_t sequence_index,
+                                std::vector<std::vector<double>> &output,
+                                std::uint32_t output_start,
+                                std::uint32_t thread_index);
 
   /**
    * @brief      Evaluate the given data set with the given parameters
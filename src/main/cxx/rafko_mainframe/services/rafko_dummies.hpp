@@ -61,7 +61,7 @@ public:
     return m_dummyLabels[0].size();
   }
   std::uint32_t get_input_size() const override {
-    return m_dummyLabels[0].size();
+    return m_dummyInputs[0].size();
   }
   std::uint32_t get_number_of_input_samples() const override { return 1; }
   std::uint32_t get_number_of_label_samples() const override { return 1; }
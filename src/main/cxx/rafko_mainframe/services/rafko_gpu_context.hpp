@@ -62,8 +62,8 @@ public:
                       bool isolated = true) override;
   void refresh_solution_weights() override {
     RFASSERT_LOG("Refreshing Solution weights in CPU context..");
-    m_solverFactory.refresh_actual_solution_weights();
-    upload_weight_table_to_device();
+    upload_weight_ranges_to_device(
+        m_solverFactory.refresh_actual_solution_weights());
   }
 
   rafko_utilities::ConstVectorSubrange<>
@@ -128,12 +128,13 @@ private:
   void upload_weight_table_to_device();
 
   /**
-   * @brief   Uploads the weights from @network to the buffer on the GPU for the
-   * given weight index
+   * @brief   Uploads the given ranges of the solution weight tables to the
+   * buffer on the GPU
    *
-   * @param[in]     weight_index    the index of the weight to upload
+   * @param[in]     ranges    the changed ranges of the partial weight tables
    */
-  void upload_weight_to_device(std::uint32_t weight_index);
+  void
+  upload_weight_ranges_to_device(const rafko_gym::WeightTableRanges &ranges);
 
   /**
    * @brief     sets the paramterers of the objective based on the data set,
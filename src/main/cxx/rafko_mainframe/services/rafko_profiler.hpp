@@ -0,0 +1,154 @@
+/*! This file is part of davids91/Rafko.
+ *
+ *    Rafko is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    (at your option) any later version.
+ *
+ *    Rafko is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with Rafko.  If not, see <https://www.gnu.org/licenses/> or
+ *    <https://github.com/davids91/rafko/blob/master/LICENSE>
+ */
+
+#ifndef RAFKO_PROFILER_H
+#define RAFKO_PROFILER_H
+
+#include "rafko_global.hpp"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace rafko_mainframe {
+
+#define RFPROFILE_CONCAT_INNER(a, b) a##b
+#define RFPROFILE_CONCAT(a, b) RFPROFILE_CONCAT_INNER(a, b)
+/**
+ * @brief      Records the time spent from this point until the end of the
+ * enclosing scope under the phase of the given name. The phase is registered
+ * only once for every place the macro is used in.
+ */
+#define RFPROFILE_SCOPE(name)                                                  \
+  static const std::uint32_t RFPROFILE_CONCAT(rafko_profile_phase_,            \
+                                              __LINE__) =                      \
+      rafko_mainframe::RafkoProfiler::register_phase(name);                    \
+  const rafko_mainframe::RafkoProfiler::Scope RFPROFILE_CONCAT(                \
+      rafko_profile_scope_, __LINE__)(                                         \
+      RFPROFILE_CONCAT(rafko_profile_phase_, __LINE__))
+
+/**
+ * @brief      A profiler cheap enough to be kept enabled in production builds,
+ * unlike @RafkoAssertionLogger. Every thread records the scopes it measured
+ * into its own ring buffer, so only the latest @s_eventsPerThread scopes are
+ * kept for the trace of each thread, while the per-phase statistics account
+ * for every recorded scope. Recording only locks a mutex owned by the
+ * recording thread, which is uncontended unless the results are being
+ * exported at the same time.
+ */
+class RAFKO_EXPORT RafkoProfiler {
+public:
+  static constexpr std::uint32_t s_eventsPerThread = 8192u;
+  static constexpr std::uint32_t s_histogramBuckets = 32u;
+
+  /**
+   * @brief      Aggregated measurements of a phase over every thread. Bucket
+   * i of the histogram counts the scopes which took [2^(i-1), 2^i)
+   * nanoseconds; the last bucket counts every longer one as well.
+   */
+  struct PhaseStatistics {
+    std::string name;
+    std::uint64_t count = 0u;
+    std::chrono::nanoseconds total{0};
+    std::chrono::nanoseconds min{0};
+    std::chrono::nanoseconds max{0};
+    std::array<std::uint64_t, s_histogramBuckets> histogram{};
+  };
+
+  /**
+   * @brief      Measures its own lifetime under the given phase, if the
+   * profiler was enabled when it was constructed
+   */
+  class Scope {
+  public:
+    explicit Scope(std::uint32_t phase)
+        : m_phase(phase), m_start(is_enabled() ? now() : s_notRecording) {}
+    ~Scope() {
+      if (s_notRecording != m_start)
+        record(m_phase, m_start, now());
+    }
+    Scope(const Scope &other) = delete;
+    Scope &operator=(const Scope &other) = delete;
+    Scope(Scope &&other) = delete;
+    Scope &operator=(Scope &&other) = delete;
+
+  private:
+    static constexpr std::int64_t s_notRecording = -1;
+    const std::uint32_t m_phase;
+    const std::int64_t m_start;
+  };
+
+  /**
+   * @brief      Provides the identifier of the phase with the given name,
+   * registering it if it's not known yet
+   */
+  static std::uint32_t register_phase(const std::string &name);
+
+  /**
+   * @brief      Enables or disables recording; Scopes started while the
+   * profiler is disabled are not recorded. Recording is enabled by default.
+   */
+  static void set_enabled(bool enabled) {
+    m_enabled.store(enabled, std::memory_order_relaxed);
+  }
+  static bool is_enabled() {
+    return m_enabled.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief      Drops every recorded scope and statistic, keeping the
+   * registered phases
+   */
+  static void reset();
+
+  /**
+   * @brief      Writes the scopes kept in the ring buffers in the Chrome trace
+   * event format, which can be opened in chrome://tracing or Perfetto
+   */
+  static void export_chrome_trace(std::ostream &stream);
+
+  /**
+   * @brief      Provides the statistics of every registered phase, in the
+   * order of their registration
+   */
+  static std::vector<PhaseStatistics> get_phase_statistics();
+
+  /**
+   * @brief      Writes the result of @get_phase_statistics as JSON
+   */
+  static void export_phase_statistics(std::ostream &stream);
+
+private:
+  static std::atomic<bool> m_enabled;
+
+  static std::int64_t now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+  }
+
+  static void record(std::uint32_t phase, std::int64_t start,
+                     std::int64_t end);
+};
+
+} /* namespace rafko_mainframe */
+
+#endif /* RAFKO_PROFILER_H */
@@ -0,0 +1,208 @@
+/*! This file is part of davids91/Rafko.
+ *
+ *    Rafko is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    (at your option) any later version.
+ *
+ *    Rafko is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with Rafko.  If not, see <https://www.gnu.org/licenses/> or
+ *    <https://github.com/davids91/rafko/blob/master/LICENSE>
+ */
+
+#ifndef RAFKO_SERVICE_SLOT_H
+#define RAFKO_SERVICE_SLOT_H
+
+#include "rafko_global.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "rafko_protocol/deep_learning_service.pb.h"
+#include "rafko_protocol/rafko_net.pb.h"
+
+#include "rafko_gym/models/rafko_dataset_implementation.hpp"
+#include "rafko_gym/models/rafko_objective.hpp"
+#include "rafko_gym/services/rafko_autodiff_optimizer.hpp"
+#include "rafko_mainframe/models/rafko_settings.hpp"
+#include "rafko_mainframe/services/rafko_cpu_context.hpp"
+#include "rafko_net/services/solution_solver.hpp"
+
+namespace rafko_mainframe {
+
+/**
+ * @brief      A channel of the deep learning service, which runs or optimizes
+ * the network described in its @ServiceSlot. Every component of the slot
+ * ( solver, data sets, optimizer ) is built from the description, and rebuilt
+ * whenever it changes. The slot is thread-safe: requests and training steps
+ * are serialized by an internal mutex, so a slot can be stepped by any worker
+ * of a shared pool while requests arrive to it. The solvers and the optimizer
+ * of a slot use a single thread, so many slots can share the cores of a host;
+ * scheduling them is the task of the @RafkoSlotScheduler.
+ */
+class RAFKO_EXPORT RafkoServiceSlot {
+public:
+  /**
+   * @brief      Class Constructor
+   *
+   * @param      description   The description of the slot, the slot id and
+   * type of which can not be changed afterwards
+   */
+  RafkoServiceSlot(const ServiceSlot &description);
+
+  /**
+   * @brief      Overwrites the description of the slot and rebuilds every
+   * component based on it; the slot stops if it was running. Data sets which
+   * don't fit the network of the slot are treated as missing.
+   *
+   * @param      description   The new description; the slot id and type need
+   * to match the stored ones
+   *
+   * @return     The state of the slot after the update
+   */
+  std::uint32_t update(const ServiceSlot &description);
+
+  /**
+   * @brief      Builds a fully connected network into the slot, replacing the
+   * one it had
+   *
+   * @param      request   The parameters of the network; the transfer functions
+   * are either given for every layer or not at all
+   *
+   * @return     The state of the slot after the network is built
+   */
+  std::uint32_t build_network(const BuildNetworkRequest &request);
+
+  /**
+   * @brief      Executes the actions requested in the bitstring of the
+   * request in the order of @Slot_action_field, except for
+   * @serv_slot_to_start, which is applied last. Data streams contain whole
+   * sequences one after another, every step of a sequence being its input
+   * followed by its label ( and its features, which are ignored ).
+   *
+   * @param      request          The request to execute; @serv_slot_to_die is
+   * handled by the scheduler owning the slot
+   * @param      source_network   The network of the source slot of the request,
+   * required by @serv_slot_to_takeover_net
+   *
+   * @return     The state of the slot, and the output or sample data asked
+   * by the request, if any
+   */
+  SlotResponse
+  handle_request(const SlotRequest &request,
+                 const rafko_net::RafkoNet *source_network = nullptr);
+
+  /**
+   * @brief      Provides the information fields asked in the bitstring, in the
+   * order of @Slot_info_field
+   *
+   * @param      request_bitstring   The requested @Slot_info_field values
+   *
+   * @return     The info fields and their values
+   */
+  SlotInfo get_info(std::uint32_t request_bitstring);
+
+  /**
+   * @brief      Provides a copy of the network attached to the slot
+   */
+  rafko_net::RafkoNet get_network();
+
+  /**
+   * @brief      Provides the state of the slot as a bitfield of
+   * @Slot_state_values, or @serv_slot_ok if nothing is missing
+   */
+  std::uint32_t get_state();
+
+  /**
+   * @brief      Executes one training iteration, if the slot is running
+   */
+  void step();
+
+  /**
+   * @brief      Stops the training loop of the slot
+   */
+  void stop() { m_running.store(false); }
+
+  bool is_running() const { return m_running.load(); }
+
+  const std::string &get_id() const { return m_id; }
+
+  Slot_type get_type() const { return m_type; }
+
+private:
+  const std::string m_id;
+  const Slot_type m_type;
+  std::mutex m_mutex;
+  std::atomic<bool> m_running{false};
+  ServiceSlot m_description;
+  std::shared_ptr<RafkoSettings> m_settings;
+  std::unique_ptr<rafko_net::SolutionSolver::Factory> m_solverFactory;
+  std::shared_ptr<rafko_net::SolutionSolver> m_solver;
+  std::shared_ptr<rafko_gym::RafkoDatasetImplementation> m_trainingSet;
+  std::shared_ptr<rafko_gym::RafkoDatasetImplementation> m_testSet;
+  std::shared_ptr<rafko_gym::RafkoObjective> m_objective;
+  std::shared_ptr<RafkoCPUContext> m_trainingContext;
+  std::shared_ptr<RafkoCPUContext> m_testContext;
+  std::unique_ptr<rafko_gym::RafkoAutodiffOptimizer> m_optimizer;
+  std::uint32_t m_iteration = 0u;
+  bool m_resetSolverMemory = true;
+
+  /**
+   * @brief      Checks if the description can be used to build a slot from
+   */
+  static void check(const ServiceSlot &description);
+
+  /**
+   * @brief      Rebuilds every component of the slot from the stored
+   * description, which also stops the slot. Expects the mutex to be locked.
+   */
+  void rebuild();
+
+  /**
+   * @brief      Provides the state of the slot; expects the mutex to be locked
+   */
+  std::uint32_t get_state_locked() const;
+
+  /**
+   * @brief      Runs the network on the input sequences of the data stream
+   *
+   * @param      data_stream   The input sequences to run the network on
+   *
+   * @return     The output of the network for every step of the sequences
+   */
+  NeuralIOStream run_once(const NeuralIOStream &data_stream);
+
+  /**
+   * @brief      Appends the sequences of the data stream to a data set of the
+   * slot description
+   *
+   * @param      data_stream   The sequences to append
+   * @param      data_set      The data set to append the sequences to
+   */
+  static void append_to(const NeuralIOStream &data_stream,
+                        rafko_gym::DataSetPackage &data_set);
+
+  /**
+   * @brief      Packs one sequence of a data set into a data stream; the
+   * prefill inputs of the sequence, if any, come before its steps.
+   *
+   * @param      data_set         The data set to take the sequence from
+   * @param      sequence_index   The index of the sequence inside the data set
+   *
+   * @return     The sequence packed into a data stream
+   */
+  static NeuralIOStream get_sample(const rafko_gym::RafkoDataSet *data_set,
+                                   std::uint32_t sequence_index);
+};
+
+} /* namespace rafko_mainframe */
+
+#endif /* RAFKO_SERVICE_SLOT_H */
@@ -0,0 +1,168 @@
+/*! This file is part of davids91/Rafko.
+ *
+ *    Rafko is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    (at your option) any later version.
+ *
+ *    Rafko is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with Rafko.  If not, see <https://www.gnu.org/licenses/> or
+ *    <https://github.com/davids91/rafko/blob/master/LICENSE>
+ */
+
+#ifndef RAFKO_SLOT_SCHEDULER_H
+#define RAFKO_SLOT_SCHEDULER_H
+
+#include "rafko_global.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "rafko_protocol/deep_learning_service.pb.h"
+
+#include "rafko_mainframe/services/rafko_service_slot.hpp"
+
+namespace rafko_mainframe {
+
+/**
+ * @brief      Owns the slots of the deep learning service and shares the cores
+ * of the host between them. The running @serv_slot_to_optimize slots are
+ * time-sliced on a shared pool of workers: a worker takes the next slot from a
+ * round robin queue, steps it until its time slice runs out, then puts it back
+ * to the end of the queue. The requests of every @serv_slot_to_run slot are
+ * executed by a dedicated thread of the slot, so inference is never queued
+ * behind training.
+ */
+class RAFKO_EXPORT RafkoSlotScheduler {
+public:
+  using ResponseCallback =
+      std::function<void(const SlotResponse &, std::exception_ptr)>;
+
+  /**
+   * @brief      Class Constructor
+   *
+   * @param      worker_count   The number of threads to train the slots with
+   * @param      time_slice     The time an optimizer slot is stepped for before
+   * the next slot in the queue gets its turn
+   */
+  RafkoSlotScheduler(
+      std::uint32_t worker_count =
+          std::max(1u, std::thread::hardware_concurrency()),
+      std::chrono::milliseconds time_slice = std::chrono::milliseconds(10));
+  ~RafkoSlotScheduler();
+
+  /**
+   * @brief      Creates a new slot from the given description
+   *
+   * @param      description   The description of the slot; if no id is
+   * provided in it, an unique id is generated for the slot
+   *
+   * @return     The id and state of the new slot
+   */
+  SlotResponse add_slot(const ServiceSlot &description);
+
+  /**
+   * @brief      Overwrites the description of an existing slot
+   *
+   * @param      description   The new description of the slot with its id
+   *
+   * @return     The id and state of the slot
+   */
+  SlotResponse update_slot(const ServiceSlot &description);
+
+  /**
+   * @brief      Provides the slot with the given id, or throws if there's none
+   */
+  std::shared_ptr<RafkoServiceSlot> get_slot(const std::string &slot_id) const;
+
+  /**
+   * @brief      Executes the request on its target slot; on the dedicated
+   * thread of the slot for @serv_slot_to_run slots, on the calling thread
+   * otherwise. Slots started by the request are queued to be trained,
+   * @serv_slot_to_die removes the slot before any other action is considered.
+   *
+   * @param      request    The request to execute
+   * @param      callback   Called with the response of the request, or with
+   * the exception it failed with
+   */
+  void request(const SlotRequest &request, ResponseCallback callback);
+
+  std::uint32_t get_slot_count() const {
+    std::lock_guard<std::mutex> lock(m_slotsMutex);
+    return m_slots.size();
+  }
+
+private:
+  /**
+   * @brief      A thread executing the tasks of one @serv_slot_to_run slot in
+   * the order they arrive
+   */
+  struct DedicatedWorker {
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::deque<std::function<void()>> tasks;
+    bool stopping = false;
+    std::thread thread;
+  };
+
+  const std::chrono::milliseconds m_timeSlice;
+  mutable std::mutex m_slotsMutex;
+  std::map<std::string, std::shared_ptr<RafkoServiceSlot>> m_slots;
+  std::map<std::string, std::shared_ptr<DedicatedWorker>> m_dedicatedWorkers;
+  std::uint32_t m_nextSlotIndex = 0u;
+
+  std::mutex m_queueMutex;
+  std::condition_variable m_queueCondition;
+  std::deque<std::shared_ptr<RafkoServiceSlot>> m_readyQueue;
+  std::set<const RafkoServiceSlot *> m_scheduledSlots;
+  bool m_stopping = false;
+  std::vector<std::thread> m_trainingWorkers;
+
+  /**
+   * @brief      Queues the slot to be trained, unless it's already queued or
+   * being trained by a worker of the pool
+   */
+  void schedule(std::shared_ptr<RafkoServiceSlot> slot);
+
+  /**
+   * @brief      The loop of the workers of the shared pool
+   */
+  void train_slots();
+
+  /**
+   * @brief      Removes the slot and stops its dedicated thread, if any;
+   * tasks queued before the removal are still executed
+   */
+  void remove_slot(const std::string &slot_id);
+
+  /**
+   * @brief      Executes the request on the given slot
+   */
+  SlotResponse execute(std::shared_ptr<RafkoServiceSlot> slot,
+                       const SlotRequest &request,
+                       const rafko_net::RafkoNet *source_network);
+
+  static void run_dedicated_worker(std::shared_ptr<DedicatedWorker> worker);
+  static void stop_dedicated_worker(DedicatedWorker &worker);
+};
+
+} /* namespace rafko_mainframe */
+
+#endif /* RAFKO_SLOT_SCHEDULER_H */
@@ -17,6 +17,7 @@
 
 #include "rafko_mainframe/services/rafko_cpu_context.hpp"
 
+#include <atomic>
 #include <math.h>
 
 #include "rafko_gym/models/rafko_dataset_implementation.hpp"
@@ -27,6 +28,12 @@
 #include "rafko_utilities/models/data_ringbuffer.hpp"
 
 #include "rafko_mainframe/services/rafko_dummies.hpp"
+#include "rafko_mainframe/services/rafko_profiler.hpp"
+
+namespace {
+/* The number of batches the sequences of one thread are split into */
+constexpr std::uint32_t s_batchesPerThread = 2u;
+} /* namespace */
 
 namespace rafko_mainframe {
 
@@ -41,10 +48,11 @@ RafkoCPUContext::RafkoCPUContext(
       m_objective(objective),
       m_weightUpdater(rafko_gym::UpdaterFactory::build_weight_updater(
           m_network, rafko_gym::weight_updater_default, *m_settings)),
-      m_executionThreads(m_settings->get_max_processing_threads()),
+      m_threadPool(rafko_utilities::WorkStealingPool::shared()),
+      m_threadNumber(m_settings->get_max_processing_threads()),
       m_neuronOutputsToEvaluate(/* For every thread, 1 sequence is evaluated..
                                  */
-                                (m_executionThreads.get_number_of_threads() *
+                                (m_threadNumber *
                                      m_dataSet->get_sequence_size() +
                                  1u),
                                 std::vector<double>(
@@ -59,9 +67,10 @@ RafkoCPUContext::RafkoCPUContext(
       m_usedSequenceTruncation(std::min(m_settings->get_memory_truncation(),
                                         m_dataSet->get_sequence_size())),
       m_usedMinibatchSize(std::min(m_settings->get_minibatch_size(),
-                                   m_dataSet->get_number_of_sequences())) {
-  m_neuronOutputsToEvaluate.back().resize(
-      m_dataSet->get_number_of_label_samples());
+                                   m_dataSet->get_number_of_sequences())),
+      m_sequencesInBatch(1u),
+      m_batchInputs(m_threadNumber), m_batchOutputs(m_threadNumber) {
+  refresh_batch_buffers();
 }
 
 void RafkoCPUContext::set_data_set(
@@ -76,25 +85,117 @@ void RafkoCPUContext::set_data_set(
   RFASSERT(data_set->get_input_size() == m_network.input_data_size());
   m_dataSet.reset();
   m_dataSet = data_set;
-  std::uint32_t old_output_buffer_num = m_neuronOutputsToEvaluate.size();
-  std::uint32_t new_output_buffer_num =
-      m_executionThreads.get_number_of_threads() *
-          m_dataSet->get_sequence_size() +
-      1u;
-  m_neuronOutputsToEvaluate.resize(new_output_buffer_num);
-  if (old_output_buffer_num < new_output_buffer_num) {
-    for (std::uint32_t buffer_index = old_output_buffer_num - 1;
-         buffer_index < new_output_buffer_num; ++buffer_index) {
-      m_neuronOutputsToEvaluate[buffer_index].resize(
-          m_dataSet->get_feature_size());
-    }
-  }
-  m_neuronOutputsToEvaluate.back().resize(
-      m_dataSet->get_number_of_label_samples());
   m_usedSequenceTruncation = std::min(m_settings->get_memory_truncation(),
                                       m_dataSet->get_sequence_size());
   m_usedMinibatchSize = std::min(m_settings->get_minibatch_size(),
                                  m_dataSet->get_number_of_sequences());
+  refresh_batch_buffers();
+}
+
+void RafkoCPUContext::refresh_batch_buffers() {
+  const std::uint32_t thread_number = m_threadNumber;
+  /*!Note: A minibatch is distributed between the threads, so a stochastic
+   * evaluation is done in one round */
+  m_sequencesInBatch = std::max(
+      1u, ((m_usedMinibatchSize + thread_number - 1u) / thread_number));
+  m_neuronOutputsToEvaluate.resize(
+      /* For every thread, a batch of sequences is evaluated.. */
+      (thread_number * m_sequencesInBatch * m_dataSet->get_sequence_size()) +
+      1u /* ..plus for the label errors one additional vector is needed */
+  );
+  for (std::vector<double> &buffer : m_neuronOutputsToEvaluate)
+    buffer.resize(m_dataSet->get_feature_size());
+  m_neuronOutputsToEvaluate.back().resize(
+      m_dataSet->get_number_of_label_samples());
+}
+
+void RafkoCPUContext::solve_sequences_in_parallel(
+    std::uint32_t sequence_start, std::uint32_t sequence_count,
+    std::vector<std::vector<double>> &output, std::uint32_t batch_size) {
+  std::atomic<std::uint32_t> next_batch = {0u};
+  m_threadPool.parallel_for(
+      0u, std::min(m_threadNumber, sequence_count),
+      [this, sequence_start, sequence_count, batch_size, &output,
+       &next_batch](std::uint32_t thread_index) {
+        for (std::uint32_t batch_start = (next_batch++ * batch_size);
+             batch_start < sequence_count;
+             batch_start = (next_batch++ * batch_size))
+          solve_sequences((sequence_start + batch_start),
+                          std::min(batch_size, (sequence_count - batch_start)),
+                          output, (batch_start * m_dataSet->get_sequence_size()),
+                          thread_index);
+      });
+}
+
+void RafkoCPUContext::solve_sequences(std::uint32_t sequence_start,
+                                      std::uint32_t sequence_count,
+                                      std::vector<std::vector<double>> &output,
+                                      std::uint32_t output_start,
+                                      std::uint32_t thread_index) {
+  if (0u == sequence_count)
+    return;
+  const std::uint32_t input_size = m_dataSet->get_input_size();
+  const std::uint32_t sequence_size = m_dataSet->get_sequence_size();
+  const std::uint32_t prefill_size = m_dataSet->get_prefill_inputs_number();
+  std::vector<double> &batch_inputs = m_batchInputs[thread_index];
+  std::vector<double> &batch_outputs = m_batchOutputs[thread_index];
+  batch_inputs.resize(sequence_count * input_size);
+
+  /*!Note: The first few inputs are there to set an initial state to the
+   * network, results are only stored after the inital "prefill" */
+  for (std::uint32_t step = 0u; step < (prefill_size + sequence_size);
+       ++step) {
+    for (std::uint32_t sequence = 0u; sequence < sequence_count; ++sequence) {
+      const rafko_gym::RafkoDataSet::SampleView input_sample =
+          m_dataSet->get_input_view(
+              ((sequence_start + sequence) * (sequence_size + prefill_size)) +
+              step);
+      std::copy(input_sample.begin(), input_sample.end(),
+                batch_inputs.begin() + (sequence * input_size));
+    }
+    m_agent->solve_batch(batch_inputs, sequence_count, batch_outputs,
+                         (0u == step) /* reset_neuron_data */, thread_index);
+    if (step < prefill_size)
+      continue;
+
+    const std::uint32_t output_size = batch_outputs.size() / sequence_count;
+    for (std::uint32_t sequence = 0u; sequence < sequence_count; ++sequence) {
+      const std::uint32_t output_buffer_index =
+          output_start + (sequence * sequence_size) + (step - prefill_size);
+      RFASSERT(output_buffer_index < output.size());
+      RFASSERT(output[output_buffer_index].size() == output_size);
+      std::copy(batch_outputs.begin() + (sequence * output_size),
+                batch_outputs.begin() + ((sequence + 1u) * output_size),
+                output[output_buffer_index].begin());
+    }
+  }
+}
+
+void RafkoCPUContext::solve_sequence_in_memory(
+    std::uint32_t sequence_index, std::vector<std::vector<double>> &output,
+    std::uint32_t output_start, std::uint32_t thread_index) {
+  const std::uint32_t sequence_size = m_dataSet->get_sequence_size();
+  const std::uint32_t prefill_size = m_dataSet->get_prefill_inputs_number();
+  std::vector<double> &input = m_batchInputs[thread_index];
+  input.resize(m_dataSet->get_input_size());
+  for (std::uint32_t step = 0u; step < (prefill_size + sequence_size);
+       ++step) {
+    const rafko_gym::RafkoDataSet::SampleView input_sample =
+        m_dataSet->get_input_view(
+            (sequence_index * (sequence_size + prefill_size)) + step);
+    std::copy(input_sample.begin(), input_sample.end(), input.begin());
+    rafko_utilities::ConstVectorSubrange<> neuron_output = m_agent->solve(
+        input, (0u == step) /* reset_neuron_data */, thread_index);
+    if (step < prefill_size)
+      continue;
+
+    const std::uint32_t output_buffer_index =
+        output_start + (step - prefill_size);
+    RFASSERT(output_buffer_index < output.size());
+    RFASSERT(output[output_buffer_index].size() == neuron_output.size());
+    std::copy(neuron_output.begin(), neuron_output.end(),
+              output[output_buffer_index].begin());
+  }
 }
 
 double RafkoCPUContext::error_post_process(double raw_error,
@@ -120,6 +221,7 @@ double RafkoCPUContext::evaluate(std::uint32_t sequence_start,
                                  std::uint32_t sequences_to_evaluate,
                                  std::uint32_t start_index_in_sequence,
                                  std::uint32_t sequence_truncation) {
+  RFPROFILE_SCOPE("RafkoCPUContext::evaluate");
   RFASSERT_LOG("Evaluating sequences in CPU context: {} + {} / {}; start index "
                "inside sequence: {}; sequence truncation: {} ",
                sequence_start, sequences_to_evaluate,
@@ -131,74 +233,26 @@ double RafkoCPUContext::evaluate(std::uint32_t sequence_start,
 
   double error_sum = (0.0);
   m_agent->set_eval_mode(true);
+  const std::uint32_t sequence_end = sequence_start + sequences_to_evaluate;
+  const std::uint32_t sequences_in_round = m_threadNumber * m_sequencesInBatch;
+  /*!Note: Batches are smaller than what would fit into one thread, so threads
+   * finishing early can pick up the remaining work */
+  const std::uint32_t sequences_in_batch =
+      (m_sequencesInBatch + s_batchesPerThread - 1u) / s_batchesPerThread;
   for (std::uint32_t sequence_index = sequence_start;
-       sequence_index < (sequence_start + sequences_to_evaluate);
-       sequence_index += m_executionThreads.get_number_of_threads()) {
-    m_executionThreads.start_and_block([this, sequence_index](
-                                           std::uint32_t thread_index) {
-      if (m_dataSet->get_number_of_sequences() >
-          (sequence_index +
-           thread_index)) { /* See if the sequence index is inside bounds */
-        /*!Note: This might happen because of the number of used threads might
-         * point to a grater index, than the number of sequences; Which is
-         * mainly because of division remainder between number fo threads and
-         * the number of sequences
-         * */
-        /* Solve the sequence under sequence_index + thread_index */
-        std::uint32_t raw_inputs_index =
-            (sequence_index + thread_index) *
-            (m_dataSet->get_sequence_size() +
-             m_dataSet->get_prefill_inputs_number());
-
-        /* Evaluate the current sequence step by step */
-        for (std::uint32_t prefill_iterator = 0;
-             prefill_iterator < m_dataSet->get_prefill_inputs_number();
-             ++prefill_iterator) {
-          (void)m_agent->solve(m_dataSet->get_input_sample(raw_inputs_index),
-                               (0 == prefill_iterator), thread_index);
-          ++raw_inputs_index;
-        } /* The first few inputs are there to set an initial state to the
-             network */
-
-        /* Solve the data and store the result after the inital "prefill" */
-        for (std::uint32_t sequence_iterator = 0;
-             sequence_iterator < m_dataSet->get_sequence_size();
-             ++sequence_iterator) {
-          rafko_utilities::ConstVectorSubrange<> neuron_output =
-              m_agent->solve(m_dataSet->get_input_sample(raw_inputs_index),
-                             ((0u == m_dataSet->get_prefill_inputs_number()) &&
-                              (0u == sequence_iterator)),
-                             thread_index);
-          std::copy(/* copy the result to the eval array */
-                    neuron_output.begin(), neuron_output.end(),
-                    m_neuronOutputsToEvaluate[(thread_index *
-                                               m_dataSet->get_sequence_size()) +
-                                              sequence_iterator]
-                        .begin());
-          ++raw_inputs_index;
-        } /*for(relevant sequences)*/
-      }   /*if(thread index inside bounds)*/
-    });
+       sequence_index < sequence_end; sequence_index += sequences_in_round) {
+    const std::uint32_t sequences_in_this_round =
+        std::min(sequences_in_round, (sequence_end - sequence_index));
+    solve_sequences_in_parallel(sequence_index, sequences_in_this_round,
+                                m_neuronOutputsToEvaluate, sequences_in_batch);
 
     RFASSERT_LOGV2(m_neuronOutputsToEvaluate, "Neuron outputs to evaluate: ");
 
-    double error_part =
-        m_objective
-            ->set_features_for_sequences(/* Upload results to the data set */
-                                         *m_dataSet, m_neuronOutputsToEvaluate,
-                                         0u /* neuron_buffer_index */,
-                                         sequence_index,
-                                         std::min(
-                                             ((sequence_start +
-                                               sequences_to_evaluate) -
-                                              (sequence_index)),
-                                             static_cast<std::uint32_t>(
-                                                 m_executionThreads
-                                                     .get_number_of_threads())) /* sequences_to_evaluate */
-                                         ,
-                                         start_index_in_sequence,
-                                         sequence_truncation,
-                                         m_neuronOutputsToEvaluate.back());
+    double error_part = m_objective->set_features_for_sequences(
+        /* Upload results to the data set */
+        *m_dataSet, m_neuronOutputsToEvaluate, 0u /* neuron_buffer_index */,
+        sequence_index, sequences_in_this_round, start_index_in_sequence,
+        sequence_truncation, m_neuronOutputsToEvaluate.back());
     error_sum += error_part;
   } /* for(sequence_index: sequence_start --> (sequence start +
        sequences_to_evaluate)) */
@@ -213,55 +267,25 @@ void RafkoCPUContext::solve_data_set(std::vector<std::vector<double>> &output,
   RFASSERT(
       (isolated && (output.size() == (m_dataSet->get_number_of_sequences() *
                                       m_dataSet->get_sequence_size()))) ||
-      (!isolated &&
-       (output.size() == (m_executionThreads.get_number_of_threads() *
-                          m_dataSet->get_sequence_size()))));
-  std::uint32_t sequence_index = 0u;
-  while (sequence_index < m_dataSet->get_number_of_sequences()) {
-    m_executionThreads.start_and_block([this, sequence_index,
-                                        &output](std::uint32_t thread_index) {
-      const std::uint32_t actual_sequence_index = sequence_index + thread_index;
-      if (actual_sequence_index < m_dataSet->get_number_of_sequences()) {
-        /* Solve the sequence under sequence_index + thread_index */
-        std::uint32_t raw_inputs_index =
-            actual_sequence_index * (m_dataSet->get_sequence_size() +
-                                     m_dataSet->get_prefill_inputs_number());
-
-        /* Evaluate the current sequence step by step */
-        for (std::uint32_t prefill_iterator = 0;
-             prefill_iterator < m_dataSet->get_prefill_inputs_number();
-             ++prefill_iterator) {
-          (void)m_agent->solve(m_dataSet->get_input_sample(raw_inputs_index),
-                               (0 == prefill_iterator), thread_index);
-          ++raw_inputs_index;
-        } /* The first few inputs are there to set an initial state to the
-             network */
-
-        /* Solve the data and store the result after the inital "prefill" */
-        for (std::uint32_t sequence_iterator = 0;
-             sequence_iterator < m_dataSet->get_sequence_size();
-             ++sequence_iterator) {
-          rafko_utilities::ConstVectorSubrange<> neuron_output =
-              m_agent->solve(m_dataSet->get_input_sample(raw_inputs_index),
-                             ((0u == m_dataSet->get_prefill_inputs_number()) &&
-                              (0u == sequence_iterator)),
-                             thread_index);
-          const std::uint32_t output_buffer_index =
-              (actual_sequence_index * m_dataSet->get_sequence_size()) +
-              sequence_iterator;
-          RFASSERT(output_buffer_index < output.size());
-          RFASSERT(output[output_buffer_index].size() == neuron_output.size());
-          std::copy(neuron_output.begin(), neuron_output.end(),
-                    output[output_buffer_index].begin());
-          ++raw_inputs_index;
-        } /*for(relevant sequences)*/
-      }
-    });
-    sequence_index += m_executionThreads.get_number_of_threads();
-    if (!isolated)
-      break; /* to keep buffer data consistent in non-isolated runs, only the
-                first @get_number_of_threads sequences are solved */
-  }          /*while(there are sequences left to solve)*/
+      (!isolated && (output.size() == (m_threadNumber *
+                                       m_dataSet->get_sequence_size()))));
+  if (isolated) {
+    solve_sequences_in_parallel(
+        0u, m_dataSet->get_number_of_sequences(), output,
+        std::max(1u, (m_dataSet->get_number_of_sequences() /
+                      (m_threadNumber * s_batchesPerThread))));
+  } else {
+    /*!Note: to keep buffer data consistent in non-isolated runs, only the
+     * first @m_threadNumber sequences are solved, each always by the same
+     * thread, and in the Neuron memory of that thread instead of a batch */
+    m_threadPool.parallel_for(
+        0u, std::min(m_threadNumber, m_dataSet->get_number_of_sequences()),
+        [this, &output](std::uint32_t thread_index) {
+          solve_sequence_in_memory(
+              thread_index, output,
+              (thread_index * m_dataSet->get_sequence_size()), thread_index);
+        });
+  }
 }
 
 } /* namespace rafko_mainframe */
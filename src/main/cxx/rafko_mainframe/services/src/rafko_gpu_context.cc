@@ -21,6 +21,7 @@
 
 #include "rafko_mainframe/services/rafko_assertion_logger.hpp"
 #include "rafko_mainframe/services/rafko_dummies.hpp"
+#include "rafko_mainframe/services/rafko_profiler.hpp"
 #include "rafko_net/services/solution_builder.hpp"
 #include "rafko_protocol/solution.pb.h"
 
@@ -73,44 +74,26 @@ RafkoGPUContext::RafkoGPUContext(
     refresh_objective();
 }
 
-void RafkoGPUContext::upload_weight_to_device(std::uint32_t weight_index) {
-  const std::vector<std::pair<std::uint32_t, std::uint32_t>>
-      &relevant_partial_weights =
-          (m_solverFactory.expose_weight_adapter()
-               .get_relevant_partial_weight_indices_for(weight_index));
-  std::uint32_t weight_table_offset = 0u;
-  std::uint32_t partial_index = 0u;
-  RFASSERT_LOG("Starting to upload a single weight to device..");
-  for (const std::pair<std::uint32_t, std::uint32_t> &index_pair :
-       relevant_partial_weights) {
-    while (partial_index < std::get<0>(index_pair)) {
-      weight_table_offset += m_solverFactory.actual_solution()
-                                 ->partial_solutions(partial_index)
-                                 .weight_table_size();
-      ++partial_index;
-    }
-    std::uint32_t weight_index_in_partial = std::get<1>(index_pair);
-    double weight_value = m_solverFactory.actual_solution()
-                              ->partial_solutions(partial_index)
-                              .weight_table(weight_index_in_partial);
-    RFASSERT_LOG("Weight index in partial[{}]: {}", partial_index,
-                 weight_index_in_partial);
-
-    /* Update weight at weight_table_offset + std::get<1>(index_pair) */
-    std::uint32_t current_offset =
-        (sizeof(double) * (m_agent->get_input_shapes()[0][0] +
-                           weight_table_offset + weight_index_in_partial));
-    RFASSERT_LOG("buffer byte offset: {} / {}", current_offset,
-                 (m_agent->get_input_shapes()[0].get_byte_size<double>()));
+void RafkoGPUContext::upload_weight_ranges_to_device(
+    const rafko_gym::WeightTableRanges &ranges) {
+  RFASSERT_LOG("Uploading {} weight ranges to device..", ranges.size());
+  for (const rafko_gym::WeightTableRange &range : ranges) {
+    RFASSERT((range.global_start + range.size) <= m_deviceWeightTableSize);
     cl_int return_value = m_openclQueue.enqueueWriteBuffer(
-        m_solutionPhase.get_input_buffer(), CL_TRUE /* blocking */,
-        current_offset /*offset: mode */, sizeof(double) /*size*/,
-        &weight_value);
+        m_solutionPhase.get_input_buffer(), CL_FALSE /*blocking*/,
+        (sizeof(double) * (1u + range.global_start)) /*offset: mode*/,
+        (sizeof(double) * range.size) /*size*/,
+        (m_solverFactory.actual_solution()
+             ->partial_solutions(range.partial_index)
+             .weight_table()
+             .data() +
+         range.start));
     if (CL_SUCCESS != return_value) {
       RFASSERT_LOG("OpenCL Return value: {}", return_value);
     }
     RFASSERT(return_value == CL_SUCCESS);
   }
+  m_openclQueue.finish();
   RFASSERT_LOG("Weight upload complete!");
 }
 
@@ -120,8 +103,7 @@ void RafkoGPUContext::set_network_weight(std::uint32_t weight_index,
   RFASSERT(static_cast<std::int32_t>(weight_index) <
            m_network.weight_table_size());
   m_network.set_weight_table(weight_index, weight_value);
-  m_solverFactory.refresh_actual_solution_weights();
-  upload_weight_to_device(weight_index);
+  refresh_solution_weights();
 }
 
 void RafkoGPUContext::set_network_weights(const std::vector<double> &weights) {
@@ -129,8 +111,7 @@ void RafkoGPUContext::set_network_weights(const std::vector<double> &weights) {
   RFASSERT(static_cast<std::int32_t>(weights.size()) ==
            m_network.weight_table_size());
   *m_network.mutable_weight_table() = {weights.begin(), weights.end()};
-  m_solverFactory.refresh_actual_solution_weights();
-  upload_weight_table_to_device();
+  refresh_solution_weights();
 }
 
 void RafkoGPUContext::apply_weight_update(
@@ -141,8 +122,7 @@ void RafkoGPUContext::apply_weight_update(
   if (m_weightUpdater->is_finished())
     m_weightUpdater->start();
   m_weightUpdater->iterate(weight_delta);
-  m_solverFactory.refresh_actual_solution_weights();
-  upload_weight_table_to_device();
+  refresh_solution_weights();
 }
 
 void RafkoGPUContext::upload_weight_table_to_device() {
@@ -319,6 +299,7 @@ double RafkoGPUContext::full_evaluation(bool force_gpu_upload) {
   [[maybe_unused]] cl_int return_value;
   std::vector<cl::Event> label_events;
   RFASSERT_SCOPE(GPU_FULL_EVALUATION);
+  RFPROFILE_SCOPE("RafkoGPUContext::full_evaluation");
   RFASSERT_LOG("Full evaluation in GPU Context..");
   RFASSERT(static_cast<bool>(m_objective));
 
@@ -449,6 +430,7 @@ double RafkoGPUContext::stochastic_evaluation(bool to_seed,
   std::vector<cl::Event> input_events;
   std::vector<cl::Event> label_events;
   RFASSERT_SCOPE(GPU_STOCHASTIC_EVALUATION);
+  RFPROFILE_SCOPE("RafkoGPUContext::stochastic_evaluation");
   RFASSERT_LOG("Stochastic evaluation in GPU Context..");
 
   if (to_seed) {
@@ -0,0 +1,224 @@
+/*! This file is part of davids91/Rafko.
+ *
+ *    Rafko is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    (at your option) any later version.
+ *
+ *    Rafko is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with Rafko.  If not, see <https://www.gnu.org/licenses/> or
+ *    <https://github.com/davids91/rafko/blob/master/LICENSE>
+ */
+#include "rafko_mainframe/services/rafko_profiler.hpp"
+
+#include <algorithm>
+#include <deque>
+#include <limits>
+#include <memory>
+#include <mutex>
+
+namespace rafko_mainframe {
+
+namespace {
+
+struct Event {
+  std::uint32_t phase;
+  std::int64_t start;
+  std::int64_t duration;
+};
+
+struct PhaseTally {
+  std::uint64_t count = 0u;
+  std::int64_t total = 0;
+  std::int64_t min = std::numeric_limits<std::int64_t>::max();
+  std::int64_t max = 0;
+  std::array<std::uint64_t, RafkoProfiler::s_histogramBuckets> histogram{};
+
+  void add(std::int64_t duration) {
+    ++count;
+    total += duration;
+    min = std::min(min, duration);
+    max = std::max(max, duration);
+    std::uint32_t bucket = 0u;
+    while ((0 < (duration >> bucket)) &&
+           (bucket < (RafkoProfiler::s_histogramBuckets - 1u)))
+      ++bucket;
+    ++histogram[bucket];
+  }
+};
+
+struct ThreadRecord {
+  explicit ThreadRecord(std::uint32_t index)
+      : thread_index(index), events(RafkoProfiler::s_eventsPerThread) {}
+
+  const std::uint32_t thread_index;
+  std::mutex mutex;
+  std::vector<Event> events;
+  std::uint64_t recorded = 0u;
+  std::vector<PhaseTally> phases;
+};
+
+struct Registry {
+  std::mutex mutex;
+  std::deque<std::string> phase_names;
+  std::vector<std::shared_ptr<ThreadRecord>> threads;
+  std::uint32_t threads_started = 0u;
+};
+
+/*!Note: The registry is never destroyed, so threads still running at exit
+ * may record scopes safely */
+Registry &get_registry() {
+  static Registry *registry = new Registry();
+  return *registry;
+}
+
+ThreadRecord &get_thread_record() {
+  thread_local const std::shared_ptr<ThreadRecord> thread_record = []() {
+    Registry &registry = get_registry();
+    std::lock_guard<std::mutex> my_lock(registry.mutex);
+    registry.threads.push_back(
+        std::make_shared<ThreadRecord>(registry.threads_started++));
+    return registry.threads.back();
+  }();
+  return *thread_record;
+}
+
+void write_json_string(std::ostream &stream, const std::string &value) {
+  stream << '"';
+  for (char c : value) {
+    if (('"' == c) || ('\\' == c))
+      stream << '\\';
+    stream << c;
+  }
+  stream << '"';
+}
+
+} /* namespace */
+
+std::atomic<bool> RafkoProfiler::m_enabled{true};
+
+std::uint32_t RafkoProfiler::register_phase(const std::string &name) {
+  Registry &registry = get_registry();
+  std::lock_guard<std::mutex> my_lock(registry.mutex);
+  auto found = std::find(registry.phase_names.begin(),
+                         registry.phase_names.end(), name);
+  if (found != registry.phase_names.end())
+    return std::distance(registry.phase_names.begin(), found);
+  registry.phase_names.push_back(name);
+  return registry.phase_names.size() - 1u;
+}
+
+void RafkoProfiler::record(std::uint32_t phase, std::int64_t start,
+                           std::int64_t end) {
+  ThreadRecord &thread_record = get_thread_record();
+  std::lock_guard<std::mutex> my_lock(thread_record.mutex);
+  thread_record.events[thread_record.recorded % s_eventsPerThread] = {
+      phase, start, end - start};
+  ++thread_record.recorded;
+  if (thread_record.phases.size() <= phase)
+    thread_record.phases.resize(phase + 1u);
+  thread_record.phases[phase].add(end - start);
+}
+
+void RafkoProfiler::reset() {
+  Registry &registry = get_registry();
+  std::lock_guard<std::mutex> my_lock(registry.mutex);
+  /*!Note: Records only referenced from the registry belong to finished threads
+   */
+  registry.threads.erase(
+      std::remove_if(registry.threads.begin(), registry.threads.end(),
+                     [](const std::shared_ptr<ThreadRecord> &thread_record) {
+                       return (1 == thread_record.use_count());
+                     }),
+      registry.threads.end());
+  for (const std::shared_ptr<ThreadRecord> &thread_record : registry.threads) {
+    std::lock_guard<std::mutex> thread_lock(thread_record->mutex);
+    thread_record->recorded = 0u;
+    thread_record->phases.clear();
+  }
+}
+
+void RafkoProfiler::export_chrome_trace(std::ostream &stream) {
+  Registry &registry = get_registry();
+  std::lock_guard<std::mutex> my_lock(registry.mutex);
+  const auto previous_precision = stream.precision(3);
+  const auto previous_flags = stream.setf(std::ios::fixed);
+  bool first_event = true;
+  stream << "{\"traceEvents\":[";
+  for (const std::shared_ptr<ThreadRecord> &thread_record : registry.threads) {
+    std::lock_guard<std::mutex> thread_lock(thread_record->mutex);
+    const std::uint64_t kept =
+        std::min<std::uint64_t>(thread_record->recorded, s_eventsPerThread);
+    for (std::uint64_t i = thread_record->recorded - kept;
+         i < thread_record->recorded; ++i) {
+      const Event &event = thread_record->events[i % s_eventsPerThread];
+      stream << (first_event ? "" : ",") << "{\"name\":";
+      write_json_string(stream, registry.phase_names[event.phase]);
+      stream << ",\"ph\":\"X\",\"ts\":" << (event.start / 1000.0)
+             << ",\"dur\":" << (event.duration / 1000.0)
+             << ",\"pid\":0,\"tid\":" << thread_record->thread_index << "}";
+      first_event = false;
+    }
+  }
+  stream << "],\"displayTimeUnit\":\"ns\"}";
+  stream.flags(previous_flags);
+  stream.precision(previous_precision);
+}
+
+std::vector<RafkoProfiler::PhaseStatistics>
+RafkoProfiler::get_phase_statistics() {
+  Registry &registry = get_registry();
+  std::lock_guard<std::mutex> my_lock(registry.mutex);
+  std::vector<PhaseTally> tallies(registry.phase_names.size());
+  for (const std::shared_ptr<ThreadRecord> &thread_record : registry.threads) {
+    std::lock_guard<std::mutex> thread_lock(thread_record->mutex);
+    for (std::uint32_t phase = 0u; phase < thread_record->phases.size();
+         ++phase) {
+      const PhaseTally &thread_tally = thread_record->phases[phase];
+      PhaseTally &tally = tallies[phase];
+      tally.count += thread_tally.count;
+      tally.total += thread_tally.total;
+      tally.min = std::min(tally.min, thread_tally.min);
+      tally.max = std::max(tally.max, thread_tally.max);
+      for (std::uint32_t bucket = 0u; bucket < s_histogramBuckets; ++bucket)
+        tally.histogram[bucket] += thread_tally.histogram[bucket];
+    }
+  }
+
+  std::vector<PhaseStatistics> result(tallies.size());
+  for (std::uint32_t phase = 0u; phase < tallies.size(); ++phase) {
+    result[phase].name = registry.phase_names[phase];
+    result[phase].count = tallies[phase].count;
+    result[phase].total = std::chrono::nanoseconds(tallies[phase].total);
+    if (0u < tallies[phase].count)
+      result[phase].min = std::chrono::nanoseconds(tallies[phase].min);
+    result[phase].max = std::chrono::nanoseconds(tallies[phase].max);
+    result[phase].histogram = tallies[phase].histogram;
+  }
+  return result;
+}
+
+void RafkoProfiler::export_phase_statistics(std::ostream &stream) {
+  bool first_phase = true;
+  stream << "{\"phases\":[";
+  for (const PhaseStatistics &phase : get_phase_statistics()) {
+    stream << (first_phase ? "" : ",") << "{\"name\":";
+    write_json_string(stream, phase.name);
+    stream << ",\"count\":" << phase.count
+           << ",\"total_ns\":" << phase.total.count()
+           << ",\"min_ns\":" << phase.min.count()
+           << ",\"max_ns\":" << phase.max.count() << ",\"histogram\":[";
+    for (std::uint32_t bucket = 0u; bucket < s_histogramBuckets; ++bucket)
+      stream << (0u == bucket ? "" : ",") << phase.histogram[bucket];
+    stream << "]}";
+    first_phase = false;
+  }
+  stream << "]}";
+}
+
+} /* namespace rafko_mainframe */
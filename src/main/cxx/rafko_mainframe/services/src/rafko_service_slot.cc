@@ -0,0 +1,424 @@
+/*! This file is part of davids91/Rafko.
+ *
+ *    Rafko is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    (at your option) any later version.
+ *
+ *    Rafko is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with Rafko.  If not, see <https://www.gnu.org/licenses/> or
+ *    <https://github.com/davids91/rafko/blob/master/LICENSE>
+ */
+
+#include "rafko_mainframe/services/rafko_service_slot.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <set>
+#include <stdexcept>
+#include <vector>
+
+#include "rafko_gym/models/rafko_cost.hpp"
+#include "rafko_net/services/rafko_net_builder.hpp"
+
+namespace {
+
+/**
+ * @brief      Checks if a data set can be used to train or test a network
+ *
+ * @param      data_set   The data set to check
+ * @param      network    The network the data set is used with
+ *
+ * @return     True, if the data set is not empty and it fits the network
+ */
+bool is_compatible(const rafko_gym::DataSetPackage &data_set,
+                   const rafko_net::RafkoNet &network) {
+  if ((0u == data_set.input_size()) || (0u == data_set.feature_size()) ||
+      (0u == data_set.sequence_size()) || (0 == data_set.labels_size()) ||
+      (data_set.input_size() != network.input_data_size()) ||
+      (data_set.feature_size() != network.output_neuron_number()) ||
+      (0u != (data_set.inputs_size() % data_set.input_size())) ||
+      (0u != (data_set.labels_size() %
+              (data_set.feature_size() * data_set.sequence_size()))))
+    return false;
+  const std::uint32_t input_samples =
+      data_set.inputs_size() / data_set.input_size();
+  const std::uint32_t label_samples =
+      data_set.labels_size() / data_set.feature_size();
+  const std::uint32_t sequences = label_samples / data_set.sequence_size();
+  return ((input_samples >= label_samples) &&
+          (0u == ((input_samples - label_samples) % sequences)));
+}
+
+} /* namespace */
+
+namespace rafko_mainframe {
+
+RafkoServiceSlot::RafkoServiceSlot(const ServiceSlot &description)
+    : m_id(description.slot_id()), m_type(description.type()) {
+  check(description);
+  m_description.CopyFrom(description);
+  rebuild();
+}
+
+std::uint32_t RafkoServiceSlot::update(const ServiceSlot &description) {
+  if ((description.slot_id() != m_id) || (description.type() != m_type))
+    throw std::runtime_error("The id and type of slot " + m_id +
+                             " can not be changed!");
+  check(description);
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_description.CopyFrom(description);
+  rebuild();
+  return get_state_locked();
+}
+
+std::uint32_t
+RafkoServiceSlot::build_network(const BuildNetworkRequest &request) {
+  if ((0u == request.input_size()) || (0 == request.layer_sizes_size()))
+    throw std::runtime_error("Unable to build a network without inputs or "
+                             "layers into slot " +
+                             m_id);
+  if ((0 < request.allowed_transfers_by_layer_size()) &&
+      (request.allowed_transfers_by_layer_size() !=
+       request.layer_sizes_size()))
+    throw std::runtime_error("Transfer functions need to be provided for "
+                             "every layer or for none of them!");
+  std::lock_guard<std::mutex> lock(m_mutex);
+  rafko_net::RafkoNetBuilder builder(*m_settings);
+  builder.input_size(request.input_size())
+      .expected_input_range(request.expected_input_range());
+  if (0 < request.allowed_transfers_by_layer_size()) {
+    std::vector<std::set<rafko_net::Transfer_functions>> filter;
+    for (std::int32_t transfer_function : request.allowed_transfers_by_layer())
+      filter.push_back(
+          {static_cast<rafko_net::Transfer_functions>(transfer_function)});
+    builder.allowed_transfer_functions_by_layer(filter);
+  }
+  m_description.set_allocated_network(builder.create_layers(
+      nullptr, {request.layer_sizes().begin(), request.layer_sizes().end()}));
+  rebuild();
+  return get_state_locked();
+}
+
+SlotResponse
+RafkoServiceSlot::handle_request(const SlotRequest &request,
+                                 const rafko_net::RafkoNet *source_network) {
+  const std::uint32_t actions = request.request_bitstring();
+  const std::uint32_t data_actions =
+      (actions & (serv_slot_to_run_once | serv_slot_to_get_training_sample |
+                  serv_slot_to_get_test_sample));
+  /*!Note: every action is checked before any of them is applied, so a failing
+   * request leaves the slot unchanged */
+  if (0u != (actions & (serv_slot_to_distill_network |
+                        serv_slot_to_amplify_network)))
+    throw std::runtime_error(
+        "Distilling or amplifying networks is not supported by the service!");
+  if (0u != (data_actions & (data_actions - 1u)))
+    throw std::runtime_error("Only one data stream can be provided for one "
+                             "request!");
+  if ((0u != (actions & serv_slot_to_takeover_net)) &&
+      (nullptr == source_network))
+    throw std::runtime_error("Missing source network to take over into slot " +
+                             m_id);
+  if ((0u != (actions & serv_slot_to_start)) &&
+      (serv_slot_to_optimize != m_type))
+    throw std::runtime_error("Slot " + m_id + " is not an optimizer slot!");
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+  SlotResponse response;
+  if (0u != (actions & serv_slot_to_stop))
+    m_running.store(false);
+  if (0u != (actions & serv_slot_to_reset)) {
+    m_iteration = 0u;
+    m_resetSolverMemory = true;
+    if (m_optimizer)
+      m_optimizer->reset_epoch();
+  }
+  bool rebuild_needed = false;
+  if (0u != (actions & serv_slot_to_takeover_net)) {
+    m_description.mutable_network()->CopyFrom(*source_network);
+    rebuild_needed = true;
+  }
+  if (0u != (actions & serv_slot_to_takeover_training_set)) {
+    append_to(request.data_stream(), *m_description.mutable_training_set());
+    rebuild_needed = true;
+  }
+  if (0u != (actions & serv_slot_to_append_test_set)) {
+    append_to(request.data_stream(), *m_description.mutable_test_set());
+    rebuild_needed = true;
+  }
+  if (rebuild_needed)
+    rebuild();
+  if (0u != (actions & serv_slot_to_run_once))
+    *response.mutable_data_stream() = run_once(request.data_stream());
+  if (0u != (actions & serv_slot_to_get_training_sample))
+    *response.mutable_data_stream() =
+        get_sample(m_trainingSet.get(), request.request_index());
+  if (0u != (actions & serv_slot_to_get_test_sample))
+    *response.mutable_data_stream() =
+        get_sample(m_testSet.get(), request.request_index());
+  if (0u != (actions & serv_slot_to_refresh_solution)) {
+    if (!m_solverFactory)
+      throw std::runtime_error("No network to build a solution from in slot " +
+                               m_id);
+    m_solver = m_solverFactory->build(true);
+    m_resetSolverMemory = true;
+  }
+  if (0u != (actions & serv_slot_to_start)) {
+    if (serv_slot_ok != get_state_locked())
+      throw std::runtime_error("Slot " + m_id + " is not ready to start!");
+    m_running.store(true);
+  }
+  response.set_slot_id(m_id);
+  response.set_slot_state(get_state_locked());
+  return response;
+}
+
+SlotInfo RafkoServiceSlot::get_info(std::uint32_t request_bitstring) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  SlotInfo info;
+  auto add_field = [&info](Slot_info_field field, double value) {
+    info.add_info_field(field);
+    info.add_info_package(value);
+  };
+  auto error_of = [](std::shared_ptr<RafkoCPUContext> &context) {
+    if (!context)
+      return std::numeric_limits<double>::quiet_NaN();
+    context->refresh_solution_weights();
+    return -context->full_evaluation();
+  };
+  if (0u != (request_bitstring & slot_info_iteration))
+    add_field(slot_info_iteration, m_iteration);
+  if (0u != (request_bitstring & slot_info_training_error))
+    add_field(slot_info_training_error, error_of(m_trainingContext));
+  if (0u != (request_bitstring & slot_info_training_set_sequence_count))
+    add_field(slot_info_training_set_sequence_count,
+              (m_trainingSet) ? m_trainingSet->get_number_of_sequences() : 0u);
+  if (0u != (request_bitstring & slot_info_test_error))
+    add_field(slot_info_test_error, error_of(m_testContext));
+  if (0u != (request_bitstring & slot_info_test_set_sequence_count))
+    add_field(slot_info_test_set_sequence_count,
+              (m_testSet) ? m_testSet->get_number_of_sequences() : 0u);
+  return info;
+}
+
+rafko_net::RafkoNet RafkoServiceSlot::get_network() {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_description.network();
+}
+
+std::uint32_t RafkoServiceSlot::get_state() {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return get_state_locked();
+}
+
+void RafkoServiceSlot::step() {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (!m_running.load() || !m_optimizer)
+    return;
+  m_optimizer->iterate(*m_trainingSet);
+  ++m_iteration;
+  if (m_optimizer->stop_triggered())
+    m_running.store(false);
+}
+
+void RafkoServiceSlot::check(const ServiceSlot &description) {
+  if ((serv_slot_to_run != description.type()) &&
+      (serv_slot_to_optimize != description.type()))
+    throw std::runtime_error("Unknown slot type: " +
+                             Slot_type_Name(description.type()));
+  if (description.has_hypers() &&
+      ((0u == description.hypers().minibatch_size()) ||
+       (0u == description.hypers().memory_truncation()) ||
+       (0 >= description.hypers().training_relevant_loop_count())))
+    throw std::runtime_error("The minibatch size, memory truncation and "
+                             "training relevant loop count of a slot need to "
+                             "be positive!");
+}
+
+void RafkoServiceSlot::rebuild() {
+  m_running.store(false);
+  m_optimizer.reset();
+  m_testContext.reset();
+  m_trainingContext.reset();
+  m_objective.reset();
+  m_testSet.reset();
+  m_trainingSet.reset();
+  m_solver.reset();
+  m_solverFactory.reset();
+  m_iteration = 0u;
+  m_resetSolverMemory = true;
+
+  /*!Note: One thread for every slot, the cores are shared by scheduling the
+   * slots; sequences are processed by the parallel path of the optimizer as
+   * it handles minibatches starting at any sequence */
+  m_settings = std::make_shared<RafkoSettings>();
+  if (m_description.has_hypers())
+    m_settings->set_hypers(m_description.hypers());
+  m_settings->set_max_solve_threads(1u)
+      .set_max_processing_threads(1u)
+      .set_parallel_sequences(true);
+
+  if (0 == m_description.network().neuron_array_size())
+    return;
+  rafko_net::RafkoNet &network = *m_description.mutable_network();
+  m_solverFactory =
+      std::make_unique<rafko_net::SolutionSolver::Factory>(network, m_settings);
+  m_solver = m_solverFactory->build();
+  if (serv_slot_to_optimize != m_type)
+    return;
+
+  if (is_compatible(m_description.training_set(), network))
+    m_trainingSet = std::make_shared<rafko_gym::RafkoDatasetImplementation>(
+        m_description.training_set());
+  if (is_compatible(m_description.test_set(), network))
+    m_testSet = std::make_shared<rafko_gym::RafkoDatasetImplementation>(
+        m_description.test_set());
+  if (rafko_gym::cost_function_unknown != m_description.cost_function())
+    m_objective = std::make_shared<rafko_gym::RafkoCost>(
+        *m_settings, m_description.cost_function());
+  if (!m_trainingSet || !m_objective)
+    return;
+
+  m_trainingContext =
+      std::make_shared<RafkoCPUContext>(network, m_settings, m_objective);
+  m_trainingContext->set_data_set(m_trainingSet);
+  if (m_testSet) {
+    m_testContext =
+        std::make_shared<RafkoCPUContext>(network, m_settings, m_objective);
+    m_testContext->set_data_set(m_testSet);
+  }
+  m_optimizer = std::make_unique<rafko_gym::RafkoAutodiffOptimizer>(
+      m_settings, network, m_trainingContext, m_testContext);
+  m_optimizer->build(m_trainingSet, m_objective);
+  m_optimizer->set_weight_updater(m_description.weight_updater());
+}
+
+std::uint32_t RafkoServiceSlot::get_state_locked() const {
+  std::uint32_t state = 0u;
+  if (!m_solverFactory)
+    state |= serv_slot_missing_net;
+  if (!m_solver)
+    state |= serv_slot_missing_solution;
+  if (serv_slot_to_optimize == m_type) {
+    if (!m_trainingSet)
+      state |= serv_slot_missing_data_set;
+    if (!m_objective)
+      state |= serv_slot_missing_cost_function;
+    if (!m_optimizer)
+      state |= serv_slot_missing_trainer;
+  }
+  return (0u == state) ? static_cast<std::uint32_t>(serv_slot_ok) : state;
+}
+
+NeuralIOStream RafkoServiceSlot::run_once(const NeuralIOStream &data_stream) {
+  if (!m_solver)
+    throw std::runtime_error("No solution to run in slot " + m_id);
+  const rafko_net::RafkoNet &network = m_description.network();
+  const std::uint32_t sequence_size = std::max(1u, data_stream.sequence_size());
+  const std::uint32_t step_size = data_stream.input_size() +
+                                  data_stream.label_size() +
+                                  data_stream.feature_size();
+  if ((data_stream.input_size() != network.input_data_size()) ||
+      (0 == data_stream.package_size()) ||
+      (0u != (data_stream.package_size() % (step_size * sequence_size))))
+    throw std::runtime_error(
+        "The data stream doesn't fit the network of slot " + m_id);
+
+  NeuralIOStream result;
+  result.set_sequence_size(sequence_size);
+  result.set_feature_size(network.output_neuron_number());
+  m_solver->refresh_weights();
+  std::vector<double> input(network.input_data_size());
+  const std::uint32_t step_count = data_stream.package_size() / step_size;
+  for (std::uint32_t step_index = 0u; step_index < step_count; ++step_index) {
+    auto input_start = data_stream.package().begin() + step_index * step_size;
+    std::copy(input_start, input_start + input.size(), input.begin());
+    /*!Note: The first sequence continues from the memory of the previous run,
+     * unless it was reset; the other sequences always start from scratch */
+    const bool reset_memory =
+        ((0u == step_index) ? m_resetSolverMemory
+                            : (0u == (step_index % sequence_size)));
+    rafko_utilities::ConstVectorSubrange<> output =
+        m_solver->solve(input, reset_memory);
+    result.mutable_package()->Add(output.begin(), output.end());
+  }
+  m_resetSolverMemory = false;
+  return result;
+}
+
+void RafkoServiceSlot::append_to(const NeuralIOStream &data_stream,
+                                 rafko_gym::DataSetPackage &data_set) {
+  const std::uint32_t sequence_size = std::max(1u, data_stream.sequence_size());
+  const std::uint32_t step_size = data_stream.input_size() +
+                                  data_stream.label_size() +
+                                  data_stream.feature_size();
+  if ((0u == data_stream.input_size()) || (0u == data_stream.label_size()) ||
+      (0 == data_stream.package_size()) ||
+      (0u != (data_stream.package_size() % (step_size * sequence_size))))
+    throw std::runtime_error("Incomplete sequences in the data stream!");
+  if (0 < data_set.labels_size()) {
+    if ((data_set.input_size() != data_stream.input_size()) ||
+        (data_set.feature_size() != data_stream.label_size()) ||
+        (data_set.sequence_size() != sequence_size))
+      throw std::runtime_error(
+          "The data stream doesn't match the sequences of the data set!");
+    if ((data_set.inputs_size() / data_set.input_size()) !=
+        (data_set.labels_size() / data_set.feature_size()))
+      throw std::runtime_error(
+          "Unable to append to a data set with prefill inputs!");
+  } else {
+    data_set.Clear();
+    data_set.set_input_size(data_stream.input_size());
+    data_set.set_feature_size(data_stream.label_size());
+    data_set.set_sequence_size(sequence_size);
+  }
+  for (auto step_start = data_stream.package().begin();
+       step_start != data_stream.package().end(); step_start += step_size) {
+    auto label_start = step_start + data_stream.input_size();
+    data_set.mutable_inputs()->Add(step_start, label_start);
+    data_set.mutable_labels()->Add(label_start,
+                                   label_start + data_stream.label_size());
+  }
+}
+
+NeuralIOStream
+RafkoServiceSlot::get_sample(const rafko_gym::RafkoDataSet *data_set,
+                             std::uint32_t sequence_index) {
+  if ((nullptr == data_set) ||
+      (sequence_index >= data_set->get_number_of_sequences()))
+    throw std::runtime_error("Requested sequence " +
+                             std::to_string(sequence_index) +
+                             " is not in the data set!");
+  NeuralIOStream result;
+  result.set_sequence_size(data_set->get_sequence_size());
+  result.set_input_size(data_set->get_input_size());
+  result.set_label_size(data_set->get_feature_size());
+  const std::uint32_t raw_input_start =
+      sequence_index * data_set->get_inputs_in_one_sequence();
+  const std::uint32_t raw_label_start =
+      sequence_index * data_set->get_sequence_size();
+  const std::uint32_t prefill = data_set->get_prefill_inputs_number();
+  for (std::uint32_t prefill_index = 0u; prefill_index < prefill;
+       ++prefill_index) {
+    const rafko_gym::RafkoDataSet::SampleView input =
+        data_set->get_input_view(raw_input_start + prefill_index);
+    result.mutable_package()->Add(input.begin(), input.end());
+  }
+  for (std::uint32_t step = 0u; step < data_set->get_sequence_size(); ++step) {
+    const rafko_gym::RafkoDataSet::SampleView input =
+        data_set->get_input_view(raw_input_start + prefill + step);
+    const rafko_gym::RafkoDataSet::SampleView label =
+        data_set->get_label_view(raw_label_start + step);
+    result.mutable_package()->Add(input.begin(), input.end());
+    result.mutable_package()->Add(label.begin(), label.end());
+  }
+  return result;
+}
+
+} /* namespace rafko_mainframe */
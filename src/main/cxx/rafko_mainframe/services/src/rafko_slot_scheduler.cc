@@ -0,0 +1,250 @@
+/*! This file is part of davids91/Rafko.
+ *
+ *    Rafko is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    (at your option) any later version.
+ *
+ *    Rafko is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with Rafko.  If not, see <https://www.gnu.org/licenses/> or
+ *    <https://github.com/davids91/rafko/blob/master/LICENSE>
+ */
+
+#include "rafko_mainframe/services/rafko_slot_scheduler.hpp"
+
+#include <stdexcept>
+#include <utility>
+
+namespace rafko_mainframe {
+
+RafkoSlotScheduler::RafkoSlotScheduler(std::uint32_t worker_count,
+                                       std::chrono::milliseconds time_slice)
+    : m_timeSlice(time_slice) {
+  RFASSERT(0u < worker_count);
+  for (std::uint32_t worker_index = 0u; worker_index < worker_count;
+       ++worker_index)
+    m_trainingWorkers.emplace_back(&RafkoSlotScheduler::train_slots, this);
+}
+
+RafkoSlotScheduler::~RafkoSlotScheduler() {
+  {
+    std::lock_guard<std::mutex> lock(m_queueMutex);
+    m_stopping = true;
+  }
+  m_queueCondition.notify_all();
+  for (std::thread &worker : m_trainingWorkers)
+    worker.join();
+  for (auto &[slot_id, worker] : m_dedicatedWorkers)
+    stop_dedicated_worker(*worker);
+}
+
+SlotResponse RafkoSlotScheduler::add_slot(const ServiceSlot &description) {
+  ServiceSlot slot_description(description);
+  {
+    std::lock_guard<std::mutex> lock(m_slotsMutex);
+    if (slot_description.slot_id().empty()) {
+      do {
+        slot_description.set_slot_id("slot_" +
+                                     std::to_string(m_nextSlotIndex++));
+      } while (0u < m_slots.count(slot_description.slot_id()));
+    }
+  }
+  /*!Note: The slot is built outside the lock, so building it doesn't block
+   * requests to the other slots */
+  std::shared_ptr<RafkoServiceSlot> slot =
+      std::make_shared<RafkoServiceSlot>(slot_description);
+  std::lock_guard<std::mutex> lock(m_slotsMutex);
+  if (!m_slots.emplace(slot->get_id(), slot).second)
+    throw std::runtime_error("Slot " + slot->get_id() + " already exists!");
+  if (serv_slot_to_run == slot->get_type()) {
+    std::shared_ptr<DedicatedWorker> worker =
+        std::make_shared<DedicatedWorker>();
+    worker->thread =
+        std::thread(&RafkoSlotScheduler::run_dedicated_worker, worker);
+    m_dedicatedWorkers.emplace(slot->get_id(), worker);
+  }
+  SlotResponse response;
+  response.set_slot_id(slot->get_id());
+  response.set_slot_state(slot->get_state());
+  return response;
+}
+
+SlotResponse RafkoSlotScheduler::update_slot(const ServiceSlot &description) {
+  std::shared_ptr<RafkoServiceSlot> slot = get_slot(description.slot_id());
+  SlotResponse response;
+  response.set_slot_id(slot->get_id());
+  response.set_slot_state(slot->update(description));
+  return response;
+}
+
+std::shared_ptr<RafkoServiceSlot>
+RafkoSlotScheduler::get_slot(const std::string &slot_id) const {
+  std::lock_guard<std::mutex> lock(m_slotsMutex);
+  auto slot = m_slots.find(slot_id);
+  if (slot == m_slots.end())
+    throw std::runtime_error("Unknown slot: " + slot_id);
+  return slot->second;
+}
+
+void RafkoSlotScheduler::request(const SlotRequest &request,
+                                 ResponseCallback callback) {
+  SlotResponse response;
+  try {
+    if (0u != (request.request_bitstring() & serv_slot_to_die)) {
+      remove_slot(request.target_slot_id());
+      response.set_slot_id(request.target_slot_id());
+      response.set_slot_state(serv_slot_state_unknown);
+    } else {
+      std::shared_ptr<RafkoServiceSlot> slot =
+          get_slot(request.target_slot_id());
+      std::shared_ptr<rafko_net::RafkoNet> source_network;
+      if (0u != (request.request_bitstring() & serv_slot_to_takeover_net))
+        source_network = std::make_shared<rafko_net::RafkoNet>(
+            get_slot(request.source_slot_id())->get_network());
+      if (serv_slot_to_run == slot->get_type()) {
+        std::lock_guard<std::mutex> lock(m_slotsMutex);
+        auto worker = m_dedicatedWorkers.find(slot->get_id());
+        if (worker == m_dedicatedWorkers.end())
+          throw std::runtime_error("Slot " + slot->get_id() +
+                                   " is being removed!");
+        {
+          std::lock_guard<std::mutex> worker_lock(worker->second->mutex);
+          worker->second->tasks.push_back(
+              [this, slot, request, source_network, callback]() {
+                SlotResponse response;
+                try {
+                  response = execute(slot, request, source_network.get());
+                } catch (...) {
+                  callback(response, std::current_exception());
+                  return;
+                }
+                callback(response, nullptr);
+              });
+        }
+        worker->second->condition.notify_one();
+        return;
+      }
+      response = execute(slot, request, source_network.get());
+    }
+  } catch (...) {
+    callback(SlotResponse(), std::current_exception());
+    return;
+  }
+  callback(response, nullptr);
+}
+
+void RafkoSlotScheduler::schedule(std::shared_ptr<RafkoServiceSlot> slot) {
+  {
+    std::lock_guard<std::mutex> lock(m_queueMutex);
+    if (!m_scheduledSlots.insert(slot.get()).second)
+      return;
+    m_readyQueue.push_back(slot);
+  }
+  m_queueCondition.notify_one();
+}
+
+void RafkoSlotScheduler::train_slots() {
+  while (true) {
+    std::shared_ptr<RafkoServiceSlot> slot;
+    {
+      std::unique_lock<std::mutex> lock(m_queueMutex);
+      m_queueCondition.wait(
+          lock, [this]() { return m_stopping || !m_readyQueue.empty(); });
+      if (m_stopping)
+        return;
+      slot = m_readyQueue.front();
+      m_readyQueue.pop_front();
+    }
+    const std::chrono::steady_clock::time_point slice_end =
+        std::chrono::steady_clock::now() + m_timeSlice;
+    try {
+      while (slot->is_running() &&
+             (std::chrono::steady_clock::now() < slice_end))
+        slot->step();
+    } catch (const std::exception &) {
+      /*!Note: A slot failing to train is stopped, its state can still be
+       * queried through its requests */
+      slot->stop();
+    }
+    /*!Note: The running state is checked under the queue lock, so a slot
+     * started while it's being trained is either kept in the queue here, or
+     * queued again by @schedule */
+    std::lock_guard<std::mutex> lock(m_queueMutex);
+    if (slot->is_running()) {
+      m_readyQueue.push_back(slot);
+      m_queueCondition.notify_one();
+    } else {
+      m_scheduledSlots.erase(slot.get());
+    }
+  }
+}
+
+void RafkoSlotScheduler::remove_slot(const std::string &slot_id) {
+  std::shared_ptr<RafkoServiceSlot> slot;
+  std::shared_ptr<DedicatedWorker> worker;
+  {
+    std::lock_guard<std::mutex> lock(m_slotsMutex);
+    auto slot_iterator = m_slots.find(slot_id);
+    if (slot_iterator == m_slots.end())
+      throw std::runtime_error("Unknown slot: " + slot_id);
+    slot = slot_iterator->second;
+    m_slots.erase(slot_iterator);
+    auto worker_iterator = m_dedicatedWorkers.find(slot_id);
+    if (worker_iterator != m_dedicatedWorkers.end()) {
+      worker = worker_iterator->second;
+      m_dedicatedWorkers.erase(worker_iterator);
+    }
+  }
+  slot->stop();
+  if (worker)
+    stop_dedicated_worker(*worker);
+}
+
+SlotResponse
+RafkoSlotScheduler::execute(std::shared_ptr<RafkoServiceSlot> slot,
+                            const SlotRequest &request,
+                            const rafko_net::RafkoNet *source_network) {
+  SlotResponse response = slot->handle_request(request, source_network);
+  if (slot->is_running())
+    schedule(slot);
+  return response;
+}
+
+void RafkoSlotScheduler::run_dedicated_worker(
+    std::shared_ptr<DedicatedWorker> worker) {
+  while (true) {
+    std::function<void()> task;
+    {
+      std::unique_lock<std::mutex> lock(worker->mutex);
+      worker->condition.wait(lock, [&worker]() {
+        return worker->stopping || !worker->tasks.empty();
+      });
+      if (worker->tasks.empty())
+        return;
+      task = std::move(worker->tasks.front());
+      worker->tasks.pop_front();
+    }
+    task();
+  }
+}
+
+void RafkoSlotScheduler::stop_dedicated_worker(DedicatedWorker &worker) {
+  {
+    std::lock_guard<std::mutex> lock(worker.mutex);
+    worker.stopping = true;
+  }
+  worker.condition.notify_one();
+  /*!Note: A slot might be removed by a callback running on its own thread,
+   * which keeps the worker alive until it finishes */
+  if (worker.thread.get_id() == std::this_thread::get_id())
+    worker.thread.detach();
+  else
+    worker.thread.join();
+}
+
+} /* namespace rafko_mainframe */
@@ -20,6 +20,7 @@
 
 #include "rafko_global.hpp"
 
+#include <cstddef>
 #include <set>
 #if (RAFKO_USES_OPENCL)
 #include <string>
@@ -54,6 +55,26 @@ public:
    */
   static double collect(Input_functions function, double a, double b);
 
+  /**
+   * @brief      Apply the given input function to the given single precision
+   * inputs; used by reduced precision inference
+   */
+  static float collect(Input_functions function, float a, float b);
+
+  /**
+   * @brief      Collects an array of weighted values into an array of
+   * accumulated values through the given input function, element-wise
+   *
+   * @param[in]      function      The function to apply
+   * @param[in,out]  accumulator   The values to merge into, and the results
+   * @param[in]      values        The values to merge into @accumulator
+   * @param[in]      weight        The weight to multiply every value with
+   * @param[in]      count         The number of elements in both arrays
+   */
+  static void collect_weighted(Input_functions function, double *accumulator,
+                               const double *values, double weight,
+                               std::size_t count);
+
   /**
    * @brief      Calculate the derivative value of the given input function and
    * the given inputs
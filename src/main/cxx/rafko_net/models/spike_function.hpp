@@ -22,6 +22,7 @@
 
 #include "rafko_protocol/rafko_net.pb.h"
 
+#include <cstddef>
 #include <set>
 #if (RAFKO_USES_OPENCL)
 #include <string>
@@ -59,6 +60,21 @@ public:
   static double get_value(Spike_functions function, double parameter,
                           double new_data, double previous_data);
 
+  /**
+   * @brief      Apply the given spike function to an array of activation data
+   *
+   * @param[in]       function        The function to apply
+   * @param[in]       parameter       The parameter supplied by a Neuron
+   * @param[in]       new_data        The latest data as inputs to the spike
+   * function
+   * @param[in,out]   previous_data   The previously stored states of the Spike
+   * function, overwritten by the results
+   * @param[in]       count           The number of elements in both arrays
+   */
+  static void get_values(Spike_functions function, double parameter,
+                         const double *new_data, double *previous_data,
+                         std::size_t count);
+
   /**
    * @brief      Calculates the derivative of the spike function
    *             in case the basis of the derivative is the relevant parameter
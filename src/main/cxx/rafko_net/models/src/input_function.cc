@@ -54,6 +54,34 @@ double InputFunction::collect(Input_functions function, double a, double b) {
   };
 }
 
+float InputFunction::collect(Input_functions function, float a, float b) {
+  switch (function) {
+  case input_function_add:
+    return a + b;
+  case input_function_multiply:
+    return a * b;
+  default:
+    throw std::runtime_error("Unidentified Input function called!");
+  };
+}
+
+void InputFunction::collect_weighted(Input_functions function,
+                                     double *accumulator, const double *values,
+                                     double weight, std::size_t count) {
+  switch (function) {
+  case input_function_add:
+    for (std::size_t i = 0u; i < count; ++i)
+      accumulator[i] += values[i] * weight;
+    break;
+  case input_function_multiply:
+    for (std::size_t i = 0u; i < count; ++i)
+      accumulator[i] *= values[i] * weight;
+    break;
+  default:
+    throw std::runtime_error("Unidentified Input function called!");
+  };
+}
+
 double InputFunction::get_derivative(Input_functions function, double a,
                                      double a_dw, double b, double b_dw) {
   switch (function) {
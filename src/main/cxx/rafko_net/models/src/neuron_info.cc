@@ -17,6 +17,8 @@
 
 #include "rafko_net/models/neuron_info.hpp"
 
+#include "rafko_net/services/synapse_iterator.hpp"
+
 namespace rafko_net {
 
 bool NeuronInfo::is_neuron_valid(const Neuron &neuron) {
@@ -43,7 +45,9 @@ bool NeuronInfo::is_neuron_valid(const Neuron &neuron) {
 
     std::uint32_t number_of_input_indexes = 0;
     for (int i = 0; i < neuron.input_indices_size(); ++i) {
-      number_of_input_indexes += neuron.input_indices(i).interval_size();
+      number_of_input_indexes +=
+          SynapseIterator<InputSynapseInterval>::synapse_size(
+              neuron.input_indices(i));
     }
 
     std::uint32_t number_of_input_weights = 0;
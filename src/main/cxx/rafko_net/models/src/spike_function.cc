@@ -17,6 +17,7 @@
 
 #include "rafko_net/models/spike_function.hpp"
 
+#include <algorithm>
 #include <stdexcept>
 
 #if (RAFKO_USES_OPENCL)
@@ -45,6 +46,32 @@ double SpikeFunction::get_value(Spike_functions function, double parameter,
   }
 }
 
+void SpikeFunction::get_values(Spike_functions function, double parameter,
+                               const double *new_data, double *previous_data,
+                               std::size_t count) {
+  switch (function) {
+  case spike_function_none:
+    std::copy(new_data, new_data + count, previous_data);
+    break;
+  case spike_function_memory:
+    for (std::size_t i = 0u; i < count; ++i)
+      previous_data[i] =
+          (previous_data[i] * parameter) + (new_data[i] * (1.0 - parameter));
+    break;
+  case spike_function_p:
+    for (std::size_t i = 0u; i < count; ++i)
+      previous_data[i] += (new_data[i] - previous_data[i]) * parameter;
+    break;
+  case spike_function_amplify_value:
+    for (std::size_t i = 0u; i < count; ++i)
+      previous_data[i] = new_data[i] * parameter;
+    break;
+  default:
+    throw std::runtime_error(
+        "Unknown spike function requested for calculation!");
+  }
+}
+
 double SpikeFunction::get_derivative_for_w(/* means: x = w; new_data = g(x);
                                               previous_data = f(x) */
                                            Spike_functions function,
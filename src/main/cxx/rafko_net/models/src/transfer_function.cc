@@ -17,6 +17,10 @@
 
 #include "rafko_net/models/transfer_function.hpp"
 
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
 #include <math.h>
 #include <stdexcept>
 #if (RAFKO_USES_OPENCL)
@@ -26,6 +30,334 @@
 #endif /*(RAFKO_USES_OPENCL)*/
 #include "rafko_mainframe/services/rafko_assertion_logger.hpp"
 
+#if defined(__GNUC__) && !defined(__clang__) &&                                \
+    (defined(__x86_64__) || defined(__i386__))
+#define RAFKO_VECTORIZED_TRANSFER_FUNCTIONS 1
+#else
+#define RAFKO_VECTORIZED_TRANSFER_FUNCTIONS 0
+#endif
+
+#if (RAFKO_VECTORIZED_TRANSFER_FUNCTIONS)
+namespace {
+
+/*!Note: Everything in this block is compiled with auto-vectorization enabled
+ * and without floating point trap semantics, so both sides of the selections
+ * below can be evaluated, and the loops calling the helpers are vectorized for
+ * every instruction set the kernels are cloned for. */
+#pragma GCC push_options
+#pragma GCC optimize("O3", "no-trapping-math")
+
+#define RAFKO_KERNEL_INLINE inline __attribute__((always_inline))
+
+constexpr double s_expOverflow = 709.782712893384; /* exp(x) is inf above */
+constexpr double s_expUnderflow = -708.0; /* exp(x) is flushed to 0 below */
+constexpr double s_log2e = 1.4426950408889634074;
+constexpr double s_ln2High = 6.93147180369123816490e-01;
+constexpr double s_ln2Low = 1.90821492927058770002e-10;
+constexpr double s_halfLn2 = 0.34657359027997265471;
+constexpr double s_roundingShifter = 6755399441055744.0; /* 1.5 * 2^52 */
+constexpr std::uint64_t s_roundingShifterBits = 0x4338000000000000u;
+
+/**
+ * @brief      Calculates exp(r) - 1 for |r| <= ln(2)/2 with a Taylor polynomial
+ * of degree 13, which is accurate to double precision in that range
+ */
+RAFKO_KERNEL_INLINE double reduced_expm1(double r) {
+  double p = 1.0 / 6227020800.0;
+  p = p * r + 1.0 / 479001600.0;
+  p = p * r + 1.0 / 39916800.0;
+  p = p * r + 1.0 / 3628800.0;
+  p = p * r + 1.0 / 362880.0;
+  p = p * r + 1.0 / 40320.0;
+  p = p * r + 1.0 / 5040.0;
+  p = p * r + 1.0 / 720.0;
+  p = p * r + 1.0 / 120.0;
+  p = p * r + 1.0 / 24.0;
+  p = p * r + 1.0 / 6.0;
+  p = p * r + 0.5;
+  p = p * r + 1.0;
+  return p * r;
+}
+
+/**
+ * @brief      exp(x) as 2^k * exp(r), where x = k * ln(2) + r and |r| <=
+ * ln(2)/2. k is rounded with the shifter trick so it never leaves the floating
+ * point domain, and 2^(k-1) is assembled from its bits directly.
+ */
+RAFKO_KERNEL_INLINE double vector_exp(double x) {
+  const double above_minimum = (x < s_expUnderflow) ? s_expUnderflow : x;
+  const double clamped =
+      (above_minimum > s_expOverflow) ? s_expOverflow : above_minimum;
+  const double shifted = clamped * s_log2e + s_roundingShifter;
+  const double k = shifted - s_roundingShifter;
+  const double r = (clamped - k * s_ln2High) - k * s_ln2Low;
+  std::uint64_t bits;
+  std::memcpy(&bits, &shifted, sizeof(bits));
+  bits = (bits - s_roundingShifterBits + 1022u) << 52u;
+  double half_scale;
+  std::memcpy(&half_scale, &bits, sizeof(half_scale));
+  const double result = (1.0 + reduced_expm1(r)) * half_scale * 2.0;
+  return (x < s_expUnderflow) ? 0.0 : result;
+}
+
+/**
+ * @brief      exp(x) - 1 without the cancellation around zero
+ */
+RAFKO_KERNEL_INLINE double vector_expm1(double x) {
+  return (std::fabs(x) <= s_halfLn2) ? reduced_expm1(x)
+                                     : (vector_exp(x) - 1.0);
+}
+
+/**
+ * @brief      tanh(x) from exp(-2|x|), with a Taylor series close to zero where
+ * the division would lose precision
+ */
+RAFKO_KERNEL_INLINE double vector_tanh(double x) {
+  const double magnitude = std::fabs(x);
+  const double e = vector_exp(-2.0 * magnitude);
+  const double square = magnitude * magnitude;
+  double series = 21844.0 / 6081075.0;
+  series = series * square - 1382.0 / 155925.0;
+  series = series * square + 62.0 / 2835.0;
+  series = series * square - 17.0 / 315.0;
+  series = series * square + 2.0 / 15.0;
+  series = series * square - 1.0 / 3.0;
+  series = magnitude + magnitude * square * series;
+  const double result = (magnitude < 0.1) ? series : ((1.0 - e) / (1.0 + e));
+  return (x < 0.0) ? -result : result;
+}
+
+RAFKO_KERNEL_INLINE void
+transfer_values(rafko_net::Transfer_functions function, double alpha,
+                double lambda, const double *data, double *result,
+                std::size_t count) {
+  switch (function) {
+  case rafko_net::transfer_function_sigmoid:
+    for (std::size_t i = 0u; i < count; ++i)
+      result[i] = 1.0 / (1.0 + vector_exp(-data[i]));
+    break;
+  case rafko_net::transfer_function_tanh:
+    for (std::size_t i = 0u; i < count; ++i)
+      result[i] = vector_tanh(data[i]);
+    break;
+  case rafko_net::transfer_function_elu:
+    for (std::size_t i = 0u; i < count; ++i)
+      result[i] =
+          (data[i] <= 0.0) ? (alpha * vector_expm1(data[i])) : data[i];
+    break;
+  case rafko_net::transfer_function_selu:
+    for (std::size_t i = 0u; i < count; ++i)
+      result[i] = lambda * ((data[i] <= 0.0) ? (alpha * vector_expm1(data[i]))
+                                             : data[i]);
+    break;
+  case rafko_net::transfer_function_swish:
+    for (std::size_t i = 0u; i < count; ++i)
+      result[i] = data[i] / (1.0 + vector_exp(-data[i]));
+    break;
+  default:
+    break; /* Only the functions involving exp are dispatched here */
+  }
+}
+
+RAFKO_KERNEL_INLINE void
+transfer_derivatives(rafko_net::Transfer_functions function, double alpha,
+                     double lambda, const double *input,
+                     const double *input_dw, double *result,
+                     std::size_t count) {
+  switch (function) {
+  case rafko_net::transfer_function_sigmoid:
+    for (std::size_t i = 0u; i < count; ++i) {
+      /* Same formula as the scalar variant, so the results stay consistent */
+      const double e = vector_exp(input[i]);
+      const double inverse_e = 1.0 / e;
+      result[i] =
+          (input_dw[i] * e) / ((inverse_e + 1.0) * (inverse_e + 1.0));
+    }
+    break;
+  case rafko_net::transfer_function_tanh:
+    for (std::size_t i = 0u; i < count; ++i) {
+      const double e = vector_exp(std::fabs(input[i]));
+      const double double_cosh = e + (1.0 / e);
+      result[i] = (4.0 * input_dw[i]) / (double_cosh * double_cosh);
+    }
+    break;
+  case rafko_net::transfer_function_elu:
+    for (std::size_t i = 0u; i < count; ++i)
+      result[i] = (input[i] <= 0.0)
+                      ? (alpha * vector_exp(input[i]) * input_dw[i])
+                      : input_dw[i];
+    break;
+  case rafko_net::transfer_function_selu:
+    for (std::size_t i = 0u; i < count; ++i)
+      result[i] = (input[i] <= 0.0)
+                      ? (lambda * alpha * vector_exp(input[i]) * input_dw[i])
+                      : (lambda * input_dw[i]);
+    break;
+  case rafko_net::transfer_function_swish:
+    for (std::size_t i = 0u; i < count; ++i) {
+      /* swish'(x) = sigmoid(x) * (1 + x * (1 - sigmoid(x))) */
+      const double e = vector_exp(-std::fabs(input[i]));
+      const double positive_part = 1.0 / (1.0 + e);
+      const double negative_part = e / (1.0 + e);
+      const double sigmoid = (input[i] < 0.0) ? negative_part : positive_part;
+      const double sigmoid_complement =
+          (input[i] < 0.0) ? positive_part : negative_part;
+      result[i] =
+          input_dw[i] * sigmoid * (1.0 + input[i] * sigmoid_complement);
+    }
+    break;
+  default:
+    break; /* Only the functions involving exp are dispatched here */
+  }
+}
+
+/* Clones of the kernels for each supported instruction set */
+using ValuesKernel = void (*)(rafko_net::Transfer_functions, double, double,
+                              const double *, double *, std::size_t);
+using DerivativesKernel = void (*)(rafko_net::Transfer_functions, double,
+                                   double, const double *, const double *,
+                                   double *, std::size_t);
+
+void transfer_values_default(rafko_net::Transfer_functions function,
+                             double alpha, double lambda, const double *data,
+                             double *result, std::size_t count) {
+  transfer_values(function, alpha, lambda, data, result, count);
+}
+
+__attribute__((target("avx2,fma"))) void
+transfer_values_avx2(rafko_net::Transfer_functions function, double alpha,
+                     double lambda, const double *data, double *result,
+                     std::size_t count) {
+  transfer_values(function, alpha, lambda, data, result, count);
+}
+
+__attribute__((target("avx512f,prefer-vector-width=512"))) void
+transfer_values_avx512(rafko_net::Transfer_functions function, double alpha,
+                       double lambda, const double *data, double *result,
+                       std::size_t count) {
+  transfer_values(function, alpha, lambda, data, result, count);
+}
+
+void transfer_derivatives_default(rafko_net::Transfer_functions function,
+                                  double alpha, double lambda,
+                                  const double *input, const double *input_dw,
+                                  double *result, std::size_t count) {
+  transfer_derivatives(function, alpha, lambda, input, input_dw, result, count);
+}
+
+__attribute__((target("avx2,fma"))) void
+transfer_derivatives_avx2(rafko_net::Transfer_functions function, double alpha,
+                          double lambda, const double *input,
+                          const double *input_dw, double *result,
+                          std::size_t count) {
+  transfer_derivatives(function, alpha, lambda, input, input_dw, result, count);
+}
+
+__attribute__((target("avx512f,prefer-vector-width=512"))) void
+transfer_derivatives_avx512(rafko_net::Transfer_functions function,
+                            double alpha, double lambda, const double *input,
+                            const double *input_dw, double *result,
+                            std::size_t count) {
+  transfer_derivatives(function, alpha, lambda, input, input_dw, result, count);
+}
+
+#undef RAFKO_KERNEL_INLINE
+#pragma GCC pop_options
+
+enum class KernelSet { sse, avx2, avx512 };
+
+KernelSet supported_kernel_set() {
+  static const KernelSet kernel_set = []() {
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f"))
+      return KernelSet::avx512;
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+      return KernelSet::avx2;
+    return KernelSet::sse;
+  }();
+  return kernel_set;
+}
+
+ValuesKernel values_kernel() {
+  switch (supported_kernel_set()) {
+  case KernelSet::avx512:
+    return transfer_values_avx512;
+  case KernelSet::avx2:
+    return transfer_values_avx2;
+  default:
+    return transfer_values_default;
+  }
+}
+
+DerivativesKernel derivatives_kernel() {
+  switch (supported_kernel_set()) {
+  case KernelSet::avx512:
+    return transfer_derivatives_avx512;
+  case KernelSet::avx2:
+    return transfer_derivatives_avx2;
+  default:
+    return transfer_derivatives_default;
+  }
+}
+
+constexpr bool is_vectorized(rafko_net::Transfer_functions function) {
+  switch (function) {
+  case rafko_net::transfer_function_sigmoid:
+  case rafko_net::transfer_function_tanh:
+  case rafko_net::transfer_function_elu:
+  case rafko_net::transfer_function_selu:
+  case rafko_net::transfer_function_swish:
+    return true;
+  default:
+    return false;
+  }
+}
+
+} /* namespace */
+#endif /*(RAFKO_VECTORIZED_TRANSFER_FUNCTIONS)*/
+
+namespace {
+
+/* The saturating functions are tabulated inside [-range, range], outside of
+ * it the values at the edges of the table are used */
+constexpr double s_lookupRange = 8.0;
+constexpr std::uint32_t s_lookupIntervals = 256u;
+using LookupTable = std::array<double, s_lookupIntervals + 1u>;
+
+template <typename Function> LookupTable build_lookup_table(Function function) {
+  LookupTable table;
+  for (std::uint32_t index = 0u; index <= s_lookupIntervals; ++index)
+    table[index] = function(-s_lookupRange + ((2.0 * s_lookupRange * index) /
+                                              s_lookupIntervals));
+  return table;
+}
+
+double look_up(const LookupTable &table, double data) {
+  const double position =
+      (data + s_lookupRange) * (s_lookupIntervals / (2.0 * s_lookupRange));
+  if (!(0.0 < position)) /* NaN is stored at the first entry as well */
+    return table.front();
+  if (position >= s_lookupIntervals)
+    return table.back();
+  const std::uint32_t index = static_cast<std::uint32_t>(position);
+  const double ratio = position - index;
+  return table[index] + ((table[index + 1u] - table[index]) * ratio);
+}
+
+const LookupTable &sigmoid_table() {
+  static const LookupTable table = build_lookup_table(
+      [](double data) { return 1.0 / (1.0 + std::exp(-data)); });
+  return table;
+}
+
+const LookupTable &tanh_table() {
+  static const LookupTable table =
+      build_lookup_table([](double data) { return std::tanh(data); });
+  return table;
+}
+
+} /* namespace */
+
 namespace rafko_net {
 
 Transfer_functions TransferFunction::next(std::set<Transfer_functions> range) {
@@ -73,6 +405,22 @@ double TransferFunction::get_value(Transfer_functions function,
   }
 }
 
+double TransferFunction::get_lookup_value(Transfer_functions function,
+                                          double data) const {
+  switch (function) {
+  case transfer_function_sigmoid:
+    return look_up(sigmoid_table(), data);
+  case transfer_function_tanh:
+    return look_up(tanh_table(), data);
+  case transfer_function_swish: /* not saturated outside of the table */
+    if (std::abs(data) < s_lookupRange)
+      return data * look_up(sigmoid_table(), data);
+    return get_value(function, data);
+  default:
+    return get_value(function, data);
+  }
+}
+
 double TransferFunction::get_derivative(Transfer_functions function,
                                         double input, double input_dw) const {
   switch (function) {
@@ -108,6 +456,61 @@ double TransferFunction::get_derivative(Transfer_functions function,
   }
 }
 
+void TransferFunction::get_values(Transfer_functions function,
+                                  const double *data, double *result,
+                                  std::size_t count) const {
+  switch (function) {
+  case transfer_function_identity:
+    if (data != result)
+      std::copy(data, data + count, result);
+    return;
+  case transfer_function_relu:
+    for (std::size_t i = 0u; i < count; ++i)
+      result[i] = std::max(0.0, data[i]);
+    return;
+  default:
+    break;
+  }
+#if (RAFKO_VECTORIZED_TRANSFER_FUNCTIONS)
+  if (is_vectorized(function)) {
+    static const ValuesKernel kernel = values_kernel();
+    kernel(function, m_settings.get_alpha(), m_settings.get_lambda(), data,
+           result, count);
+    return;
+  }
+#endif /*(RAFKO_VECTORIZED_TRANSFER_FUNCTIONS)*/
+  for (std::size_t i = 0u; i < count; ++i)
+    result[i] = get_value(function, data[i]);
+}
+
+void TransferFunction::get_derivatives(Transfer_functions function,
+                                       const double *input,
+                                       const double *input_dw, double *result,
+                                       std::size_t count) const {
+  switch (function) {
+  case transfer_function_identity:
+    if (input_dw != result)
+      std::copy(input_dw, input_dw + count, result);
+    return;
+  case transfer_function_relu:
+    for (std::size_t i = 0u; i < count; ++i)
+      result[i] = (input[i] <= 0.0) ? 0.0 : input_dw[i];
+    return;
+  default:
+    break;
+  }
+#if (RAFKO_VECTORIZED_TRANSFER_FUNCTIONS)
+  if (is_vectorized(function)) {
+    static const DerivativesKernel kernel = derivatives_kernel();
+    kernel(function, m_settings.get_alpha(), m_settings.get_lambda(), input,
+           input_dw, result, count);
+    return;
+  }
+#endif /*(RAFKO_VECTORIZED_TRANSFER_FUNCTIONS)*/
+  for (std::size_t i = 0u; i < count; ++i)
+    result[i] = get_derivative(function, input[i], input_dw[i]);
+}
+
 #if (RAFKO_USES_OPENCL)
 std::string
 TransferFunction::get_kernel_function_for(Transfer_functions function,
@@ -20,6 +20,7 @@
 
 #include "rafko_global.hpp"
 
+#include <cstddef>
 #include <set>
 #if (RAFKO_USES_OPENCL)
 #include <string>
@@ -91,6 +92,19 @@ public:
    */
   double get_value(Transfer_functions function, double data) const;
 
+  /**
+   * @brief      Apply the given transfer function to the given data, reading
+   * the saturating functions ( sigmoid, tanh and the sigmoid part of swish )
+   * from a lookup table with linear interpolation between its entries. Used
+   * by quantized inference; the other functions are calculated directly.
+   *
+   * @param[in]  function  The function to apply
+   * @param[in]  data      The data to apply it to
+   *
+   * @return     The approximated result of transfer_function(data).
+   */
+  double get_lookup_value(Transfer_functions function, double data) const;
+
   /**
    * @brief      Calculate the derivative of the given transfer function
    *
@@ -103,6 +117,35 @@ public:
   double get_derivative(Transfer_functions function, double input,
                         double input_dw) const;
 
+  /**
+   * @brief      Apply the given transfer function to an array of data. The
+   * calculation is vectorized with the widest instruction set the CPU supports
+   * ( selected at runtime ), with the scalar implementation as fallback.
+   *
+   * @param[in]  function  The function to apply
+   * @param[in]  data      The data to apply it to
+   * @param[out] result    The array to store the results in; may be @data
+   * @param[in]  count     The number of elements in @data and @result
+   */
+  void get_values(Transfer_functions function, const double *data,
+                  double *result, std::size_t count) const;
+
+  /**
+   * @brief      Calculate the derivative of the given transfer function for an
+   * array of inputs. Vectorized the same way as @get_values.
+   *
+   * @param[in]  function   The function to apply
+   * @param[in]  input      The inputs of the transfer function
+   * @param[in]  input_dw   The derivatives of the inputs of the transfer
+   * function
+   * @param[out] result     The array to store the derivatives in; may be
+   * either of the input arrays
+   * @param[in]  count      The number of elements in every array
+   */
+  void get_derivatives(Transfer_functions function, const double *input,
+                       const double *input_dw, double *result,
+                       std::size_t count) const;
+
 #if (RAFKO_USES_OPENCL)
 
   /**
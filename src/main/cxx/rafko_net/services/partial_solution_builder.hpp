@@ -115,6 +115,20 @@ private:
                  std::uint32_t &current_synapse_count,
                  google::protobuf::RepeatedPtrField<InputSynapseInterval>
                      *synapse_intervals);
+
+  /**
+   * @brief      Merges synapses into the ones preceeding them wherever the
+   * indices they describe allow it, to have as few synapses as possible
+   *
+   * @param      synapse_intervals      The array of synapses to compact
+   * @param[in]  compact_from           The index of the first synapse which
+   * might be merged into the one preceeding it; Synapses before it are left
+   * unchanged
+   */
+  static void
+  compact_synapses(google::protobuf::RepeatedPtrField<InputSynapseInterval>
+                       *synapse_intervals,
+                   std::int32_t compact_from);
 };
 
 } /* namespace rafko_net */
@@ -20,6 +20,9 @@
 
 #include "rafko_global.hpp"
 
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
 #include <vector>
 
 #include "rafko_protocol/rafko_net.pb.h"
@@ -37,10 +40,40 @@ class RAFKO_EXPORT PartialSolutionSolver {
 public:
   PartialSolutionSolver(const PartialSolution &partial_solution,
                         const rafko_mainframe::RafkoSettings &settings)
-      : m_partialSolution(partial_solution),
-        m_internal_weight_iterator(m_partialSolution.weight_indices()),
-        m_input_iterator(m_partialSolution.input_data()),
-        m_transfer_function(settings) {}
+      : m_partialSolution(partial_solution), m_transfer_function(settings),
+        m_precision(settings.get_inference_precision()) {
+    compile_plan();
+    refresh_weights();
+  }
+
+  /**
+   * @brief      Constructs a solver which reads the weights directly from a
+   * shared weight table instead of the one inside the partial solution, so
+   * changes in the shared table are visible without copying them over
+   *
+   * @param      partial_solution   The partial solution to solve
+   * @param      settings           The settings of the solver
+   * @param      shared_weights     The weight table to read the weights from,
+   * e.g. the one of the @RafkoNet the partial solution was built from; it needs
+   * to outlive the solver
+   * @param      weight_sources     The index inside the shared weight table
+   * of every element inside the weight table of the partial solution
+   */
+  PartialSolutionSolver(
+      const PartialSolution &partial_solution,
+      const rafko_mainframe::RafkoSettings &settings,
+      const google::protobuf::RepeatedField<double> &shared_weights,
+      const std::vector<std::uint32_t> &weight_sources)
+      : m_partialSolution(partial_solution), m_transfer_function(settings),
+        m_sharedWeights(&shared_weights),
+        m_precision(settings.get_inference_precision()) {
+    compile_plan();
+    for (std::uint32_t &weight_index : m_weightIndex)
+      weight_index = weight_sources[weight_index];
+    for (std::uint32_t &weight_index : m_neuronSpikeWeight)
+      weight_index = weight_sources[weight_index];
+    refresh_weights();
+  }
 
   /**
    * @brief      Solves the partial solution in the given argument and loads the
@@ -95,6 +128,32 @@ public:
     solve_internal(input_data, output_neuron_data, temp_data);
   }
 
+  /**
+   * @brief      Solves the partial solution for multiple independent samples at
+   * once. Neuron data is stored Neuron-major: the value of every sample for one
+   * Neuron follow one another, so every Neuron is calculated for the whole
+   * batch in one inner loop. It shall resize the provided temp_data to fit
+   * buffer needs.
+   *
+   * @param      inputs               The inputs of the samples, one sample
+   * after another
+   * @param      batch_size           The number of samples in the batch
+   * @param      batch_neuron_data    The Neuron data of the batch
+   * @param      temp_data            The reference a vector allocated to keep
+   * the required collected inputs and intermediate values for the batch
+   */
+  void solve_batch(const std::vector<double> &inputs, std::uint32_t batch_size,
+                   rafko_utilities::DataRingbuffer<> &batch_neuron_data,
+                   std::vector<double> &temp_data) const;
+
+  /**
+   * @brief      Copies the weights the compiled plan uses into its single
+   * precision weight table in plan order. Solvers with reduced inference
+   * precision read the weights only from there, so this needs to be called
+   * after the weights change; with double precision it does nothing.
+   */
+  void refresh_weights();
+
   /**
    * @brief      Provides the number of vector elements needed to solve the
    * stored partial solution to store the temporary data for the calculations
@@ -102,7 +161,7 @@ public:
    * @return     True if detail is valid, False otherwise.
    */
   std::uint32_t get_required_tmp_data_size() const {
-    return m_input_iterator.size();
+    return m_requiredTmpDataSize;
   }
 
   /**
@@ -116,9 +175,116 @@ public:
 private:
   static rafko_utilities::DataPool<double> m_commonDataPool;
   const PartialSolution &m_partialSolution;
-  SynapseIterator<> m_internal_weight_iterator;
-  SynapseIterator<InputSynapseInterval> m_input_iterator;
   TransferFunction m_transfer_function;
+  const google::protobuf::RepeatedField<double> *m_sharedWeights = nullptr;
+  const Inference_precision m_precision;
+
+  /* The execution plan compiled from the @PartialSolution, see @compile_plan */
+  std::uint32_t m_requiredTmpDataSize = 0u;
+  std::uint32_t m_outputStart = 0u;
+  /* {partial input synapses}: how to collect the inputs into the temp data */
+  std::vector<std::int32_t> m_collectStart;
+  std::vector<std::uint32_t> m_collectSize;
+  std::vector<std::uint32_t> m_collectPastIndex;
+  std::vector<std::uint8_t> m_collectFromNetwork;
+  /* {neurons}: the operations of each Neuron in order */
+  std::vector<std::uint32_t> m_neuronInputStart;
+  std::vector<std::uint32_t> m_neuronInputCount;
+  std::vector<std::uint32_t> m_neuronWeightStart;
+  std::vector<std::uint32_t> m_neuronWeightCount;
+  std::vector<std::uint32_t> m_neuronSpikeWeight;
+  /* {neuron inputs}: index in temp data or in the current Neuron data */
+  std::vector<std::uint32_t> m_inputIndex;
+  std::vector<std::uint8_t> m_inputFromTmpData;
+  /* {neuron weights}: index in the weight table for inputs, then biases */
+  std::vector<std::uint32_t> m_weightIndex;
+  /* The weights of @m_weightIndex and @m_neuronSpikeWeight in single
+   * precision, only used with reduced inference precision */
+  std::vector<float> m_reducedWeights;
+  std::vector<float> m_reducedSpikeWeights;
+  /* Quantized inference: the input weights of @m_weightIndex in 8 bits, the
+   * biases and spike weights are read from the single precision weights */
+  std::vector<std::int8_t> m_quantizedWeights;
+  /* {neuron inputs}: index in the quantized activations, which are the
+   * collected inputs followed by the Neurons of the partial solution */
+  std::vector<std::uint32_t> m_quantizedInputIndex;
+  double m_activationScale = 1.0;
+  double m_accumulatorScale = 1.0;
+
+  /**
+   * @brief      Lowers the stored @PartialSolution into flat arrays, so solving
+   * it doesn't need to iterate through the synapses of the protobuf structure.
+   * The weight values and the Neuron functions are still read from the
+   * @PartialSolution ( once per solve ), so updating them doesn't require the
+   * plan to be compiled again.
+   */
+  void compile_plan();
+
+  /**
+   * @brief      Provides the weight table the compiled plan indexes into
+   *
+   * @return     The start of the shared weight table if the solver has one,
+   * otherwise the start of the weight table inside the partial solution
+   */
+  const double *get_weights() const {
+    return ((nullptr != m_sharedWeights)
+                ? m_sharedWeights->data()
+                : m_partialSolution.weight_table().data());
+  }
+
+  /**
+   * @brief      Tells if the solver reads its weights from its own reduced
+   * precision copy of them
+   */
+  bool is_reduced_precision() const {
+    return ((inference_precision_single_rounding == m_precision) ||
+            (inference_precision_mixed_rounding == m_precision) || is_quantized());
+  }
+
+  /**
+   * @brief      Tells if the solver uses 8 bit weights and activations
+   */
+  bool is_quantized() const {
+    return (inference_precision_int8 == m_precision);
+  }
+
+  /**
+   * @brief      Maps the given activation into 8 bits based on the calibrated
+   * activation range of the partial solution
+   */
+  std::int8_t quantize(double value) const {
+    return static_cast<std::int8_t>(
+        std::clamp(std::lround(value / m_activationScale), -127l, 127l));
+  }
+
+  /**
+   * @brief      Solves the Neurons of the partial solution from the already
+   * collected inputs with single precision weights and activations rounded
+   * to single precision. The transfer and spike functions are evaluated in
+   * double precision, their results are rounded to single precision, but
+   * stored in the double precision Neuron memory.
+   *
+   * @param      temp_data     The collected inputs of the partial solution
+   * @param      neuron_data   The current Neuron data to store the results in
+   *
+   * @tparam     Accumulator   The type the weighted inputs are collected in
+   */
+  template <typename Accumulator>
+  void solve_reduced_precision(const std::vector<double> &temp_data,
+                               std::vector<double> &neuron_data) const;
+
+  /**
+   * @brief      Solves the Neurons of the partial solution from the already
+   * collected inputs with 8 bit weights and activations. The weighted inputs
+   * of Neurons collecting them by addition are accumulated in integers, the
+   * transfer functions are read from lookup tables, and the results of the
+   * spike functions are stored in double precision.
+   *
+   * @param      temp_data     The collected inputs of the partial solution
+   * @param      neuron_data   The current Neuron data to store the results in
+   */
+  void solve_quantized(const std::vector<double> &temp_data,
+                       std::vector<double> &neuron_data) const;
 
   /**
    * @brief      Solves the partial solution in the given argument and loads the
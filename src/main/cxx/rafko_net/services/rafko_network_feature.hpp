@@ -34,7 +34,7 @@
 #include "rafko_mainframe/models/rafko_settings.hpp"
 #include "rafko_protocol/rafko_net.pb.h"
 #include "rafko_utilities/models/subscript_proxy.hpp"
-#include "rafko_utilities/services/thread_group.hpp"
+#include "rafko_utilities/services/work_stealing_pool.hpp"
 
 namespace rafko_net {
 
@@ -45,9 +45,9 @@ class RAFKO_EXPORT RafkoNetworkFeature {
 public:
   using NeuronDataProxy = rafko_utilities::SubscriptProxy<std::vector<double>>;
 
-  RafkoNetworkFeature(std::vector<std::unique_ptr<rafko_utilities::ThreadGroup>>
-                          &execution_threads)
-      : m_executionThreads(execution_threads) {}
+  RafkoNetworkFeature(rafko_utilities::WorkStealingPool &thread_pool =
+                          rafko_utilities::WorkStealingPool::shared())
+      : m_threadPool(thread_pool) {}
 
   /**
    * @brief     Execute the given @FeatureGroup(supposedly solution relevant) on
@@ -58,13 +58,10 @@ public:
    * @param[in]  settings       The settings object containing the required
    * hyperparameters for the features
    * @param      neuron_data    The array containing the neuron data to update
-   * @param[in]  thread_index   The index of the thread the feature is to be
-   * executed
    */
   void execute_solution_relevant(const FeatureGroup &feature,
                                  const rafko_mainframe::RafkoSettings &settings,
-                                 NeuronDataProxy neuron_data,
-                                 std::uint32_t thread_index = 0) const;
+                                 NeuronDataProxy neuron_data) const;
 
   /**
    * @brief     Execute the given @FeatureGroup(supposedly performance relevant)
@@ -75,14 +72,11 @@ public:
    * @param[in]  settings       The settings object containing the required
    * hyperparameters for the features
    * @param[in]  network        The network to calculate the values from
-   * @param[in]  thread_index   The index of the thread the feature is to be
-   * executed
    */
   double
   calculate_performance_relevant(const FeatureGroup &feature,
                                  const rafko_mainframe::RafkoSettings &settings,
-                                 const RafkoNet &network,
-                                 std::uint32_t thread_index = 0) const;
+                                 const RafkoNet &network) const;
 
 #if (RAFKO_USES_OPENCL)
 
@@ -158,8 +152,7 @@ public:
 #endif /*(RAFKO_USES_OPENCL)*/
 
 private:
-  std::vector<std::unique_ptr<rafko_utilities::ThreadGroup>>
-      &m_executionThreads;
+  rafko_utilities::WorkStealingPool &m_threadPool;
 #if (RAFKO_USES_OPENCL)
   static inline std::mutex m_featureCacheMutex;
   static inline std::uint32_t m_lxFeatureCalled;
@@ -173,14 +166,11 @@ private:
    * apply the function on
    * @param[in]  fun                The function to call with the index value of
    * every relevant Neuron
-   * @param[in]  thread_index       The index of the thread the feature is to be
-   * executed
    */
   void execute_in_paralell_for(
       const google::protobuf::RepeatedPtrField<IndexSynapseInterval>
           &relevant_neurons,
-      std::function<void(std::uint32_t)> &&fun,
-      std::uint32_t thread_index = 0u) const;
+      std::function<void(std::uint32_t)> &&fun) const;
 
   /**
    * @brief      Calculate the softmax function by setting the data values
@@ -190,14 +180,11 @@ private:
    * update
    * @param[in]  relevant_neurons   The index values of the relevant neurons to
    * apply the function on
-   * @param[in]  thread_index       The index of the thread the feature is to be
-   * executed
    */
   void
   execute_softmax(NeuronDataProxy neuron_data,
                   const google::protobuf::RepeatedPtrField<IndexSynapseInterval>
-                      &relevant_neurons,
-                  std::uint32_t thread_index = 0u) const;
+                      &relevant_neurons) const;
 
   /**
    * @brief      Calculate the dropout function for the given group of Neurons
@@ -209,15 +196,12 @@ private:
    * hyperparameters for the features
    * @param[in]  relevant_neurons   The index values of the relevant neurons to
    * apply the function on
-   * @param[in]  thread_index       The index of the thread the feature is to be
-   * executed
    */
   void
   execute_dropout(NeuronDataProxy neuron_data,
                   const rafko_mainframe::RafkoSettings &settings,
                   const google::protobuf::RepeatedPtrField<IndexSynapseInterval>
-                      &relevant_neurons,
-                  std::uint32_t thread_index = 0u) const;
+                      &relevant_neurons) const;
 
   /**
    * @brief      Calculate the error value coming from L1 weight regularization
@@ -226,16 +210,13 @@ private:
    * update
    * @param[in]  relevant_neurons   The index values of the relevant neurons to
    * apply the function on
-   * @param[in]  thread_index       The index of the thread the feature is to be
-   * executed
    *
    * @return the resulting error value
    */
   double calculate_l1_regularization(
       const rafko_net::RafkoNet &network,
       const google::protobuf::RepeatedPtrField<IndexSynapseInterval>
-          &relevant_neurons,
-      std::uint32_t thread_index = 0u) const;
+          &relevant_neurons) const;
 
   /**
    * @brief      Calculate the error value coming from L2 weight regularization
@@ -244,16 +225,13 @@ private:
    * update
    * @param[in]  relevant_neurons   The index values of the relevant neurons to
    * apply the function on
-   * @param[in]  thread_index       The index of the thread the feature is to be
-   * executed
    *
    * @return the resulting error value
    */
   double calculate_l2_regularization(
       const rafko_net::RafkoNet &network,
       const google::protobuf::RepeatedPtrField<IndexSynapseInterval>
-          &relevant_neurons,
-      std::uint32_t thread_index = 0u) const;
+          &relevant_neurons) const;
 
 #if (RAFKO_USES_OPENCL)
   /**
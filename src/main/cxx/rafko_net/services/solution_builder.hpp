@@ -21,6 +21,8 @@
 #include "rafko_global.hpp"
 
 #include <memory>
+#include <optional>
+#include <vector>
 #if (RAFKO_USES_OPENCL)
 #include <string>
 #endif /*(RAFKO_USES_OPENCL)*/
@@ -31,6 +33,38 @@
 
 namespace rafko_net {
 
+/**
+ * @brief      The structural changes of a network since a Solution was built
+ * from it. Neurons reading from an added or a removed Neuron are expected to be
+ * listed as changed as well.
+ */
+struct NetworkChanges {
+  /* Neurons whose parameters, inputs or weights changed; indices in the
+   * updated network */
+  std::vector<std::uint32_t> changed_neurons;
+  /* indices in the updated network */
+  std::vector<std::uint32_t> added_neurons;
+  /* indices in the network the Solution was built from */
+  std::vector<std::uint32_t> removed_neurons;
+};
+
+/**
+ * @brief      The partial solutions touched by an incremental update of a
+ * Solution, every list is in ascending order
+ */
+struct SolutionUpdate {
+  /* Partials built again from their Neurons; indices in the updated Solution */
+  std::vector<std::uint32_t> rebuilt_partials;
+  /* Partials with only their Neuron indices shifted; indices in the updated
+   * Solution */
+  std::vector<std::uint32_t> reindexed_partials;
+  /* Partials emptied by removing Neurons; indices in the previous Solution */
+  std::vector<std::uint32_t> removed_partials;
+  /* Re-built partials which were calibrated for quantized inference before the
+   * update; indices in the updated Solution */
+  std::vector<std::uint32_t> uncalibrated_partials;
+};
+
 /**
  * @brief      Front-end to create a @Soltuion to solve a @RafkoNet.
  * @max_solve_threads determines the maximum number of threads to be used inside
@@ -103,6 +137,38 @@ public:
   void update(Solution *previous, const RafkoNet &network,
               bool optimize_to_gpu = false);
 
+  /**
+   * @brief     Updates a previously built Solution in place with the given
+   * changes of the network it was built from. Only the partial solutions
+   * containing changed, added or removed Neurons are re-built: added Neurons
+   * extend the partial solution of a neighbouring Neuron, and partial
+   * solutions emptied by the removed Neurons are removed. Partial solutions
+   * only reading from Neurons with a shifted index are re-indexed without
+   * re-building them. In case the Neurons can not be placed this way, a new
+   * Solution is built and swapped with the previous one.
+   * Re-built partial solutions lose their activation range, so a Solution
+   * calibrated for quantized inference needs to be calibrated again with
+   * @SolutionQuantizer::calibrate before building int8 solvers from it; the
+   * partials this concerns are listed in @uncalibrated_partials, and every
+   * partial is concerned when the whole Solution is re-built.
+   *
+   * @param         previous            A pointer to the @Solution object to
+   * update. The provided pointer is advised to be pointing to an object
+   * allocated on a protobuf Arena
+   * @param[in]     network             The network the Solution is updated to
+   * @param[in]     changes             The changes of the network since the
+   * Solution was built from it
+   * @param[in]     optimize_to_gpu     True, Should the resulting solution be
+   * optimized for large amount of threads
+   *
+   * @return    The description of the updated partial solutions, or an empty
+   * optional if the whole Solution was re-built
+   */
+  std::optional<SolutionUpdate> update(Solution *previous,
+                                       const RafkoNet &network,
+                                       const NetworkChanges &changes,
+                                       bool optimize_to_gpu = false);
+
 #if (RAFKO_USES_OPENCL)
   /**
    * @brief     Generate the OpenCL Kernel code solving the provided solution
@@ -132,6 +198,22 @@ public:
 private:
   const rafko_mainframe::RafkoSettings &m_settings;
 
+  /**
+   * @brief     Updates the partial solutions of the given Solution with the
+   * changes of the network, keeping the placement of every unchanged Neuron
+   *
+   * @param         solution    The Solution to update
+   * @param[in]     network     The network to update the Solution to
+   * @param[in]     changes     The changes of the network since the Solution
+   * was built from it
+   *
+   * @return    The description of the updated partial solutions, or an empty
+   * optional if the Neurons can not be placed into the existing partials
+   */
+  std::optional<SolutionUpdate>
+  update_partials(Solution &solution, const RafkoNet &network,
+                  const NetworkChanges &changes) const;
+
   static std::uint32_t
   get_last_neuron_index_of_partial(const PartialSolution &partial) {
     return (partial.output_data().starts() +
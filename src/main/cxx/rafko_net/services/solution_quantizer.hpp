@@ -0,0 +1,52 @@
+/*! This file is part of davids91/Rafko.
+ *
+ *    Rafko is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    (at your option) any later version.
+ *
+ *    Rafko is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with Rafko.  If not, see <https://www.gnu.org/licenses/> or
+ *    <https://github.com/davids91/rafko/blob/master/LICENSE>
+ */
+
+#ifndef SOLUTION_QUANTIZER_H
+#define SOLUTION_QUANTIZER_H
+
+#include "rafko_global.hpp"
+
+#include "rafko_gym/models/rafko_dataset.hpp"
+#include "rafko_mainframe/models/rafko_settings.hpp"
+#include "rafko_protocol/solution.pb.h"
+
+namespace rafko_net {
+
+/**
+ * @brief      Post-training quantization pass over a @Solution: prepares it
+ * for inference with @inference_precision_int8
+ */
+class RAFKO_EXPORT SolutionQuantizer {
+public:
+  /**
+   * @brief      Solves the given data set with the solution in double
+   * precision and stores the largest absolute value of the inputs and Neurons
+   * of every partial solution as its activation range. Weight scales are not
+   * calibrated, they are derived from the weights by the solvers.
+   *
+   * @param      solution   The solution to calibrate
+   * @param[in]  data_set   The data set to calibrate the solution on
+   * @param[in]  settings   The settings to solve the data set with
+   */
+  static void calibrate(Solution &solution,
+                        const rafko_gym::RafkoDataSet &data_set,
+                        const rafko_mainframe::RafkoSettings &settings);
+};
+
+} /* namespace rafko_net */
+
+#endif /* SOLUTION_QUANTIZER_H */
@@ -27,13 +27,15 @@
 #include <vector>
 
 #include "rafko_gym/models/rafko_agent.hpp"
+#include "rafko_gym/models/rafko_dataset.hpp"
 #include "rafko_protocol/solution.pb.h"
 #include "rafko_utilities/models/data_ringbuffer.hpp"
-#include "rafko_utilities/services/thread_group.hpp"
+#include "rafko_utilities/services/work_stealing_pool.hpp"
 
 #include "rafko_gym/services/rafko_weight_adapter.hpp"
 #include "rafko_net/services/partial_solution_solver.hpp"
 #include "rafko_net/services/rafko_network_feature.hpp"
+#include "rafko_net/services/solution_builder.hpp"
 
 namespace rafko_net {
 
@@ -43,8 +45,18 @@ namespace rafko_net {
  */
 class RAFKO_EXPORT SolutionSolver : public virtual rafko_gym::RafkoAgent {
 public:
+  /**
+   * @brief      Constructs a solver for the given solution
+   *
+   * @param      to_solve         The solution to solve
+   * @param      settings         The settings of the solver
+   * @param      weight_network   When not nullptr, the partial solvers read
+   * the weights directly from the weight table of this network, which the
+   * solution was built from, instead of the weight tables of the solution
+   */
   SolutionSolver(const Solution *to_solve,
-                 const rafko_mainframe::RafkoSettings &settings);
+                 const rafko_mainframe::RafkoSettings &settings,
+                 const RafkoNet *weight_network = nullptr);
 
   SolutionSolver(const SolutionSolver &other) = delete; /* Copy constructor */
   SolutionSolver &
@@ -80,6 +92,38 @@ public:
         std::uint32_t thread_index = 0u) override;
 
   void set_eval_mode(bool evaluation) override { m_evaluating = evaluation; }
+
+  /**
+   * @brief      Refreshes the single precision weights of the partial solvers
+   * from the weights they read; needed after the weights change when the
+   * solver was built with reduced inference precision. Solvers built by a
+   * @Factory are refreshed by its refresh_actual_solution_weights as well.
+   */
+  void refresh_weights();
+
+  /**
+   * @brief      Solves the network for multiple independent samples at once,
+   * each with its own Neuron memory. Every Neuron is evaluated for the whole
+   * batch in one inner loop; Partial solutions are solved one after another,
+   * multiple batches can be solved in paralell through different thread
+   * indices. The Neuron memory of the batch is kept between calls as long as
+   * the batch size stays the same. With reduced inference precision the
+   * batch uses the single precision weights and rounded activations, but
+   * accumulates the weighted inputs in double precision.
+   *
+   * @param[in]      inputs              The inputs of the samples, one after
+   * another
+   * @param[in]      batch_size          The number of samples in the batch
+   * @param[out]     outputs             The matrix to store the output of the
+   * network into: one row of output Neuron values for every sample
+   * @param[in]      reset_neuron_data   Should the memory of the batch be
+   * reset before solving
+   * @param[in]      thread_index        The index of the thread the batch is
+   * solved in
+   */
+  void solve_batch(const std::vector<double> &inputs, std::uint32_t batch_size,
+                   std::vector<double> &outputs, bool reset_neuron_data = false,
+                   std::uint32_t thread_index = 0u);
 #if (RAFKO_USES_OPENCL)
   /**
    * @brief     Sets the parameters the generated kernel code will be based on.
@@ -167,13 +211,20 @@ public:
 
 private:
   const rafko_net::Solution *m_solution;
+  const RafkoNet *m_weightNetwork;
   std::uint32_t m_maxThreadNumber;
   rafko_utilities::DataPool<double> m_commonDataPool;
   std::vector<rafko_utilities::DataRingbuffer<>>
       m_neuronValueBuffers; /* One rafko_utilities::DataRingbuffer per thread */
   std::vector<std::reference_wrapper<std::vector<double>>> m_usedDataBuffers;
-  std::vector<std::vector<PartialSolutionSolver>> m_partialSolvers;
-  std::vector<std::unique_ptr<rafko_utilities::ThreadGroup>> m_executionThreads;
+  std::vector<rafko_utilities::DataRingbuffer<>>
+      m_batchValueBuffers; /* One Neuron-major rafko_utilities::DataRingbuffer
+                              per thread */
+  std::vector<std::vector<double>> m_batchTmpBuffers; /* One per thread */
+  std::vector<std::vector<double>> m_batchFeatureBuffers; /* One per thread */
+  std::vector<std::vector<std::unique_ptr<PartialSolutionSolver>>>
+      m_partialSolvers;
+  rafko_utilities::WorkStealingPool &m_threadPool;
   RafkoNetworkFeature m_featureExecutor;
   std::uint32_t m_maxTmpSizeNeeded = 0u;
   std::uint32_t m_maxTmpDataNeededPerThread = 0u;
@@ -195,6 +246,33 @@ private:
    */
   void rebuild(const Solution *to_solve);
 
+  /**
+   * @brief     Re-initializes the solvers of the given partial solutions after
+   * they were updated in place inside the stored @Solution, keeping the solvers
+   * of every other partial solution
+   *
+   * @param[in]     solution_update    The partial solutions touched by the
+   * update of the @Solution
+   */
+  void update(const SolutionUpdate &solution_update);
+
+  /**
+   * @brief     Sizes the Neuron and temporary data buffers to the stored
+   * partial solvers; Neuron data stored in them is reset
+   */
+  void refresh_buffers();
+
+  /**
+   * @brief      Constructs a solver for the given partial solution of the
+   * stored solution, reading the weights from the network if one is set
+   *
+   * @param[in]  partial_index    The index of the partial solution
+   *
+   * @return     The constructed partial solver
+   */
+  std::unique_ptr<PartialSolutionSolver>
+  create_partial_solver(std::uint32_t partial_index) const;
+
 public:
   class RAFKO_EXPORT Factory {
   public:
@@ -222,11 +300,14 @@ public:
 
     /**
      * @brief     Updates the stored solution with the weights from the stored
-     * Neural Network reference
+     * Neural Network reference, then refreshes the single precision weights of
+     * the solvers built by this factory. With shared weight storage the built
+     * solvers only need the latter, which SolutionSolver::refresh_weights
+     * does alone.
+     *
+     * @return    The ranges of the partial weight tables changed by the update
      */
-    void refresh_actual_solution_weights() {
-      m_weightAdapter->update_solution_with_weights();
-    }
+    const rafko_gym::WeightTableRanges &refresh_actual_solution_weights();
 
     /**
      * @brief     Builds a SolutionSolver and produces a pointer to it, based on
@@ -242,6 +323,27 @@ public:
     std::shared_ptr<SolutionSolver> build(bool rebuild_solution = false,
                                           bool swap_solution = false);
 
+    /**
+     * @brief     Updates the stored solution with the given structural changes
+     * of the stored Neural Network reference, re-initializing only the partial
+     * solvers the changes touched inside the already built solvers. The
+     * weights of the unchanged partial solutions are not refreshed by this.
+     * Partial solutions re-built by the update lose their calibration for
+     * quantized inference; when a calibration data set is given, the stored
+     * solution is calibrated on it before the solvers are updated, in case any
+     * of its partial solutions is without calibration.
+     *
+     * @param[in]   network_changes   The changes of the network since the
+     * stored solution was built or updated
+     * @param[in]   calibration_set   The data set to calibrate the updated
+     * solution on for quantized inference, if any
+     *
+     * @return    Ownership and pointer of the built solver
+     */
+    std::shared_ptr<SolutionSolver>
+    build(const NetworkChanges &network_changes,
+          const rafko_gym::RafkoDataSet *calibration_set = nullptr);
+
   private:
     const RafkoNet &m_network;
     std::shared_ptr<const rafko_mainframe::RafkoSettings> m_settings;
@@ -26,7 +26,7 @@ std::uint32_t FeatureGroupCache::construct(const FeatureGroup &host) {
   SynapseIterator<> relevant_neurons =
       SynapseIterator<>(host.relevant_neurons());
   relevant_neurons.skim([this, &calculated_checksum,
-                         &fletchers_hash](IndexSynapseInterval interval) {
+                         &fletchers_hash](const IndexSynapseInterval &interval) {
     calculated_checksum |= interval.starts();
     calculated_checksum |= interval.interval_size();
     fletchers_hash |= calculated_checksum;
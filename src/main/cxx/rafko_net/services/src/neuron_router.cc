@@ -39,9 +39,9 @@ NeuronRouter::NeuronRouter(const RafkoNet &rafko_net)
          m_net.neuron_array(neuron_iterator).input_indices_size();
          ++synapse_iterator)
       m_neuronNumberOfInputs[neuron_iterator] +=
-          m_net.neuron_array(neuron_iterator)
-              .input_indices(synapse_iterator)
-              .interval_size();
+          SynapseIterator<InputSynapseInterval>::synapse_size(
+              m_net.neuron_array(neuron_iterator)
+                  .input_indices(synapse_iterator));
     m_neuronStates.push_back(std::make_unique<std::atomic<std::uint32_t>>());
   } /* Calculating how many children one Neuron has */
 
@@ -149,11 +149,13 @@ NeuronRouter::get_next_neuron(std::vector<std::uint32_t> &visiting,
       number_of_processed_inputs =
           std::min(static_cast<std::uint32_t>(*m_neuronStates[visiting.back()]),
                    m_neuronNumberOfInputs[visiting.back()]);
-      iter.skim_terminatable([&](InputSynapseInterval input_synapse) {
-        if ((start_input_index_from + input_synapse.interval_size()) <
+      iter.skim_terminatable([&](const InputSynapseInterval &input_synapse) {
+        const std::uint32_t synapse_size =
+            SynapseIterator<InputSynapseInterval>::synapse_size(input_synapse);
+        if ((start_input_index_from + synapse_size) <
             number_of_processed_inputs) {
           ++start_synapse_iteration_from; /* Skip this synapse */
-          start_input_index_from += input_synapse.interval_size();
+          start_input_index_from += synapse_size;
           return true; /* start_input_index_from was still smaller, than
                           number_of_processed_inputs, so the synapse can be
                           skipped */
@@ -165,7 +167,7 @@ NeuronRouter::get_next_neuron(std::vector<std::uint32_t> &visiting,
     number_of_processed_inputs = start_input_index_from;
     std::uint32_t current_backreach;
     iter.iterate_terminatable(
-        [&](InputSynapseInterval input_synapse) {
+        [&](const InputSynapseInterval &input_synapse) {
           current_backreach = input_synapse.reach_past_loops();
           return true;
         },
@@ -17,6 +17,7 @@
 
 #include "rafko_net/services/partial_solution_builder.hpp"
 
+#include <algorithm>
 #include <stdexcept>
 
 #include "rafko_net/models/input_function.hpp"
@@ -58,7 +59,7 @@ PartialSolutionBuilder::add_neuron_to_partial_solution(
     m_partial.add_weight_synapse_number(
         net.neuron_array(neuron_index).input_weights_size());
     weight_iterator.iterate(
-        [&](IndexSynapseInterval weight_synapse) {
+        [&](const IndexSynapseInterval &weight_synapse) {
           m_partial.add_weight_indices()->set_starts(
               m_partial.weight_table_size());
           m_partial
@@ -77,21 +78,27 @@ PartialSolutionBuilder::add_neuron_to_partial_solution(
                                          of the input */
     const std::uint32_t index_synapse_previous_size =
         m_partial.inside_indices_size();
+    const std::uint32_t input_synapse_previous_size =
+        m_partial.input_data_size();
 
     std::uint32_t current_backreach;
     input_iterator.iterate(
-        [&](InputSynapseInterval interval_synapse) {
+        [&](const InputSynapseInterval &interval_synapse) {
           RFASSERT_LOG("Input synapse reach past loops: {}",
                        interval_synapse.reach_past_loops());
           current_backreach = interval_synapse.reach_past_loops();
           if (interval_synapse.reach_past_loops() > max_reach_back)
             max_reach_back = interval_synapse.reach_past_loops();
+          const std::uint32_t synapse_size =
+              SynapseIterator<InputSynapseInterval>::synapse_size(
+                  interval_synapse);
           if (SynapseIterator<InputSynapseInterval>::is_synapse_input(
-                  interval_synapse)) {
-            std::uint32_t input_index =
-                SynapseIterator<InputSynapseInterval>::
-                    external_index_from_array_index(interval_synapse.starts()) +
-                interval_synapse.interval_size() - 1u;
+                  interval_synapse) &&
+              (0u < synapse_size)) {
+            std::uint32_t input_index = SynapseIterator<InputSynapseInterval>::
+                array_index_from_external_index(
+                    SynapseIterator<InputSynapseInterval>::index_in_synapse(
+                        interval_synapse, synapse_size - 1u));
             if (max_reach_index < input_index)
               max_reach_index = input_index;
           }
@@ -210,6 +217,8 @@ PartialSolutionBuilder::add_neuron_to_partial_solution(
                                              partial inputs)*/
         });
 
+    compact_synapses(m_partial.mutable_inside_indices(),
+                     index_synapse_previous_size + 1u);
     RFASSERT_LOG(
         "Partial solution Input synapses number for Neuron: {}",
         (m_partial.inside_indices_size() - index_synapse_previous_size));
@@ -230,6 +239,12 @@ PartialSolutionBuilder::add_neuron_to_partial_solution(
       /* input_synapse.refresh_cached_size(); */
     }
 
+    /*!Note: The input synapses of the previous Neurons are already compacted,
+     * so only the new ones need to be checked */
+    compact_synapses(m_partial.mutable_input_data(),
+                     std::max(1u, input_synapse_previous_size));
+    m_inputSynapse.reset_cached_position();
+
     return std::make_pair(max_reach_back, max_reach_index);
   } else
     throw std::runtime_error(
@@ -264,7 +279,7 @@ bool PartialSolutionBuilder::look_for_neuron_input(
   if (cache_hit == m_foundNetworkInputInPartialInput.end()) {
     std::uint32_t current_backreach;
     m_inputSynapse.iterate_terminatable(
-        [&current_backreach](InputSynapseInterval interval_synapse) {
+        [&current_backreach](const InputSynapseInterval &interval_synapse) {
           current_backreach = interval_synapse.reach_past_loops();
           return true;
         },
@@ -361,4 +376,25 @@ void PartialSolutionBuilder::add_to_synapse(
   }
 }
 
+void PartialSolutionBuilder::compact_synapses(
+    google::protobuf::RepeatedPtrField<InputSynapseInterval> *synapse_intervals,
+    std::int32_t compact_from) {
+  if ((0 >= compact_from) || (synapse_intervals->size() <= compact_from))
+    return;
+  std::int32_t last_kept = compact_from - 1;
+  for (std::int32_t synapse_index = compact_from;
+       synapse_index < synapse_intervals->size(); ++synapse_index) {
+    if (!SynapseIterator<InputSynapseInterval>::merge_interval(
+            *synapse_intervals->Mutable(last_kept),
+            synapse_intervals->Get(synapse_index))) {
+      ++last_kept;
+      if (last_kept != synapse_index)
+        *synapse_intervals->Mutable(last_kept) =
+            synapse_intervals->Get(synapse_index);
+    }
+  }
+  synapse_intervals->DeleteSubrange(last_kept + 1,
+                                    synapse_intervals->size() - last_kept - 1);
+}
+
 } /* namespace rafko_net */
@@ -30,147 +30,512 @@ namespace rafko_net {
 
 rafko_utilities::DataPool<double> PartialSolutionSolver::m_commonDataPool;
 
+void PartialSolutionSolver::compile_plan() {
+  m_outputStart = m_partialSolution.output_data().starts();
+
+  /* Store the input synapses of the partial solution in order */
+  SynapseIterator<InputSynapseInterval> input_iterator(
+      m_partialSolution.input_data());
+  m_requiredTmpDataSize = input_iterator.size();
+  input_iterator.skim([this](const InputSynapseInterval &input_synapse) {
+    const bool from_network_input =
+        SynapseIterator<>::is_index_input(input_synapse.starts());
+    /* Every run of a strided synapse is collected separately */
+    for (std::uint32_t run_index = 0u;
+         run_index <
+         SynapseIterator<InputSynapseInterval>::run_count(input_synapse);
+         ++run_index) {
+      const std::int32_t run_start =
+          SynapseIterator<InputSynapseInterval>::run_start(input_synapse,
+                                                           run_index);
+      m_collectFromNetwork.push_back(from_network_input);
+      m_collectStart.push_back(
+          from_network_input
+              ? SynapseIterator<>::array_index_from_external_index(run_start)
+              : run_start);
+      m_collectSize.push_back(input_synapse.interval_size());
+      m_collectPastIndex.push_back(input_synapse.reach_past_loops());
+    }
+  });
+
+  /* Resolve the input and weight indices of every Neuron */
+  SynapseIterator<> weight_iterator(m_partialSolution.weight_indices());
+  std::uint32_t weight_synapse_start = 0u;
+  std::uint32_t index_synapse_start = 0u;
+  const std::uint32_t neuron_number =
+      m_partialSolution.output_data().interval_size();
+  for (std::uint32_t neuron_index = 0u; neuron_index < neuron_number;
+       ++neuron_index) {
+    m_neuronInputStart.push_back(m_inputIndex.size());
+    for (std::uint32_t synapse_index = index_synapse_start;
+         synapse_index < (index_synapse_start +
+                          m_partialSolution.index_synapse_number(neuron_index));
+         ++synapse_index) {
+      const InputSynapseInterval &input_synapse =
+          m_partialSolution.inside_indices(synapse_index);
+      const std::uint32_t synapse_size =
+          SynapseIterator<InputSynapseInterval>::synapse_size(input_synapse);
+      for (std::uint32_t input_offset = 0u; input_offset < synapse_size;
+           ++input_offset) {
+        const std::int32_t input_index =
+            SynapseIterator<InputSynapseInterval>::index_in_synapse(
+                input_synapse, input_offset);
+        if (SynapseIterator<>::is_index_input(
+                input_index)) { /* Neuron gets its input from the
+                                   partial solution input */
+          m_inputIndex.push_back(
+              SynapseIterator<>::array_index_from_external_index(input_index));
+          m_inputFromTmpData.push_back(true);
+        } else { /* Neuron gets its input internaly */
+          m_inputIndex.push_back(m_outputStart + input_index);
+          m_inputFromTmpData.push_back(false);
+        }
+      }
+    }
+    index_synapse_start += m_partialSolution.index_synapse_number(neuron_index);
+
+    /* as per structure, the first weight is for the spike function, the next
+     * weights are for inputs and biases */
+    bool first_weight_in_neuron = true;
+    m_neuronWeightStart.push_back(m_weightIndex.size());
+    weight_iterator.iterate(
+        [this, &first_weight_in_neuron](std::int32_t weight_index) {
+          if (first_weight_in_neuron) {
+            m_neuronSpikeWeight.push_back(weight_index);
+            first_weight_in_neuron = false;
+          } else
+            m_weightIndex.push_back(weight_index);
+        },
+        weight_synapse_start,
+        m_partialSolution.weight_synapse_number(neuron_index));
+    weight_synapse_start +=
+        m_partialSolution.weight_synapse_number(neuron_index);
+    RFASSERT(!first_weight_in_neuron);
+    m_neuronWeightCount.push_back(m_weightIndex.size() -
+                                  m_neuronWeightStart.back());
+
+    /* Inputs are only collected as long as there are weights for them */
+    m_neuronInputCount.push_back(
+        std::min(static_cast<std::uint32_t>(m_inputIndex.size() -
+                                            m_neuronInputStart.back()),
+                 m_neuronWeightCount.back()));
+    m_inputIndex.resize(m_neuronInputStart.back() + m_neuronInputCount.back());
+    m_inputFromTmpData.resize(m_inputIndex.size());
+  } /*for(every Neuron)*/
+
+  if (is_quantized()) {
+    m_quantizedInputIndex.resize(m_inputIndex.size());
+    for (std::uint32_t input_index = 0u; input_index < m_inputIndex.size();
+         ++input_index)
+      m_quantizedInputIndex[input_index] =
+          (m_inputFromTmpData[input_index]
+               ? m_inputIndex[input_index]
+               : (m_requiredTmpDataSize + m_inputIndex[input_index] -
+                  m_outputStart));
+  }
+}
+
+void PartialSolutionSolver::refresh_weights() {
+  if (!is_reduced_precision())
+    return;
+  const double *weights = get_weights();
+  m_reducedWeights.resize(m_weightIndex.size());
+  for (std::uint32_t weight_index = 0u; weight_index < m_weightIndex.size();
+       ++weight_index)
+    m_reducedWeights[weight_index] =
+        static_cast<float>(weights[m_weightIndex[weight_index]]);
+  m_reducedSpikeWeights.resize(m_neuronSpikeWeight.size());
+  for (std::uint32_t neuron_index = 0u;
+       neuron_index < m_neuronSpikeWeight.size(); ++neuron_index)
+    m_reducedSpikeWeights[neuron_index] =
+        static_cast<float>(weights[m_neuronSpikeWeight[neuron_index]]);
+  if (!is_quantized())
+    return;
+
+  /* The weights of the inputs share one symmetric scale inside the partial
+   * solution; the biases stay in single precision */
+  if (!(0.0 < m_partialSolution.activation_range()))
+    throw std::runtime_error(
+        "Quantized inference needs a Solution calibrated for it!");
+  double weight_range = 0.0;
+  for (std::uint32_t neuron_index = 0u;
+       neuron_index < m_neuronSpikeWeight.size(); ++neuron_index)
+    for (std::uint32_t weight_index = m_neuronWeightStart[neuron_index];
+         weight_index < (m_neuronWeightStart[neuron_index] +
+                         m_neuronInputCount[neuron_index]);
+         ++weight_index)
+      weight_range = std::max(weight_range,
+                              std::abs(weights[m_weightIndex[weight_index]]));
+  const double weight_scale =
+      ((0.0 < weight_range) ? (weight_range / 127.0) : 1.0);
+  m_activationScale = m_partialSolution.activation_range() / 127.0;
+  m_accumulatorScale = weight_scale * m_activationScale;
+  m_quantizedWeights.assign(m_weightIndex.size(), 0);
+  for (std::uint32_t neuron_index = 0u;
+       neuron_index < m_neuronSpikeWeight.size(); ++neuron_index) {
+    for (std::uint32_t weight_index = m_neuronWeightStart[neuron_index];
+         weight_index < (m_neuronWeightStart[neuron_index] +
+                         m_neuronInputCount[neuron_index]);
+         ++weight_index) {
+      m_quantizedWeights[weight_index] = static_cast<std::int8_t>(std::lround(
+          weights[m_weightIndex[weight_index]] / weight_scale));
+      /* The batched solve reads the quantized weights from here */
+      m_reducedWeights[weight_index] =
+          m_quantizedWeights[weight_index] * weight_scale;
+    }
+  }
+}
+
+void PartialSolutionSolver::solve_quantized(
+    const std::vector<double> &temp_data,
+    std::vector<double> &neuron_data) const {
+  thread_local std::vector<std::int8_t> activations;
+  const std::uint32_t neuron_number = m_neuronSpikeWeight.size();
+  activations.resize(m_requiredTmpDataSize + neuron_number);
+  for (std::uint32_t input_index = 0u; input_index < m_requiredTmpDataSize;
+       ++input_index)
+    activations[input_index] = quantize(temp_data[input_index]);
+
+  const int *input_functions =
+      m_partialSolution.neuron_input_functions().data();
+  const int *transfer_functions =
+      m_partialSolution.neuron_transfer_functions().data();
+  const int *spike_functions =
+      m_partialSolution.neuron_spike_functions().data();
+  for (std::uint32_t neuron_index = 0u; neuron_index < neuron_number;
+       ++neuron_index) {
+    const Input_functions input_function =
+        static_cast<Input_functions>(input_functions[neuron_index]);
+    const std::uint32_t weight_start = m_neuronWeightStart[neuron_index];
+    const std::uint32_t weight_end =
+        weight_start + m_neuronWeightCount[neuron_index];
+    const std::uint32_t input_start = m_neuronInputStart[neuron_index];
+    const std::uint32_t input_end =
+        input_start + m_neuronInputCount[neuron_index];
+    std::uint32_t weight_index = weight_start;
+    double new_neuron_data = 0.0;
+
+    if (input_function_add == input_function) {
+      std::int32_t accumulator = 0;
+      for (std::uint32_t input_index = input_start; input_index < input_end;
+           ++input_index, ++weight_index)
+        accumulator +=
+            static_cast<std::int32_t>(
+                activations[m_quantizedInputIndex[input_index]]) *
+            m_quantizedWeights[weight_index];
+      new_neuron_data = accumulator * m_accumulatorScale;
+      for (; weight_index < weight_end; ++weight_index)
+        new_neuron_data += m_reducedWeights[weight_index];
+    } else {
+      for (std::uint32_t input_index = input_start; input_index < input_end;
+           ++input_index, ++weight_index) {
+        const double new_neuron_input =
+            static_cast<std::int32_t>(
+                activations[m_quantizedInputIndex[input_index]]) *
+            m_quantizedWeights[weight_index] * m_accumulatorScale;
+        if (weight_start == weight_index)
+          new_neuron_data = new_neuron_input;
+        else
+          new_neuron_data = InputFunction::collect(
+              input_function, new_neuron_data, new_neuron_input);
+      }
+      for (; weight_index < weight_end; ++weight_index) {
+        /* Any additional weight shall count as biases */
+        if (weight_start == weight_index)
+          new_neuron_data = m_reducedWeights[weight_index];
+        else
+          new_neuron_data = InputFunction::collect(
+              input_function, new_neuron_data,
+              static_cast<double>(m_reducedWeights[weight_index]));
+      }
+    }
+
+    double &stored_neuron_data = neuron_data[m_outputStart + neuron_index];
+    stored_neuron_data = SpikeFunction::get_value(
+        static_cast<Spike_functions>(spike_functions[neuron_index]),
+        m_reducedSpikeWeights[neuron_index],
+        m_transfer_function.get_lookup_value(
+            static_cast<Transfer_functions>(transfer_functions[neuron_index]),
+            new_neuron_data),
+        stored_neuron_data);
+    activations[m_requiredTmpDataSize + neuron_index] =
+        quantize(stored_neuron_data);
+  } /*for(every Neuron)*/
+}
+
+template <typename Accumulator>
+void PartialSolutionSolver::solve_reduced_precision(
+    const std::vector<double> &temp_data,
+    std::vector<double> &neuron_data) const {
+  const float *weights = m_reducedWeights.data();
+  const int *input_functions =
+      m_partialSolution.neuron_input_functions().data();
+  const int *transfer_functions =
+      m_partialSolution.neuron_transfer_functions().data();
+  const int *spike_functions =
+      m_partialSolution.neuron_spike_functions().data();
+  const std::uint32_t neuron_number = m_neuronSpikeWeight.size();
+  for (std::uint32_t neuron_index = 0u; neuron_index < neuron_number;
+       ++neuron_index) {
+    const Input_functions input_function =
+        static_cast<Input_functions>(input_functions[neuron_index]);
+    const std::uint32_t weight_start = m_neuronWeightStart[neuron_index];
+    const std::uint32_t weight_end =
+        weight_start + m_neuronWeightCount[neuron_index];
+    const std::uint32_t input_start = m_neuronInputStart[neuron_index];
+    const std::uint32_t input_end =
+        input_start + m_neuronInputCount[neuron_index];
+    std::uint32_t weight_index = weight_start;
+    Accumulator new_neuron_data = 0.0;
+
+    for (std::uint32_t input_index = input_start; input_index < input_end;
+         ++input_index, ++weight_index) {
+      const float input_value = static_cast<float>(
+          m_inputFromTmpData[input_index]
+              ? temp_data[m_inputIndex[input_index]]
+              : neuron_data[m_inputIndex[input_index]]);
+      const Accumulator new_neuron_input =
+          static_cast<Accumulator>(input_value) *
+          static_cast<Accumulator>(weights[weight_index]);
+      if (weight_start == weight_index)
+        new_neuron_data = new_neuron_input;
+      else
+        new_neuron_data = InputFunction::collect(
+            input_function, new_neuron_data, new_neuron_input);
+    }
+    for (; weight_index < weight_end; ++weight_index) {
+      /* Any additional weight shall count as biases */
+      if (weight_start == weight_index)
+        new_neuron_data = weights[weight_index];
+      else
+        new_neuron_data = InputFunction::collect(
+            input_function, new_neuron_data,
+            static_cast<Accumulator>(weights[weight_index]));
+    }
+
+    double &stored_neuron_data = neuron_data[m_outputStart + neuron_index];
+    stored_neuron_data = static_cast<float>(SpikeFunction::get_value(
+        static_cast<Spike_functions>(spike_functions[neuron_index]),
+        m_reducedSpikeWeights[neuron_index],
+        m_transfer_function.get_value(
+            static_cast<Transfer_functions>(transfer_functions[neuron_index]),
+            new_neuron_data),
+        stored_neuron_data));
+  } /*for(every Neuron)*/
+}
+
 void PartialSolutionSolver::solve_internal(
     const std::vector<double> &input_data,
     rafko_utilities::DataRingbuffer<> &output_neuron_data,
     std::vector<double> &temp_data) const {
-  std::uint32_t weight_synapse_iterator_start =
-      0; /* Which is the first synapse belonging to the neuron under
-            @neuron_iterator */
-  std::uint32_t input_synapse_iterator_start =
-      0; /* Which is the first synapse belonging to the neuron under
-            @neuron_iterator */
-  std::uint32_t input_synapse_index =
-      0; /* Which synapse is being processed inside the Neuron */
-  std::uint32_t input_index_offset = 0;
-  std::int32_t input_index;
+  RFASSERT(temp_data.size() >= m_requiredTmpDataSize);
 
   /* Collect the input data to solve the partial solution */
-  m_input_iterator.skim([&](InputSynapseInterval input_synapse) {
-    if (SynapseIterator<>::is_index_input(
-            input_synapse.starts())) { /* If @PartialSolution input is from the
-                                          network input */
-      std::copy(input_data.begin() +
-                    SynapseIterator<>::array_index_from_external_index(
-                        input_synapse.starts()),
-                input_data.begin() +
-                    SynapseIterator<>::array_index_from_external_index(
-                        input_synapse.starts()) +
-                    input_synapse.interval_size(),
-                temp_data.begin() + input_index_offset);
+  std::uint32_t tmp_data_offset = 0u;
+  for (std::uint32_t synapse_index = 0u; synapse_index < m_collectSize.size();
+       ++synapse_index) {
+    const std::int32_t start = m_collectStart[synapse_index];
+    const std::uint32_t size = m_collectSize[synapse_index];
+    if (m_collectFromNetwork[synapse_index]) { /* If @PartialSolution input is
+                                                  from the network input */
+      std::copy(input_data.begin() + start, input_data.begin() + start + size,
+                temp_data.begin() + tmp_data_offset);
     } else if (static_cast<std::int32_t>(output_neuron_data.buffer_size()) >
-               input_synapse.starts()) { /* If @PartialSolution input is from
-                                            the previous row */
-      std::copy(output_neuron_data.get_element(input_synapse.reach_past_loops())
-                        .begin() +
-                    input_synapse.starts(),
-                output_neuron_data.get_element(input_synapse.reach_past_loops())
-                        .begin() +
-                    input_synapse.starts() + input_synapse.interval_size(),
-                temp_data.begin() + input_index_offset);
+               start) { /* If @PartialSolution input is from the previous row */
+      const std::vector<double> &source_data =
+          output_neuron_data.get_element(m_collectPastIndex[synapse_index]);
+      std::copy(source_data.begin() + start, source_data.begin() + start + size,
+                temp_data.begin() + tmp_data_offset);
     }
-    input_index_offset += input_synapse.interval_size();
-  });
+    tmp_data_offset += size;
+  }
 
-  /* Solve the Partial Solution based on the collected input data and stored
-   * operations */
-  input_index_offset = 0;
-  for (std::uint16_t neuron_iterator = 0;
-       neuron_iterator < m_partialSolution.output_data().interval_size();
-       ++neuron_iterator) {
-    double new_neuron_data;
-    double spike_function_weight = (0.0);
-    bool first_weight_in_neuron = true;
-    bool first_input_in_neuron = true;
-    m_internal_weight_iterator.iterate(
-        [&](std::int32_t weight_index) {
-          if (true ==
-              first_weight_in_neuron) { /* as per structure, the first weight is
-                                           for the spike function */
-            first_weight_in_neuron = false;
-            spike_function_weight =
-                m_partialSolution.weight_table(weight_index);
-          } else { /* the next weights are for inputs and biases */
-            double new_neuron_input;
-            if (m_partialSolution.index_synapse_number(neuron_iterator) >
-                input_synapse_index) { /* Collect input only as long as there is
-                                          any in the current inner neuron */
-              input_index = m_partialSolution
-                                .inside_indices(input_synapse_iterator_start +
-                                                input_synapse_index)
-                                .starts();
-              if (SynapseIterator<>::is_index_input(
-                      input_index)) { /* Neuron gets its input from the partial
-                                         solution input */
-                input_index =
-                    SynapseIterator<>::array_index_from_external_index(
-                        input_index - input_index_offset);
-                new_neuron_input = temp_data[input_index];
-              } else { /* Neuron gets its input internaly */
-                input_index = m_partialSolution.output_data().starts() +
-                              input_index + input_index_offset;
-                new_neuron_input =
-                    output_neuron_data.get_element(0, input_index);
-              }
-              ++input_index_offset; /* Step the input index to the next input */
-              if (input_index_offset >=
-                  m_partialSolution
-                      .inside_indices(input_synapse_iterator_start +
-                                      input_synapse_index)
-                      .interval_size()) {
-                input_index_offset =
-                    0; /* In case the next input would ascend above the current
-                          patition, go to next one */
-                ++input_synapse_index;
-              }
-            } else /* Any additional weight shall count as biases, so the input
-                      value is set to 1.0 */
-              new_neuron_input = (1.0);
-            /* The weighted input shall be added to the calculated value */
-            if (true == first_input_in_neuron) {
-              new_neuron_data = new_neuron_input *
-                                m_partialSolution.weight_table(weight_index);
-              first_input_in_neuron = false;
-            } else {
-              new_neuron_data = InputFunction::collect(
-                  m_partialSolution.neuron_input_functions(neuron_iterator),
-                  new_neuron_data,
-                  (new_neuron_input *
-                   m_partialSolution.weight_table(weight_index)));
-            }
-          }
-        },
-        weight_synapse_iterator_start,
-        m_partialSolution.weight_synapse_number(neuron_iterator));
-    weight_synapse_iterator_start +=
-        m_partialSolution.weight_synapse_number(neuron_iterator);
-    input_synapse_iterator_start += input_synapse_index;
-    input_index_offset = 0;
-    input_synapse_index = 0;
-
-    new_neuron_data =
-        m_transfer_function
-            .get_value(/* apply transfer function */
-                       m_partialSolution.neuron_transfer_functions(
-                           neuron_iterator),
-                       new_neuron_data);
-
-    new_neuron_data =
-        SpikeFunction::get_value(/* apply spike function */
-                                 m_partialSolution.neuron_spike_functions(
-                                     neuron_iterator),
-                                 spike_function_weight, new_neuron_data,
-                                 output_neuron_data.get_element(
-                                     0,
-                                     (m_partialSolution.output_data().starts() +
-                                      neuron_iterator)));
-
-    output_neuron_data.set_element(/* Store the resulting Neuron value */
-                                   0,
-                                   m_partialSolution.output_data().starts() +
-                                       neuron_iterator,
-                                   new_neuron_data);
-  } /*for(neuron_iterator --> every Neuron)*/
+  /* Solve the Partial Solution based on the collected input data and the
+   * compiled plan */
+  if (inference_precision_single_rounding == m_precision) {
+    solve_reduced_precision<float>(temp_data,
+                                   output_neuron_data.get_element(0u));
+    return;
+  }
+  if (inference_precision_mixed_rounding == m_precision) {
+    solve_reduced_precision<double>(temp_data,
+                                    output_neuron_data.get_element(0u));
+    return;
+  }
+  if (is_quantized()) {
+    solve_quantized(temp_data, output_neuron_data.get_element(0u));
+    return;
+  }
+  const double *weights = get_weights();
+  const int *input_functions =
+      m_partialSolution.neuron_input_functions().data();
+  const int *transfer_functions =
+      m_partialSolution.neuron_transfer_functions().data();
+  const int *spike_functions =
+      m_partialSolution.neuron_spike_functions().data();
+  std::vector<double> &neuron_data = output_neuron_data.get_element(0u);
+  const std::uint32_t neuron_number = m_neuronSpikeWeight.size();
+  for (std::uint32_t neuron_index = 0u; neuron_index < neuron_number;
+       ++neuron_index) {
+    const Input_functions input_function =
+        static_cast<Input_functions>(input_functions[neuron_index]);
+    const std::uint32_t weight_start = m_neuronWeightStart[neuron_index];
+    const std::uint32_t weight_end =
+        weight_start + m_neuronWeightCount[neuron_index];
+    const std::uint32_t input_start = m_neuronInputStart[neuron_index];
+    const std::uint32_t input_end =
+        input_start + m_neuronInputCount[neuron_index];
+    std::uint32_t weight_index = weight_start;
+    double new_neuron_data = 0.0;
+
+    for (std::uint32_t input_index = input_start; input_index < input_end;
+         ++input_index, ++weight_index) {
+      const double new_neuron_input =
+          (m_inputFromTmpData[input_index]
+               ? temp_data[m_inputIndex[input_index]]
+               : neuron_data[m_inputIndex[input_index]]) *
+          weights[m_weightIndex[weight_index]];
+      if (weight_start == weight_index)
+        new_neuron_data = new_neuron_input;
+      else
+        new_neuron_data = InputFunction::collect(
+            input_function, new_neuron_data, new_neuron_input);
+    }
+    for (; weight_index < weight_end; ++weight_index) {
+      /* Any additional weight shall count as biases, so the input value is 1.0
+       */
+      if (weight_start == weight_index)
+        new_neuron_data = weights[m_weightIndex[weight_index]];
+      else
+        new_neuron_data =
+            InputFunction::collect(input_function, new_neuron_data,
+                                   weights[m_weightIndex[weight_index]]);
+    }
+
+    new_neuron_data = m_transfer_function.get_value(
+        static_cast<Transfer_functions>(transfer_functions[neuron_index]),
+        new_neuron_data);
+
+    double &stored_neuron_data = neuron_data[m_outputStart + neuron_index];
+    stored_neuron_data = SpikeFunction::get_value(
+        static_cast<Spike_functions>(spike_functions[neuron_index]),
+        weights[m_neuronSpikeWeight[neuron_index]], new_neuron_data,
+        stored_neuron_data);
+  } /*for(every Neuron)*/
+}
+
+void PartialSolutionSolver::solve_batch(
+    const std::vector<double> &inputs, std::uint32_t batch_size,
+    rafko_utilities::DataRingbuffer<> &batch_neuron_data,
+    std::vector<double> &temp_data) const {
+  RFASSERT(0u < batch_size);
+  RFASSERT(0u == (inputs.size() % batch_size));
+  const std::uint32_t input_size = inputs.size() / batch_size;
+  const std::uint32_t neuron_number =
+      batch_neuron_data.buffer_size() / batch_size;
+
+  /*!Note: temp data layout: {collected inputs, batch}, then the accumulated
+   * values of the current Neuron and a row of 1.0 for the biases */
+  temp_data.resize((m_requiredTmpDataSize + 2u) * batch_size);
+  double *accumulator = temp_data.data() + (m_requiredTmpDataSize * batch_size);
+  double *bias_inputs = accumulator + batch_size;
+  std::fill(bias_inputs, bias_inputs + batch_size, 1.0);
+
+  /* Collect the input data to solve the partial solution */
+  std::uint32_t tmp_data_offset = 0u;
+  for (std::uint32_t synapse_index = 0u; synapse_index < m_collectSize.size();
+       ++synapse_index) {
+    const std::int32_t start = m_collectStart[synapse_index];
+    const std::uint32_t size = m_collectSize[synapse_index];
+    if (m_collectFromNetwork[synapse_index]) {
+      for (std::uint32_t input_index = 0u; input_index < size; ++input_index) {
+        double *target =
+            temp_data.data() + ((tmp_data_offset + input_index) * batch_size);
+        for (std::uint32_t sample = 0u; sample < batch_size; ++sample)
+          target[sample] = inputs[(sample * input_size) + start + input_index];
+      }
+    } else if (static_cast<std::int32_t>(neuron_number) > start) {
+      const std::vector<double> &source_data =
+          batch_neuron_data.get_element(m_collectPastIndex[synapse_index]);
+      std::copy(source_data.begin() + (start * batch_size),
+                source_data.begin() + ((start + size) * batch_size),
+                temp_data.begin() + (tmp_data_offset * batch_size));
+    }
+    tmp_data_offset += size;
+  }
+  /*!Note: With quantized inference the batch is solved with the quantized
+   * weights and inputs, but in double precision arithmetic */
+  if (is_quantized())
+    for (std::uint32_t value_index = 0u;
+         value_index < (m_requiredTmpDataSize * batch_size); ++value_index)
+      temp_data[value_index] =
+          quantize(temp_data[value_index]) * m_activationScale;
+  else if (is_reduced_precision()) /* the inputs are activations too */
+    for (std::uint32_t value_index = 0u;
+         value_index < (m_requiredTmpDataSize * batch_size); ++value_index)
+      temp_data[value_index] = static_cast<float>(temp_data[value_index]);
+
+  /* Solve every Neuron for the whole batch */
+  const double *weights = get_weights();
+  const int *input_functions =
+      m_partialSolution.neuron_input_functions().data();
+  const int *transfer_functions =
+      m_partialSolution.neuron_transfer_functions().data();
+  const int *spike_functions =
+      m_partialSolution.neuron_spike_functions().data();
+  std::vector<double> &neuron_data = batch_neuron_data.get_element(0u);
+  for (std::uint32_t neuron_index = 0u;
+       neuron_index < m_neuronSpikeWeight.size(); ++neuron_index) {
+    const Input_functions input_function =
+        static_cast<Input_functions>(input_functions[neuron_index]);
+    const std::uint32_t weight_start = m_neuronWeightStart[neuron_index];
+    const std::uint32_t weight_end =
+        weight_start + m_neuronWeightCount[neuron_index];
+    const std::uint32_t input_start = m_neuronInputStart[neuron_index];
+    const std::uint32_t input_end =
+        input_start + m_neuronInputCount[neuron_index];
+    std::uint32_t input_index = input_start;
+    std::fill(accumulator, accumulator + batch_size, 0.0);
+
+    for (std::uint32_t weight_index = weight_start; weight_index < weight_end;
+         ++weight_index, ++input_index) {
+      const double *values;
+      if (input_index >= input_end) /* Any additional weight shall count as
+                                       biases */
+        values = bias_inputs;
+      else if (m_inputFromTmpData[input_index])
+        values = temp_data.data() + (m_inputIndex[input_index] * batch_size);
+      else
+        values = neuron_data.data() + (m_inputIndex[input_index] * batch_size);
+      const double weight = (is_reduced_precision()
+                                 ? m_reducedWeights[weight_index]
+                                 : weights[m_weightIndex[weight_index]]);
+      if (weight_start == weight_index) {
+        for (std::uint32_t sample = 0u; sample < batch_size; ++sample)
+          accumulator[sample] = values[sample] * weight;
+      } else
+        InputFunction::collect_weighted(input_function, accumulator, values,
+                                        weight, batch_size);
+    }
+
+    const Transfer_functions transfer_function =
+        static_cast<Transfer_functions>(transfer_functions[neuron_index]);
+    const Spike_functions spike_function =
+        static_cast<Spike_functions>(spike_functions[neuron_index]);
+    const double spike_weight =
+        (is_reduced_precision() ? m_reducedSpikeWeights[neuron_index]
+                                : weights[m_neuronSpikeWeight[neuron_index]]);
+    double *stored_neuron_data =
+        neuron_data.data() + ((m_outputStart + neuron_index) * batch_size);
+    m_transfer_function.get_values(transfer_function, accumulator, accumulator,
+                                   batch_size);
+    SpikeFunction::get_values(spike_function, spike_weight, accumulator,
+                              stored_neuron_data, batch_size);
+    if (is_reduced_precision() && !is_quantized())
+      for (std::uint32_t sample = 0u; sample < batch_size; ++sample)
+        stored_neuron_data[sample] =
+            static_cast<float>(stored_neuron_data[sample]);
+  } /*for(every Neuron)*/
 }
 
 bool PartialSolutionSolver::is_valid() const {
@@ -214,9 +579,9 @@ bool PartialSolutionSolver::is_valid() const {
              m_partialSolution.index_synapse_number(neuron_iterator);
              ++input_iterator) {
           count_of_input_indexes +=
-              m_partialSolution
-                  .inside_indices(index_synapse_iterator_start + input_iterator)
-                  .interval_size();
+              SynapseIterator<InputSynapseInterval>::synapse_size(
+                  m_partialSolution.inside_indices(
+                      index_synapse_iterator_start + input_iterator));
           if (/* If a synapse input in a Neuron points after the neurons index
                */
               (m_partialSolution
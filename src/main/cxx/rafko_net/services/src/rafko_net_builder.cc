@@ -513,8 +513,7 @@ RafkoNet *RafkoNetBuilder::create_layers(
                           "Kernel Parameter mismatch: Input out of bounds!");
 
                     input_weights_to_add += interval_length;
-                    InputSynapseInterval &interval =
-                        *m_argNeuronArray.back().add_input_indices();
+                    InputSynapseInterval interval;
                     if (0 == layer_index)
                       interval.set_starts(
                           SynapseIterator<>::external_index_from_array_index(
@@ -523,6 +522,17 @@ RafkoNet *RafkoNetBuilder::create_layers(
                       interval.set_starts(layer_input_starts_at + mapped_index);
                     interval.set_interval_size(interval_length);
                     interval.set_reach_past_loops(0);
+
+                    /*!Note: The rows of a kernel are equally far from each
+                     * other, so they are described by one strided interval */
+                    google::protobuf::RepeatedPtrField<InputSynapseInterval>
+                        &input_indices =
+                            *m_argNeuronArray.back().mutable_input_indices();
+                    if ((0 == input_indices.size()) ||
+                        (!SynapseIterator<InputSynapseInterval>::merge_interval(
+                            *input_indices.Mutable(input_indices.size() - 1),
+                            interval)))
+                      *input_indices.Add() = interval;
                   });
           std::uint32_t stepped_dimension = 0;
           rafko_utilities::NDArrayIndex &input =
@@ -35,22 +35,29 @@ namespace rafko_net {
 void RafkoNetworkFeature::execute_in_paralell_for(
     const google::protobuf::RepeatedPtrField<IndexSynapseInterval>
         &relevant_neurons,
-    std::function<void(std::uint32_t)> &&fun,
-    std::uint32_t thread_index) const {
-  m_executionThreads[thread_index]->start_and_block(
-      [this, &relevant_neurons, &fun](std::uint32_t thread_index) {
+    std::function<void(std::uint32_t)> &&fun) const {
+  const std::uint32_t number_of_neurons =
+      SynapseIterator<>(relevant_neurons).size();
+  std::uint32_t neurons_to_do_in_one_task =
+      1u + (number_of_neurons / m_threadPool.get_concurrency());
+  std::uint32_t number_of_tasks =
+      (number_of_neurons + neurons_to_do_in_one_task - 1u) /
+      neurons_to_do_in_one_task;
+  m_threadPool.parallel_for(
+      0u, number_of_tasks,
+      [&relevant_neurons, &fun,
+       neurons_to_do_in_one_task](std::uint32_t task_index) {
+        /*!Note: The iterator caches its last position when indexed, so every
+         * task needs its own */
         SynapseIterator<> relevant_neuron_iterator(relevant_neurons);
-        std::uint32_t neurons_to_do_in_one_thread =
-            1u + (relevant_neuron_iterator.size() /
-                  m_executionThreads[0]->get_number_of_threads());
         std::uint32_t start_index =
             std::min(relevant_neuron_iterator.size(),
-                     (neurons_to_do_in_one_thread * thread_index));
-        std::uint32_t neurons_to_do_in_this_thread =
-            std::min(neurons_to_do_in_one_thread,
+                     (neurons_to_do_in_one_task * task_index));
+        std::uint32_t neurons_to_do_in_this_task =
+            std::min(neurons_to_do_in_one_task,
                      (relevant_neuron_iterator.size() - start_index));
         for (std::uint32_t synapse_index = 0;
-             synapse_index < neurons_to_do_in_this_thread; synapse_index++) {
+             synapse_index < neurons_to_do_in_this_task; synapse_index++) {
           fun(relevant_neuron_iterator[start_index + synapse_index]);
         }
       });
@@ -58,16 +65,13 @@ void RafkoNetworkFeature::execute_in_paralell_for(
 
 void RafkoNetworkFeature::execute_solution_relevant(
     const FeatureGroup &feature, const rafko_mainframe::RafkoSettings &settings,
-    NeuronDataProxy neuron_data, std::uint32_t thread_index) const {
-  RFASSERT(thread_index < m_executionThreads.size());
-
+    NeuronDataProxy neuron_data) const {
   switch (feature.feature()) {
   case neuron_group_feature_softmax:
-    execute_softmax(neuron_data, feature.relevant_neurons(), thread_index);
+    execute_softmax(neuron_data, feature.relevant_neurons());
     break;
   case neuron_group_feature_dropout_regularization:
-    execute_dropout(neuron_data, settings, feature.relevant_neurons(),
-                    thread_index);
+    execute_dropout(neuron_data, settings, feature.relevant_neurons());
     break;
   default:
     break;
@@ -77,16 +81,12 @@ void RafkoNetworkFeature::execute_solution_relevant(
 double RafkoNetworkFeature::calculate_performance_relevant(
     const FeatureGroup &feature,
     const rafko_mainframe::RafkoSettings & /*settings*/,
-    const RafkoNet &network, std::uint32_t thread_index) const {
-  RFASSERT(thread_index < m_executionThreads.size());
-
+    const RafkoNet &network) const {
   switch (feature.feature()) {
   case neuron_group_feature_l1_regularization:
-    return calculate_l1_regularization(network, feature.relevant_neurons(),
-                                       thread_index);
+    return calculate_l1_regularization(network, feature.relevant_neurons());
   case neuron_group_feature_l2_regularization:
-    return calculate_l2_regularization(network, feature.relevant_neurons(),
-                                       thread_index);
+    return calculate_l2_regularization(network, feature.relevant_neurons());
   default:
     return 0.0;
   }
@@ -95,8 +95,7 @@ double RafkoNetworkFeature::calculate_performance_relevant(
 void RafkoNetworkFeature::execute_softmax(
     NeuronDataProxy neuron_data,
     const google::protobuf::RepeatedPtrField<IndexSynapseInterval>
-        &relevant_neurons,
-    std::uint32_t thread_index) const {
+        &relevant_neurons) const {
   std::atomic<double> max_value{-std::numeric_limits<double>::max()};
   std::atomic<double> expsum{(0)};
 
@@ -113,8 +112,7 @@ void RafkoNetworkFeature::execute_softmax(
         while (!expsum.compare_exchange_weak(
             current, (current + std::exp(neuron_data[neuron_index]))))
           current = expsum;
-      },
-      thread_index);
+      });
 
   double used_max_value = max_value;
   double used_expsum = expsum / std::exp(max_value);
@@ -133,15 +131,13 @@ void RafkoNetworkFeature::execute_softmax(
        &used_expsum](std::uint32_t neuron_index) {
         neuron_data[neuron_index] =
             std::exp(neuron_data[neuron_index] - used_max_value) / used_expsum;
-      },
-      thread_index);
+      });
 }
 
 void RafkoNetworkFeature::execute_dropout(
     NeuronDataProxy neuron_data, const rafko_mainframe::RafkoSettings &settings,
     const google::protobuf::RepeatedPtrField<IndexSynapseInterval>
-        &relevant_neurons,
-    std::uint32_t thread_index) const {
+        &relevant_neurons) const {
   /*!Note: Since no Neuron will be involved in the execution twice, no need for
    * a mutual exclusive lock or atomics */
   execute_in_paralell_for(
@@ -151,15 +147,13 @@ void RafkoNetworkFeature::execute_dropout(
             static_cast<double>(rand() % 100 + 1u)) {
           neuron_data[neuron_index] = 0.0;
         }
-      },
-      thread_index);
+      });
 }
 
 double RafkoNetworkFeature::calculate_l1_regularization(
     const RafkoNet &network,
     const google::protobuf::RepeatedPtrField<IndexSynapseInterval>
-        &relevant_neurons,
-    std::uint32_t thread_index) const {
+        &relevant_neurons) const {
   std::atomic<double> error_value = 0.0;
   execute_in_paralell_for(
       relevant_neurons,
@@ -173,16 +167,14 @@ double RafkoNetworkFeature::calculate_l1_regularization(
                   (error_value + std::abs(network.weight_table(weight_index)))))
                 current = error_value;
             });
-      },
-      thread_index);
+      });
   return static_cast<double>(error_value);
 }
 
 double RafkoNetworkFeature::calculate_l2_regularization(
     const RafkoNet &network,
     const google::protobuf::RepeatedPtrField<IndexSynapseInterval>
-        &relevant_neurons,
-    std::uint32_t thread_index) const {
+        &relevant_neurons) const {
   std::atomic<double> error_value = 0.0;
   execute_in_paralell_for(
       relevant_neurons,
@@ -197,8 +189,7 @@ double RafkoNetworkFeature::calculate_l2_regularization(
                    std::pow(network.weight_table(weight_index), (2.0)))))
                 current = error_value;
             });
-      },
-      thread_index);
+      });
   return static_cast<double>(error_value);
 }
 
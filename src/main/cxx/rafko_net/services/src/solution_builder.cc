@@ -18,8 +18,14 @@
 #include "rafko_net/services/solution_builder.hpp"
 
 #include <math.h>
+#include <algorithm>
+#include <iterator>
 #include <memory>
+#include <numeric>
+#include <set>
 #include <stdexcept>
+#include <string>
+#include <type_traits>
 #include <utility>
 
 #if (RAFKO_USES_OPENCL)
@@ -33,6 +39,7 @@
 #include "rafko_net/models/transfer_function.hpp"
 #include "rafko_utilities/models/rafko_gpu_kernel_library.hpp"
 #endif /*(RAFKO_USES_OPENCL)*/
+#include "rafko_mainframe/services/rafko_profiler.hpp"
 #include "rafko_net/models/input_function.hpp"
 #include "rafko_net/models/neuron_info.hpp"
 #include "rafko_net/services/neuron_router.hpp"
@@ -41,6 +48,104 @@
 
 #include "rafko_net/services/partial_solution_builder.hpp"
 
+namespace {
+
+/**
+ * @brief     Maps the Neuron indices of the given intervals to their updated
+ * value, merging the consecutive indices into one interval and the equally
+ * placed runs of the same size into one strided interval. Network input
+ * intervals and the intervals before the first shifted Neuron are kept as is.
+ *
+ * @param         intervals               The intervals to re-index
+ * @param[in]     first_shifted_neuron    The first Neuron index to be mapped
+ * @param[in]     updated_index_of        Maps a Neuron index to its updated
+ * value, or to an empty optional if the Neuron is removed
+ *
+ * @return    true if the intervals were re-indexed, false if they contain a
+ * removed Neuron
+ */
+template <typename Interval, typename IndexMap>
+bool remap_interval_indices(
+    google::protobuf::RepeatedPtrField<Interval> &intervals,
+    std::uint32_t first_shifted_neuron, IndexMap &&updated_index_of) {
+  using Iterator = rafko_net::SynapseIterator<Interval>;
+  google::protobuf::RepeatedPtrField<Interval> remapped;
+  auto append = [&remapped](const Interval &piece) {
+    if ((0 == remapped.size()) ||
+        !Iterator::merge_interval(*remapped.Mutable(remapped.size() - 1),
+                                  piece))
+      *remapped.Add() = piece;
+  };
+  for (const Interval &interval : intervals) {
+    const std::uint32_t run_count = Iterator::run_count(interval);
+    if ((0 > interval.starts()) || (0u == interval.interval_size()) ||
+        (static_cast<std::uint32_t>(Iterator::index_in_synapse(
+             interval, Iterator::synapse_size(interval) - 1u)) <
+         first_shifted_neuron)) {
+      *remapped.Add() = interval;
+      continue;
+    }
+    for (std::uint32_t run_index = 0u; run_index < run_count; ++run_index) {
+      const std::uint32_t run_start =
+          static_cast<std::uint32_t>(Iterator::run_start(interval, run_index));
+      std::optional<Interval> piece;
+      for (std::uint32_t neuron_index = run_start;
+           neuron_index < (run_start + interval.interval_size());
+           ++neuron_index) {
+        std::optional<std::uint32_t> updated_index =
+            updated_index_of(neuron_index);
+        if (!updated_index.has_value())
+          return false;
+        if (piece.has_value() &&
+            ((piece->starts() + piece->interval_size()) ==
+             updated_index.value())) {
+          piece->set_interval_size(piece->interval_size() + 1u);
+          continue;
+        }
+        if (piece.has_value())
+          append(piece.value());
+        piece.emplace();
+        piece->set_starts(updated_index.value());
+        piece->set_interval_size(1u);
+        if constexpr (std::is_same_v<Interval,
+                                     rafko_net::InputSynapseInterval>)
+          piece->set_reach_past_loops(interval.reach_past_loops());
+      }
+      append(piece.value());
+    }
+  }
+  intervals.Swap(&remapped);
+  return true;
+}
+
+/**
+ * @brief     Tells if the given intervals point to the same indices
+ */
+template <typename Interval>
+bool same_intervals(const google::protobuf::RepeatedPtrField<Interval> &a,
+                    const google::protobuf::RepeatedPtrField<Interval> &b) {
+  using Iterator = rafko_net::SynapseIterator<Interval>;
+  return std::equal(
+      a.begin(), a.end(), b.begin(), b.end(),
+      [](const Interval &interval_a, const Interval &interval_b) {
+        bool same = (interval_a.starts() == interval_b.starts()) &&
+                    (interval_a.interval_size() ==
+                     interval_b.interval_size()) &&
+                    (Iterator::run_count(interval_a) ==
+                     Iterator::run_count(interval_b));
+        if constexpr (std::is_same_v<Interval,
+                                     rafko_net::InputSynapseInterval>)
+          same = same &&
+                 ((1u == Iterator::run_count(interval_a)) ||
+                  (interval_a.stride_size() == interval_b.stride_size())) &&
+                 (interval_a.reach_past_loops() ==
+                  interval_b.reach_past_loops());
+        return same;
+      });
+}
+
+} /* namespace */
+
 namespace rafko_net {
 
 void SolutionBuilder::update(Solution *previous, const RafkoNet &network,
@@ -51,10 +156,310 @@ void SolutionBuilder::update(Solution *previous, const RafkoNet &network,
   delete solution;
 }
 
+std::optional<SolutionUpdate>
+SolutionBuilder::update(Solution *previous, const RafkoNet &network,
+                        const NetworkChanges &changes, bool optimize_to_gpu) {
+  RFASSERT(nullptr != previous);
+  std::optional<SolutionUpdate> solution_update =
+      update_partials(*previous, network, changes);
+  if (!solution_update.has_value())
+    update(previous, network, optimize_to_gpu);
+  return solution_update;
+}
+
+std::optional<SolutionUpdate>
+SolutionBuilder::update_partials(Solution &solution, const RafkoNet &network,
+                                 const NetworkChanges &changes) const {
+  RFPROFILE_SCOPE("SolutionBuilder::update_partials");
+  std::vector<std::uint32_t> removed(changes.removed_neurons);
+  std::vector<std::uint32_t> added(changes.added_neurons);
+  std::vector<std::uint32_t> changed(changes.changed_neurons);
+  for (std::vector<std::uint32_t> *neurons : {&removed, &added, &changed}) {
+    std::sort(neurons->begin(), neurons->end());
+    neurons->erase(std::unique(neurons->begin(), neurons->end()),
+                   neurons->end());
+  }
+  const std::uint32_t neuron_number = network.neuron_array_size();
+  if (((0u < removed.size()) && (solution.neuron_number() <= removed.back())) ||
+      ((0u < added.size()) && (neuron_number <= added.back())) ||
+      ((0u < changed.size()) && (neuron_number <= changed.back())) ||
+      ((solution.neuron_number() + added.size()) !=
+       (neuron_number + removed.size())))
+    throw std::runtime_error(
+        "Network changes don't match the network the Solution is built from!");
+  if (solution.output_neuron_number() != network.output_neuron_number())
+    return {};
+
+  /* Neurons before the first added or removed one keep their index */
+  const std::uint32_t first_shifted_neuron =
+      std::min((0u < removed.size()) ? removed.front() : neuron_number,
+               (0u < added.size()) ? added.front() : neuron_number);
+  auto updated_index_of = [&removed, &added](std::uint32_t neuron_index)
+      -> std::optional<std::uint32_t> {
+    std::vector<std::uint32_t>::const_iterator removed_before =
+        std::lower_bound(removed.begin(), removed.end(), neuron_index);
+    if ((removed_before != removed.end()) && (*removed_before == neuron_index))
+      return {};
+    std::uint32_t updated_index =
+        neuron_index - std::distance(removed.cbegin(), removed_before);
+    for (std::uint32_t added_index : added) {
+      if (added_index > updated_index)
+        break;
+      ++updated_index;
+    }
+    return updated_index;
+  };
+
+  /* Collect the updated Neuron range of each partial */
+  const std::uint32_t partial_count = solution.partial_solutions_size();
+  std::vector<std::uint32_t> partial_starts(partial_count);
+  std::vector<std::uint32_t> partial_sizes(partial_count, 0u);
+  std::vector<std::uint32_t> partial_rows(partial_count);
+  std::vector<bool> partial_rebuilt(partial_count, false);
+  std::vector<std::uint32_t> partials_by_start;
+  std::uint32_t partial_index = 0u;
+  for (std::int32_t row_index = 0; row_index < solution.cols_size();
+       ++row_index) {
+    for (std::uint32_t column_index = 0u;
+         column_index < solution.cols(row_index); ++column_index) {
+      const IndexSynapseInterval &output =
+          solution.partial_solutions(partial_index).output_data();
+      const std::uint32_t partial_end =
+          output.starts() + output.interval_size();
+      const std::uint32_t removed_inside =
+          std::distance(std::lower_bound(removed.begin(), removed.end(),
+                                         output.starts()),
+                        std::lower_bound(removed.begin(), removed.end(),
+                                         partial_end));
+      partial_rows[partial_index] = row_index;
+      if (removed_inside < output.interval_size()) {
+        std::uint32_t first_kept = output.starts();
+        while (std::binary_search(removed.begin(), removed.end(), first_kept))
+          ++first_kept;
+        std::uint32_t last_kept = partial_end - 1u;
+        while (std::binary_search(removed.begin(), removed.end(), last_kept))
+          --last_kept;
+        partial_starts[partial_index] = updated_index_of(first_kept).value();
+        partial_sizes[partial_index] = updated_index_of(last_kept).value() -
+                                       partial_starts[partial_index] + 1u;
+        /* Neurons were removed from the partial, or added inside it */
+        partial_rebuilt[partial_index] =
+            ((0u < removed_inside) ||
+             (partial_sizes[partial_index] != output.interval_size()));
+        partials_by_start.push_back(partial_index);
+      }
+      ++partial_index;
+    }
+  }
+  std::sort(partials_by_start.begin(), partials_by_start.end(),
+            [&partial_starts](std::uint32_t a, std::uint32_t b) {
+              return partial_starts[a] < partial_starts[b];
+            });
+  auto partial_of =
+      [&](std::uint32_t neuron_index) -> std::optional<std::uint32_t> {
+    std::vector<std::uint32_t>::const_iterator next_partial = std::upper_bound(
+        partials_by_start.cbegin(), partials_by_start.cend(), neuron_index,
+        [&partial_starts](std::uint32_t index, std::uint32_t partial) {
+          return index < partial_starts[partial];
+        });
+    if (next_partial == partials_by_start.cbegin())
+      return {};
+    const std::uint32_t partial = *std::prev(next_partial);
+    if (neuron_index < (partial_starts[partial] + partial_sizes[partial]))
+      return partial;
+    return {};
+  };
+
+  /* Added Neurons extend the partial of the Neuron before them, or the one
+   * after them if there is no such partial */
+  std::vector<std::uint32_t> added_to_prepend;
+  for (std::uint32_t added_index : added) {
+    if (partial_of(added_index).has_value())
+      continue;
+    std::optional<std::uint32_t> previous_partial;
+    if (0u < added_index)
+      previous_partial = partial_of(added_index - 1u);
+    if (previous_partial.has_value()) {
+      ++partial_sizes[previous_partial.value()];
+      partial_rebuilt[previous_partial.value()] = true;
+    } else {
+      added_to_prepend.push_back(added_index);
+    }
+  }
+  for (std::vector<std::uint32_t>::const_reverse_iterator added_index =
+           added_to_prepend.crbegin();
+       added_index != added_to_prepend.crend(); ++added_index) {
+    std::optional<std::uint32_t> next_partial = partial_of(*added_index + 1u);
+    if (!next_partial.has_value())
+      return {};
+    --partial_starts[next_partial.value()];
+    ++partial_sizes[next_partial.value()];
+    partial_rebuilt[next_partial.value()] = true;
+  }
+  for (std::uint32_t changed_index : changed)
+    partial_rebuilt[partial_of(changed_index).value()] = true;
+  RFASSERT(neuron_number == std::accumulate(partial_sizes.begin(),
+                                            partial_sizes.end(), 0u));
+
+  /* Re-build or re-index the partials */
+  const double max_megabytes_in_one_partial =
+      (m_settings.get_device_max_megabytes() /
+       static_cast<double>(m_settings.get_max_solve_threads()));
+  std::uint32_t reach_back_max = solution.network_memory_length() - 1u;
+  std::uint32_t reach_index_max = solution.network_input_size() - 1u;
+  std::vector<std::uint32_t> rebuilt_partials;
+  std::vector<std::uint32_t> reindexed_partials;
+  std::vector<std::uint32_t> uncalibrated_partials;
+  SolutionUpdate solution_update;
+  for (partial_index = 0u; partial_index < partial_count; ++partial_index) {
+    if (0u == partial_sizes[partial_index]) {
+      solution_update.removed_partials.push_back(partial_index);
+      continue;
+    }
+    PartialSolution &partial =
+        *solution.mutable_partial_solutions(partial_index);
+
+    /* Feature groups of the network are re-indexed by the caller of the update
+     * as well, a change in them is checked after every partial is in place */
+    bool features_shifted = false;
+    for (FeatureGroup &feature : *partial.mutable_solved_features()) {
+      google::protobuf::RepeatedPtrField<IndexSynapseInterval>
+          relevant_neurons = feature.relevant_neurons();
+      if (!remap_interval_indices(relevant_neurons, first_shifted_neuron,
+                                  updated_index_of))
+        return {};
+      features_shifted = features_shifted ||
+                         !same_intervals(relevant_neurons,
+                                         feature.relevant_neurons());
+      feature.mutable_relevant_neurons()->Swap(&relevant_neurons);
+    }
+
+    if (!partial_rebuilt[partial_index]) {
+      google::protobuf::RepeatedPtrField<InputSynapseInterval> input_data =
+          partial.input_data();
+      if (remap_interval_indices(input_data, first_shifted_neuron,
+                                 updated_index_of)) {
+        if (features_shifted ||
+            (static_cast<std::uint32_t>(partial.output_data().starts()) !=
+             partial_starts[partial_index]) ||
+            !same_intervals(input_data, partial.input_data())) {
+          partial.mutable_output_data()->set_starts(
+              partial_starts[partial_index]);
+          partial.mutable_input_data()->Swap(&input_data);
+          reindexed_partials.push_back(partial_index);
+        }
+        continue;
+      } /* A partial reading a removed Neuron is re-built */
+    }
+
+    PartialSolution updated_partial;
+    PartialSolutionBuilder partial_builder(updated_partial);
+    double remaining_megabytes_in_partial = max_megabytes_in_one_partial;
+    updated_partial.mutable_output_data()->set_starts(
+        partial_starts[partial_index]);
+    for (std::uint32_t neuron_index = partial_starts[partial_index];
+         neuron_index <
+         (partial_starts[partial_index] + partial_sizes[partial_index]);
+         ++neuron_index) {
+      const double neuron_megabyte_size =
+          NeuronInfo::get_neuron_estimated_size_megabytes(
+              network.neuron_array(neuron_index));
+      if (neuron_megabyte_size >= remaining_megabytes_in_partial)
+        return {};
+      remaining_megabytes_in_partial -= neuron_megabyte_size;
+      std::pair<std::uint32_t, std::uint32_t> neuron_input_params =
+          partial_builder.add_neuron_to_partial_solution(network, neuron_index);
+      reach_back_max =
+          std::max(reach_back_max, std::get<0>(neuron_input_params));
+      reach_index_max =
+          std::max(reach_index_max, std::get<1>(neuron_input_params));
+    }
+
+    /* Inputs from the current loop need to be solved in previous rows */
+    bool dependencies_solved = true;
+    std::uint32_t synapse_reach_past = 0u;
+    SynapseIterator<InputSynapseInterval>::iterate_terminatable(
+        updated_partial.input_data(),
+        [&synapse_reach_past](const InputSynapseInterval &synapse) {
+          synapse_reach_past = synapse.reach_past_loops();
+          return true;
+        },
+        [&](std::int32_t neuron_index) {
+          if ((0u < synapse_reach_past) ||
+              SynapseIterator<>::is_index_input(neuron_index))
+            return true;
+          std::optional<std::uint32_t> input_partial = partial_of(neuron_index);
+          dependencies_solved =
+              (input_partial.has_value() &&
+               (partial_rows[input_partial.value()] <
+                partial_rows[partial_index]));
+          return dependencies_solved;
+        });
+    if (!dependencies_solved)
+      return {};
+
+    updated_partial.mutable_solved_features()->Swap(
+        partial.mutable_solved_features());
+    if (0.0 < partial.activation_range())
+      uncalibrated_partials.push_back(partial_index);
+    partial.Swap(&updated_partial);
+    rebuilt_partials.push_back(partial_index);
+  }
+
+  /*!Note: Features are kept in the partial solutions they were solved in, so
+   * they need to be the same as the ones in the network */
+  std::multiset<std::string> network_features;
+  for (const FeatureGroup &feature : network.neuron_group_features())
+    network_features.insert(feature.SerializeAsString());
+  std::multiset<std::string> solved_features;
+  for (const PartialSolution &partial : solution.partial_solutions())
+    for (const FeatureGroup &feature : partial.solved_features())
+      solved_features.insert(feature.SerializeAsString());
+  if (network_features != solved_features)
+    return {};
+
+  /* Remove the emptied partials, and the rows left without partials */
+  std::vector<std::uint32_t> cols(solution.cols().begin(),
+                                  solution.cols().end());
+  for (std::vector<std::uint32_t>::const_reverse_iterator removed_partial =
+           solution_update.removed_partials.crbegin();
+       removed_partial != solution_update.removed_partials.crend();
+       ++removed_partial) {
+    solution.mutable_partial_solutions()->DeleteSubrange(*removed_partial, 1);
+    --cols[partial_rows[*removed_partial]];
+  }
+  solution.clear_cols();
+  for (std::uint32_t row_cols : cols)
+    if (0u < row_cols)
+      solution.add_cols(row_cols);
+
+  const std::vector<std::uint32_t> &removed_partials =
+      solution_update.removed_partials;
+  auto updated_partial_index = [&removed_partials](std::uint32_t index) {
+    return index - static_cast<std::uint32_t>(std::distance(
+                       removed_partials.cbegin(),
+                       std::lower_bound(removed_partials.cbegin(),
+                                        removed_partials.cend(), index)));
+  };
+  for (std::uint32_t index : rebuilt_partials)
+    solution_update.rebuilt_partials.push_back(updated_partial_index(index));
+  for (std::uint32_t index : reindexed_partials)
+    solution_update.reindexed_partials.push_back(updated_partial_index(index));
+  for (std::uint32_t index : uncalibrated_partials)
+    solution_update.uncalibrated_partials.push_back(
+        updated_partial_index(index));
+
+  solution.set_neuron_number(neuron_number);
+  solution.set_network_memory_length(reach_back_max + 1u);
+  solution.set_network_input_size(reach_index_max + 1u);
+  return solution_update;
+}
+
 Solution *SolutionBuilder::build(const RafkoNet &net,
                                  google::protobuf::Arena *arena_ptr,
                                  bool optimize_to_gpu) {
   RFASSERT_SCOPE(SOLUTION_BUILD);
+  RFPROFILE_SCOPE("SolutionBuilder::build");
   NeuronRouter neuron_router(net);
   Solution *solution =
       google::protobuf::Arena::CreateMessage<Solution>(arena_ptr);
@@ -325,6 +730,7 @@ std::string SolutionBuilder::get_kernel_for_solution(
     std::uint32_t input_synapse_index = 0u;
     std::uint32_t input_synapse_index_offset = 0u;
     std::uint32_t input_offset_in_current_synapse = 0u;
+    std::uint32_t input_run_in_current_synapse = 0u;
     std::uint32_t weight_synapse_start = 0u;
 
     for (std::uint32_t inner_neuron_index = 0;
@@ -350,7 +756,7 @@ std::string SolutionBuilder::get_kernel_for_solution(
       std::string inner_neuron_operation = "";
       SynapseIterator<>::skim(
           partial.weight_indices(),
-          [&](IndexSynapseInterval weight_synapse) {
+          [&](const IndexSynapseInterval &weight_synapse) {
             std::uint32_t synapse_weights_done = 0u;
             if (first_weight_synapse_in_neuron) {
               spike_weight_index = weight_synapse.starts();
@@ -360,11 +766,13 @@ std::string SolutionBuilder::get_kernel_for_solution(
             while ((synapse_weights_done < weight_synapse.interval_size()) &&
                    (input_synapse_index_offset <
                     partial.index_synapse_number(inner_neuron_index))) {
+              const InputSynapseInterval &current_input_synapse =
+                  partial.inside_indices(input_synapse_index +
+                                         input_synapse_index_offset);
+              /*!Note: Inputs are paired with weights in runs of the input
+               * synapse, as the indices are only continuous inside those */
               const std::uint32_t current_input_synapse_size =
-                  partial
-                      .inside_indices(input_synapse_index +
-                                      input_synapse_index_offset)
-                      .interval_size();
+                  current_input_synapse.interval_size();
               std::uint32_t weights_able_to_do = std::min(
                   (weight_synapse.interval_size() - synapse_weights_done),
                   (current_input_synapse_size -
@@ -372,15 +780,10 @@ std::string SolutionBuilder::get_kernel_for_solution(
 
               /* decide input index start for this synapse */
               std::int32_t input_past_reach =
-                  partial
-                      .inside_indices(input_synapse_index +
-                                      input_synapse_index_offset)
-                      .reach_past_loops();
+                  current_input_synapse.reach_past_loops();
               std::int32_t input_index_start =
-                  partial
-                      .inside_indices(input_synapse_index +
-                                      input_synapse_index_offset)
-                      .starts();
+                  SynapseIterator<InputSynapseInterval>::run_start(
+                      current_input_synapse, input_run_in_current_synapse);
               RFASSERT_LOG("InnerNeuron[{} / {}]: ", inner_neuron_index,
                            partial.output_data().interval_size());
               RFASSERT_LOG("synapse_weights_done: {}/{}", synapse_weights_done,
@@ -409,7 +812,8 @@ std::string SolutionBuilder::get_kernel_for_solution(
                                            input_index_start);
                 weights_able_to_do = std::min(
                     weights_able_to_do,
-                    partial_input_synapses.interval_size_of(input_index_start));
+                    partial_input_synapses.contiguous_size_from(
+                        input_index_start));
                 input_index_start = partial_input_synapses[input_index_start];
                 if (SynapseIterator<>::is_index_input(input_index_start)) {
                   input_index_start =
@@ -498,6 +902,12 @@ std::string SolutionBuilder::get_kernel_for_solution(
               if (input_offset_in_current_synapse >=
                   current_input_synapse_size) {
                 input_offset_in_current_synapse = 0;
+                ++input_run_in_current_synapse;
+              }
+              if (input_run_in_current_synapse >=
+                  SynapseIterator<InputSynapseInterval>::run_count(
+                      current_input_synapse)) {
+                input_run_in_current_synapse = 0;
                 ++input_synapse_index_offset;
               }
               synapse_weights_done += weights_able_to_do;
@@ -0,0 +1,103 @@
+/*! This file is part of davids91/Rafko.
+ *
+ *    Rafko is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    (at your option) any later version.
+ *
+ *    Rafko is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with Rafko.  If not, see <https://www.gnu.org/licenses/> or
+ *    <https://github.com/davids91/rafko/blob/master/LICENSE>
+ */
+
+#include "rafko_net/services/solution_quantizer.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "rafko_mainframe/services/rafko_assertion_logger.hpp"
+#include "rafko_net/services/solution_solver.hpp"
+#include "rafko_net/services/synapse_iterator.hpp"
+
+namespace rafko_net {
+
+void SolutionQuantizer::calibrate(
+    Solution &solution, const rafko_gym::RafkoDataSet &data_set,
+    const rafko_mainframe::RafkoSettings &settings) {
+  RFASSERT(data_set.get_input_size() == solution.network_input_size());
+  const rafko_mainframe::RafkoSettings calibration_settings =
+      rafko_mainframe::RafkoSettings(settings).set_inference_precision(
+          inference_precision_double);
+  SolutionSolver solver(&solution, calibration_settings);
+
+  /* Collect the range of every network input and Neuron */
+  std::vector<double> input_ranges(solution.network_input_size(), 0.0);
+  std::vector<double> neuron_ranges(solution.neuron_number(), 0.0);
+  const std::uint32_t inputs_in_one_sequence =
+      data_set.get_inputs_in_one_sequence();
+  std::vector<double> input(data_set.get_input_size());
+  for (std::uint32_t sequence_index = 0u;
+       sequence_index < data_set.get_number_of_sequences(); ++sequence_index) {
+    for (std::uint32_t input_index = 0u; input_index < inputs_in_one_sequence;
+         ++input_index) {
+      const rafko_gym::RafkoDataSet::SampleView input_sample =
+          data_set.get_input_view((sequence_index * inputs_in_one_sequence) +
+                                  input_index);
+      std::copy(input_sample.begin(), input_sample.end(), input.begin());
+      solver.solve(input, (0u == input_index) /*reset_neuron_data*/);
+      for (std::uint32_t index = 0u; index < input_ranges.size(); ++index)
+        input_ranges[index] =
+            std::max(input_ranges[index], std::abs(input[index]));
+      const std::vector<double> &neuron_data =
+          solver.get_memory().get_element(0u);
+      for (std::uint32_t index = 0u; index < neuron_ranges.size(); ++index)
+        neuron_ranges[index] =
+            std::max(neuron_ranges[index], std::abs(neuron_data[index]));
+    }
+  }
+
+  /* A partial solution reads its inputs and its own Neurons */
+  for (PartialSolution &partial : *solution.mutable_partial_solutions()) {
+    double range = 0.0;
+    SynapseIterator<InputSynapseInterval>(partial.input_data())
+        .skim([&range, &input_ranges,
+               &neuron_ranges](const InputSynapseInterval &input_synapse) {
+          const bool from_network_input =
+              SynapseIterator<>::is_index_input(input_synapse.starts());
+          for (std::uint32_t run_index = 0u;
+               run_index <
+               SynapseIterator<InputSynapseInterval>::run_count(input_synapse);
+               ++run_index) {
+            const std::int32_t run_start =
+                SynapseIterator<InputSynapseInterval>::run_start(input_synapse,
+                                                                 run_index);
+            const std::vector<double> &ranges =
+                (from_network_input ? input_ranges : neuron_ranges);
+            const std::uint32_t start =
+                (from_network_input
+                     ? SynapseIterator<>::array_index_from_external_index(
+                           run_start)
+                     : run_start);
+            range = std::max(range, *std::max_element(
+                                        ranges.begin() + start,
+                                        ranges.begin() + start +
+                                            input_synapse.interval_size()));
+          }
+        });
+    const std::uint32_t output_start = partial.output_data().starts();
+    range = std::max(
+        range, *std::max_element(neuron_ranges.begin() + output_start,
+                                 neuron_ranges.begin() + output_start +
+                                     partial.output_data().interval_size()));
+    /* Without any activation every scale is as good as any other */
+    partial.set_activation_range((0.0 < range) ? range : 1.0);
+  }
+}
+
+} /* namespace rafko_net */
@@ -17,12 +17,15 @@
 
 #include "rafko_net/services/solution_solver.hpp"
 
+#include <algorithm>
 #include <mutex>
 #include <stdexcept>
 
+#include "rafko_mainframe/services/rafko_profiler.hpp"
 #include "rafko_net/models/neuron_info.hpp"
 #include "rafko_net/services/rafko_network_feature.hpp"
 #include "rafko_net/services/solution_builder.hpp"
+#include "rafko_net/services/solution_quantizer.hpp"
 #include "rafko_net/services/synapse_iterator.hpp"
 
 namespace rafko_net {
@@ -62,16 +65,57 @@ SolutionSolver::Factory::build(bool rebuild_solution, bool swap_solution) {
         "Error: Nothing to swap the actual Solution with!");
 
   RFASSERT(static_cast<bool>(m_actualSolution));
-  m_ownedSolvers.push_back(
-      std::make_shared<SolutionSolver>(m_actualSolution, *m_settings));
+  m_ownedSolvers.push_back(std::make_shared<SolutionSolver>(
+      m_actualSolution, *m_settings,
+      (m_settings->get_shared_weight_storage() ? &m_network : nullptr)));
+  return m_ownedSolvers.back();
+}
+
+const rafko_gym::WeightTableRanges &
+SolutionSolver::Factory::refresh_actual_solution_weights() {
+  const rafko_gym::WeightTableRanges &changed_ranges =
+      m_weightAdapter->update_solution_with_weights();
+  for (std::shared_ptr<SolutionSolver> &solver : m_ownedSolvers)
+    solver->refresh_weights();
+  return changed_ranges;
+}
+
+std::shared_ptr<SolutionSolver>
+SolutionSolver::Factory::build(const NetworkChanges &network_changes,
+                               const rafko_gym::RafkoDataSet *calibration_set) {
+  std::optional<SolutionUpdate> solution_update =
+      SolutionBuilder(*m_settings)
+          .update(m_actualSolution, m_network, network_changes);
+  if ((nullptr != calibration_set) &&
+      std::any_of(m_actualSolution->partial_solutions().begin(),
+                  m_actualSolution->partial_solutions().end(),
+                  [](const PartialSolution &partial) {
+                    return !(0.0 < partial.activation_range());
+                  }))
+    SolutionQuantizer::calibrate(*m_actualSolution, *calibration_set,
+                                 *m_settings);
+  for (std::shared_ptr<SolutionSolver> &solver : m_ownedSolvers) {
+    if (solution_update.has_value())
+      solver->update(solution_update.value());
+    else
+      solver->rebuild(m_actualSolution);
+  }
+  m_weightAdapter = std::make_unique<rafko_gym::RafkoWeightAdapter>(
+      m_network, *m_actualSolution, *m_settings);
+  m_ownedSolvers.push_back(std::make_shared<SolutionSolver>(
+      m_actualSolution, *m_settings,
+      (m_settings->get_shared_weight_storage() ? &m_network : nullptr)));
   return m_ownedSolvers.back();
 }
 
 SolutionSolver::SolutionSolver(const Solution *to_solve,
-                               const rafko_mainframe::RafkoSettings &settings)
+                               const rafko_mainframe::RafkoSettings &settings,
+                               const RafkoNet *weight_network)
     : rafko_gym::RafkoAgent(settings), m_solution(to_solve),
+      m_weightNetwork(weight_network),
       m_maxThreadNumber(settings.get_max_processing_threads()),
-      m_featureExecutor(m_executionThreads)
+      m_threadPool(rafko_utilities::WorkStealingPool::shared()),
+      m_featureExecutor(m_threadPool)
 #if (RAFKO_USES_OPENCL)
       ,
       m_deviceWeightTableSize(
@@ -85,42 +129,101 @@ SolutionSolver::SolutionSolver(const Solution *to_solve,
 {
   RFASSERT(m_solution);
   rebuild(m_solution);
-  for (std::uint32_t thread_index = 0;
-       thread_index < m_settings.get_max_processing_threads(); ++thread_index)
-    m_executionThreads.emplace_back(
-        std::make_unique<rafko_utilities::ThreadGroup>(
-            settings.get_max_solve_threads()));
 }
 
 void SolutionSolver::rebuild(const Solution *to_solve) {
   std::lock_guard<std::mutex> my_lock(m_structureMutex);
-  m_maxTmpSizeNeeded = 0u;
-  m_maxTmpDataNeededPerThread = 0u;
   m_partialSolvers.clear();
   m_solution = to_solve;
-  m_neuronValueBuffers.clear();
 
   std::uint32_t partial_index_at_row_start = 0u;
   for (std::int32_t row_iterator = 0; row_iterator < m_solution->cols_size();
        ++row_iterator) {
-    m_partialSolvers.push_back(std::vector<PartialSolutionSolver>());
+    m_partialSolvers.emplace_back();
     for (std::uint32_t column_index = 0;
          column_index < m_solution->cols(row_iterator); ++column_index) {
-      m_partialSolvers[row_iterator].emplace_back(
-          m_solution->partial_solutions(partial_index_at_row_start +
-                                        column_index),
-          m_settings); /* Initialize a solver for this partial solution element
-                        */
-      if (m_partialSolvers[row_iterator][column_index]
-              .get_required_tmp_data_size() > m_maxTmpSizeNeeded)
-        m_maxTmpSizeNeeded = m_partialSolvers[row_iterator][column_index]
-                                 .get_required_tmp_data_size();
+      m_partialSolvers[row_iterator].push_back(create_partial_solver(
+          partial_index_at_row_start +
+          column_index)); /* Initialize a solver for this partial solution
+                             element */
     }
     partial_index_at_row_start += m_solution->cols(row_iterator);
-    if (m_solution->cols(row_iterator) > m_maxTmpDataNeededPerThread)
-      m_maxTmpDataNeededPerThread = m_solution->cols(row_iterator);
   } /* loop through every partial solution and initialize solvers and output
        maps for them */
+  refresh_buffers();
+}
+
+void SolutionSolver::refresh_weights() {
+  std::lock_guard<std::mutex> my_lock(m_structureMutex);
+  for (std::vector<std::unique_ptr<PartialSolutionSolver>> &row :
+       m_partialSolvers)
+    for (std::unique_ptr<PartialSolutionSolver> &partial_solver : row)
+      partial_solver->refresh_weights();
+}
+
+void SolutionSolver::update(const SolutionUpdate &solution_update) {
+  std::lock_guard<std::mutex> my_lock(m_structureMutex);
+  std::vector<std::unique_ptr<PartialSolutionSolver>> partial_solvers;
+  for (std::vector<std::unique_ptr<PartialSolutionSolver>> &row :
+       m_partialSolvers)
+    for (std::unique_ptr<PartialSolutionSolver> &partial_solver : row)
+      partial_solvers.push_back(std::move(partial_solver));
+  for (std::vector<std::uint32_t>::const_reverse_iterator removed_partial =
+           solution_update.removed_partials.crbegin();
+       removed_partial != solution_update.removed_partials.crend();
+       ++removed_partial)
+    partial_solvers.erase(partial_solvers.begin() + *removed_partial);
+  RFASSERT(static_cast<std::int32_t>(partial_solvers.size()) ==
+           m_solution->partial_solutions_size());
+
+  /*!Note: The partial solutions are updated in place, but their solvers need to
+   * be re-initialized as they pre-compile their structure */
+  for (std::uint32_t partial_index : solution_update.rebuilt_partials)
+    partial_solvers[partial_index] = create_partial_solver(partial_index);
+  for (std::uint32_t partial_index : solution_update.reindexed_partials)
+    partial_solvers[partial_index] = create_partial_solver(partial_index);
+
+  m_partialSolvers.clear();
+  std::uint32_t partial_index = 0u;
+  for (std::int32_t row_iterator = 0; row_iterator < m_solution->cols_size();
+       ++row_iterator) {
+    m_partialSolvers.emplace_back();
+    for (std::uint32_t column_index = 0;
+         column_index < m_solution->cols(row_iterator); ++column_index) {
+      m_partialSolvers[row_iterator].push_back(
+          std::move(partial_solvers[partial_index]));
+      ++partial_index;
+    }
+  }
+  refresh_buffers();
+}
+
+std::unique_ptr<PartialSolutionSolver>
+SolutionSolver::create_partial_solver(std::uint32_t partial_index) const {
+  const PartialSolution &partial = m_solution->partial_solutions(partial_index);
+  if (nullptr == m_weightNetwork)
+    return std::make_unique<PartialSolutionSolver>(partial, m_settings);
+  return std::make_unique<PartialSolutionSolver>(
+      partial, m_settings, m_weightNetwork->weight_table(),
+      rafko_gym::RafkoWeightAdapter::get_weight_sources(partial,
+                                                        *m_weightNetwork));
+}
+
+void SolutionSolver::refresh_buffers() {
+  m_maxTmpSizeNeeded = 0u;
+  m_maxTmpDataNeededPerThread = 0u;
+  m_neuronValueBuffers.clear();
+  m_batchValueBuffers.clear();
+  m_batchTmpBuffers.clear();
+  m_batchFeatureBuffers.clear();
+  for (const std::vector<std::unique_ptr<PartialSolutionSolver>> &row :
+       m_partialSolvers) {
+    for (const std::unique_ptr<PartialSolutionSolver> &partial_solver : row)
+      m_maxTmpSizeNeeded = std::max(
+          m_maxTmpSizeNeeded, partial_solver->get_required_tmp_data_size());
+    m_maxTmpDataNeededPerThread = std::max(
+        m_maxTmpDataNeededPerThread, static_cast<std::uint32_t>(row.size()));
+  }
 
   /* Actualize buffers and buffer sizes: A temporary buffer is allocated for
    * future usage per thread */
@@ -137,12 +240,20 @@ void SolutionSolver::rebuild(const Solution *to_solve) {
                                         buffer = std::vector<double>(
                                             m_solution->neuron_number(), 0.0);
                                       });
+    m_batchValueBuffers.emplace_back(m_solution->network_memory_length(),
+                                     [this](std::vector<double> &buffer) {
+                                       buffer = std::vector<double>(
+                                           m_solution->neuron_number(), 0.0);
+                                     });
+    m_batchTmpBuffers.emplace_back();
+    m_batchFeatureBuffers.emplace_back(m_solution->neuron_number());
   }
 }
 
 rafko_utilities::ConstVectorSubrange<>
 SolutionSolver::solve(const std::vector<double> &input, bool reset_neuron_data,
                       std::uint32_t thread_index) {
+  RFPROFILE_SCOPE("SolutionSolver::solve");
   if (m_maxThreadNumber > thread_index) {
     if (input.size() != m_solution->network_input_size())
       throw std::runtime_error(
@@ -182,7 +293,7 @@ SolutionSolver::solve(const std::vector<double> &input, bool reset_neuron_data,
                  inner_thread_index < m_settings.get_max_solve_threads();
                  ++inner_thread_index) {
               if (col_iterator < m_solution->cols(row_iterator)) {
-                m_partialSolvers[row_iterator][col_iterator].solve(
+                m_partialSolvers[row_iterator][col_iterator]->solve(
                     std::ref(input),
                     std::ref(m_neuronValueBuffers[thread_index]),
                     std::ref(m_usedDataBuffers[used_data_pool_start +
@@ -203,41 +314,42 @@ SolutionSolver::solve(const std::vector<double> &input, bool reset_neuron_data,
           } /* while(col_iterator < solution.cols(row_iterator)) */
         } else {
           while (col_iterator < m_solution->cols(row_iterator)) {
+            const std::uint32_t columns_to_solve = std::min(
+                static_cast<std::uint32_t>(m_settings.get_max_solve_threads()),
+                (m_solution->cols(row_iterator) - col_iterator));
             { /* To make the Solver itself thread-safe; the sub-threads need to
                  be guarded with a lock */
-              m_executionThreads[thread_index]->start_and_block(
+              m_threadPool.parallel_for(
+                  0u, columns_to_solve,
                   [this, &input, used_data_pool_start, row_iterator,
                    col_iterator, partial_index, &solved_features_mutex,
                    &solved_features,
                    thread_index](std::uint32_t inner_thread_index) {
-                    if ((col_iterator + inner_thread_index) <
-                        m_solution->cols(row_iterator)) {
-                      m_partialSolvers[row_iterator][(col_iterator +
-                                                      inner_thread_index)]
-                          .solve(input, m_neuronValueBuffers[thread_index],
-                                 m_usedDataBuffers[used_data_pool_start +
-                                                   inner_thread_index]
-                                     .get());
-                      const PartialSolution &partial =
-                          m_solution->partial_solutions(partial_index +
-                                                        inner_thread_index);
-                      for (std::int32_t feature_index = 0;
-                           feature_index < partial.solved_features_size();
-                           feature_index++) {
-                        std::lock_guard<std::mutex> my_lock(
-                            solved_features_mutex);
-                        solved_features.push_back(
-                            partial.solved_features(feature_index));
-                        /*!Note: multiple features might be solved at the same
-                         * time, but theoretically they shouldn't clash because
-                         * of the Neuron router filtering.
-                         */
-                      }
+                    m_partialSolvers[row_iterator][(col_iterator +
+                                                    inner_thread_index)]
+                        ->solve(input, m_neuronValueBuffers[thread_index],
+                               m_usedDataBuffers[used_data_pool_start +
+                                                 inner_thread_index]
+                                   .get());
+                    const PartialSolution &partial =
+                        m_solution->partial_solutions(partial_index +
+                                                      inner_thread_index);
+                    for (std::int32_t feature_index = 0;
+                         feature_index < partial.solved_features_size();
+                         feature_index++) {
+                      std::lock_guard<std::mutex> my_lock(
+                          solved_features_mutex);
+                      solved_features.push_back(
+                          partial.solved_features(feature_index));
+                      /*!Note: multiple features might be solved at the same
+                       * time, but theoretically they shouldn't clash because
+                       * of the Neuron router filtering.
+                       */
                     }
                   });
             }
-            partial_index += m_settings.get_max_solve_threads();
-            col_iterator += m_settings.get_max_solve_threads();
+            partial_index += columns_to_solve;
+            col_iterator += columns_to_solve;
           } /* while(col_iterator < solution.cols(row_iterator)) */
         }
         /*!Note: Triggered feature groups are only solved after the row for
@@ -254,8 +366,7 @@ SolutionSolver::solve(const std::vector<double> &input, bool reset_neuron_data,
              * evaluation */
             m_featureExecutor.execute_solution_relevant(
                 solved_features[feature_index], m_settings,
-                {m_neuronValueBuffers[thread_index].get_element(0u)},
-                thread_index);
+                {m_neuronValueBuffers[thread_index].get_element(0u)});
           }
         }
         solved_features.clear();
@@ -271,4 +382,91 @@ SolutionSolver::solve(const std::vector<double> &input, bool reset_neuron_data,
     throw std::runtime_error("Thread index out of bounds!");
 }
 
+void SolutionSolver::solve_batch(const std::vector<double> &inputs,
+                                 std::uint32_t batch_size,
+                                 std::vector<double> &outputs,
+                                 bool reset_neuron_data,
+                                 std::uint32_t thread_index) {
+  if (m_maxThreadNumber <= thread_index)
+    throw std::runtime_error("Thread index out of bounds!");
+  if (0u == batch_size)
+    throw std::runtime_error("A batch of 0 samples!");
+  if (inputs.size() != (batch_size * m_solution->network_input_size()))
+    throw std::runtime_error(
+        "Input size(" + std::to_string(inputs.size()) + ") doesn't match " +
+        std::string("networks input size(") +
+        std::to_string(m_solution->network_input_size()) + ") * batch size(" +
+        std::to_string(batch_size) + ")!");
+  if (0 == m_solution->cols_size())
+    throw std::runtime_error("A solution of 0 rows!");
+
+  const std::uint32_t neuron_number = m_solution->neuron_number();
+  rafko_utilities::DataRingbuffer<> &batch_data =
+      m_batchValueBuffers[thread_index];
+  if (batch_data.buffer_size() != (neuron_number * batch_size)) {
+    batch_data = rafko_utilities::DataRingbuffer<>(
+        m_solution->network_memory_length(),
+        [neuron_number, batch_size](std::vector<double> &buffer) {
+          buffer = std::vector<double>(neuron_number * batch_size, 0.0);
+        });
+  } else if (reset_neuron_data)
+    batch_data.reset();
+
+  batch_data.copy_step(); /* move the iterator forward to the next slot and
+                             store the current data */
+  std::vector<double> &feature_buffer = m_batchFeatureBuffers[thread_index];
+  std::uint32_t partial_index = 0u;
+  for (std::int32_t row_iterator = 0; row_iterator < m_solution->cols_size();
+       ++row_iterator) {
+    if (0 == m_solution->cols(row_iterator))
+      throw std::runtime_error("A solution row of 0 columns!");
+    for (std::uint32_t col_iterator = 0;
+         col_iterator < m_solution->cols(row_iterator); ++col_iterator) {
+      m_partialSolvers[row_iterator][col_iterator]->solve_batch(
+          inputs, batch_size, batch_data, m_batchTmpBuffers[thread_index]);
+    }
+
+    /*!Note: Features are executed on the data of each sample separately, as
+     * they are defined on a single Neuron data array */
+    for (std::uint32_t col_iterator = 0;
+         col_iterator < m_solution->cols(row_iterator);
+         ++col_iterator, ++partial_index) {
+      const PartialSolution &partial =
+          m_solution->partial_solutions(partial_index);
+      for (const FeatureGroup &feature : partial.solved_features()) {
+        if ((!m_evaluating) &&
+            (!NeuronInfo::is_feature_relevant_to_solution(feature.feature())))
+          continue; /* training relevant features only need to be run during
+                       evaluation */
+        std::vector<double> &neuron_data = batch_data.get_element(0u);
+        for (std::uint32_t sample = 0u; sample < batch_size; ++sample) {
+          for (std::uint32_t neuron_index = 0u; neuron_index < neuron_number;
+               ++neuron_index)
+            feature_buffer[neuron_index] =
+                neuron_data[(neuron_index * batch_size) + sample];
+          m_featureExecutor.execute_solution_relevant(
+              feature, m_settings, {feature_buffer});
+          for (std::uint32_t neuron_index = 0u; neuron_index < neuron_number;
+               ++neuron_index)
+            neuron_data[(neuron_index * batch_size) + sample] =
+                feature_buffer[neuron_index];
+        }
+      }
+    }
+  } /* for(every row in the @Solution) */
+
+  /* Copy the output Neuron values of every sample into the result */
+  const std::uint32_t output_number = m_solution->output_neuron_number();
+  const std::uint32_t output_start = neuron_number - output_number;
+  const std::vector<double> &neuron_data = batch_data.get_element(0u);
+  outputs.resize(batch_size * output_number);
+  for (std::uint32_t output_index = 0u; output_index < output_number;
+       ++output_index) {
+    const double *output_values =
+        neuron_data.data() + ((output_start + output_index) * batch_size);
+    for (std::uint32_t sample = 0u; sample < batch_size; ++sample)
+      outputs[(sample * output_number) + output_index] = output_values[sample];
+  }
+}
+
 } /* namespace rafko_net */
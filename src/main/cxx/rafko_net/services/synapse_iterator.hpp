@@ -20,8 +20,9 @@
 
 #include "rafko_global.hpp"
 
-#include <functional>
+#include <algorithm>
 #include <stdexcept>
+#include <type_traits>
 
 #include <google/protobuf/repeated_field.h>
 
@@ -54,132 +55,140 @@ namespace rafko_net {
  * @do_for_each_synapse lambda is optional. Example: To iterate through a
  * synapse set, a lambda for each synapse start, and for each element in that
  * synapse: syn_iter.iterate([&](int synapse_start){},[&](int index){});
+ *
+ *             Input synapses may describe more, than one interval: with an
+ * @interval_count above 1, the interval is repeated that many times, each
+ * repetition( run ) starting @stride_size indices further than the previous
+ * one. Iteration visits the runs in order, so a strided synapse behaves exactly
+ * like the list of intervals it describes.
  */
 template <typename Interval_type = IndexSynapseInterval>
 class RAFKO_EXPORT SynapseIterator {
+  /* Callables are told apart by their parameter: a synapse interval or an
+   * index inside it */
+  template <typename Function>
+  using EnableForIndex =
+      std::enable_if_t<std::is_invocable_v<Function &, std::int32_t>, bool>;
+  template <typename Function>
+  using EnableForSynapse = std::enable_if_t<
+      std::is_invocable_v<Function &, const Interval_type &>, bool>;
+
 public:
   constexpr SynapseIterator(
       const google::protobuf::RepeatedPtrField<Interval_type>
           &arg_synapse_interval)
       : m_synapseInterval(arg_synapse_interval), m_cachedSizeVar(size()){};
 
-  constexpr void iterate(std::function<void(std::int32_t)> do_for_each_index,
+  template <typename IndexFunction, EnableForIndex<IndexFunction> = true>
+  constexpr void iterate(IndexFunction &&do_for_each_index,
                          std::uint32_t interval_start = 0,
                          std::uint32_t interval_size_ = 0) const {
     iterate(m_synapseInterval, do_for_each_index, interval_start,
             interval_size_);
   }
-  constexpr void iterate(std::function<void(Interval_type)> do_for_each_synapse,
-                         std::function<void(std::int32_t)> do_for_each_index,
+  template <typename SynapseFunction, typename IndexFunction,
+            EnableForSynapse<SynapseFunction> = true,
+            EnableForIndex<IndexFunction> = true>
+  constexpr void iterate(SynapseFunction &&do_for_each_synapse,
+                         IndexFunction &&do_for_each_index,
                          std::uint32_t interval_start = 0,
                          std::uint32_t interval_size_ = 0) const {
     iterate(m_synapseInterval, do_for_each_synapse, do_for_each_index,
             interval_start, interval_size_);
   }
-  constexpr void
-  iterate_terminatable(std::function<bool(std::int32_t)> do_for_each_index,
-                       std::uint32_t interval_start = 0,
-                       std::uint32_t interval_size_ = 0) const {
+  template <typename IndexFunction, EnableForIndex<IndexFunction> = true>
+  constexpr void iterate_terminatable(IndexFunction &&do_for_each_index,
+                                      std::uint32_t interval_start = 0,
+                                      std::uint32_t interval_size_ = 0) const {
     iterate_terminatable(m_synapseInterval, do_for_each_index, interval_start,
                          interval_size_);
   }
-  constexpr void
-  iterate_terminatable(std::function<bool(Interval_type)> do_for_each_synapse,
-                       std::function<bool(std::int32_t)> do_for_each_index,
-                       std::uint32_t interval_start = 0,
-                       std::uint32_t interval_size_ = 0) const {
+  template <typename SynapseFunction, typename IndexFunction,
+            EnableForSynapse<SynapseFunction> = true,
+            EnableForIndex<IndexFunction> = true>
+  constexpr void iterate_terminatable(SynapseFunction &&do_for_each_synapse,
+                                      IndexFunction &&do_for_each_index,
+                                      std::uint32_t interval_start = 0,
+                                      std::uint32_t interval_size_ = 0) const {
     iterate_terminatable(m_synapseInterval, do_for_each_synapse,
                          do_for_each_index, interval_start, interval_size_);
   }
-  constexpr void skim(std::function<void(Interval_type)> do_for_each_synapse,
+  template <typename SynapseFunction, EnableForSynapse<SynapseFunction> = true>
+  constexpr void skim(SynapseFunction &&do_for_each_synapse,
                       std::uint32_t interval_start = 0,
                       std::uint32_t interval_size_ = 0) const {
     skim(m_synapseInterval, do_for_each_synapse, interval_start,
          interval_size_);
   }
-  constexpr void
-  skim_terminatable(std::function<bool(Interval_type)> do_for_each_synapse,
-                    std::uint32_t interval_start = 0,
-                    std::uint32_t interval_size_ = 0) const {
+  template <typename SynapseFunction, EnableForSynapse<SynapseFunction> = true>
+  constexpr void skim_terminatable(SynapseFunction &&do_for_each_synapse,
+                                   std::uint32_t interval_start = 0,
+                                   std::uint32_t interval_size_ = 0) const {
     skim_terminatable(m_synapseInterval, do_for_each_synapse, interval_start,
                       interval_size_);
   }
 
+  /*!Note: The callables are template parameters instead of std::function
+   * objects, so they can be inlined into the loops below; Iteration happens on
+   * the innermost loops of the solvers and the optimizers, where an indirect
+   * call for every index is noticeable. */
+  template <typename SynapseFunction, EnableForSynapse<SynapseFunction> = true>
   static void skim(const google::protobuf::RepeatedPtrField<Interval_type>
                        &arg_synapse_interval,
-                   std::function<void(Interval_type)> do_for_each_synapse,
+                   SynapseFunction &&do_for_each_synapse,
                    std::uint32_t interval_start = 0,
                    std::uint32_t interval_size_ = 0) {
-    std::uint32_t interval_size = get_number_of_synapses_to_iterate(
-        arg_synapse_interval, interval_start, interval_size_);
-    for (std::uint32_t syn_iter = interval_start;
-         syn_iter < (interval_start + interval_size); ++syn_iter) {
-      do_for_each_synapse(arg_synapse_interval[syn_iter]);
-    }
+    skim_terminatable(
+        arg_synapse_interval,
+        [&do_for_each_synapse](const Interval_type &synapse) {
+          do_for_each_synapse(synapse);
+          return true;
+        },
+        interval_start, interval_size_);
   }
 
+  template <typename IndexFunction, EnableForIndex<IndexFunction> = true>
   static void iterate(const google::protobuf::RepeatedPtrField<Interval_type>
                           &arg_synapse_interval,
-                      std::function<void(std::int32_t)> do_for_each_index,
+                      IndexFunction &&do_for_each_index,
                       std::uint32_t interval_start = 0,
                       std::uint32_t interval_size_ = 0) {
-    std::uint32_t interval_size = get_number_of_synapses_to_iterate(
-        arg_synapse_interval, interval_start, interval_size_);
-    for (std::uint32_t syn_iter = interval_start;
-         syn_iter < (interval_start + interval_size); ++syn_iter) {
-      std::uint32_t this_interval_size =
-          arg_synapse_interval[syn_iter].interval_size();
-      std::uint32_t this_interval_start =
-          arg_synapse_interval[syn_iter].starts();
-      if (!is_index_input(this_interval_start)) {
-        for (std::uint32_t input_iterator = 0;
-             input_iterator < this_interval_size; ++input_iterator) {
-          do_for_each_index(this_interval_start + input_iterator);
-        }
-      } else /* current @starts. element is from the input, iterate in a
-                negative way */
-        for (std::uint32_t input_iterator = 0;
-             input_iterator < this_interval_size; ++input_iterator) {
-          do_for_each_index(this_interval_start - input_iterator);
-        }
-    } /* For every synapse */
+    iterate_terminatable(
+        arg_synapse_interval,
+        [&do_for_each_index](std::int32_t index) {
+          do_for_each_index(index);
+          return true;
+        },
+        interval_start, interval_size_);
   }
 
+  template <typename SynapseFunction, typename IndexFunction,
+            EnableForSynapse<SynapseFunction> = true,
+            EnableForIndex<IndexFunction> = true>
   static void iterate(const google::protobuf::RepeatedPtrField<Interval_type>
                           &arg_synapse_interval,
-                      std::function<void(Interval_type)> do_for_each_synapse,
-                      std::function<void(std::int32_t)> do_for_each_index,
+                      SynapseFunction &&do_for_each_synapse,
+                      IndexFunction &&do_for_each_index,
                       std::uint32_t interval_start = 0,
                       std::uint32_t interval_size_ = 0) {
-    std::uint32_t interval_size = get_number_of_synapses_to_iterate(
-        arg_synapse_interval, interval_start, interval_size_);
-    for (std::uint32_t syn_iter = interval_start;
-         syn_iter < (interval_start + interval_size); ++syn_iter) {
-      do_for_each_synapse(arg_synapse_interval[syn_iter]);
-      std::uint32_t this_interval_size =
-          arg_synapse_interval[syn_iter].interval_size();
-      std::uint32_t this_interval_start =
-          arg_synapse_interval[syn_iter].starts();
-      if (!is_index_input(this_interval_start)) {
-        for (std::uint32_t input_iterator = 0;
-             input_iterator < this_interval_size; ++input_iterator) {
-          do_for_each_index(this_interval_start + input_iterator);
-        }
-      } else { /* current @starts. element is from the input, iterate in a
-                  negative way */
-        for (std::int32_t input_iterator = 0;
-             static_cast<std::uint32_t>(input_iterator) < this_interval_size;
-             ++input_iterator) {
-          do_for_each_index(this_interval_start - input_iterator);
-        }
-      }
-    } /* For every synapse */
+    iterate_terminatable(
+        arg_synapse_interval,
+        [&do_for_each_synapse](const Interval_type &synapse) {
+          do_for_each_synapse(synapse);
+          return true;
+        },
+        [&do_for_each_index](std::int32_t index) {
+          do_for_each_index(index);
+          return true;
+        },
+        interval_start, interval_size_);
   }
 
+  template <typename SynapseFunction, EnableForSynapse<SynapseFunction> = true>
   static void
   skim_terminatable(const google::protobuf::RepeatedPtrField<Interval_type>
                         &arg_synapse_interval,
-                    std::function<bool(Interval_type)> do_for_each_synapse,
+                    SynapseFunction &&do_for_each_synapse,
                     std::uint32_t interval_start = 0,
                     std::uint32_t interval_size_ = 0) {
     std::uint32_t interval_size = get_number_of_synapses_to_iterate(
@@ -190,65 +199,54 @@ public:
         return;
   }
 
+  template <typename IndexFunction, EnableForIndex<IndexFunction> = true>
   static void
   iterate_terminatable(const google::protobuf::RepeatedPtrField<Interval_type>
                            &arg_synapse_interval,
-                       std::function<bool(std::int32_t)> do_for_each_index,
+                       IndexFunction &&do_for_each_index,
                        std::uint32_t interval_start = 0,
                        std::uint32_t interval_size_ = 0) {
-    std::uint32_t interval_size = get_number_of_synapses_to_iterate(
-        arg_synapse_interval, interval_start, interval_size_);
-    for (std::uint32_t syn_iter = interval_start;
-         syn_iter < (interval_start + interval_size); ++syn_iter) {
-      std::uint32_t this_interval_size =
-          arg_synapse_interval[syn_iter].interval_size();
-      std::uint32_t this_interval_start =
-          arg_synapse_interval[syn_iter].starts();
-      if (!is_index_input(this_interval_start)) {
-        for (std::uint32_t input_iterator = 0;
-             input_iterator < this_interval_size; ++input_iterator)
-          if (!do_for_each_index(this_interval_start + input_iterator))
-            return;
-      } else { /* current @starts. element is from the input, iterate in a
-                  negative way */
-        for (std::uint32_t input_iterator = 0;
-             input_iterator < this_interval_size; ++input_iterator)
-          if (!do_for_each_index(this_interval_start - input_iterator))
-            return;
-      }
-    } /* For every synapse */
+    iterate_terminatable(
+        arg_synapse_interval, [](const Interval_type &) { return true; },
+        do_for_each_index, interval_start, interval_size_);
   }
 
+  template <typename SynapseFunction, typename IndexFunction,
+            EnableForSynapse<SynapseFunction> = true,
+            EnableForIndex<IndexFunction> = true>
   static void
   iterate_terminatable(const google::protobuf::RepeatedPtrField<Interval_type>
                            &arg_synapse_interval,
-                       std::function<bool(Interval_type)> do_for_each_synapse,
-                       std::function<bool(std::int32_t)> do_for_each_index,
+                       SynapseFunction &&do_for_each_synapse,
+                       IndexFunction &&do_for_each_index,
                        std::uint32_t interval_start = 0,
                        std::uint32_t interval_size_ = 0) {
     std::uint32_t interval_size = get_number_of_synapses_to_iterate(
         arg_synapse_interval, interval_start, interval_size_);
     for (std::uint32_t syn_iter = interval_start;
          syn_iter < (interval_start + interval_size); ++syn_iter) {
-      if (!do_for_each_synapse(arg_synapse_interval[syn_iter]))
+      const Interval_type &synapse = arg_synapse_interval[syn_iter];
+      if (!do_for_each_synapse(synapse))
         return;
-      std::uint32_t this_interval_size =
-          arg_synapse_interval[syn_iter].interval_size();
-      std::uint32_t this_interval_start =
-          arg_synapse_interval[syn_iter].starts();
-      if (!is_index_input(this_interval_start)) {
-        for (std::uint32_t input_iterator = 0;
-             input_iterator < this_interval_size; ++input_iterator)
-          if (!do_for_each_index(this_interval_start + input_iterator))
-            return;
-      } else { /* current @starts. element is from the input, iterate in a
-                  negative way */
-        for (std::uint32_t input_iterator = 0;
-             input_iterator < this_interval_size; ++input_iterator)
-          if (!do_for_each_index(this_interval_start - input_iterator))
-            return;
-      }
-    } /* For every synapse */
+      const std::uint32_t this_interval_size = synapse.interval_size();
+      const std::uint32_t this_run_count = run_count(synapse);
+      for (std::uint32_t run_index = 0u; run_index < this_run_count;
+           ++run_index) {
+        const std::int32_t this_interval_start = run_start(synapse, run_index);
+        if (!is_index_input(this_interval_start)) {
+          for (std::uint32_t input_iterator = 0;
+               input_iterator < this_interval_size; ++input_iterator)
+            if (!do_for_each_index(this_interval_start + input_iterator))
+              return;
+        } else { /* current @starts. element is from the input, iterate in a
+                    negative way */
+          for (std::uint32_t input_iterator = 0;
+               input_iterator < this_interval_size; ++input_iterator)
+            if (!do_for_each_index(this_interval_start - input_iterator))
+              return;
+        }
+      } /* For every run of the synapse */
+    }   /* For every synapse */
   }
 
   /**
@@ -260,7 +258,7 @@ public:
    */
   std::int32_t operator[](uint32_t index) const {
     RFASSERT(index < size());
-    std::int32_t result_index;
+    std::int32_t result_index = 0;
     std::uint32_t previous_last_reached_index = 0;
     std::uint32_t iteration_helper = 0;
     std::uint32_t synapse_start = 0;
@@ -272,7 +270,7 @@ public:
       m_lastReachedSynapse = 0;
 
     iterate_terminatable(
-        [&](Interval_type /*interval_synapse*/) {
+        [&](const Interval_type & /*interval_synapse*/) {
           ++m_lastReachedSynapse;
           m_lastReachedIndex = iteration_helper;
           previous_last_reached_index = m_lastReachedIndex;
@@ -309,14 +307,14 @@ public:
              m_synapseInterval.size());
     std::uint32_t index = 0;
     for (std::uint32_t syn_iter = 0u; syn_iter < interval_index; ++syn_iter) {
-      index += m_synapseInterval[syn_iter].interval_size();
+      index += synapse_size(m_synapseInterval[syn_iter]);
     }
     return index;
   }
 
   std::uint32_t interval_size_of(std::uint32_t nth_element) {
     RFASSERT(0u < size());
-    std::uint32_t result_size;
+    std::uint32_t result_size = 0u;
     std::uint32_t previous_last_reached_index = 0;
     std::uint32_t iteration_helper = 0;
     std::uint32_t synapse_start = 0;
@@ -328,11 +326,11 @@ public:
       m_lastReachedSynapse = 0;
 
     iterate_terminatable(
-        [&](InputSynapseInterval interval_synapse) {
+        [&](const InputSynapseInterval &interval_synapse) {
           ++m_lastReachedSynapse;
           m_lastReachedIndex = iteration_helper;
           previous_last_reached_index = m_lastReachedIndex;
-          result_size = interval_synapse.interval_size();
+          result_size = synapse_size(interval_synapse);
           return true;
         },
         [&](std::int32_t /*synapse_index*/) {
@@ -349,10 +347,37 @@ public:
     return result_size;
   }
 
+  /**
+   * @brief      Provides the number of indices following the nth element in
+   * the iteration without a gap, the element itself included: Those which are
+   * in the same run of the synapse the element is inside of.
+   *
+   * @param[in]  nth_element   The position of the element in the iteration
+   *
+   * @return     The number of indices continuing from the nth element
+   */
+  std::uint32_t contiguous_size_from(std::uint32_t nth_element) const {
+    RFASSERT(nth_element < size());
+    std::uint32_t result_size = 0u;
+    std::uint32_t synapse_starts_at = 0u;
+    skim_terminatable([&](const Interval_type &interval_synapse) {
+      const std::uint32_t this_synapse_size = synapse_size(interval_synapse);
+      if (nth_element < (synapse_starts_at + this_synapse_size)) {
+        result_size = interval_synapse.interval_size() -
+                      ((nth_element - synapse_starts_at) %
+                       interval_synapse.interval_size());
+        return false;
+      }
+      synapse_starts_at += this_synapse_size;
+      return true;
+    });
+    return result_size;
+  }
+
   template <typename InputSynapseInterval>
   std::uint32_t reach_past_loops(std::uint32_t nth_element) const {
     RFASSERT(0u < size());
-    std::uint32_t result_reach;
+    std::uint32_t result_reach = 0u;
     std::uint32_t previous_last_reached_index = 0;
     std::uint32_t iteration_helper = 0;
     std::uint32_t synapse_start = 0;
@@ -363,9 +388,9 @@ public:
     } else
       m_lastReachedSynapse = 0;
 
-    std::int32_t synapse_reach;
+    std::int32_t synapse_reach = 0;
     iterate_terminatable(
-        [&](InputSynapseInterval interval_synapse) {
+        [&](const InputSynapseInterval &interval_synapse) {
           ++m_lastReachedSynapse;
           m_lastReachedIndex = iteration_helper;
           previous_last_reached_index = m_lastReachedIndex;
@@ -399,7 +424,7 @@ public:
   bool operator==(const SynapseIterator<Interval_type> &other) const {
     std::uint32_t synapse_index = 0u;
     std::uint32_t match = true;
-    iterate_terminatable([other, &synapse_index, &match](std::int32_t index) {
+    iterate_terminatable([&other, &synapse_index, &match](std::int32_t index) {
       if (index != other[synapse_index]) {
         match = false;
         return false;
@@ -437,7 +462,7 @@ public:
     Interval_type result;
 
     iterate_terminatable(
-        [&](Interval_type interval_synapse) {
+        [&](const Interval_type &interval_synapse) {
           result = interval_synapse;
           return true;
         },
@@ -460,12 +485,22 @@ public:
    */
   std::uint32_t size() const {
     std::uint32_t number_of_inputs = 0;
-    skim([&](Interval_type interval) {
-      number_of_inputs += interval.interval_size();
+    skim([&](const Interval_type &interval) {
+      number_of_inputs += synapse_size(interval);
     });
     return number_of_inputs;
   }
 
+  /**
+   * @brief      Resets the position of the last reached element, which is
+   * remembered to speed up sequential queries. Needs to be called whenever the
+   * synapses change in a way other than growing at their end.
+   */
+  void reset_cached_position() const {
+    m_lastReachedSynapse = 0u;
+    m_lastReachedIndex = 0u;
+  }
+
   /**
    * @brief      Refresh the cache variable for @cached_size
    *
@@ -499,15 +534,11 @@ public:
    */
   std::int32_t back() const {
     if (0 < m_synapseInterval.size()) {
-      std::int32_t last_index =
-          m_synapseInterval[m_synapseInterval.size() - 1].starts();
-      if (is_index_input(last_index))
-        last_index -=
-            m_synapseInterval[m_synapseInterval.size() - 1].interval_size() - 1;
-      else
-        last_index +=
-            m_synapseInterval[m_synapseInterval.size() - 1].interval_size() - 1;
-      return last_index;
+      const Interval_type &last_synapse =
+          m_synapseInterval[m_synapseInterval.size() - 1];
+      if (0u == last_synapse.interval_size())
+        return last_synapse.starts() - 1;
+      return index_in_synapse(last_synapse, synapse_size(last_synapse) - 1u);
     } else
       throw std::runtime_error("Last index requested from empty synapse!");
   }
@@ -549,6 +580,124 @@ public:
     return (is_index_input(interval.starts()));
   }
 
+  /**
+   * @brief      Provides the number of times the interval is repeated inside
+   * the synapse; Only input synapses can have more, than one runs.
+   *
+   * @param[in]  interval   A const reference to the interval to examine
+   *
+   * @return     The number of runs in the synapse
+   */
+  static std::uint32_t run_count(const Interval_type &interval) {
+    if constexpr (std::is_same_v<Interval_type, InputSynapseInterval>)
+      return std::max(1u, interval.interval_count());
+    else
+      return 1u;
+  }
+
+  /**
+   * @brief      Provides the first index of a run inside the synapse
+   *
+   * @param[in]  interval     A const reference to the interval to examine
+   * @param[in]  run_index    The index of the run, below @run_count
+   *
+   * @return     The first index of the run
+   */
+  static std::int32_t run_start(const Interval_type &interval,
+                                std::uint32_t run_index) {
+    if constexpr (std::is_same_v<Interval_type, InputSynapseInterval>) {
+      RFASSERT(run_index < run_count(interval));
+      const std::int32_t run_offset =
+          static_cast<std::int32_t>(run_index * interval.stride_size());
+      return (is_synapse_input(interval) ? (interval.starts() - run_offset)
+                                         : (interval.starts() + run_offset));
+    } else {
+      RFASSERT(0u == run_index);
+      return interval.starts();
+    }
+  }
+
+  /**
+   * @brief      Provides the number of indices the given synapse describes
+   *
+   * @param[in]  interval   A const reference to the interval to examine
+   *
+   * @return     The size of the interval multiplied by the number of its runs
+   */
+  static std::uint32_t synapse_size(const Interval_type &interval) {
+    return interval.interval_size() * run_count(interval);
+  }
+
+  /**
+   * @brief      Provides the index the synapse describes at the given position
+   *
+   * @param[in]  interval   A const reference to the interval to examine
+   * @param[in]  position   The position inside the synapse, below
+   * @synapse_size
+   *
+   * @return     The index at the given position
+   */
+  static std::int32_t index_in_synapse(const Interval_type &interval,
+                                       std::uint32_t position) {
+    RFASSERT(position < synapse_size(interval));
+    const std::int32_t start =
+        run_start(interval, position / interval.interval_size());
+    const std::int32_t offset =
+        static_cast<std::int32_t>(position % interval.interval_size());
+    return (is_index_input(start) ? (start - offset) : (start + offset));
+  }
+
+  /**
+   * @brief      Tries to extend an interval so it also describes the indices of
+   * the one following it: either by its size, when the two are continuous, or
+   * by adding the following one as a new run, when they are of the same size
+   * and are placed equally far from each other as the runs of the extended
+   * interval.
+   *
+   * @param          previous   The interval to extend
+   * @param[in]      next       The interval to describe with @previous
+   *
+   * @return     True if @previous now describes the indices of @next as well
+   */
+  static bool merge_interval(Interval_type &previous,
+                             const Interval_type &next) {
+    if ((1u < run_count(next)) || (0u == previous.interval_size()) ||
+        (is_synapse_input(previous) != is_synapse_input(next)))
+      return false;
+    if constexpr (std::is_same_v<Interval_type, InputSynapseInterval>) {
+      if (previous.reach_past_loops() != next.reach_past_loops())
+        return false;
+    }
+
+    const std::int32_t direction = (is_synapse_input(previous) ? -1 : 1);
+    if ((1u == run_count(previous)) &&
+        ((index_in_synapse(previous, previous.interval_size() - 1u) +
+          direction) == next.starts())) {
+      previous.set_interval_size(previous.interval_size() +
+                                 next.interval_size());
+      return true;
+    }
+
+    if constexpr (std::is_same_v<Interval_type, InputSynapseInterval>) {
+      const std::int32_t distance =
+          direction * (next.starts() - previous.starts());
+      if ((previous.interval_size() != next.interval_size()) ||
+          (distance <= static_cast<std::int32_t>(previous.interval_size())))
+        return false;
+      if (1u == run_count(previous)) {
+        previous.set_stride_size(distance);
+        previous.set_interval_count(2u);
+        return true;
+      }
+      if (distance == static_cast<std::int32_t>(run_count(previous) *
+                                                previous.stride_size())) {
+        previous.set_interval_count(previous.interval_count() + 1u);
+        return true;
+      }
+    }
+    return false;
+  }
+
   /**
    * @brief      Converts synapse an array index[0..n] to an index usable inside
    * synapses where index values from two different sources are merged together
@@ -22,21 +22,25 @@
 
 #include <algorithm>
 #include <cassert>
+#include <iterator>
+#include <type_traits>
 #include <vector>
 
 namespace rafko_utilities {
 
 /**
  * @brief     A lightweight class representing a read-only part of a vector-like
- * container, using iterators to simulate the interface of it.
+ * container, using iterators to simulate the interface of it. Raw pointers are
+ * also accepted as iterators, so the range may refer to memory not owned by
+ * any vector.
  */
 template <typename Iterator = std::vector<double>::const_iterator>
 class RAFKO_EXPORT ConstVectorSubrange {
 public:
-  using T = typename Iterator::value_type;
+  using T = typename std::iterator_traits<Iterator>::value_type;
 
   ConstVectorSubrange(const std::vector<T> &data)
-      : m_start(data.begin()), m_rangeSize(data.size()) {}
+      : m_start(begin_of(data)), m_rangeSize(data.size()) {}
 
   constexpr ConstVectorSubrange(Iterator start, std::size_t size)
       : m_start(start), m_rangeSize(size) {}
@@ -44,6 +48,32 @@ public:
   constexpr ConstVectorSubrange(Iterator begin, Iterator end)
       : m_start(begin), m_rangeSize(std::distance(m_start, end)) {}
 
+  /**
+   * @brief     Ranges based on pointers may also be created from any other
+   * contiguous range, e.g. from the iterators of a vector
+   */
+  template <typename OtherIterator,
+            typename = std::enable_if_t<
+                std::is_pointer<Iterator>::value &&
+                !std::is_same<Iterator, OtherIterator>::value>>
+  ConstVectorSubrange(OtherIterator begin, OtherIterator end)
+      : m_start((begin == end) ? nullptr : &*begin),
+        m_rangeSize(std::distance(begin, end)) {}
+
+  template <typename OtherIterator,
+            typename = std::enable_if_t<
+                std::is_pointer<Iterator>::value &&
+                !std::is_same<Iterator, OtherIterator>::value>>
+  ConstVectorSubrange(OtherIterator start, std::size_t size)
+      : m_start((0u == size) ? nullptr : &*start), m_rangeSize(size) {}
+
+  template <typename OtherIterator,
+            typename = std::enable_if_t<
+                std::is_pointer<Iterator>::value &&
+                !std::is_same<Iterator, OtherIterator>::value>>
+  ConstVectorSubrange(const ConstVectorSubrange<OtherIterator> &other)
+      : ConstVectorSubrange(other.begin(), other.end()) {}
+
   template <class U> bool operator==(const U &other) const {
     std::uint32_t i = 0;
     return std::all_of(begin(), end(), [&i, &other](const T &item) {
@@ -66,6 +96,13 @@ public:
   }
 
 private:
+  static Iterator begin_of(const std::vector<T> &data) {
+    if constexpr (std::is_pointer<Iterator>::value)
+      return data.data();
+    else
+      return data.begin();
+  }
+
   const std::vector<T> m_maybeData;
   const Iterator m_start;
   const std::size_t m_rangeSize;
@@ -0,0 +1,132 @@
+/*! This file is part of davids91/Rafko.
+ *
+ *    Rafko is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    (at your option) any later version.
+ *
+ *    Rafko is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with Rafko.  If not, see <https://www.gnu.org/licenses/> or
+ *    <https://github.com/davids91/rafko/blob/master/LICENSE>
+ */
+
+#ifndef CONTIGUOUS_RINGBUFFER_H
+#define CONTIGUOUS_RINGBUFFER_H
+
+#include "rafko_global.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <new>
+
+namespace rafko_utilities {
+
+/**
+ * @brief      A ringbuffer of fixed size slots, stored in one aligned
+ * allocation. Each slot is a contiguous array of values starting on a cache
+ * line boundary. Stepping the buffer only moves the offset of the current slot,
+ * so it never allocates memory, unlike a @DataRingbuffer of vectors.
+ */
+template <typename T = double> class RAFKO_EXPORT ContiguousRingbuffer {
+public:
+  static constexpr std::size_t s_alignment = 64u;
+
+  ContiguousRingbuffer(std::uint32_t number_of_slots, std::size_t slot_size)
+      : m_numberOfSlots(number_of_slots), m_slotSize(slot_size),
+        m_slotStride(((slot_size * sizeof(T) + s_alignment - 1u) /
+                      s_alignment * s_alignment) /
+                     sizeof(T)),
+        m_data(static_cast<T *>(::operator new(
+            std::max(std::size_t(1u),
+                     (m_slotStride * number_of_slots * sizeof(T))),
+            std::align_val_t(s_alignment)))) {
+    static_assert(0u == (s_alignment % sizeof(T)),
+                  "Slots can only be aligned for values dividing the alignment");
+    assert(0u < number_of_slots);
+    reset();
+  }
+
+  /**
+   * @brief      Move the offset forward to the next slot, filling it with
+   * zeroes
+   */
+  void clean_step() {
+    shallow_step();
+    std::fill_n(get_slot(0u), m_slotSize, T(0));
+  }
+
+  /**
+   * @brief      Move the offset forward to the next slot, keeping its contents
+   */
+  constexpr void shallow_step() {
+    m_currentSlot = (m_currentSlot + 1u) % m_numberOfSlots;
+  }
+
+  /**
+   * @brief      Resets every value to zero, with the current slot being the
+   * first one
+   */
+  void reset() {
+    m_currentSlot = 0u;
+    std::fill_n(m_data.get(), m_slotStride * m_numberOfSlots, T(0));
+  }
+
+  /**
+   * @brief      Provides the start of the slot the given number of steps in
+   * the past
+   *
+   * @param[in]  past_index  The number of steps back from the current slot
+   *
+   * @return     Pointer to the first value of the slot, aligned to
+   * @s_alignment
+   */
+  T *get_slot(std::uint32_t past_index) {
+    return m_data.get() + (get_slot_index(past_index) * m_slotStride);
+  }
+  const T *get_slot(std::uint32_t past_index) const {
+    return m_data.get() + (get_slot_index(past_index) * m_slotStride);
+  }
+
+  T &get_element(std::uint32_t past_index, std::size_t data_index) {
+    assert(data_index < m_slotSize);
+    return get_slot(past_index)[data_index];
+  }
+  T get_element(std::uint32_t past_index, std::size_t data_index) const {
+    assert(data_index < m_slotSize);
+    return get_slot(past_index)[data_index];
+  }
+
+  constexpr std::uint32_t get_number_of_slots() const {
+    return m_numberOfSlots;
+  }
+  constexpr std::size_t get_slot_size() const { return m_slotSize; }
+
+private:
+  struct AlignedDelete {
+    void operator()(T *data) const {
+      ::operator delete(data, std::align_val_t(s_alignment));
+    }
+  };
+
+  const std::uint32_t m_numberOfSlots;
+  const std::size_t m_slotSize;
+  const std::size_t m_slotStride;
+  std::unique_ptr<T[], AlignedDelete> m_data;
+  std::uint32_t m_currentSlot = 0u;
+
+  constexpr std::uint32_t get_slot_index(std::uint32_t past_index) const {
+    assert(past_index < m_numberOfSlots);
+    return (m_currentSlot + m_numberOfSlots - past_index) % m_numberOfSlots;
+  }
+};
+
+} /* namespace rafko_utilities */
+
+#endif /* CONTIGUOUS_RINGBUFFER_H */
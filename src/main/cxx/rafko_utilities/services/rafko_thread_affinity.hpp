@@ -0,0 +1,53 @@
+/*! This file is part of davids91/Rafko.
+ *
+ *    Rafko is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    (at your option) any later version.
+ *
+ *    Rafko is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with Rafko.  If not, see <https://www.gnu.org/licenses/> or
+ *    <https://github.com/davids91/rafko/blob/master/LICENSE>
+ */
+
+#ifndef RAFKO_THREAD_AFFINITY_H
+#define RAFKO_THREAD_AFFINITY_H
+
+#include "rafko_global.hpp"
+
+#include <thread>
+#include <vector>
+
+namespace rafko_utilities {
+
+/**
+ * @brief      Divides the CPUs the process is allowed to run on into disjunct
+ * sets of consecutive CPUs, e.g. to pin groups of threads to
+ *
+ * @param[in]  number_of_sets   The number of CPU sets to divide into
+ *
+ * @return     The CPU sets, or an empty vector if there are less CPUs
+ * available than the number of sets, or thread affinity is not supported
+ */
+std::vector<std::vector<std::uint32_t>>
+divide_cpus(std::uint32_t number_of_sets);
+
+/**
+ * @brief      Restricts the given thread to run only on the given CPUs; Thread
+ * affinity is left to the system with an empty CPU set, on systems where it is
+ * not supported, or in case the CPUs are not available to the process.
+ *
+ * @param      thread   The thread to restrict
+ * @param[in]  cpus     The CPUs the thread is allowed to run on
+ */
+void set_thread_affinity(std::thread &thread,
+                         const std::vector<std::uint32_t> &cpus);
+
+} /* namespace rafko_utilities */
+
+#endif /* RAFKO_THREAD_AFFINITY_H */
@@ -0,0 +1,70 @@
+/*! This file is part of davids91/Rafko.
+ *
+ *    Rafko is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    (at your option) any later version.
+ *
+ *    Rafko is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with Rafko.  If not, see <https://www.gnu.org/licenses/> or
+ *    <https://github.com/davids91/rafko/blob/master/LICENSE>
+ */
+
+#include "rafko_utilities/services/rafko_thread_affinity.hpp"
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif /*defined(__linux__)*/
+
+namespace rafko_utilities {
+
+std::vector<std::vector<std::uint32_t>>
+divide_cpus(std::uint32_t number_of_sets) {
+  std::vector<std::vector<std::uint32_t>> cpu_sets;
+#if defined(__linux__)
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  if ((0u == number_of_sets) ||
+      (0 != sched_getaffinity(0, sizeof(cpu_set_t), &cpu_set)))
+    return cpu_sets;
+  std::vector<std::uint32_t> available_cpus;
+  for (std::uint32_t cpu = 0u; cpu < CPU_SETSIZE; ++cpu)
+    if (CPU_ISSET(cpu, &cpu_set))
+      available_cpus.push_back(cpu);
+  if (available_cpus.size() < number_of_sets)
+    return cpu_sets;
+  const std::uint32_t cpus_in_one_set = available_cpus.size() / number_of_sets;
+  for (std::uint32_t set_index = 0u; set_index < number_of_sets; ++set_index)
+    cpu_sets.emplace_back(
+        available_cpus.begin() + (set_index * cpus_in_one_set),
+        available_cpus.begin() + ((set_index + 1u) * cpus_in_one_set));
+#else
+  (void)number_of_sets;
+#endif /*defined(__linux__)*/
+  return cpu_sets;
+}
+
+void set_thread_affinity(std::thread &thread,
+                         const std::vector<std::uint32_t> &cpus) {
+#if defined(__linux__)
+  if (cpus.empty())
+    return;
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  for (std::uint32_t cpu : cpus)
+    if (cpu < CPU_SETSIZE)
+      CPU_SET(cpu, &cpu_set);
+  pthread_setaffinity_np(thread.native_handle(), sizeof(cpu_set_t), &cpu_set);
+#else
+  (void)thread;
+  (void)cpus;
+#endif /*defined(__linux__)*/
+}
+
+} /* namespace rafko_utilities */
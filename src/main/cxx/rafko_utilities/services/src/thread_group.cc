@@ -17,15 +17,49 @@
 
 #include "rafko_utilities/services/thread_group.hpp"
 
+#include "rafko_mainframe/services/rafko_profiler.hpp"
+#include "rafko_utilities/services/rafko_thread_affinity.hpp"
+
+namespace {
+/* The number of times a waiting thread checks its condition before sleeping */
+constexpr std::uint32_t s_spinIterations = 4096u;
+} /* namespace */
+
 namespace rafko_utilities {
 
-ThreadGroup::ThreadGroup(std::uint32_t number_of_threads) {
+ThreadGroup::ThreadGroup(
+    std::uint32_t number_of_threads, synchronization_t synchronization,
+    const std::vector<std::vector<std::uint32_t>> &cpu_sets)
+    : m_synchronization(synchronization) {
   assert(0u < number_of_threads);
-  for (std::uint32_t i = 0; i < number_of_threads; ++i)
-    m_threads.emplace_back(std::thread(&ThreadGroup::worker, this, i));
+  /*!Note: Spinning only pays off when the workers and the calling thread all
+   * have a core for themselves, otherwise it only takes time from them */
+  if (number_of_threads < std::thread::hardware_concurrency())
+    m_spinLimit = s_spinIterations;
+  for (std::uint32_t i = 0; i < number_of_threads; ++i) {
+    if (SpinThenPark == m_synchronization)
+      m_threads.emplace_back(
+          std::thread(&ThreadGroup::spinning_worker, this, i));
+    else
+      m_threads.emplace_back(std::thread(&ThreadGroup::worker, this, i));
+    if (i < cpu_sets.size())
+      set_thread_affinity(m_threads.back(), cpu_sets[i]);
+  }
 }
 
 ThreadGroup::~ThreadGroup() {
+  if (SpinThenPark == m_synchronization) {
+    { /* Signal to the worker threads that the show is over */
+      std::lock_guard<std::mutex> my_lock(m_stateMutex);
+      m_stopping.store(true);
+      m_generation.fetch_add(1u);
+    }
+    m_workerWakeup.notify_all();
+    for (std::thread &thread : m_threads)
+      thread.join();
+    return;
+  }
+
   { /* Signal to the worker threads that the show is over */
     std::lock_guard<std::mutex> my_lock(m_stateMutex);
     m_state.store(End);
@@ -41,14 +75,22 @@ ThreadGroup::~ThreadGroup() {
 
 void ThreadGroup::start_and_block(
     const std::function<void(std::uint32_t)> &function) const {
+  if (SpinThenPark == m_synchronization) {
+    spinning_start_and_block(function);
+    return;
+  }
   std::lock_guard<std::mutex> function_lock(m_functionMutex);
-  { /* initialize, start.. */
-    std::unique_lock<std::mutex> my_lock(m_stateMutex);
-    m_workerFunction = &function;
-    m_state.store(Start);
+  {
+    RFPROFILE_SCOPE("ThreadGroup::dispatch");
+    { /* initialize, start.. */
+      std::unique_lock<std::mutex> my_lock(m_stateMutex);
+      m_workerFunction = &function;
+      m_state.store(Start);
+    }
+    m_synchroniser.notify_all(); /* Whip the peons */
   }
-  m_synchroniser.notify_all(); /* Whip the peons */
 
+  RFPROFILE_SCOPE("ThreadGroup::wait");
   { /* wait until the work is done */
     std::unique_lock<std::mutex> my_lock(m_stateMutex);
     m_synchroniser.wait(
@@ -106,4 +148,63 @@ void ThreadGroup::worker(std::uint32_t thread_index) {
   } /*while(END_VALUE != state)*/
 }
 
+void ThreadGroup::spinning_start_and_block(
+    const std::function<void(std::uint32_t)> &function) const {
+  std::lock_guard<std::mutex> function_lock(m_functionMutex);
+  {
+    RFPROFILE_SCOPE("ThreadGroup::dispatch");
+    m_workerFunction = &function;
+    m_pendingThreads.store(m_threads.size());
+    m_generation.fetch_add(1u); /* Publishes the function to the workers */
+
+    /*!Note: A worker registers itself as parked before checking the
+     * generation one last time, so either it sees the new generation, or it is
+     * seen here */
+    if (0u < m_parkedWorkers.load()) {
+      { /* Any worker about to park is inside the wait once the lock is free */
+        std::lock_guard<std::mutex> my_lock(m_stateMutex);
+      }
+      m_workerWakeup.notify_all();
+    }
+  }
+
+  RFPROFILE_SCOPE("ThreadGroup::wait");
+  /* wait until the work is done */
+  auto work_done = [this]() { return (0u == m_pendingThreads.load()); };
+  if (!spin_until(work_done)) {
+    std::unique_lock<std::mutex> my_lock(m_stateMutex);
+    m_callerParked.store(true);
+    m_callerWakeup.wait(my_lock, work_done);
+    m_callerParked.store(false);
+  }
+}
+
+void ThreadGroup::spinning_worker(std::uint32_t thread_index) {
+  std::uint32_t executed_generation = 0u;
+  auto triggered = [this, &executed_generation]() {
+    return (executed_generation != m_generation.load());
+  };
+  while (true) {
+    if (!spin_until(triggered)) { /* Wait until main thread triggers a task */
+      std::unique_lock<std::mutex> my_lock(m_stateMutex);
+      m_parkedWorkers.fetch_add(1u);
+      m_workerWakeup.wait(my_lock, triggered);
+      m_parkedWorkers.fetch_sub(1u);
+    }
+    if (m_stopping.load())
+      break;
+
+    executed_generation = m_generation.load();
+    (*m_workerFunction)(thread_index); /* do the work */
+
+    /* The last thread to finish wakes up the main thread, in case it's asleep */
+    if ((1u == m_pendingThreads.fetch_sub(1u)) && m_callerParked.load()) {
+      {
+        std::lock_guard<std::mutex> my_lock(m_stateMutex);
+      }
+      m_callerWakeup.notify_all();
+    }
+  }
+}
+
 } /* namespace rafko_utilities */
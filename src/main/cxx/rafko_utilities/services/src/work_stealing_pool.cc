@@ -0,0 +1,204 @@
+/*! This file is part of davids91/Rafko.
+ *
+ *   Rafko is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Rafko is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Rafko.  If not, see <https://www.gnu.org/licenses/> or
+ *   <https://github.com/davids91/rafko/blob/master/LICENSE>
+ */
+
+#include "rafko_utilities/services/work_stealing_pool.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+
+#include "rafko_mainframe/services/rafko_profiler.hpp"
+#include "rafko_utilities/services/rafko_thread_affinity.hpp"
+
+namespace {
+/* The pool and the queue index the current thread is working in, if any */
+thread_local rafko_utilities::WorkStealingPool *s_currentPool = nullptr;
+thread_local std::uint32_t s_currentQueue = 0u;
+
+/* Time after which a waiting thread checks again for tasks to steal */
+constexpr std::chrono::microseconds s_waitRecheckPeriod(100);
+} /* namespace */
+
+namespace rafko_utilities {
+
+WorkStealingPool::WorkStealingPool(std::uint32_t number_of_workers,
+                                   const std::vector<std::uint32_t> &cpus) {
+  assert(0u < number_of_workers);
+  for (std::uint32_t i = 0; i <= number_of_workers; ++i)
+    m_queues.push_back(std::make_unique<TaskQueue>());
+  for (std::uint32_t i = 0; i < number_of_workers; ++i) {
+    m_workers.emplace_back(std::thread(&WorkStealingPool::worker, this, i));
+    set_thread_affinity(m_workers.back(), cpus);
+  }
+}
+
+WorkStealingPool::~WorkStealingPool() {
+  { /* Signal to the worker threads that the show is over */
+    std::lock_guard<std::mutex> my_lock(m_sleepMutex);
+    m_stopping.store(true);
+  }
+  m_wakeup.notify_all();
+  for (std::thread &worker : m_workers)
+    worker.join();
+}
+
+WorkStealingPool &WorkStealingPool::shared() {
+  static WorkStealingPool pool(
+      std::max(2u, std::thread::hardware_concurrency()) - 1u);
+  return pool;
+}
+
+void WorkStealingPool::push(Task task) {
+  RFPROFILE_SCOPE("WorkStealingPool::dispatch");
+  const std::uint32_t queue_index =
+      (this == s_currentPool) ? s_currentQueue : (m_queues.size() - 1u);
+  m_queuedTasks.fetch_add(1u);
+  {
+    std::lock_guard<std::mutex> my_lock(m_queues[queue_index]->mutex);
+    m_queues[queue_index]->tasks.push_back(std::move(task));
+  }
+
+  /*!Note: A worker registers itself as sleeping before checking the queued
+   * tasks one last time, so either it sees the new task, or it is seen here */
+  if (0u < m_sleepingWorkers.load()) {
+    { /* Any worker about to sleep is inside the wait once the lock is free */
+      std::lock_guard<std::mutex> my_lock(m_sleepMutex);
+    }
+    m_wakeup.notify_one();
+  }
+}
+
+bool WorkStealingPool::try_pop(std::uint32_t queue_index, bool newest,
+                               Task &task) {
+  TaskQueue &queue = *m_queues[queue_index];
+  std::lock_guard<std::mutex> my_lock(queue.mutex);
+  if (queue.tasks.empty())
+    return false;
+  if (newest) {
+    task = std::move(queue.tasks.back());
+    queue.tasks.pop_back();
+  } else {
+    task = std::move(queue.tasks.front());
+    queue.tasks.pop_front();
+  }
+  m_queuedTasks.fetch_sub(1u);
+  return true;
+}
+
+bool WorkStealingPool::try_execute_one() {
+  const bool inside_pool = (this == s_currentPool);
+  const std::uint32_t own_queue =
+      inside_pool ? s_currentQueue : (m_queues.size() - 1u);
+  Task task;
+  /* Own tasks are taken from the back, as they are the most likely to be hot
+   * in the cache; stolen ones from the front, as they are usually the biggest */
+  bool found = try_pop(own_queue, true, task);
+  for (std::uint32_t offset = 1u; (!found) && (offset < m_queues.size());
+       ++offset)
+    found = try_pop(((own_queue + offset) % m_queues.size()), false, task);
+  if (found)
+    task();
+  return found;
+}
+
+void WorkStealingPool::worker(std::uint32_t worker_index) {
+  s_currentPool = this;
+  s_currentQueue = worker_index;
+  while (!m_stopping.load()) {
+    if (try_execute_one())
+      continue;
+    std::unique_lock<std::mutex> my_lock(m_sleepMutex);
+    m_sleepingWorkers.fetch_add(1u);
+    m_wakeup.wait(my_lock, [this]() {
+      return (m_stopping.load() || (0u < m_queuedTasks.load()));
+    });
+    m_sleepingWorkers.fetch_sub(1u);
+  }
+}
+
+void WorkStealingPool::parallel_for(
+    std::uint32_t begin, std::uint32_t end,
+    const std::function<void(std::uint32_t)> &function,
+    std::uint32_t grain_size) {
+  if (end <= begin)
+    return;
+  grain_size = std::max(1u, grain_size);
+  TaskGroup group(*this);
+  std::function<void(std::uint32_t, std::uint32_t)> split =
+      [&group, &function, &split, grain_size](std::uint32_t range_begin,
+                                              std::uint32_t range_end) {
+        while (grain_size < (range_end - range_begin)) {
+          const std::uint32_t middle =
+              range_begin + ((range_end - range_begin) / 2u);
+          group.spawn(
+              [&split, middle, range_end]() { split(middle, range_end); });
+          range_end = middle;
+        }
+        for (std::uint32_t index = range_begin; index < range_end; ++index)
+          function(index);
+      };
+  group.spawn([&split, begin, end]() { split(begin, end); });
+  group.wait();
+}
+
+WorkStealingPool::TaskGroup::~TaskGroup() {
+  try {
+    wait();
+  } catch (...) {
+    /* Exceptions are only forwarded through an explicit wait */
+  }
+}
+
+void WorkStealingPool::TaskGroup::spawn(Task task) {
+  m_pendingTasks.fetch_add(1u);
+  m_pool.push([this, task = std::move(task)]() {
+    try {
+      task();
+    } catch (...) {
+      std::lock_guard<std::mutex> my_lock(m_stateMutex);
+      if (!m_exception)
+        m_exception = std::current_exception();
+    }
+    /*!Note: The counter is decreased under the lock, so the group can not be
+     * destroyed by the waiting thread while it is being notified */
+    std::lock_guard<std::mutex> my_lock(m_stateMutex);
+    if (1u == m_pendingTasks.fetch_sub(1u))
+      m_finished.notify_all();
+  });
+}
+
+void WorkStealingPool::TaskGroup::wait() {
+  while (0u < m_pendingTasks.load()) {
+    if (m_pool.try_execute_one())
+      continue;
+    /* The remaining tasks are being executed by other threads, which might
+     * spawn new ones to help with, so the wait is periodically interrupted */
+    RFPROFILE_SCOPE("WorkStealingPool::wait");
+    std::unique_lock<std::mutex> my_lock(m_stateMutex);
+    m_finished.wait_for(my_lock, s_waitRecheckPeriod,
+                        [this]() { return (0u == m_pendingTasks.load()); });
+  }
+  std::exception_ptr exception;
+  {
+    std::lock_guard<std::mutex> my_lock(m_stateMutex);
+    std::swap(exception, m_exception);
+  }
+  if (exception)
+    std::rethrow_exception(exception);
+}
+
+} /* namespace rafko_utilities */
@@ -38,12 +38,33 @@ namespace rafko_utilities {
  */
 class RAFKO_EXPORT ThreadGroup {
 public:
-  ThreadGroup(std::uint32_t number_of_threads);
+  /**
+   * @brief    The ways the calling thread and the workers may synchronize
+   */
+  enum synchronization_t {
+    Blocking, /* Every hand-off goes through a mutex and a condition variable */
+    SpinThenPark /* Lock-free hand-off through a generation counter; waiting
+                    threads spin for a bounded time before going to sleep */
+  };
+
+  /**
+   * @brief     Class Constructor
+   *
+   * @param[in]   number_of_threads   The number of worker threads to start
+   * @param[in]   synchronization     The way the threads are synchronized
+   * @param[in]   cpu_sets            The CPUs each worker thread is allowed to
+   * run on, by thread index; see @set_thread_affinity
+   */
+  ThreadGroup(std::uint32_t number_of_threads,
+              synchronization_t synchronization = Blocking,
+              const std::vector<std::vector<std::uint32_t>> &cpu_sets = {});
   ~ThreadGroup();
 
   /**
    * @brief     Executes the profided function in all of the handled threads
-   * with the index of the executing thread provided to it
+   * with the index of the executing thread provided to it. Handing the
+   * function over to the threads and waiting for them are profiled as the
+   * phases "ThreadGroup::dispatch" and "ThreadGroup::wait".
    */
   void
   start_and_block(const std::function<void(std::uint32_t)> &function) const;
@@ -53,8 +74,14 @@ public:
    */
   std::uint32_t get_number_of_threads() const { return m_threads.size(); }
 
+  /**
+   * @brief     Returns the way the threads of the group are synchronized
+   */
+  synchronization_t get_synchronization() const { return m_synchronization; }
+
 private:
   enum state_t { Idle, Start, End };
+  const synchronization_t m_synchronization;
   mutable const std::function<void(std::uint32_t)>
       *m_workerFunction; /* gets the thread index it is inside */
   mutable std::size_t m_threadsReady = 0;
@@ -64,7 +91,41 @@ private:
   mutable std::condition_variable m_synchroniser;
   std::vector<std::thread> m_threads;
 
+  /* Synchronization in @SpinThenPark mode: the generation counter is increased
+   * with every dispatch; the workers compare it to the last one they executed
+   * ( sense reversal ), and count down @m_pendingThreads when finished. */
+  std::uint32_t m_spinLimit = 0u;
+  mutable std::atomic<std::uint32_t> m_generation = {0u};
+  mutable std::atomic<std::uint32_t> m_pendingThreads = {0u};
+  mutable std::atomic<std::uint32_t> m_parkedWorkers = {0u};
+  mutable std::atomic<bool> m_callerParked = {false};
+  std::atomic<bool> m_stopping = {false};
+  mutable std::condition_variable m_workerWakeup;
+  mutable std::condition_variable m_callerWakeup;
+
   void worker(std::uint32_t thread_index);
+  void spinning_worker(std::uint32_t thread_index);
+  void spinning_start_and_block(
+      const std::function<void(std::uint32_t)> &function) const;
+
+  /**
+   * @brief     Spins until the given condition is true, for at most
+   * @m_spinLimit iterations
+   *
+   * @return    true if the condition became true while spinning
+   */
+  template <typename Condition> bool spin_until(Condition condition) const {
+    for (std::uint32_t spin = 0u; spin < m_spinLimit; ++spin) {
+      if (condition())
+        return true;
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+      __builtin_ia32_pause();
+#else
+      std::this_thread::yield();
+#endif
+    }
+    return condition();
+  }
 };
 
 } /* namespace rafko_utilities */
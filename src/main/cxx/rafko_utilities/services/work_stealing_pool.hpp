@@ -0,0 +1,147 @@
+/*! This file is part of davids91/Rafko.
+ *
+ *   Rafko is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Rafko is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Rafko.  If not, see <https://www.gnu.org/licenses/> or
+ *   <https://github.com/davids91/rafko/blob/master/LICENSE>
+ */
+
+#ifndef WORK_STEALING_POOL_H
+#define WORK_STEALING_POOL_H
+
+#include "rafko_global.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace rafko_utilities {
+
+/**
+ * @brief    A pool of worker threads each owning a queue of tasks. Workers
+ * execute their own tasks in LIFO order, and steal the oldest tasks of the
+ * others when they run out of work. Threads waiting for a group of tasks to
+ * finish execute pending tasks in the meantime, so parallel loops may be
+ * nested inside each other without blocking any threads or creating new ones.
+ * Since a waiting thread may pick up any task of the pool, tasks should not
+ * depend on per-thread state which is in use while they wait.
+ * Queueing tasks is profiled as the phase "WorkStealingPool::dispatch", and
+ * waiting for a group with no task left to pick up as "WorkStealingPool::wait".
+ */
+class RAFKO_EXPORT WorkStealingPool {
+public:
+  using Task = std::function<void()>;
+
+  /**
+   * @brief     Class Constructor
+   *
+   * @param[in]   number_of_workers   The number of worker threads to start
+   * @param[in]   cpus                The CPUs the workers are allowed to run
+   * on; see @set_thread_affinity
+   */
+  WorkStealingPool(std::uint32_t number_of_workers,
+                   const std::vector<std::uint32_t> &cpus = {});
+  ~WorkStealingPool();
+
+  /**
+   * @brief     Provides the pool shared between every component of the
+   * framework, with one thread for every available core; the thread waiting for
+   * the results counting as one.
+   */
+  static WorkStealingPool &shared();
+
+  /**
+   * @brief    A set of tasks which can be waited for together. The group waits
+   * for its tasks when it goes out of scope.
+   */
+  class RAFKO_EXPORT TaskGroup {
+  public:
+    TaskGroup(WorkStealingPool &pool) : m_pool(pool) {}
+    ~TaskGroup();
+
+    /**
+     * @brief     Adds a task to the queue of the calling thread ( or to the
+     * common queue, if the calling thread is not part of the pool ).
+     */
+    void spawn(Task task);
+
+    /**
+     * @brief     Blocks until every spawned task is finished, executing the
+     * pending tasks of the pool in the meantime. Rethrows the first exception
+     * thrown by any of the tasks of the group.
+     */
+    void wait();
+
+  private:
+    friend class WorkStealingPool;
+    WorkStealingPool &m_pool;
+    std::atomic<std::uint32_t> m_pendingTasks = {0u};
+    std::mutex m_stateMutex;
+    std::condition_variable m_finished;
+    std::exception_ptr m_exception;
+  };
+
+  /**
+   * @brief     Executes the given function for every index in the range and
+   * blocks until all of them are finished. The range is split recursively
+   * into halves so idle workers can steal the bigger parts of it.
+   *
+   * @param[in]   begin         The first index to execute the function for
+   * @param[in]   end           The index after the last one to execute
+   * @param[in]   function      The function to execute with each index
+   * @param[in]   grain_size    The number of indices not to split further
+   */
+  void parallel_for(std::uint32_t begin, std::uint32_t end,
+                    const std::function<void(std::uint32_t)> &function,
+                    std::uint32_t grain_size = 1u);
+
+  /**
+   * @brief     Returns the number of worker threads in the pool
+   */
+  std::uint32_t get_number_of_workers() const { return m_workers.size(); }
+
+  /**
+   * @brief     Returns the number of threads able to execute tasks at the same
+   * time: the workers and the thread waiting for the results
+   */
+  std::uint32_t get_concurrency() const { return m_workers.size() + 1u; }
+
+private:
+  struct TaskQueue {
+    std::mutex mutex;
+    std::deque<Task> tasks;
+  };
+
+  /* One queue for every worker, and a common one as the last for any thread
+   * outside the pool */
+  std::vector<std::unique_ptr<TaskQueue>> m_queues;
+  std::vector<std::thread> m_workers;
+  std::atomic<std::uint32_t> m_queuedTasks = {0u};
+  std::atomic<std::uint32_t> m_sleepingWorkers = {0u};
+  std::atomic<bool> m_stopping = {false};
+  std::mutex m_sleepMutex;
+  std::condition_variable m_wakeup;
+
+  void push(Task task);
+  bool try_execute_one();
+  bool try_pop(std::uint32_t queue_index, bool newest, Task &task);
+  void worker(std::uint32_t worker_index);
+};
+
+} /* namespace rafko_utilities */
+#endif /* WORK_STEALING_POOL_H */
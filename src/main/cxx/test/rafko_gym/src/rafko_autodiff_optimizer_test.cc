@@ -17,7 +17,9 @@
 #include <catch2/catch_approx.hpp>
 #include <catch2/catch_test_macros.hpp>
 
-#include <chrono>
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
 #include <iomanip>
 #include <iostream>
 
@@ -35,6 +37,10 @@
 #endif /*(RAFKO_USES_OPENCL)*/
 #include "rafko_gym/models/rafko_cost.hpp"
 #include "rafko_gym/models/rafko_dataset_implementation.hpp"
+#include "rafko_gym/models/rafko_mapped_dataset.hpp"
+#include "rafko_gym/models/rafko_streaming_dataset.hpp"
+#include "rafko_gym/services/rafko_data_parallel_optimizer.hpp"
+#include "rafko_gym/services/rafko_hogwild_optimizer.hpp"
 #include "rafko_net/services/rafko_net_builder.hpp"
 #include "rafko_net/services/solution_builder.hpp"
 #include "rafko_net/services/solution_solver.hpp"
@@ -86,8 +92,6 @@ TEST_CASE("Testing autodiff optimizer with the iteration interface for a "
   optimizer.set_weight_updater(rafko_gym::weight_updater_default);
   double actual_value = 0.0;
   std::uint32_t iteration = 0u;
-  std::uint32_t avg_duration = 0.0;
-  std::chrono::steady_clock::time_point start;
   rafko_net::SolutionSolver::Factory reference_solver_factory(network,
                                                               settings);
   std::shared_ptr<rafko_net::SolutionSolver> reference_solver =
@@ -96,16 +100,7 @@ TEST_CASE("Testing autodiff optimizer with the iteration interface for a "
          (2.0 * settings->get_learning_rate())) {
     std::cout << "\r";
     reference_solver_factory.refresh_actual_solution_weights();
-    start = std::chrono::steady_clock::now();
     optimizer.iterate(*data_set);
-    auto current_duration =
-        std::chrono::duration_cast<std::chrono::nanoseconds>(
-            std::chrono::steady_clock::now() - start)
-            .count();
-    if (0.0 == avg_duration)
-      avg_duration = current_duration;
-    else
-      avg_duration = (avg_duration + current_duration) / 2.0;
 
     actual_value =
         optimizer.get_neuron_operation(0u)->get_value(0u /*past_index*/);
@@ -121,8 +116,7 @@ TEST_CASE("Testing autodiff optimizer with the iteration interface for a "
           return accu + std::abs(element);
         });
     std::cout << "Target: " << data_set->get_label_sample(0u)[0] << " -?-> "
-              << actual_value << "\t\t\t | avg duration: " << avg_duration
-              << "ns "
+              << actual_value
               << " | weight_sum: " << weight_sum
               << " | iteration: " << iteration << "     ";
     ++iteration;
@@ -174,8 +168,6 @@ TEST_CASE("Testing autodiff optimizer with the iteration interface for a "
   optimizer.set_weight_updater(rafko_gym::weight_updater_default);
   double actual_value = 0.0;
   std::uint32_t iteration = 0u;
-  std::uint32_t avg_duration = 0.0;
-  std::chrono::steady_clock::time_point start;
   rafko_net::SolutionSolver::Factory reference_solver_factory(network,
                                                               settings);
   std::shared_ptr<rafko_net::SolutionSolver> reference_solver =
@@ -184,16 +176,7 @@ TEST_CASE("Testing autodiff optimizer with the iteration interface for a "
          (2.0 * settings->get_learning_rate())) {
     std::cout << "\r";
     reference_solver_factory.refresh_actual_solution_weights();
-    start = std::chrono::steady_clock::now();
     optimizer.iterate(*data_set);
-    auto current_duration =
-        std::chrono::duration_cast<std::chrono::nanoseconds>(
-            std::chrono::steady_clock::now() - start)
-            .count();
-    if (0.0 == avg_duration)
-      avg_duration = current_duration;
-    else
-      avg_duration = (avg_duration + current_duration) / 2.0;
 
     actual_value =
         optimizer.get_neuron_operation(0u)->get_value(0u /*past_index*/);
@@ -209,8 +192,7 @@ TEST_CASE("Testing autodiff optimizer with the iteration interface for a "
           return accu + std::abs(element);
         });
     std::cout << "Target: " << data_set->get_label_sample(0u)[0] << " -?-> "
-              << actual_value << "\t\t\t | avg duration: " << avg_duration
-              << "ns "
+              << actual_value
               << " | weight_sum: " << weight_sum
               << " | iteration: " << iteration << "     ";
     ++iteration;
@@ -263,8 +245,6 @@ TEST_CASE("Testing autodiff optimizer with the iteration interface for a "
   optimizer.set_weight_updater(rafko_gym::weight_updater_default);
   std::vector<std::vector<double>> actual_value(2, std::vector<double>(2, 0.0));
   std::uint32_t iteration = 0u;
-  std::uint32_t avg_duration = 0.0;
-  std::chrono::steady_clock::time_point start;
   rafko_net::SolutionSolver::Factory reference_solver_factory(network,
                                                               settings);
   std::shared_ptr<rafko_net::SolutionSolver> reference_solver =
@@ -274,16 +254,7 @@ TEST_CASE("Testing autodiff optimizer with the iteration interface for a "
          (2.0 * settings->get_learning_rate())) {
     std::cout << "\r";
     reference_solver_factory.refresh_actual_solution_weights();
-    start = std::chrono::steady_clock::now();
     optimizer.iterate(*data_set);
-    auto current_duration =
-        std::chrono::duration_cast<std::chrono::nanoseconds>(
-            std::chrono::steady_clock::now() - start)
-            .count();
-    if (0.0 == avg_duration)
-      avg_duration = current_duration;
-    else
-      avg_duration = (avg_duration + current_duration) / 2.0;
 
     actual_value[1][0] =
         optimizer.get_neuron_operation(0u)->get_value(1u /*past_index*/);
@@ -306,8 +277,7 @@ TEST_CASE("Testing autodiff optimizer with the iteration interface for a "
     std::cout << "Target: " << data_set->get_label_sample(0u)[0] << " -?-> "
               << actual_value[1][0] << ";   "
               << data_set->get_label_sample(1u)[0] << " -?-> "
-              << actual_value[0][0] << " | avg duration: " << avg_duration
-              << "ns "
+              << actual_value[0][0]
               << " | weight_sum: " << weight_sum
               << " | iteration: " << iteration << "     ";
     ++iteration;
@@ -361,8 +331,6 @@ TEST_CASE(
   optimizer.set_weight_updater(rafko_gym::weight_updater_default);
   double actual_value = 0.0;
   std::uint32_t iteration = 0u;
-  std::uint32_t avg_duration = 0.0;
-  std::chrono::steady_clock::time_point start;
   rafko_net::SolutionSolver::Factory reference_solver_factory(network,
                                                               settings);
   std::shared_ptr<rafko_net::SolutionSolver> reference_solver =
@@ -371,16 +339,7 @@ TEST_CASE(
          (2.0 * settings->get_learning_rate())) {
     std::cout << "\r";
     reference_solver_factory.refresh_actual_solution_weights();
-    start = std::chrono::steady_clock::now();
     optimizer.iterate(*data_set);
-    auto current_duration =
-        std::chrono::duration_cast<std::chrono::nanoseconds>(
-            std::chrono::steady_clock::now() - start)
-            .count();
-    if (0.0 == avg_duration)
-      avg_duration = current_duration;
-    else
-      avg_duration = (avg_duration + current_duration) / 2.0;
 
     actual_value =
         optimizer.get_neuron_operation(2u)->get_value(0u /*past_index*/);
@@ -396,8 +355,7 @@ TEST_CASE(
           return accu + std::abs(element);
         });
     std::cout << "Target: " << data_set->get_label_sample(0u)[0] << " -?-> "
-              << actual_value << "\t\t\t | avg duration: " << avg_duration
-              << "ns "
+              << actual_value
               << " | weight_sum: " << weight_sum
               << " | iteration: " << iteration << "     ";
     ++iteration;
@@ -446,8 +404,6 @@ TEST_CASE("Testing autodiff optimizer with the iteration interface",
   optimizer.set_weight_updater(rafko_gym::weight_updater_default);
   std::vector<std::vector<double>> actual_value(2, std::vector<double>(2, 0.0));
   std::uint32_t iteration = 0u;
-  std::uint32_t avg_duration = 0.0;
-  std::chrono::steady_clock::time_point start;
   rafko_net::SolutionSolver::Factory reference_solver_factory(network,
                                                               settings);
   std::shared_ptr<rafko_net::SolutionSolver> reference_solver =
@@ -457,16 +413,7 @@ TEST_CASE("Testing autodiff optimizer with the iteration interface",
          (2.0 * settings->get_learning_rate())) {
     std::cout << "\r";
     reference_solver_factory.refresh_actual_solution_weights();
-    start = std::chrono::steady_clock::now();
     optimizer.iterate(*data_set);
-    auto current_duration =
-        std::chrono::duration_cast<std::chrono::nanoseconds>(
-            std::chrono::steady_clock::now() - start)
-            .count();
-    if (0.0 == avg_duration)
-      avg_duration = current_duration;
-    else
-      avg_duration = (avg_duration + current_duration) / 2.0;
 
     actual_value[1][0] =
         optimizer.get_neuron_operation(0u)->get_value(1u /*past_index*/);
@@ -490,8 +437,7 @@ TEST_CASE("Testing autodiff optimizer with the iteration interface",
     std::cout << "Target: " << data_set->get_label_sample(0u)[0] << " -?-> "
               << actual_value[1][0] << ";   "
               << data_set->get_label_sample(1u)[0] << " -?-> "
-              << actual_value[0][0] << " | avg duration: " << avg_duration
-              << "ns "
+              << actual_value[0][0]
               << " | weight_sum: " << weight_sum
               << " | iteration: " << iteration << "     ";
     ++iteration;
@@ -500,6 +446,663 @@ TEST_CASE("Testing autodiff optimizer with the iteration interface",
             << std::endl;
 }
 
+TEST_CASE("Testing if reverse mode autodiff produces the same weight updates "
+          "as forward mode autodiff",
+          "[optimizer][CPU][reverse][memory]") {
+  google::protobuf::Arena arena;
+  constexpr std::uint32_t sequence_size = 4u;
+  constexpr std::uint32_t number_of_samples = 8u;
+  rafko_mainframe::RafkoSettings base_settings =
+      rafko_mainframe::RafkoSettings()
+          .set_learning_rate(0.01)
+          .set_minibatch_size(number_of_samples)
+          .set_memory_truncation(sequence_size)
+          .set_arena_ptr(&arena)
+          .set_max_solve_threads(2)
+          .set_max_processing_threads(4);
+  std::shared_ptr<rafko_mainframe::RafkoSettings> forward_settings =
+      std::make_shared<rafko_mainframe::RafkoSettings>(
+          rafko_mainframe::RafkoSettings(base_settings)
+              .set_autodiff_mode(rafko_gym::autodiff_mode_forward));
+  std::shared_ptr<rafko_mainframe::RafkoSettings> reverse_settings =
+      std::make_shared<rafko_mainframe::RafkoSettings>(
+          rafko_mainframe::RafkoSettings(base_settings)
+              .set_autodiff_mode(rafko_gym::autodiff_mode_reverse));
+
+  rafko_net::RafkoNet &forward_network =
+      *rafko_net::RafkoNetBuilder(*forward_settings)
+           .input_size(2)
+           .expected_input_range(1.0)
+           .add_neuron_recurrence(0u, 0u, 1u)
+           .add_neuron_recurrence(1u, 1u, 2u)
+           .set_neuron_input_function(0u, 1u, rafko_net::input_function_multiply)
+           .set_neuron_input_function(1u, 0u, rafko_net::input_function_multiply)
+           .set_neuron_spike_function(0u, 0u, rafko_net::spike_function_memory)
+           .set_neuron_spike_function(0u, 2u, rafko_net::spike_function_p)
+           .set_neuron_spike_function(1u, 1u,
+                                      rafko_net::spike_function_amplify_value)
+           .set_neuron_spike_function(2u, 0u, rafko_net::spike_function_none)
+           .allowed_transfer_functions_by_layer(
+               {{rafko_net::transfer_function_selu,
+                 rafko_net::transfer_function_sigmoid},
+                {rafko_net::transfer_function_tanh},
+                {rafko_net::transfer_function_identity}})
+           .create_layers({3, 2, 1});
+  rafko_net::RafkoNet reverse_network(forward_network);
+
+  auto [inputs, labels] = rafko_test::create_sequenced_addition_dataset(
+      number_of_samples, sequence_size);
+  std::shared_ptr<rafko_gym::RafkoDatasetImplementation> data_set =
+      std::make_shared<rafko_gym::RafkoDatasetImplementation>(
+          std::move(inputs), std::move(labels), sequence_size);
+  std::shared_ptr<rafko_gym::RafkoObjective> objective =
+      std::make_shared<rafko_gym::RafkoCost>(
+          *forward_settings, rafko_gym::cost_function_squared_error);
+
+  rafko_gym::RafkoAutodiffOptimizer forward_optimizer(forward_settings,
+                                                      forward_network);
+  rafko_gym::RafkoAutodiffOptimizer reverse_optimizer(reverse_settings,
+                                                      reverse_network);
+  forward_optimizer.build(data_set, objective);
+  reverse_optimizer.build(data_set, objective);
+  forward_optimizer.set_weight_updater(rafko_gym::weight_updater_default);
+  reverse_optimizer.set_weight_updater(rafko_gym::weight_updater_default);
+
+  for (std::uint32_t iteration = 0u; iteration < 5u; ++iteration) {
+    srand(iteration);
+    forward_optimizer.iterate(*data_set);
+    srand(iteration);
+    reverse_optimizer.iterate(*data_set);
+    for (std::int32_t weight_index = 0;
+         weight_index < forward_network.weight_table_size(); ++weight_index) {
+      CHECK(reverse_optimizer.get_avg_gradient(weight_index) ==
+            Catch::Approx(forward_optimizer.get_avg_gradient(weight_index))
+                .epsilon(0.0000000001));
+      REQUIRE(reverse_network.weight_table(weight_index) ==
+              Catch::Approx(forward_network.weight_table(weight_index))
+                  .epsilon(0.0000000001));
+    }
+  }
+}
+
+TEST_CASE("Testing if single precision derivatives produce close to the "
+          "same weight updates as double precision ones",
+          "[optimizer][CPU][memory]") {
+  google::protobuf::Arena arena;
+  constexpr std::uint32_t sequence_size = 3u;
+  constexpr std::uint32_t number_of_samples = 8u;
+  std::shared_ptr<rafko_mainframe::RafkoSettings> settings =
+      std::make_shared<rafko_mainframe::RafkoSettings>(
+          rafko_mainframe::RafkoSettings()
+              .set_learning_rate(0.01)
+              .set_minibatch_size(number_of_samples)
+              .set_memory_truncation(sequence_size)
+              .set_arena_ptr(&arena)
+              .set_max_solve_threads(2)
+              .set_max_processing_threads(4));
+  std::shared_ptr<rafko_mainframe::RafkoSettings> float_settings =
+      std::make_shared<rafko_mainframe::RafkoSettings>(
+          rafko_mainframe::RafkoSettings(*settings)
+              .set_single_precision_derivatives(true));
+
+  rafko_net::RafkoNet &network =
+      *rafko_net::RafkoNetBuilder(*settings)
+           .input_size(2)
+           .expected_input_range(1.0)
+           .add_neuron_recurrence(0u, 0u, 1u)
+           .set_neuron_spike_function(1u, 0u, rafko_net::spike_function_p)
+           .allowed_transfer_functions_by_layer(
+               {{rafko_net::transfer_function_selu},
+                {rafko_net::transfer_function_sigmoid},
+                {rafko_net::transfer_function_identity}})
+           .create_layers({2, 2, 1});
+  rafko_net::RafkoNet float_network(network);
+
+  auto [inputs, labels] = rafko_test::create_sequenced_addition_dataset(
+      number_of_samples, sequence_size);
+  std::shared_ptr<rafko_gym::RafkoDatasetImplementation> data_set =
+      std::make_shared<rafko_gym::RafkoDatasetImplementation>(
+          std::move(inputs), std::move(labels), sequence_size);
+  std::shared_ptr<rafko_gym::RafkoObjective> objective =
+      std::make_shared<rafko_gym::RafkoCost>(
+          *settings, rafko_gym::cost_function_squared_error);
+
+  rafko_gym::RafkoAutodiffOptimizer optimizer(settings, network);
+  rafko_gym::RafkoAutodiffOptimizer float_optimizer(float_settings,
+                                                    float_network);
+  optimizer.build(data_set, objective);
+  float_optimizer.build(data_set, objective);
+  optimizer.set_weight_updater(rafko_gym::weight_updater_default);
+  float_optimizer.set_weight_updater(rafko_gym::weight_updater_default);
+
+  for (std::uint32_t iteration = 0u; iteration < 5u; ++iteration) {
+    srand(iteration);
+    optimizer.iterate(*data_set);
+    srand(iteration);
+    float_optimizer.iterate(*data_set);
+    for (std::int32_t weight_index = 0;
+         weight_index < network.weight_table_size(); ++weight_index) {
+      CHECK(float_optimizer.get_avg_gradient(weight_index) ==
+            Catch::Approx(optimizer.get_avg_gradient(weight_index))
+                .epsilon(0.001)
+                .margin(0.000001));
+      REQUIRE(float_network.weight_table(weight_index) ==
+              Catch::Approx(network.weight_table(weight_index))
+                  .epsilon(0.0001));
+    }
+  }
+}
+
+TEST_CASE("Testing if processing the sequences of a minibatch in parallel "
+          "averages the weight updates of every sequence",
+          "[optimizer][CPU][parallel]") {
+  google::protobuf::Arena arena;
+  constexpr std::uint32_t sequence_size = 3u;
+  constexpr std::uint32_t number_of_sequences = 7u;
+  rafko_mainframe::RafkoSettings base_settings =
+      rafko_mainframe::RafkoSettings()
+          .set_learning_rate(0.01)
+          .set_memory_truncation(sequence_size)
+          .set_arena_ptr(&arena)
+          .set_max_solve_threads(2)
+          .set_max_processing_threads(3);
+  std::shared_ptr<rafko_mainframe::RafkoSettings> sequence_settings =
+      std::make_shared<rafko_mainframe::RafkoSettings>(
+          rafko_mainframe::RafkoSettings(base_settings).set_minibatch_size(1));
+  std::shared_ptr<rafko_mainframe::RafkoSettings> parallel_settings =
+      std::make_shared<rafko_mainframe::RafkoSettings>(
+          rafko_mainframe::RafkoSettings(base_settings)
+              .set_minibatch_size(number_of_sequences)
+              .set_parallel_sequences(true));
+  std::shared_ptr<rafko_mainframe::RafkoSettings> single_worker_settings =
+      std::make_shared<rafko_mainframe::RafkoSettings>(
+          rafko_mainframe::RafkoSettings(*parallel_settings)
+              .set_max_processing_threads(1));
+
+  rafko_net::RafkoNet &network =
+      *rafko_net::RafkoNetBuilder(base_settings)
+           .input_size(2)
+           .expected_input_range(1.0)
+           .add_neuron_recurrence(0u, 0u, 1u)
+           .set_neuron_spike_function(1u, 0u, rafko_net::spike_function_p)
+           .allowed_transfer_functions_by_layer(
+               {{rafko_net::transfer_function_selu},
+                {rafko_net::transfer_function_sigmoid},
+                {rafko_net::transfer_function_identity}})
+           .create_layers({2, 2, 1});
+
+  auto [inputs, labels] = rafko_test::create_sequenced_addition_dataset(
+      number_of_sequences, sequence_size);
+  std::shared_ptr<rafko_gym::RafkoObjective> objective =
+      std::make_shared<rafko_gym::RafkoCost>(
+          base_settings, rafko_gym::cost_function_squared_error);
+
+  /* The weight update of every sequence alone */
+  std::vector<double> average_weight_delta(network.weight_table_size(), 0.0);
+  for (std::uint32_t sequence_index = 0u; sequence_index < number_of_sequences;
+       ++sequence_index) {
+    std::shared_ptr<rafko_gym::RafkoDatasetImplementation> sequence_data_set =
+        std::make_shared<rafko_gym::RafkoDatasetImplementation>(
+            std::vector<std::vector<double>>(
+                inputs.begin() + (sequence_index * sequence_size),
+                inputs.begin() + ((sequence_index + 1u) * sequence_size)),
+            std::vector<std::vector<double>>(
+                labels.begin() + (sequence_index * sequence_size),
+                labels.begin() + ((sequence_index + 1u) * sequence_size)),
+            sequence_size);
+    rafko_net::RafkoNet sequence_network(network);
+    rafko_gym::RafkoAutodiffOptimizer sequence_optimizer(sequence_settings,
+                                                         sequence_network);
+    sequence_optimizer.build(sequence_data_set, objective);
+    sequence_optimizer.iterate(*sequence_data_set);
+    for (std::int32_t weight_index = 0;
+         weight_index < network.weight_table_size(); ++weight_index)
+      average_weight_delta[weight_index] +=
+          (sequence_network.weight_table(weight_index) -
+           network.weight_table(weight_index)) /
+          static_cast<double>(number_of_sequences);
+  }
+
+  std::shared_ptr<rafko_gym::RafkoDatasetImplementation> data_set =
+      std::make_shared<rafko_gym::RafkoDatasetImplementation>(
+          std::move(inputs), std::move(labels), sequence_size);
+  rafko_net::RafkoNet parallel_network(network);
+  rafko_net::RafkoNet single_worker_network(network);
+  rafko_gym::RafkoAutodiffOptimizer parallel_optimizer(parallel_settings,
+                                                       parallel_network);
+  rafko_gym::RafkoAutodiffOptimizer single_worker_optimizer(
+      single_worker_settings, single_worker_network);
+  parallel_optimizer.build(data_set, objective);
+  single_worker_optimizer.build(data_set, objective);
+  parallel_optimizer.iterate(*data_set);
+  single_worker_optimizer.iterate(*data_set);
+
+  for (std::int32_t weight_index = 0;
+       weight_index < network.weight_table_size(); ++weight_index) {
+    REQUIRE(parallel_network.weight_table(weight_index) ==
+            Catch::Approx(network.weight_table(weight_index) +
+                          average_weight_delta[weight_index])
+                .epsilon(0.0000000001));
+    REQUIRE(parallel_network.weight_table(weight_index) ==
+            single_worker_network.weight_table(weight_index));
+  }
+}
+
+TEST_CASE("Testing if the serially and the parallel processed sequences of a "
+          "minibatch produce the same gradients",
+          "[optimizer][CPU][parallel]") {
+  google::protobuf::Arena arena;
+  constexpr std::uint32_t sequence_size = 3u;
+  constexpr std::uint32_t number_of_sequences = 7u;
+  constexpr std::uint32_t minibatch_size = 3u;
+  std::shared_ptr<rafko_mainframe::RafkoSettings> serial_settings =
+      std::make_shared<rafko_mainframe::RafkoSettings>(
+          rafko_mainframe::RafkoSettings()
+              .set_learning_rate(0.01)
+              .set_minibatch_size(minibatch_size)
+              .set_memory_truncation(sequence_size)
+              .set_arena_ptr(&arena)
+              .set_max_solve_threads(2)
+              .set_max_processing_threads(3));
+  std::shared_ptr<rafko_mainframe::RafkoSettings> parallel_settings =
+      std::make_shared<rafko_mainframe::RafkoSettings>(
+          rafko_mainframe::RafkoSettings(*serial_settings)
+              .set_parallel_sequences(true));
+  std::shared_ptr<rafko_mainframe::RafkoSettings> sequence_settings =
+      std::make_shared<rafko_mainframe::RafkoSettings>(
+          rafko_mainframe::RafkoSettings(*serial_settings)
+              .set_minibatch_size(1));
+
+  rafko_net::RafkoNet &network =
+      *rafko_net::RafkoNetBuilder(*serial_settings)
+           .input_size(2)
+           .expected_input_range(1.0)
+           .add_neuron_recurrence(0u, 0u, 1u)
+           .allowed_transfer_functions_by_layer(
+               {{rafko_net::transfer_function_selu},
+                {rafko_net::transfer_function_sigmoid},
+                {rafko_net::transfer_function_identity}})
+           .create_layers({2, 2, 1});
+  auto [inputs, labels] = rafko_test::create_sequenced_addition_dataset(
+      number_of_sequences, sequence_size);
+  std::shared_ptr<rafko_gym::RafkoDatasetImplementation> data_set =
+      std::make_shared<rafko_gym::RafkoDatasetImplementation>(
+          std::move(inputs), std::move(labels), sequence_size);
+  std::shared_ptr<rafko_gym::RafkoObjective> objective =
+      std::make_shared<rafko_gym::RafkoCost>(
+          *serial_settings, rafko_gym::cost_function_squared_error);
+
+  rafko_gym::RafkoAutodiffOptimizer serial_optimizer(serial_settings,
+                                                     network);
+  rafko_gym::RafkoAutodiffOptimizer parallel_optimizer(parallel_settings,
+                                                       network);
+  rafko_gym::RafkoAutodiffOptimizer sequence_optimizer(sequence_settings,
+                                                       network);
+  serial_optimizer.build(data_set, objective);
+  parallel_optimizer.build(data_set, objective);
+  sequence_optimizer.build(data_set, objective);
+
+  /* Every minibatch is the average of the sequences it starts at */
+  for (std::uint32_t sequence_start_index :
+       {0u, 2u, number_of_sequences - minibatch_size}) {
+    std::vector<double> expected_gradients(network.weight_table_size(), 0.0);
+    for (std::uint32_t sequence_index = sequence_start_index;
+         sequence_index < (sequence_start_index + minibatch_size);
+         ++sequence_index) {
+      const std::vector<double> &sequence_gradients =
+          sequence_optimizer.calculate_gradients(*data_set, sequence_index,
+                                                 0u);
+      for (std::uint32_t weight_index = 0u;
+           weight_index < expected_gradients.size(); ++weight_index)
+        expected_gradients[weight_index] +=
+            sequence_gradients[weight_index] /
+            static_cast<double>(minibatch_size);
+    }
+    const std::vector<double> serial_gradients =
+        serial_optimizer.calculate_gradients(*data_set, sequence_start_index,
+                                             0u);
+    const std::vector<double> &parallel_gradients =
+        parallel_optimizer.calculate_gradients(*data_set, sequence_start_index,
+                                               0u);
+    for (std::uint32_t weight_index = 0u;
+         weight_index < expected_gradients.size(); ++weight_index) {
+      REQUIRE(serial_gradients[weight_index] ==
+              parallel_gradients[weight_index]);
+      REQUIRE(serial_gradients[weight_index] ==
+              Catch::Approx(expected_gradients[weight_index])
+                  .epsilon(0.0000000001)
+                  .margin(0.0000000000001));
+    }
+  }
+}
+
+TEST_CASE("Testing if data parallel training with replicas produces the same "
+          "weight updates as training on the whole minibatch at once",
+          "[optimizer][CPU][parallel][replicas]") {
+  google::protobuf::Arena arena;
+  constexpr std::uint32_t sequence_size = 3u;
+  constexpr std::uint32_t number_of_sequences = 8u;
+  constexpr std::uint32_t replica_count = 2u;
+  std::shared_ptr<rafko_mainframe::RafkoSettings> settings =
+      std::make_shared<rafko_mainframe::RafkoSettings>(
+          rafko_mainframe::RafkoSettings()
+              .set_learning_rate(0.01)
+              .set_minibatch_size(number_of_sequences)
+              .set_memory_truncation(sequence_size)
+              .set_arena_ptr(&arena)
+              .set_max_solve_threads(2)
+              .set_max_processing_threads(4)
+              .set_parallel_sequences(true));
+  std::shared_ptr<rafko_mainframe::RafkoSettings> replica_settings =
+      std::make_shared<rafko_mainframe::RafkoSettings>(
+          rafko_mainframe::RafkoSettings(*settings).set_minibatch_size(
+              number_of_sequences / replica_count));
+
+  rafko_net::RafkoNet &network =
+      *rafko_net::RafkoNetBuilder(*settings)
+           .input_size(2)
+           .expected_input_range(1.0)
+           .add_neuron_recurrence(0u, 0u, 1u)
+           .set_neuron_spike_function(1u, 0u, rafko_net::spike_function_p)
+           .allowed_transfer_functions_by_layer(
+               {{rafko_net::transfer_function_selu},
+                {rafko_net::transfer_function_sigmoid},
+                {rafko_net::transfer_function_identity}})
+           .create_layers({2, 2, 1});
+  rafko_net::RafkoNet replicated_network(network);
+
+  auto [inputs, labels] = rafko_test::create_sequenced_addition_dataset(
+      number_of_sequences, sequence_size);
+  std::shared_ptr<rafko_gym::RafkoDatasetImplementation> data_set =
+      std::make_shared<rafko_gym::RafkoDatasetImplementation>(
+          std::move(inputs), std::move(labels), sequence_size);
+  std::shared_ptr<rafko_gym::RafkoObjective> objective =
+      std::make_shared<rafko_gym::RafkoCost>(
+          *settings, rafko_gym::cost_function_squared_error);
+
+  rafko_gym::RafkoAutodiffOptimizer optimizer(settings, network);
+  rafko_gym::RafkoDataParallelOptimizer replicated_optimizer(
+      replica_settings, replicated_network, replica_count);
+  optimizer.build(data_set, objective);
+  replicated_optimizer.build(data_set, objective);
+  REQUIRE(replica_count == replicated_optimizer.get_replica_count());
+
+  for (std::uint32_t iteration = 0u; iteration < 3u; ++iteration) {
+    optimizer.iterate(*data_set);
+    replicated_optimizer.iterate(*data_set);
+    for (std::int32_t weight_index = 0;
+         weight_index < network.weight_table_size(); ++weight_index) {
+      REQUIRE(replicated_optimizer.get_gradients()[weight_index] ==
+              Catch::Approx(optimizer.get_gradients()[weight_index])
+                  .epsilon(0.0000000001)
+                  .margin(0.0000000000001));
+      REQUIRE(replicated_network.weight_table(weight_index) ==
+              Catch::Approx(network.weight_table(weight_index))
+                  .epsilon(0.0000000001));
+    }
+  }
+}
+
+TEST_CASE("Testing if asynchronous training with one worker produces the "
+          "same weight updates as the autodiff optimizer",
+          "[optimizer][CPU][parallel][hogwild]") {
+  google::protobuf::Arena arena;
+  constexpr std::uint32_t sequence_size = 3u;
+  constexpr std::uint32_t number_of_sequences = 4u;
+  std::shared_ptr<rafko_mainframe::RafkoSettings> settings =
+      std::make_shared<rafko_mainframe::RafkoSettings>(
+          rafko_mainframe::RafkoSettings()
+              .set_learning_rate(0.01)
+              .set_minibatch_size(number_of_sequences)
+              .set_memory_truncation(sequence_size)
+              .set_arena_ptr(&arena)
+              .set_parallel_sequences(true));
+  rafko_net::RafkoNet &network =
+      *rafko_net::RafkoNetBuilder(*settings)
+           .input_size(2)
+           .expected_input_range(1.0)
+           .add_neuron_recurrence(0u, 0u, 1u)
+           .allowed_transfer_functions_by_layer(
+               {{rafko_net::transfer_function_selu},
+                {rafko_net::transfer_function_sigmoid},
+                {rafko_net::transfer_function_identity}})
+           .create_layers({2, 2, 1});
+  rafko_net::RafkoNet asynchronous_network(network);
+
+  auto [inputs, labels] = rafko_test::create_sequenced_addition_dataset(
+      number_of_sequences, sequence_size);
+  std::shared_ptr<rafko_gym::RafkoDatasetImplementation> data_set =
+      std::make_shared<rafko_gym::RafkoDatasetImplementation>(
+          std::move(inputs), std::move(labels), sequence_size);
+  std::shared_ptr<rafko_gym::RafkoObjective> objective =
+      std::make_shared<rafko_gym::RafkoCost>(
+          *settings, rafko_gym::cost_function_squared_error);
+
+  rafko_gym::RafkoAutodiffOptimizer optimizer(settings, network);
+  rafko_gym::RafkoHogwildOptimizer asynchronous_optimizer(
+      settings, asynchronous_network, 1u /*worker_count*/);
+  optimizer.build(data_set, objective);
+  asynchronous_optimizer.build(data_set, objective);
+  optimizer.set_weight_updater(rafko_gym::weight_updater_momentum);
+  asynchronous_optimizer.set_weight_updater(rafko_gym::weight_updater_momentum);
+
+  for (std::uint32_t iteration = 0u; iteration < 3u; ++iteration) {
+    optimizer.iterate(*data_set);
+    asynchronous_optimizer.iterate(*data_set);
+    for (std::int32_t weight_index = 0;
+         weight_index < network.weight_table_size(); ++weight_index)
+      REQUIRE(asynchronous_network.weight_table(weight_index) ==
+              Catch::Approx(network.weight_table(weight_index))
+                  .epsilon(0.0000000001));
+  }
+  REQUIRE(3u == asynchronous_optimizer.get_update_count());
+  REQUIRE(0u == asynchronous_optimizer.get_max_staleness());
+  REQUIRE(0.0 == asynchronous_optimizer.get_average_staleness());
+}
+
+TEST_CASE("Testing if asynchronous training with multiple workers updates "
+          "the shared weights with every worker",
+          "[optimizer][CPU][parallel][hogwild]") {
+  google::protobuf::Arena arena;
+  constexpr std::uint32_t sequence_size = 3u;
+  constexpr std::uint32_t number_of_sequences = 16u;
+  constexpr std::uint32_t worker_count = 4u;
+  constexpr std::uint32_t updates_per_worker = 25u;
+  std::shared_ptr<rafko_mainframe::RafkoSettings> settings =
+      std::make_shared<rafko_mainframe::RafkoSettings>(
+          rafko_mainframe::RafkoSettings()
+              .set_learning_rate(0.0001)
+              .set_minibatch_size(4)
+              .set_memory_truncation(sequence_size)
+              .set_arena_ptr(&arena)
+              .set_max_processing_threads(worker_count));
+  rafko_net::RafkoNet &network =
+      *rafko_net::RafkoNetBuilder(*settings)
+           .input_size(2)
+           .expected_input_range(1.0)
+           .allowed_transfer_functions_by_layer(
+               {{rafko_net::transfer_function_selu},
+                {rafko_net::transfer_function_sigmoid},
+                {rafko_net::transfer_function_identity}})
+           .create_layers({4, 4, 1});
+  const std::uint32_t unused_weight_index = network.weight_table_size();
+  network.add_weight_table(0.5); /* No Neuron depends on it */
+  const std::vector<double> initial_weights(network.weight_table().begin(),
+                                            network.weight_table().end());
+
+  auto [inputs, labels] = rafko_test::create_sequenced_addition_dataset(
+      number_of_sequences, sequence_size);
+  std::shared_ptr<rafko_gym::RafkoDatasetImplementation> data_set =
+      std::make_shared<rafko_gym::RafkoDatasetImplementation>(
+          std::move(inputs), std::move(labels), sequence_size);
+  std::shared_ptr<rafko_gym::RafkoObjective> objective =
+      std::make_shared<rafko_gym::RafkoCost>(*settings,
+                                             rafko_gym::cost_function_mse);
+
+  rafko_gym::RafkoHogwildOptimizer optimizer(settings, network, worker_count);
+  optimizer.build(data_set, objective);
+  REQUIRE(worker_count == optimizer.get_worker_count());
+  { /* The workers only read and write the weights the outputs depend on */
+    rafko_net::RafkoNet worker_network(network);
+    rafko_gym::RafkoAutodiffOptimizer worker(settings, worker_network);
+    worker.build(data_set, objective);
+    const std::vector<std::uint32_t> &reachable_weights =
+        worker.get_reachable_weights();
+    REQUIRE((network.weight_table_size() - 1) ==
+            static_cast<std::int32_t>(reachable_weights.size()));
+    REQUIRE(std::is_sorted(reachable_weights.begin(), reachable_weights.end()));
+    REQUIRE(reachable_weights.end() == std::find(reachable_weights.begin(),
+                                                 reachable_weights.end(),
+                                                 unused_weight_index));
+  }
+  optimizer.train(*data_set, updates_per_worker);
+
+  constexpr std::uint64_t update_count = worker_count * updates_per_worker;
+  REQUIRE(update_count == optimizer.get_update_count());
+  REQUIRE(optimizer.get_max_staleness() < update_count);
+  REQUIRE(optimizer.get_average_staleness() <=
+          static_cast<double>(optimizer.get_max_staleness()));
+  REQUIRE(0.0 < optimizer.get_updates_per_second());
+  bool weights_changed = false;
+  for (std::int32_t weight_index = 0;
+       weight_index < network.weight_table_size(); ++weight_index) {
+    REQUIRE(std::isfinite(network.weight_table(weight_index)));
+    weights_changed |=
+        (initial_weights[weight_index] != network.weight_table(weight_index));
+  }
+  REQUIRE(weights_changed);
+  REQUIRE(0.5 == network.weight_table(unused_weight_index));
+
+  optimizer.reset_statistics();
+  REQUIRE(0u == optimizer.get_update_count());
+  REQUIRE(0.0 == optimizer.get_updates_per_second());
+}
+
+TEST_CASE("Testing if the autodiff optimizer trains through the minibatches "
+          "of a streamed data set",
+          "[optimizer][CPU][streaming]") {
+  constexpr std::uint32_t sequence_size = 2u;
+  constexpr std::uint32_t sequences_in_shard = 4u;
+  constexpr std::uint32_t shard_count = 2u;
+  constexpr std::uint32_t minibatch_size = 2u;
+  constexpr std::uint32_t number_of_sequences =
+      sequences_in_shard * shard_count;
+  std::shared_ptr<rafko_mainframe::RafkoSettings> settings =
+      std::make_shared<rafko_mainframe::RafkoSettings>(
+          rafko_mainframe::RafkoSettings()
+              .set_learning_rate(0.01)
+              .set_minibatch_size(minibatch_size)
+              .set_memory_truncation(sequence_size));
+  rafko_net::RafkoNet &network =
+      *rafko_net::RafkoNetBuilder(*settings)
+           .input_size(2)
+           .expected_input_range(1.0)
+           .add_neuron_recurrence(0u, 0u, 1u)
+           .allowed_transfer_functions_by_layer(
+               {{rafko_net::transfer_function_selu},
+                {rafko_net::transfer_function_identity}})
+           .create_layers({2, 1});
+  rafko_net::RafkoNet streamed_network(network);
+
+  /* The reference trains on the whole data set, the minibatches chosen in
+   * the order the stream provides them */
+  auto [inputs, labels] = rafko_test::create_sequenced_addition_dataset(
+      number_of_sequences, sequence_size);
+  std::vector<std::string> shard_files;
+  for (std::uint32_t shard_index = 0u; shard_index < shard_count;
+       ++shard_index) {
+    const std::uint32_t first = shard_index * sequences_in_shard * sequence_size;
+    const std::uint32_t last = first + (sequences_in_shard * sequence_size);
+    shard_files.push_back((std::filesystem::temp_directory_path() /
+                           ("rafko_streamed_training_" +
+                            std::to_string(shard_index) + ".bin"))
+                              .string());
+    rafko_gym::RafkoMappedDataSet::write(
+        rafko_gym::RafkoDatasetImplementation(
+            {inputs.begin() + first, inputs.begin() + last},
+            {labels.begin() + first, labels.begin() + last}, sequence_size),
+        shard_files.back());
+  }
+  std::shared_ptr<rafko_gym::RafkoDatasetImplementation> data_set =
+      std::make_shared<rafko_gym::RafkoDatasetImplementation>(
+          std::move(inputs), std::move(labels), sequence_size);
+  std::shared_ptr<rafko_gym::RafkoStreamingDataSet> stream =
+      std::make_shared<rafko_gym::RafkoStreamingDataSet>(
+          *settings, shard_files, 2u /* prefetched batches */,
+          1u /* shuffle window */);
+  std::shared_ptr<rafko_gym::RafkoObjective> objective =
+      std::make_shared<rafko_gym::RafkoCost>(
+          *settings, rafko_gym::cost_function_squared_error);
+
+  rafko_gym::RafkoAutodiffOptimizer optimizer(settings, network);
+  rafko_gym::RafkoAutodiffOptimizer streamed_optimizer(settings,
+                                                       streamed_network);
+  optimizer.build(data_set, objective);
+  streamed_optimizer.build(stream, objective);
+  for (std::uint32_t iteration = 0u;
+       iteration < (2u * number_of_sequences / minibatch_size); ++iteration) {
+    optimizer.iterate_on_minibatch(
+        *data_set, (iteration * minibatch_size) % number_of_sequences, 0u);
+    streamed_optimizer.iterate(*stream);
+    for (std::int32_t weight_index = 0;
+         weight_index < network.weight_table_size(); ++weight_index)
+      REQUIRE(streamed_network.weight_table(weight_index) ==
+              Catch::Approx(network.weight_table(weight_index))
+                  .epsilon(0.0000000001));
+  }
+
+  stream.reset();
+  for (const std::string &shard_file : shard_files)
+    std::filesystem::remove(shard_file);
+}
+
+TEST_CASE("Testing if backpropagation data only stores the tracked "
+          "derivatives",
+          "[optimizer][CPU][memory]") {
+  google::protobuf::Arena arena;
+  rafko_mainframe::RafkoSettings settings =
+      rafko_mainframe::RafkoSettings().set_arena_ptr(&arena);
+  rafko_net::RafkoNet &network = *rafko_net::RafkoNetBuilder(settings)
+                                      .input_size(2)
+                                      .expected_input_range(1.0)
+                                      .create_layers({2, 1});
+  const std::uint32_t weight_count = network.weight_table_size();
+  REQUIRE(2u < weight_count);
+
+  /* operation 0 is weight relevant, and depends on every weight */
+  std::vector<std::vector<std::uint32_t>> operation_weights(3u);
+  for (std::uint32_t weight_index = 0u; weight_index < weight_count;
+       ++weight_index)
+    operation_weights[0].push_back(weight_index);
+  operation_weights[1] = {0u, 2u};
+  operation_weights[2] = {};
+
+  rafko_gym::RafkoBackpropagationData data(network);
+  data.build(operation_weights, 1u /*relevant_operation_count*/,
+             2u /*sequence_size*/);
+  REQUIRE((weight_count + 2u) == data.get_tracked_derivative_count());
+  REQUIRE(operation_weights[1] == data.get_tracked_weights(1u));
+
+  data.step();
+  data.set_weight_derivative_update(true);
+  data.set_derivative(1u, 0u, 3.0);
+  data.set_derivative(1u, 2u, 5.0);
+  data.set_derivative(0u, 1u, 4.0);
+  CHECK(3.0 == data.get_derivative(0u, 1u, 0u));
+  CHECK(0.0 == data.get_derivative(0u, 1u, 1u));
+  CHECK(5.0 == data.get_derivative(0u, 1u, 2u));
+  CHECK(0.0 == data.get_derivative(0u, 2u, 0u));
+  CHECK(4.0 == data.get_derivative(0u, 0u, 1u));
+  CHECK(2.0 == data.get_average_derivative(0u, 1u));
+
+  /* The values move into the past with the step, the new slot is clean */
+  data.step();
+  CHECK(3.0 == data.get_derivative(1u, 1u, 0u));
+  CHECK(5.0 == data.get_derivative(1u, 1u, 2u));
+  CHECK(0.0 == data.get_derivative(0u, 1u, 0u));
+  CHECK(0.0 == data.get_derivative(0u, 1u, 2u));
+}
+
 #if (RAFKO_USES_OPENCL)
 TEST_CASE("Testing if autodiff GPU optimizer executes a single Neuron "
           "correctly with 2 inputs without bias",
@@ -1233,24 +1836,13 @@ TEST_CASE("Testing if autodiff GPU optimizer converges networks with the GPU "
   optimizerGPU->set_weight_updater(rafko_gym::weight_updater_amsgrad);
   std::vector<std::vector<double>> actual_value(2, std::vector<double>(2, 0.0));
   std::uint32_t iteration = 0u;
-  std::uint32_t avg_duration = 0.0;
-  std::chrono::steady_clock::time_point start;
   while ((std::abs(actual_value[1][0] - data_set->get_label_sample(0u)[0]) +
           std::abs(actual_value[0][0] - data_set->get_label_sample(1u)[0])) >
          (2.0 * settings->get_learning_rate())) {
     std::cout << "\r";
     std::shared_ptr<rafko_net::SolutionSolver> reference_solver =
         rafko_net::SolutionSolver::Factory(network, settings).build();
-    start = std::chrono::steady_clock::now();
     optimizerGPU->iterate(*data_set);
-    auto current_duration =
-        std::chrono::duration_cast<std::chrono::nanoseconds>(
-            std::chrono::steady_clock::now() - start)
-            .count();
-    if (0.0 == avg_duration)
-      avg_duration = current_duration;
-    else
-      avg_duration = (avg_duration + current_duration) / 2.0;
 
     actual_value[1][0] =
         optimizerGPU->get_neuron_data(0u /*sequence_index*/, 1u /*past_index*/,
@@ -1273,8 +1865,7 @@ TEST_CASE("Testing if autodiff GPU optimizer converges networks with the GPU "
     std::cout << "Target: " << data_set->get_label_sample(0u)[0] << " -?-> "
               << actual_value[1][0] << ";   "
               << data_set->get_label_sample(1u)[0] << " -?-> "
-              << actual_value[0][0] << " | avg duration: " << avg_duration
-              << "ns "
+              << actual_value[0][0]
               << " | weight_sum: " << weight_sum
               << " | iteration: " << iteration << "     \r";
     ++iteration;
@@ -1361,24 +1952,13 @@ TEST_CASE("Testing if autodiff GPU optimizer converges networks with the GPU "
   optimizer.set_weight_updater(rafko_gym::weight_updater_amsgrad);
   std::vector<std::vector<double>> actual_value(2, std::vector<double>(2, 0.0));
   std::uint32_t iteration = 0u;
-  std::uint32_t avg_duration = 0.0;
-  std::chrono::steady_clock::time_point start;
   while ((std::abs(actual_value[1][0] - data_set->get_label_sample(0u)[0]) +
           std::abs(actual_value[0][0] - data_set->get_label_sample(1u)[0])) >
          (2.0 * settings->get_learning_rate())) {
     std::cout << "\r";
     std::shared_ptr<rafko_net::SolutionSolver> reference_solver =
         rafko_net::SolutionSolver::Factory(network, settings).build();
-    start = std::chrono::steady_clock::now();
     optimizer.iterate(*data_set);
-    auto current_duration =
-        std::chrono::duration_cast<std::chrono::nanoseconds>(
-            std::chrono::steady_clock::now() - start)
-            .count();
-    if (0.0 == avg_duration)
-      avg_duration = current_duration;
-    else
-      avg_duration = (avg_duration + current_duration) / 2.0;
 
     actual_value[1][0] =
         optimizer.get_neuron_data(1u /*past_index*/, 3u /*neuron_index*/);
@@ -1399,8 +1979,7 @@ TEST_CASE("Testing if autodiff GPU optimizer converges networks with the GPU "
     std::cout << "Target: " << data_set->get_label_sample(0u)[0] << " -?-> "
               << actual_value[1][0] << ";   "
               << data_set->get_label_sample(1u)[0] << " -?-> "
-              << actual_value[0][0] << " | avg duration: " << avg_duration
-              << "ns "
+              << actual_value[0][0]
               << " | weight_sum : " << weight_sum
               << " | iteration: " << iteration << "     ";
     ++iteration;
@@ -1526,32 +2105,20 @@ TEST_CASE(
   std::uint32_t iteration_reached_low_error =
       std::numeric_limits<std::uint32_t>::max();
   std::uint32_t iteration;
-  std::chrono::steady_clock::time_point start;
-  std::uint32_t avg_duration;
 
   train_error = 1.0;
   test_error = 1.0;
-  avg_duration = 0;
   iteration = 0;
   minimum_error = std::numeric_limits<double>::max();
 
   std::cout << "Optimizing network:" << std::endl;
   std::cout << "Training Error; \t\tTesting Error; min; \t\t avg_d_w_abs; \t\t "
-               "iteration; \t\t duration(ms); avg duration(ms)\t "
+               "iteration\t "
             << std::endl;
   while (!optimizer->stop_triggered()) {
     std::shared_ptr<rafko_net::SolutionSolver> reference_solver =
         rafko_net::SolutionSolver::Factory(network, settings).build();
-    start = std::chrono::steady_clock::now();
     optimizer->iterate(*data_set);
-    auto current_duration =
-        std::chrono::duration_cast<std::chrono::milliseconds>(
-            std::chrono::steady_clock::now() - start)
-            .count();
-    if (0.0 == avg_duration)
-      avg_duration = current_duration;
-    else
-      avg_duration = (avg_duration + current_duration) / 2.0;
 
     train_error = optimizer->get_last_training_error();
     test_error = optimizer->get_last_testing_error();
@@ -1568,7 +2135,6 @@ TEST_CASE(
     std::cout << std::setprecision(9) << train_error << ";\t\t" << test_error
               << "; " << minimum_error << ";\t\t"
               << optimizer->get_avg_of_abs_gradient() << ";\t\t" << iteration
-              << ";\t\t" << current_duration << "; " << avg_duration << "; "
               << std::flush;
     ++iteration;
     if (std::abs(test_error) <= low_error) {
@@ -1582,7 +2148,7 @@ TEST_CASE(
   }
   std::cout << std::endl
             << "Optimum reached in " << (iteration + 1)
-            << " steps!(average runtime: " << avg_duration << " ms)   "
+            << " steps!   "
             << std::endl;
 }
 
@@ -1620,7 +2186,6 @@ TEST_CASE("Testing autodiff optimizer runtime with MNIST data set",
           .set_max_solve_threads(2)
           .set_max_processing_threads(4));
 
-  auto start_time = std::chrono::steady_clock::now();
   rafko_net::RafkoNet &network =
       *rafko_net::RafkoNetBuilder(*settings)
            .input_size(mnist_input_size)
@@ -1642,11 +2207,6 @@ TEST_CASE("Testing autodiff optimizer runtime with MNIST data set",
                 {rafko_net::transfer_function_swish},
                 {rafko_net::transfer_function_swish}})
            .create_layers({25, 15, 10});
-  std::cout << "(network creation)duration: "
-            << std::chrono::duration_cast<std::chrono::milliseconds>(
-                   std::chrono::steady_clock::now() - start_time)
-                   .count()
-            << " ms" << std::endl;
 
   std::shared_ptr<rafko_gym::RafkoObjective> objective =
       std::make_shared<rafko_gym::RafkoCost>(
@@ -1688,7 +2248,6 @@ TEST_CASE("Testing autodiff optimizer runtime with MNIST data set",
   //    std::move(inputs2), std::move(labels2)
   //  );
   //  test_context->set_data_set(test_data_set);
-  start_time = std::chrono::steady_clock::now();
 #if (0) // RAFKO_USES_OPENCL)
   std::unique_ptr<rafko_gym::RafkoAutodiffGPUOptimizer> optimizer =
       (rafko_mainframe::RafkoOCLFactory()
@@ -1699,20 +2258,9 @@ TEST_CASE("Testing autodiff optimizer runtime with MNIST data set",
   std::unique_ptr<rafko_gym::RafkoAutodiffOptimizer> optimizer =
       std::make_unique<rafko_gym::RafkoAutodiffOptimizer>(settings, network);
 #endif /*(RAFKO_USES_OPENCL)*/
-  std::cout << "(optimizer creation)duration: "
-            << std::chrono::duration_cast<std::chrono::milliseconds>(
-                   std::chrono::steady_clock::now() - start_time)
-                   .count()
-            << " ms" << std::endl;
 
-  start_time = std::chrono::steady_clock::now();
   optimizer->build(data_set, objective);
   optimizer->set_training_context(context);
-  std::cout << "(optimizer build)duration: "
-            << std::chrono::duration_cast<std::chrono::milliseconds>(
-                   std::chrono::steady_clock::now() - start_time)
-                   .count()
-            << " ms" << std::endl;
   // optimizer->set_testing_context(test_context);
   optimizer->set_weight_updater(rafko_gym::weight_updater_amsgrad);
   std::vector<std::vector<double>> actual_value(2, std::vector<double>(2, 0.0));
@@ -1723,32 +2271,20 @@ TEST_CASE("Testing autodiff optimizer runtime with MNIST data set",
   // std::uint32_t iteration_reached_low_error =
   // std::numeric_limits<std::uint32_t>::max();
   std::uint32_t iteration;
-  std::chrono::steady_clock::time_point start;
-  std::uint32_t avg_duration;
 
   train_error = 1.0;
   // test_error = 1.0;
-  avg_duration = 0;
   iteration = 0;
   minimum_error = std::numeric_limits<double>::max();
 
   std::cout << "Optimizing network:" << std::endl;
   std::cout << "Training Error; \t\tTesting Error; min; \t\t avg_d_w_abs; \t\t "
-               "iteration; \t\t duration(ms); avg duration(ms)\t "
+               "iteration\t "
             << std::endl;
   while (!optimizer->stop_triggered()) {
     std::shared_ptr<rafko_net::SolutionSolver> reference_solver =
         rafko_net::SolutionSolver::Factory(network, settings).build();
-    start = std::chrono::steady_clock::now();
     optimizer->iterate(*data_set);
-    auto current_duration =
-        std::chrono::duration_cast<std::chrono::milliseconds>(
-            std::chrono::steady_clock::now() - start)
-            .count();
-    if (0.0 == avg_duration)
-      avg_duration = current_duration;
-    else
-      avg_duration = (avg_duration + current_duration) / 2.0;
 
     train_error = optimizer->get_last_training_error();
     // test_error = optimizer->get_last_testing_error();
@@ -1767,7 +2303,6 @@ TEST_CASE("Testing autodiff optimizer runtime with MNIST data set",
               // << test_error << "; "
               << minimum_error << ";\t\t"
               << optimizer->get_avg_of_abs_gradient() << ";\t\t" << iteration
-              << ";\t\t" << current_duration << "; " << avg_duration << "; "
               << std::flush;
     ++iteration;
     // if(std::abs(test_error) <= low_error){
@@ -1781,7 +2316,7 @@ TEST_CASE("Testing autodiff optimizer runtime with MNIST data set",
   }
   std::cout << std::endl
             << "Optimum reached in " << (iteration + 1)
-            << " steps!(average runtime: " << avg_duration << " ms)   "
+            << " steps!   "
             << std::endl;
 }
 
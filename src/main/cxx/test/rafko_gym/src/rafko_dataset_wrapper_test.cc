@@ -15,11 +15,16 @@
  *    <https://github.com/davids91/rafko/blob/master/LICENSE>
  */
 
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
 #include <vector>
 
 #include <catch2/catch_test_macros.hpp>
 
 #include "rafko_gym/models/rafko_dataset_implementation.hpp"
+#include "rafko_gym/models/rafko_mapped_dataset.hpp"
+#include "rafko_gym/models/rafko_streaming_dataset.hpp"
 #include "rafko_mainframe/models/rafko_settings.hpp"
 #include "rafko_protocol/rafko_net.pb.h"
 
@@ -62,4 +67,178 @@ TEST_CASE("Testing Dataset wrapper creation", "[environment][data-handling]") {
   }       /*for(10 variants)*/
 }
 
+TEST_CASE("Testing memory mapped Datasets",
+          "[environment][data-handling][mapped]") {
+  const std::filesystem::path directory =
+      std::filesystem::temp_directory_path();
+  const std::string package_file = (directory / "rafko_dataset.pb").string();
+  const std::string mapped_file = (directory / "rafko_dataset.bin").string();
+  const std::string copied_file = (directory / "rafko_dataset_copy.bin").string();
+  for (std::uint32_t variant = 0; variant < 10; ++variant) {
+    std::unique_ptr<rafko_gym::DataSetPackage> dataset(
+        rafko_test::create_dataset(
+            (rand() % 5) + 1 /* input size */, (rand() % 5) + 1, /* features */
+            (rand() % 5) + 1 /* sequences */, (rand() % 3) + 1,
+            rand() % 3 /*prefill_size*/, static_cast<double>(rand() % 10)));
+    for (double &input : *dataset->mutable_inputs())
+      input = static_cast<double>(rand() % 100) / 7.0;
+    rafko_gym::RafkoDatasetImplementation reference(*dataset);
+    {
+      std::ofstream package(package_file, std::ios::binary | std::ios::trunc);
+      REQUIRE(dataset->SerializeToOstream(&package));
+    }
+    rafko_gym::RafkoMappedDataSet::convert(package_file, mapped_file);
+    rafko_gym::RafkoMappedDataSet mapped(mapped_file);
+
+    REQUIRE(reference.get_input_size() == mapped.get_input_size());
+    REQUIRE(reference.get_feature_size() == mapped.get_feature_size());
+    REQUIRE(reference.get_sequence_size() == mapped.get_sequence_size());
+    REQUIRE(reference.get_prefill_inputs_number() ==
+            mapped.get_prefill_inputs_number());
+    REQUIRE(reference.get_number_of_sequences() ==
+            mapped.get_number_of_sequences());
+    REQUIRE(reference.get_number_of_input_samples() ==
+            mapped.get_number_of_input_samples());
+    REQUIRE(reference.get_number_of_label_samples() ==
+            mapped.get_number_of_label_samples());
+    for (std::uint32_t index = 0; index < mapped.get_number_of_input_samples();
+         ++index) {
+      REQUIRE(mapped.get_input_view(index) == reference.get_input_sample(index));
+      REQUIRE(mapped.get_input_sample(index) ==
+              reference.get_input_sample(index));
+    }
+    for (std::uint32_t index = 0; index < mapped.get_number_of_label_samples();
+         ++index) {
+      REQUIRE(mapped.get_label_view(index) == reference.get_label_sample(index));
+      REQUIRE(mapped.get_label_sample(index) ==
+              reference.get_label_sample(index));
+    }
+    REQUIRE(mapped.get_input_samples() == reference.get_input_samples());
+    REQUIRE(mapped.get_label_samples() == reference.get_label_samples());
+
+    /* A mapped data set can be written back into a file as well */
+    rafko_gym::RafkoMappedDataSet::write(mapped, copied_file);
+    rafko_gym::RafkoMappedDataSet copied(copied_file);
+    REQUIRE(copied.get_input_samples() == reference.get_input_samples());
+    REQUIRE(copied.get_label_samples() == reference.get_label_samples());
+  }
+
+  REQUIRE_THROWS_AS(rafko_gym::RafkoMappedDataSet(package_file),
+                    std::runtime_error);
+
+  { /* A header whose sample counts wrap around in 32 bits doesn't fit the
+       file, even if the wrapped sizes do */
+    const std::uint32_t wrapping_sizes[3] = {1u << 16u /* sequence size */,
+                                             0u /* prefill inputs */,
+                                             1u << 16u /* sequences */};
+    std::fstream corrupted(mapped_file,
+                           std::ios::binary | std::ios::in | std::ios::out);
+    corrupted.seekp(20); /* after the magic, version, input and feature size */
+    corrupted.write(reinterpret_cast<const char *>(wrapping_sizes),
+                    sizeof(wrapping_sizes));
+    REQUIRE(corrupted.good());
+  }
+  REQUIRE_THROWS_AS(rafko_gym::RafkoMappedDataSet(mapped_file),
+                    std::runtime_error);
+  std::filesystem::remove(package_file);
+  std::filesystem::remove(mapped_file);
+  std::filesystem::remove(copied_file);
+  REQUIRE_THROWS_AS(rafko_gym::RafkoMappedDataSet(mapped_file),
+                    std::runtime_error);
+}
+
+TEST_CASE("Testing streamed Datasets",
+          "[environment][data-handling][streaming]") {
+  using Sequence = std::pair<std::vector<std::vector<double>>,
+                             std::vector<std::vector<double>>>;
+  const std::filesystem::path directory =
+      std::filesystem::temp_directory_path();
+  const std::uint32_t input_size = (rand() % 3) + 1;
+  const std::uint32_t feature_size = (rand() % 3) + 1;
+  const std::uint32_t sequence_size = (rand() % 3) + 1;
+  const std::uint32_t prefill_size = rand() % 2;
+  std::vector<std::string> shard_files;
+  std::vector<Sequence> sequences;
+  for (std::uint32_t shard_index = 0; shard_index < 3u; ++shard_index) {
+    std::unique_ptr<rafko_gym::DataSetPackage> dataset(
+        rafko_test::create_dataset(input_size, feature_size,
+                                   (rand() % 5) + 1 /* sequences */,
+                                   sequence_size, prefill_size));
+    for (double &input : *dataset->mutable_inputs())
+      input = static_cast<double>(rand() % 1000) / 7.0;
+    shard_files.push_back(
+        (directory / ("rafko_shard_" + std::to_string(shard_index) + ".bin"))
+            .string());
+    rafko_gym::RafkoMappedDataSet::write(*dataset, shard_files.back());
+    rafko_gym::RafkoMappedDataSet shard(shard_files.back());
+    for (std::uint32_t sequence_index = 0;
+         sequence_index < shard.get_number_of_sequences(); ++sequence_index) {
+      const std::uint32_t inputs = shard.get_inputs_in_one_sequence();
+      sequences.push_back(
+          {{shard.get_input_samples().begin() + (sequence_index * inputs),
+            shard.get_input_samples().begin() + ((sequence_index + 1) * inputs)},
+           {shard.get_label_samples().begin() + (sequence_index * sequence_size),
+            shard.get_label_samples().begin() +
+                ((sequence_index + 1) * sequence_size)}});
+    }
+  }
+
+  rafko_mainframe::RafkoSettings settings;
+  settings.set_minibatch_size(2u);
+  auto sequence_at = [&](const rafko_gym::RafkoDataSet &data_set,
+                         std::uint32_t sequence_index) {
+    const std::uint32_t inputs = data_set.get_inputs_in_one_sequence();
+    Sequence result;
+    for (std::uint32_t index = 0; index < inputs; ++index)
+      result.first.push_back(
+          data_set.get_input_sample((sequence_index * inputs) + index));
+    for (std::uint32_t index = 0; index < sequence_size; ++index)
+      result.second.push_back(
+          data_set.get_label_sample((sequence_index * sequence_size) + index));
+    return result;
+  };
+
+  { /* Without shuffling, sequences follow each other as in the shards */
+    rafko_gym::RafkoStreamingDataSet stream(settings, shard_files,
+                                            2u /* prefetched batches */,
+                                            1u /* shuffle window */);
+    REQUIRE(2u == stream.get_number_of_sequences());
+    REQUIRE(sequences.size() == stream.get_number_of_sequences_overall());
+    REQUIRE(input_size == stream.get_input_size());
+    REQUIRE(feature_size == stream.get_feature_size());
+    REQUIRE(sequence_size == stream.get_sequence_size());
+    REQUIRE(prefill_size == stream.get_prefill_inputs_number());
+    for (std::uint32_t batch = 0; batch < (3u * sequences.size()); ++batch) {
+      for (std::uint32_t index = 0; index < 2u; ++index)
+        REQUIRE(sequences[((batch * 2u) + index) % sequences.size()] ==
+                sequence_at(stream, index));
+      stream.next_minibatch();
+    }
+  }
+
+  { /* Shuffled sequences still keep their inputs and labels together */
+    rafko_gym::RafkoStreamingDataSet stream(settings, shard_files, 3u, 5u,
+                                            rand());
+    std::vector<std::uint32_t> seen(sequences.size(), 0u);
+    for (std::uint32_t batch = 0; batch < (5u * sequences.size()); ++batch) {
+      for (std::uint32_t index = 0; index < 2u; ++index) {
+        auto found = std::find(sequences.begin(), sequences.end(),
+                               sequence_at(stream, index));
+        REQUIRE(found != sequences.end());
+        ++seen[std::distance(sequences.begin(), found)];
+      }
+      stream.next_minibatch();
+    }
+    REQUIRE(0u == std::count(seen.begin(), seen.end(), 0u));
+    REQUIRE(stream.get_prefetch_stalls() <= (5u * sequences.size()));
+    REQUIRE((0 == stream.get_prefetch_stalls()) ==
+            (0 == stream.get_prefetch_stall_time().count()));
+  }
+
+  for (const std::string &shard_file : shard_files)
+    std::filesystem::remove(shard_file);
+  REQUIRE_THROWS_AS(rafko_gym::RafkoStreamingDataSet(settings, shard_files),
+                    std::runtime_error);
+}
+
 } /* namespace rafko_gym_test */
@@ -0,0 +1,491 @@
+/*! This file is part of davids91/Rafko.
+ *
+ *    Rafko is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    (at your option) any later version.
+ *
+ *    Rafko is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with Rafko.  If not, see <https://www.gnu.org/licenses/> or
+ *    <https://github.com/davids91/rafko/blob/master/LICENSE>
+ */
+
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "rafko_gym/models/rafko_cost.hpp"
+#include "rafko_gym/models/rafko_dataset_implementation.hpp"
+#include "rafko_gym/services/rafko_data_parallel_optimizer.hpp"
+#include "rafko_gym/services/rafko_distributed_optimizer.hpp"
+#include "rafko_gym/services/rafko_ring_all_reduce.hpp"
+#include "rafko_gym/services/rafko_socket_transport.hpp"
+#include "rafko_mainframe/models/rafko_settings.hpp"
+#include "rafko_mainframe/services/rafko_cpu_context.hpp"
+#include "rafko_net/services/rafko_net_builder.hpp"
+#include "rafko_protocol/rafko_net.pb.h"
+
+#include "test/test_utility.hpp"
+
+namespace rafko_gym_test {
+
+namespace {
+/**
+ * @brief      Provides an address for every worker of a ring; the addresses
+ * are chosen randomly so consecutive or parallel test runs don't collide;
+ * TCP ports are below the range the system assigns to outgoing connections
+ */
+std::vector<std::string>
+ring_addresses(rafko_gym::RafkoSocketTransport::protocol_t protocol,
+               std::uint32_t world_size) {
+  static std::mt19937 generator{std::random_device{}()};
+  std::vector<std::string> addresses;
+  const std::uint32_t port = 20000u + (generator() % 12000u);
+  const std::string suffix = std::to_string(generator());
+  for (std::uint32_t rank = 0u; rank < world_size; ++rank) {
+    if (rafko_gym::RafkoSocketTransport::TCP == protocol)
+      addresses.push_back("127.0.0.1:" + std::to_string(port + rank));
+    else
+      addresses.push_back((std::filesystem::temp_directory_path() /
+                           ("rafko_ring_" + suffix + "_" +
+                            std::to_string(rank) + ".sock"))
+                              .string());
+  }
+  return addresses;
+}
+
+/**
+ * @brief      Runs every worker of a ring in its own thread; the first
+ * exception of any worker is thrown again after all of them finished
+ */
+void run_workers(std::uint32_t world_size,
+                 const std::function<void(std::uint32_t)> &worker) {
+  std::vector<std::exception_ptr> errors(world_size);
+  std::vector<std::thread> threads;
+  for (std::uint32_t rank = 0u; rank < world_size; ++rank)
+    threads.emplace_back([rank, &worker, &errors]() {
+      try {
+        worker(rank);
+      } catch (...) {
+        errors[rank] = std::current_exception();
+      }
+    });
+  for (std::thread &thread : threads)
+    thread.join();
+  for (std::exception_ptr &error : errors)
+    if (error)
+      std::rethrow_exception(error);
+}
+
+/**
+ * @brief      A data set keeping track of the sequences whose labels were read
+ */
+class RecordingDataSet : public rafko_gym::RafkoDatasetImplementation {
+public:
+  using rafko_gym::RafkoDatasetImplementation::RafkoDatasetImplementation;
+
+  SampleView get_label_view(std::uint32_t raw_label_index) const override {
+    std::lock_guard<std::mutex> my_lock(m_sequencesMutex);
+    m_sequences.insert(raw_label_index / get_sequence_size());
+    return rafko_gym::RafkoDatasetImplementation::get_label_view(
+        raw_label_index);
+  }
+
+  std::set<std::uint32_t> get_read_sequences() const {
+    std::lock_guard<std::mutex> my_lock(m_sequencesMutex);
+    return m_sequences;
+  }
+
+private:
+  mutable std::mutex m_sequencesMutex;
+  mutable std::set<std::uint32_t> m_sequences;
+};
+} /* namespace */
+
+/*###############################################################################################
+ * Testing if the ring all-reduce averages and broadcasts vectors among the
+ * workers, with both of the socket types
+ * */
+TEST_CASE("Testing ring all-reduce through sockets",
+          "[distributed][all-reduce]") {
+  constexpr std::uint32_t world_size = 3u;
+  constexpr std::uint32_t vector_size = 10u; /* not divisible by world_size */
+  for (rafko_gym::RafkoSocketTransport::protocol_t protocol :
+       {rafko_gym::RafkoSocketTransport::UnixDomain,
+        rafko_gym::RafkoSocketTransport::TCP}) {
+    const std::vector<std::string> addresses =
+        ring_addresses(protocol, world_size);
+    std::vector<std::vector<double>> averages(world_size);
+    std::vector<std::vector<double>> broadcasts(world_size);
+    run_workers(world_size, [&](std::uint32_t rank) {
+      rafko_gym::RafkoSocketTransport transport(protocol, addresses, rank,
+                                                std::chrono::seconds(10));
+      transport.connect();
+      rafko_gym::RafkoRingAllReduce all_reduce(transport);
+      averages[rank].resize(vector_size);
+      for (std::uint32_t index = 0u; index < vector_size; ++index)
+        averages[rank][index] = (100.0 * rank) + index;
+      all_reduce.average(averages[rank]);
+      broadcasts[rank] = std::vector<double>(vector_size, rank);
+      all_reduce.broadcast(broadcasts[rank], 1u /*source_rank*/);
+    });
+    for (std::uint32_t rank = 0u; rank < world_size; ++rank) {
+      for (std::uint32_t index = 0u; index < vector_size; ++index) {
+        REQUIRE(averages[rank][index] == Catch::Approx(100.0 + index));
+        REQUIRE(broadcasts[rank][index] == Catch::Approx(1.0));
+      }
+    }
+  }
+}
+
+/*###############################################################################################
+ * Testing if the socket transport sets up the ring even if a connection which
+ * never identifies itself is waiting before the previous worker, and if it
+ * refuses messages larger than the configured maximum size
+ * */
+TEST_CASE("Testing socket transport with silent connections and oversized "
+          "messages",
+          "[distributed][transport]") {
+  constexpr std::uint32_t world_size = 2u;
+  constexpr std::uint32_t max_message_size = 16u;
+  const std::vector<std::string> addresses =
+      ring_addresses(rafko_gym::RafkoSocketTransport::UnixDomain, world_size);
+  rafko_gym::RafkoSocketTransport first(
+      rafko_gym::RafkoSocketTransport::UnixDomain, addresses, 0u,
+      std::chrono::seconds(10), max_message_size);
+  rafko_gym::RafkoSocketTransport second(
+      rafko_gym::RafkoSocketTransport::UnixDomain, addresses, 1u,
+      std::chrono::seconds(10));
+
+  sockaddr_un address{};
+  address.sun_family = AF_UNIX;
+  std::strncpy(address.sun_path, addresses[0].c_str(),
+               sizeof(address.sun_path) - 1u);
+  const int silent = ::socket(AF_UNIX, SOCK_STREAM, 0);
+  REQUIRE(0 <= silent);
+  REQUIRE(0 == ::connect(silent, reinterpret_cast<const sockaddr *>(&address),
+                         sizeof(address)));
+
+  std::string received;
+  bool oversized_received = false;
+  bool oversized_sent = false;
+  run_workers(world_size, [&](std::uint32_t rank) {
+    if (0u == rank) {
+      first.connect();
+      received = first.receive_from_previous();
+      try {
+        first.receive_from_previous();
+      } catch (const std::runtime_error &) {
+        oversized_received = true;
+      }
+      try {
+        first.send_to_next(std::string(max_message_size + 1u, 'x'));
+      } catch (const std::runtime_error &) {
+        oversized_sent = true;
+      }
+    } else {
+      second.connect();
+      second.send_to_next("message");
+      second.send_to_next(std::string(max_message_size + 1u, 'x'));
+    }
+  });
+  ::close(silent);
+  REQUIRE(received == "message");
+  REQUIRE(oversized_received);
+  REQUIRE(oversized_sent);
+}
+
+/*###############################################################################################
+ * Testing if interrupting the socket transport from another thread unblocks
+ * a worker waiting for a message, while the ring is repeatedly reconnected
+ * */
+TEST_CASE("Testing if the socket transport can be interrupted from another "
+          "thread",
+          "[distributed][transport]") {
+  constexpr std::uint32_t world_size = 2u;
+  const std::vector<std::string> addresses =
+      ring_addresses(rafko_gym::RafkoSocketTransport::UnixDomain, world_size);
+  rafko_gym::RafkoSocketTransport first(
+      rafko_gym::RafkoSocketTransport::UnixDomain, addresses, 0u,
+      std::chrono::seconds(10));
+  rafko_gym::RafkoSocketTransport second(
+      rafko_gym::RafkoSocketTransport::UnixDomain, addresses, 1u,
+      std::chrono::seconds(10));
+  for (std::uint32_t round = 0u; round < 3u; ++round) {
+    bool interrupted = false;
+    run_workers(world_size, [&](std::uint32_t rank) {
+      if (0u == rank) {
+        first.connect();
+        std::thread interrupter([&first]() {
+          std::this_thread::sleep_for(std::chrono::milliseconds(50));
+          first.interrupt();
+        });
+        try {
+          first.receive_from_previous();
+        } catch (const std::runtime_error &) {
+          interrupted = true;
+        }
+        interrupter.join();
+      } else {
+        second.connect();
+      }
+    });
+    REQUIRE(interrupted);
+  }
+}
+
+/*###############################################################################################
+ * Testing if distributed training updates the weights the same way as training
+ * with the same number of replicas inside one process, and if a restarted
+ * worker rejoins the training with the weights of the other workers
+ * */
+TEST_CASE("Testing if distributed training with a ring of workers produces "
+          "the same weights as training with replicas",
+          "[optimizer][CPU][distributed]") {
+  constexpr std::uint32_t sequence_size = 3u;
+  constexpr std::uint32_t number_of_sequences = 8u;
+  constexpr std::uint32_t world_size = 2u;
+  constexpr std::uint32_t iterations = 4u;
+  /*!Note: With the minibatch covering the shard of every worker and no memory
+   * truncation the minibatches don't depend on the random numbers drawn in
+   * the worker threads */
+  const rafko_mainframe::RafkoSettings settings =
+      rafko_mainframe::RafkoSettings()
+          .set_learning_rate(0.01)
+          .set_minibatch_size(number_of_sequences / world_size)
+          .set_memory_truncation(sequence_size);
+  std::unique_ptr<rafko_net::RafkoNet> network(
+      rafko_net::RafkoNetBuilder(settings)
+          .input_size(2)
+          .expected_input_range(1.0)
+          .add_neuron_recurrence(0u, 0u, 1u)
+          .allowed_transfer_functions_by_layer(
+              {{rafko_net::transfer_function_selu},
+               {rafko_net::transfer_function_sigmoid},
+               {rafko_net::transfer_function_identity}})
+          .create_layers({2, 2, 1}));
+  auto [inputs, labels] = rafko_test::create_sequenced_addition_dataset(
+      number_of_sequences, sequence_size);
+  std::shared_ptr<rafko_gym::RafkoDatasetImplementation> data_set =
+      std::make_shared<rafko_gym::RafkoDatasetImplementation>(
+          std::move(inputs), std::move(labels), sequence_size);
+
+  /* The reference: training with replicas, keeping the weights of every
+   * iteration */
+  std::vector<std::vector<double>> expected_weights;
+  {
+    std::shared_ptr<rafko_mainframe::RafkoSettings> replica_settings =
+        std::make_shared<rafko_mainframe::RafkoSettings>(settings);
+    rafko_net::RafkoNet replicated_network(*network);
+    std::shared_ptr<rafko_gym::RafkoObjective> objective =
+        std::make_shared<rafko_gym::RafkoCost>(*replica_settings,
+                                               rafko_gym::cost_function_mse);
+    rafko_gym::RafkoDataParallelOptimizer replicated_optimizer(
+        replica_settings, replicated_network, world_size);
+    replicated_optimizer.build(data_set, objective);
+    replicated_optimizer.set_weight_updater(rafko_gym::weight_updater_adam);
+    for (std::uint32_t iteration = 0u; iteration < iterations; ++iteration) {
+      replicated_optimizer.iterate(*data_set);
+      expected_weights.emplace_back(replicated_network.weight_table().begin(),
+                                    replicated_network.weight_table().end());
+    }
+  }
+
+  /* Every worker has its own copy of everything, like separate processes */
+  struct Worker {
+    std::shared_ptr<rafko_mainframe::RafkoSettings> settings;
+    rafko_net::RafkoNet network;
+    std::shared_ptr<rafko_gym::RafkoObjective> objective;
+    std::shared_ptr<rafko_gym::RafkoDistributedOptimizer> optimizer;
+  };
+  auto start_worker = [&](rafko_gym::RafkoSocketTransport::protocol_t protocol,
+                          const std::vector<std::string> &addresses,
+                          std::uint32_t rank) {
+    std::unique_ptr<Worker> worker = std::make_unique<Worker>(
+        Worker{std::make_shared<rafko_mainframe::RafkoSettings>(settings),
+               rafko_net::RafkoNet(*network),
+               {},
+               {}});
+    if (0u < rank) /* the weights of the first worker are used */
+      for (double &weight : *worker->network.mutable_weight_table())
+        weight = 0.0;
+    worker->optimizer = std::make_shared<rafko_gym::RafkoDistributedOptimizer>(
+        worker->settings, worker->network,
+        std::make_shared<rafko_gym::RafkoSocketTransport>(
+            protocol, addresses, rank, std::chrono::seconds(10)));
+    worker->objective = std::make_shared<rafko_gym::RafkoCost>(
+        *worker->settings, rafko_gym::cost_function_mse);
+    /* The moments of Adam have to be taken over by restarted workers too */
+    worker->optimizer->set_weight_updater(rafko_gym::weight_updater_adam);
+    worker->optimizer->build(data_set, worker->objective);
+    return worker;
+  };
+  auto check_weights = [&](const std::vector<double> &weights,
+                           std::uint32_t iteration) {
+    REQUIRE(expected_weights[iteration].size() == weights.size());
+    for (std::uint32_t weight_index = 0u; weight_index < weights.size();
+         ++weight_index)
+      REQUIRE(weights[weight_index] ==
+              Catch::Approx(expected_weights[iteration][weight_index])
+                  .epsilon(0.0000000001));
+  };
+
+  for (rafko_gym::RafkoSocketTransport::protocol_t protocol :
+       {rafko_gym::RafkoSocketTransport::UnixDomain,
+        rafko_gym::RafkoSocketTransport::TCP}) {
+    const std::vector<std::string> addresses =
+        ring_addresses(protocol, world_size);
+    std::vector<std::vector<double>> final_weights(world_size);
+    run_workers(world_size, [&](std::uint32_t rank) {
+      std::unique_ptr<Worker> worker = start_worker(protocol, addresses, rank);
+      for (std::uint32_t iteration = 0u; iteration < iterations; ++iteration)
+        worker->optimizer->iterate(*data_set);
+      final_weights[rank].assign(worker->network.weight_table().begin(),
+                                 worker->network.weight_table().end());
+    });
+    for (const std::vector<double> &weights : final_weights)
+      check_weights(weights, iterations - 1u);
+  }
+
+  /* The second worker is restarted in the middle of the training */
+  const std::vector<std::string> addresses =
+      ring_addresses(rafko_gym::RafkoSocketTransport::UnixDomain, world_size);
+  std::vector<std::vector<double>> weights_before_restart;
+  std::vector<std::vector<double>> final_weights(world_size);
+  run_workers(world_size, [&](std::uint32_t rank) {
+    std::unique_ptr<Worker> worker = start_worker(
+        rafko_gym::RafkoSocketTransport::UnixDomain, addresses, rank);
+    if (0u == rank) {
+      for (std::uint32_t iteration = 0u; iteration < iterations; ++iteration)
+        worker->optimizer->iterate(*data_set);
+    } else {
+      for (std::uint32_t iteration = 0u; iteration < (iterations / 2u);
+           ++iteration)
+        worker->optimizer->iterate(*data_set);
+      weights_before_restart.emplace_back(
+          worker->network.weight_table().begin(),
+          worker->network.weight_table().end());
+      worker.reset();
+      worker = start_worker(rafko_gym::RafkoSocketTransport::UnixDomain,
+                            addresses, rank);
+      for (std::uint32_t iteration = 0u; iteration < (iterations / 2u);
+           ++iteration)
+        worker->optimizer->iterate(*data_set);
+    }
+    final_weights[rank].assign(worker->network.weight_table().begin(),
+                               worker->network.weight_table().end());
+  });
+  check_weights(weights_before_restart[0], (iterations / 2u) - 1u);
+  for (const std::vector<double> &weights : final_weights)
+    check_weights(weights, iterations - 1u);
+}
+
+/*###############################################################################################
+ * Testing if the workers train on every sequence of the data set even if the
+ * sequences are not divisible among them, and if the weights of the
+ * evaluating contexts are refreshed after the weights of the workers are
+ * synchronized
+ * */
+TEST_CASE("Testing if distributed training covers every sequence and "
+          "refreshes the contexts of joining workers",
+          "[optimizer][CPU][distributed]") {
+  constexpr std::uint32_t sequence_size = 2u;
+  constexpr std::uint32_t number_of_sequences = 5u;
+  constexpr std::uint32_t world_size = 3u;
+  const rafko_mainframe::RafkoSettings settings =
+      rafko_mainframe::RafkoSettings()
+          .set_learning_rate(0.01)
+          .set_minibatch_size(1u)
+          .set_memory_truncation(sequence_size);
+  std::unique_ptr<rafko_net::RafkoNet> network(
+      rafko_net::RafkoNetBuilder(settings)
+          .input_size(2)
+          .expected_input_range(1.0)
+          .allowed_transfer_functions_by_layer(
+              {{rafko_net::transfer_function_selu},
+               {rafko_net::transfer_function_identity}})
+          .create_layers({2, 1}));
+  auto [inputs, labels] = rafko_test::create_sequenced_addition_dataset(
+      number_of_sequences, sequence_size);
+  std::shared_ptr<RecordingDataSet> data_set =
+      std::make_shared<RecordingDataSet>(std::move(inputs), std::move(labels),
+                                         sequence_size);
+  auto [test_inputs, test_labels] =
+      rafko_test::create_sequenced_addition_dataset(number_of_sequences,
+                                                    sequence_size);
+  std::shared_ptr<rafko_gym::RafkoDatasetImplementation> test_set =
+      std::make_shared<rafko_gym::RafkoDatasetImplementation>(
+          std::move(test_inputs), std::move(test_labels), sequence_size);
+  std::shared_ptr<rafko_mainframe::RafkoSettings> reference_settings =
+      std::make_shared<rafko_mainframe::RafkoSettings>(settings);
+  rafko_mainframe::RafkoCPUContext reference_context(*network,
+                                                     reference_settings);
+  const std::vector<double> reference_output =
+      reference_context.solve({0.5, 0.25}).acquire();
+
+  const std::vector<std::string> addresses = ring_addresses(
+      rafko_gym::RafkoSocketTransport::UnixDomain, world_size);
+  std::vector<std::vector<double>> context_outputs(world_size);
+  run_workers(world_size, [&](std::uint32_t rank) {
+    std::shared_ptr<rafko_mainframe::RafkoSettings> worker_settings =
+        std::make_shared<rafko_mainframe::RafkoSettings>(settings);
+    rafko_net::RafkoNet worker_network(*network);
+    if (0u < rank) /* the weights of the first worker are used */
+      for (double &weight : *worker_network.mutable_weight_table())
+        weight = 0.0;
+    std::shared_ptr<rafko_gym::RafkoObjective> objective =
+        std::make_shared<rafko_gym::RafkoCost>(*worker_settings,
+                                               rafko_gym::cost_function_mse);
+    std::shared_ptr<rafko_mainframe::RafkoCPUContext> test_context =
+        std::make_shared<rafko_mainframe::RafkoCPUContext>(
+            worker_network, worker_settings, objective);
+    test_context->set_data_set(test_set);
+    rafko_gym::RafkoDistributedOptimizer optimizer(
+        worker_settings, worker_network,
+        std::make_shared<rafko_gym::RafkoSocketTransport>(
+            rafko_gym::RafkoSocketTransport::UnixDomain, addresses, rank,
+            std::chrono::seconds(10)),
+        {}, test_context);
+    optimizer.set_weight_updater(rafko_gym::weight_updater_default);
+    optimizer.build(data_set, objective);
+    context_outputs[rank] = test_context->solve({0.5, 0.25}).acquire();
+    for (std::uint32_t iteration = 0u; iteration < 30u; ++iteration)
+      optimizer.iterate(*data_set);
+  });
+
+  for (const std::vector<double> &output : context_outputs) {
+    REQUIRE(output.size() == reference_output.size());
+    for (std::uint32_t index = 0u; index < output.size(); ++index)
+      REQUIRE(output[index] ==
+              Catch::Approx(reference_output[index]).epsilon(0.0000000001));
+  }
+  /*!Note: Every worker draws from a shard of at most 2 sequences 30 times */
+  const std::set<std::uint32_t> read_sequences = data_set->get_read_sequences();
+  for (std::uint32_t sequence_index = 0u;
+       sequence_index < number_of_sequences; ++sequence_index)
+    REQUIRE(0u < read_sequences.count(sequence_index));
+}
+
+} /* namespace rafko_gym_test */
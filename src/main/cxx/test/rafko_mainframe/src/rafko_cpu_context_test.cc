@@ -553,4 +553,86 @@ TEST_CASE("Testing is solve is working as expected in CPU context for isolated "
   }
 }
 
+TEST_CASE("Testing if CPU context keeps the Neuron memory of a non-isolated "
+          "environment solve",
+          "[context][CPU][solve]") {
+  constexpr const std::uint32_t sample_number = 5;
+  constexpr const std::uint32_t sequence_size = 6;
+  constexpr const std::uint32_t thread_number = 4;
+  google::protobuf::Arena arena;
+
+  std::shared_ptr<rafko_mainframe::RafkoSettings> settings =
+      std::make_shared<rafko_mainframe::RafkoSettings>(
+          rafko_mainframe::RafkoSettings()
+              .set_max_processing_threads(thread_number)
+              .set_memory_truncation(sequence_size)
+              .set_arena_ptr(&arena)
+              .set_minibatch_size(3));
+
+  rafko_net::RafkoNet &network =
+      *rafko_net::RafkoNetBuilder(*settings)
+           .input_size(2)
+           .expected_input_range(1.0)
+           .add_neuron_recurrence(0u, 0u, 1u)
+           .add_neuron_recurrence(0u, 1u, 2u)
+           .allowed_transfer_functions_by_layer({
+               {rafko_net::transfer_function_identity},
+               {rafko_net::transfer_function_sigmoid},
+               {rafko_net::transfer_function_tanh},
+           })
+           .create_layers({2, 2, 1});
+  auto [inputs, labels] = rafko_test::create_sequenced_addition_dataset(
+      sample_number, sequence_size);
+  std::shared_ptr<rafko_gym::RafkoDatasetImplementation> environment =
+      std::make_shared<rafko_gym::RafkoDatasetImplementation>(
+          std::move(inputs), std::move(labels), sequence_size);
+
+  rafko_mainframe::RafkoCPUContext context(network, settings);
+  context.set_data_set(environment);
+  std::vector<std::vector<double>> context_result(
+      (thread_number * environment->get_sequence_size()),
+      std::vector<double>(network.output_neuron_number()));
+  context.solve_data_set(context_result, false /* isolated */);
+
+  /* Every thread solved the sequence under its index, so continuing the run
+   * in the thread should continue from the state of that sequence */
+  const std::vector<double> next_input(network.input_data_size(), 0.5);
+  for (std::uint32_t thread_index = 0u; thread_index < thread_number;
+       ++thread_index) {
+    std::shared_ptr<rafko_net::SolutionSolver> reference_solver =
+        rafko_net::SolutionSolver::Factory(network, settings).build();
+    reference_solver->set_eval_mode(false);
+    std::uint32_t raw_inputs_index =
+        thread_index * (environment->get_sequence_size() +
+                        environment->get_prefill_inputs_number());
+    for (std::uint32_t step = 0u;
+         step < (environment->get_sequence_size() +
+                 environment->get_prefill_inputs_number());
+         ++step) {
+      std::vector<double> reference_output =
+          reference_solver
+              ->solve(environment->get_input_sample(raw_inputs_index),
+                      (0u == step))
+              .acquire();
+      if (environment->get_prefill_inputs_number() <= step)
+        REQUIRE_THAT(
+            reference_output,
+            Catch::Matchers::Approx(
+                context_result[(thread_index *
+                                environment->get_sequence_size()) +
+                               step -
+                               environment->get_prefill_inputs_number()])
+                .margin(0.0000000000001));
+      ++raw_inputs_index;
+    }
+    std::vector<double> reference_continued =
+        reference_solver->solve(next_input).acquire();
+    std::vector<double> context_continued =
+        context.solve(next_input, false, thread_index).acquire();
+    REQUIRE_THAT(reference_continued,
+                 Catch::Matchers::Approx(context_continued)
+                     .margin(0.0000000000001));
+  }
+}
+
 } // namespace rafko_gym_test
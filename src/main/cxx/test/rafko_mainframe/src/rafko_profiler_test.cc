@@ -0,0 +1,134 @@
+/*! This file is part of davids91/Rafko.
+ *
+ *    Rafko is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    (at your option) any later version.
+ *
+ *    Rafko is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with Rafko.  If not, see <https://www.gnu.org/licenses/> or
+ *    <https://github.com/davids91/rafko/blob/master/LICENSE>
+ */
+#include <catch2/catch_test_macros.hpp>
+
+#include <chrono>
+#include <numeric>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include "rafko_mainframe/services/rafko_profiler.hpp"
+#include "rafko_utilities/services/thread_group.hpp"
+#include "rafko_utilities/services/work_stealing_pool.hpp"
+
+#include "test/test_utility.hpp"
+
+namespace rafko_mainframe_test {
+
+namespace {
+rafko_mainframe::RafkoProfiler::PhaseStatistics
+get_statistics_of(const std::string &name) {
+  for (const auto &phase :
+       rafko_mainframe::RafkoProfiler::get_phase_statistics())
+    if (phase.name == name)
+      return phase;
+  return {};
+}
+
+std::uint32_t count_occurences(const std::string &text,
+                               const std::string &pattern) {
+  std::uint32_t count = 0u;
+  for (std::size_t position = text.find(pattern);
+       position != std::string::npos;
+       position = text.find(pattern, position + pattern.size()))
+    ++count;
+  return count;
+}
+} /* namespace */
+
+TEST_CASE("Testing the phase profiler", "[profiler]") {
+  constexpr std::uint32_t threads = 3u;
+  constexpr std::uint32_t scopes_in_thread = 10u;
+  rafko_mainframe::RafkoProfiler::reset();
+
+  std::vector<std::thread> workers;
+  for (std::uint32_t thread_index = 0u; thread_index < threads;
+       ++thread_index) {
+    workers.emplace_back([]() {
+      for (std::uint32_t i = 0u; i < scopes_in_thread; ++i) {
+        RFPROFILE_SCOPE("profiler_test::outer");
+        {
+          RFPROFILE_SCOPE("profiler_test::inner");
+          std::this_thread::sleep_for(std::chrono::microseconds(10));
+        }
+      }
+    });
+  }
+  for (std::thread &worker : workers)
+    worker.join();
+
+  const auto outer = get_statistics_of("profiler_test::outer");
+  const auto inner = get_statistics_of("profiler_test::inner");
+  REQUIRE(outer.count == (threads * scopes_in_thread));
+  REQUIRE(inner.count == (threads * scopes_in_thread));
+  REQUIRE(inner.total <= outer.total);
+  REQUIRE(std::chrono::microseconds(10) <= inner.min);
+  REQUIRE(inner.min <= inner.max);
+  REQUIRE(outer.count == std::accumulate(outer.histogram.begin(),
+                                         outer.histogram.end(),
+                                         std::uint64_t(0u)));
+
+  /* Scopes started while the profiler is disabled are not recorded */
+  rafko_mainframe::RafkoProfiler::set_enabled(false);
+  { RFPROFILE_SCOPE("profiler_test::outer"); }
+  rafko_mainframe::RafkoProfiler::set_enabled(true);
+  REQUIRE(get_statistics_of("profiler_test::outer").count == outer.count);
+
+  std::stringstream trace;
+  rafko_mainframe::RafkoProfiler::export_chrome_trace(trace);
+  REQUIRE(0u == trace.str().find("{\"traceEvents\":[{\"name\":"));
+  REQUIRE((threads * scopes_in_thread) ==
+          count_occurences(trace.str(),
+                           "{\"name\":\"profiler_test::outer\",\"ph\":\"X\""));
+  REQUIRE((threads * scopes_in_thread) ==
+          count_occurences(trace.str(),
+                           "{\"name\":\"profiler_test::inner\",\"ph\":\"X\""));
+
+  std::stringstream statistics;
+  rafko_mainframe::RafkoProfiler::export_phase_statistics(statistics);
+  const std::string inner_statistics =
+      "{\"name\":\"profiler_test::inner\",\"count\":" +
+      std::to_string(inner.count) + ",";
+  REQUIRE(1u == count_occurences(statistics.str(), inner_statistics));
+
+  rafko_mainframe::RafkoProfiler::reset();
+  REQUIRE(0u == get_statistics_of("profiler_test::outer").count);
+  trace.str("");
+  rafko_mainframe::RafkoProfiler::export_chrome_trace(trace);
+  REQUIRE(0u == count_occurences(trace.str(), "profiler_test::outer"));
+}
+
+TEST_CASE("Testing if the thread pools profile their dispatch and wait",
+          "[profiler]") {
+  rafko_mainframe::RafkoProfiler::reset();
+  for (rafko_utilities::ThreadGroup::synchronization_t synchronization :
+       {rafko_utilities::ThreadGroup::Blocking,
+        rafko_utilities::ThreadGroup::SpinThenPark}) {
+    rafko_utilities::ThreadGroup group(2u, synchronization);
+    group.start_and_block([](std::uint32_t) {});
+  }
+  REQUIRE(2u == get_statistics_of("ThreadGroup::dispatch").count);
+  REQUIRE(2u == get_statistics_of("ThreadGroup::wait").count);
+
+  rafko_utilities::WorkStealingPool pool(2u);
+  pool.parallel_for(0u, 16u, [](std::uint32_t) {});
+  REQUIRE(0u < get_statistics_of("WorkStealingPool::dispatch").count);
+  rafko_mainframe::RafkoProfiler::reset();
+}
+
+} /* namespace rafko_mainframe_test */
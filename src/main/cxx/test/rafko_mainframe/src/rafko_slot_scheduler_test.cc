@@ -0,0 +1,285 @@
+/*! This file is part of davids91/Rafko.
+ *
+ *    Rafko is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    (at your option) any later version.
+ *
+ *    Rafko is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with Rafko.  If not, see <https://www.gnu.org/licenses/> or
+ *    <https://github.com/davids91/rafko/blob/master/LICENSE>
+ */
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <chrono>
+#include <cmath>
+#include <exception>
+#include <future>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "rafko_mainframe/models/rafko_settings.hpp"
+#include "rafko_mainframe/services/rafko_slot_scheduler.hpp"
+#include "rafko_net/services/rafko_net_builder.hpp"
+#include "rafko_net/services/solution_solver.hpp"
+#include "rafko_protocol/deep_learning_service.pb.h"
+
+#include "test/test_utility.hpp"
+
+namespace rafko_mainframe_test {
+
+namespace {
+rafko_mainframe::SlotResponse
+request_from(rafko_mainframe::RafkoSlotScheduler &scheduler,
+             const rafko_mainframe::SlotRequest &request) {
+  std::promise<rafko_mainframe::SlotResponse> response;
+  scheduler.request(request, [&response](
+                                 const rafko_mainframe::SlotResponse &result,
+                                 std::exception_ptr error) {
+    if (error)
+      response.set_exception(error);
+    else
+      response.set_value(result);
+  });
+  return response.get_future().get();
+}
+
+rafko_mainframe::SlotRequest make_request(const std::string &slot_id,
+                                          std::uint32_t actions) {
+  rafko_mainframe::SlotRequest request;
+  request.set_target_slot_id(slot_id);
+  request.set_request_bitstring(actions);
+  return request;
+}
+
+double get_info_of(rafko_mainframe::RafkoSlotScheduler &scheduler,
+                   const std::string &slot_id,
+                   rafko_mainframe::Slot_info_field field) {
+  rafko_mainframe::SlotInfo info = scheduler.get_slot(slot_id)->get_info(field);
+  REQUIRE(1 == info.info_package_size());
+  CHECK(field == info.info_field(0));
+  return info.info_package(0);
+}
+
+/* Sequences of one step, each summing up its two inputs */
+rafko_mainframe::NeuralIOStream
+create_addition_stream(std::uint32_t sequence_count) {
+  rafko_mainframe::NeuralIOStream stream;
+  stream.set_sequence_size(1u);
+  stream.set_input_size(2u);
+  stream.set_label_size(1u);
+  for (std::uint32_t sequence = 0u; sequence < sequence_count; ++sequence) {
+    const double first = static_cast<double>(rand() % 100) / 100.0;
+    const double second = static_cast<double>(rand() % 100) / 100.0;
+    stream.add_package(first);
+    stream.add_package(second);
+    stream.add_package(first + second);
+  }
+  return stream;
+}
+} /* namespace */
+
+TEST_CASE("Testing run slots of the slot scheduler", "[service][slot]") {
+  rafko_mainframe::RafkoSlotScheduler scheduler(2u);
+  rafko_mainframe::ServiceSlot description;
+  description.set_type(rafko_mainframe::serv_slot_to_run);
+  rafko_mainframe::SlotResponse added = scheduler.add_slot(description);
+  REQUIRE_FALSE(added.slot_id().empty());
+  REQUIRE(0u != (added.slot_state() & rafko_mainframe::serv_slot_missing_net));
+  REQUIRE(1u == scheduler.get_slot_count());
+
+  /* Running a slot without a network fails */
+  rafko_mainframe::SlotRequest run_request =
+      make_request(added.slot_id(), rafko_mainframe::serv_slot_to_run_once);
+  *run_request.mutable_data_stream() = create_addition_stream(5u);
+  REQUIRE_THROWS_AS(request_from(scheduler, run_request), std::runtime_error);
+
+  rafko_mainframe::BuildNetworkRequest network_request;
+  network_request.set_target_slot_id(added.slot_id());
+  network_request.set_input_size(2u);
+  network_request.set_expected_input_range(1.0);
+  network_request.add_layer_sizes(3u);
+  network_request.add_layer_sizes(1u);
+  network_request.add_allowed_transfers_by_layer(
+      rafko_net::transfer_function_selu);
+  network_request.add_allowed_transfers_by_layer(
+      rafko_net::transfer_function_identity);
+  REQUIRE(rafko_mainframe::serv_slot_ok ==
+          scheduler.get_slot(added.slot_id())->build_network(network_request));
+
+  /* Every sequence is solved from scratch, as it would be by a solver */
+  rafko_mainframe::SlotResponse response =
+      request_from(scheduler, run_request);
+  CHECK(added.slot_id() == response.slot_id());
+  CHECK(rafko_mainframe::serv_slot_ok == response.slot_state());
+  REQUIRE(5 == response.data_stream().package_size());
+  rafko_net::RafkoNet network =
+      scheduler.get_slot(added.slot_id())->get_network();
+  std::shared_ptr<rafko_mainframe::RafkoSettings> settings =
+      std::make_shared<rafko_mainframe::RafkoSettings>();
+  rafko_net::SolutionSolver::Factory reference_solver_factory(network,
+                                                              settings);
+  std::shared_ptr<rafko_net::SolutionSolver> reference_solver =
+      reference_solver_factory.build();
+  for (std::uint32_t sequence = 0u; sequence < 5u; ++sequence) {
+    const std::vector<double> input{
+        run_request.data_stream().package(sequence * 3u),
+        run_request.data_stream().package(sequence * 3u + 1u)};
+    CHECK(Catch::Approx(reference_solver->solve(input, true)[0])
+              .epsilon(1e-10) == response.data_stream().package(sequence));
+  }
+
+  /* Actions not supported by run slots are rejected */
+  REQUIRE_THROWS_AS(
+      request_from(scheduler,
+                   make_request(added.slot_id(),
+                                rafko_mainframe::serv_slot_to_start)),
+      std::runtime_error);
+  REQUIRE_THROWS_AS(
+      request_from(scheduler,
+                   make_request(added.slot_id(),
+                                rafko_mainframe::serv_slot_to_distill_network)),
+      std::runtime_error);
+
+  /* Another run slot can take over the network */
+  rafko_mainframe::SlotResponse copy = scheduler.add_slot(description);
+  REQUIRE(copy.slot_id() != added.slot_id());
+  rafko_mainframe::SlotRequest takeover_request =
+      make_request(copy.slot_id(), rafko_mainframe::serv_slot_to_takeover_net |
+                                       rafko_mainframe::serv_slot_to_run_once);
+  takeover_request.set_source_slot_id(added.slot_id());
+  *takeover_request.mutable_data_stream() = run_request.data_stream();
+  rafko_mainframe::SlotResponse copy_response =
+      request_from(scheduler, takeover_request);
+  CHECK(rafko_mainframe::serv_slot_ok == copy_response.slot_state());
+  for (std::uint32_t sequence = 0u; sequence < 5u; ++sequence)
+    CHECK(Catch::Approx(response.data_stream().package(sequence))
+              .epsilon(1e-10) == copy_response.data_stream().package(sequence));
+
+  REQUIRE_NOTHROW(request_from(
+      scheduler,
+      make_request(added.slot_id(), rafko_mainframe::serv_slot_to_die)));
+  REQUIRE_NOTHROW(request_from(
+      scheduler,
+      make_request(copy.slot_id(), rafko_mainframe::serv_slot_to_die)));
+  REQUIRE(0u == scheduler.get_slot_count());
+  REQUIRE_THROWS_AS(request_from(scheduler, run_request), std::runtime_error);
+}
+
+TEST_CASE("Testing the time sliced training of optimizer slots",
+          "[service][slot][scheduler]") {
+  constexpr std::uint32_t slot_count = 3u;
+  /* One worker for every slot would not test the time slices */
+  rafko_mainframe::RafkoSlotScheduler scheduler(1u,
+                                                std::chrono::milliseconds(2));
+  rafko_mainframe::RafkoSettings settings;
+  rafko_mainframe::ServiceSlot description;
+  description.set_type(rafko_mainframe::serv_slot_to_optimize);
+  description.set_cost_function(rafko_gym::cost_function_squared_error);
+  description.set_weight_updater(rafko_gym::weight_updater_default);
+  description.mutable_hypers()->set_learning_rate(0.01);
+  description.mutable_hypers()->set_minibatch_size(8u);
+  description.mutable_hypers()->set_memory_truncation(1u);
+  description.mutable_hypers()->set_training_relevant_loop_count(10);
+  description.set_allocated_network(
+      rafko_net::RafkoNetBuilder(settings)
+          .input_size(2u)
+          .expected_input_range(1.0)
+          .allowed_transfer_functions_by_layer(
+              {{rafko_net::transfer_function_identity}})
+          .create_layers(nullptr, {1u}));
+
+  std::vector<std::string> slot_ids;
+  std::vector<double> initial_errors;
+  for (std::uint32_t slot_index = 0u; slot_index < slot_count; ++slot_index) {
+    rafko_mainframe::SlotResponse added = scheduler.add_slot(description);
+    REQUIRE(0u !=
+            (added.slot_state() & rafko_mainframe::serv_slot_missing_data_set));
+    /* Starting a slot without a data set fails */
+    REQUIRE_THROWS_AS(
+        request_from(scheduler,
+                     make_request(added.slot_id(),
+                                  rafko_mainframe::serv_slot_to_start)),
+        std::runtime_error);
+    rafko_mainframe::SlotRequest data_request = make_request(
+        added.slot_id(), rafko_mainframe::serv_slot_to_takeover_training_set |
+                             rafko_mainframe::serv_slot_to_append_test_set);
+    *data_request.mutable_data_stream() = create_addition_stream(32u);
+    REQUIRE(rafko_mainframe::serv_slot_ok ==
+            request_from(scheduler, data_request).slot_state());
+
+    /* The appended sequences can be queried back */
+    rafko_mainframe::SlotRequest sample_request = make_request(
+        added.slot_id(), rafko_mainframe::serv_slot_to_get_training_sample);
+    sample_request.set_request_index(7u);
+    rafko_mainframe::NeuralIOStream sample =
+        request_from(scheduler, sample_request).data_stream();
+    REQUIRE(3 == sample.package_size());
+    for (std::uint32_t value = 0u; value < 3u; ++value)
+      CHECK(data_request.data_stream().package(7u * 3u + value) ==
+            sample.package(value));
+
+    slot_ids.push_back(added.slot_id());
+    initial_errors.push_back(get_info_of(
+        scheduler, added.slot_id(), rafko_mainframe::slot_info_training_error));
+    CHECK(32.0 == get_info_of(scheduler, added.slot_id(),
+                              rafko_mainframe::
+                                  slot_info_training_set_sequence_count));
+  }
+
+  for (const std::string &slot_id : slot_ids)
+    REQUIRE(rafko_mainframe::serv_slot_ok ==
+            request_from(scheduler, make_request(
+                                        slot_id,
+                                        rafko_mainframe::serv_slot_to_start))
+                .slot_state());
+
+  /* Every running slot gets its turn on the single worker */
+  const std::chrono::steady_clock::time_point deadline =
+      std::chrono::steady_clock::now() + std::chrono::seconds(60);
+  bool every_slot_trained = false;
+  while (!every_slot_trained &&
+         (std::chrono::steady_clock::now() < deadline)) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    every_slot_trained = true;
+    for (const std::string &slot_id : slot_ids)
+      every_slot_trained &= (200.0 <= get_info_of(scheduler, slot_id,
+                                                  rafko_mainframe::
+                                                      slot_info_iteration));
+  }
+  REQUIRE(every_slot_trained);
+
+  for (std::uint32_t slot_index = 0u; slot_index < slot_count; ++slot_index) {
+    request_from(scheduler, make_request(slot_ids[slot_index],
+                                         rafko_mainframe::serv_slot_to_stop));
+    REQUIRE_FALSE(scheduler.get_slot(slot_ids[slot_index])->is_running());
+    const double iteration = get_info_of(scheduler, slot_ids[slot_index],
+                                         rafko_mainframe::slot_info_iteration);
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    CHECK(iteration == get_info_of(scheduler, slot_ids[slot_index],
+                                   rafko_mainframe::slot_info_iteration));
+    const double training_error =
+        get_info_of(scheduler, slot_ids[slot_index],
+                    rafko_mainframe::slot_info_training_error);
+    CHECK(std::isfinite(training_error));
+    CHECK(training_error < initial_errors[slot_index]);
+    CHECK(std::isfinite(get_info_of(scheduler, slot_ids[slot_index],
+                                    rafko_mainframe::slot_info_test_error)));
+  }
+
+  /* A slot can be removed while it's being trained */
+  request_from(scheduler,
+               make_request(slot_ids[0], rafko_mainframe::serv_slot_to_start));
+  REQUIRE_NOTHROW(request_from(
+      scheduler, make_request(slot_ids[0], rafko_mainframe::serv_slot_to_die)));
+  REQUIRE((slot_count - 1u) == scheduler.get_slot_count());
+}
+
+} /* namespace rafko_mainframe_test */
@@ -32,6 +32,7 @@
 #include "rafko_net/services/synapse_iterator.hpp"
 #include "rafko_protocol/rafko_net.pb.h"
 #include "rafko_protocol/solution.pb.h"
+#include "rafko_utilities/services/work_stealing_pool.hpp"
 #if (RAFKO_USES_OPENCL)
 #include "rafko_mainframe/services/rafko_gpu_context.hpp"
 #include "rafko_mainframe/services/rafko_ocl_factory.hpp"
@@ -107,10 +108,9 @@ TEST_CASE("Test if L1 regularization calculates the expected error",
     } /*for(the affected layers)*/
 
     /* declare an executor */
-    std::vector<std::unique_ptr<rafko_utilities::ThreadGroup>> exec_threads;
-    exec_threads.push_back(std::make_unique<rafko_utilities::ThreadGroup>(
-        settings.get_max_processing_threads()));
-    rafko_net::RafkoNetworkFeature features(exec_threads);
+    rafko_utilities::WorkStealingPool thread_pool(
+        settings.get_max_processing_threads());
+    rafko_net::RafkoNetworkFeature features(thread_pool);
 
     for (const rafko_net::FeatureGroup &group :
          network.neuron_group_features()) {
@@ -193,10 +193,9 @@ TEST_CASE("Test if L2 regularization calculates the expected error",
     } /*for(the affected layers)*/
 
     /* create a feature executor */
-    std::vector<std::unique_ptr<rafko_utilities::ThreadGroup>> exec_threads;
-    exec_threads.push_back(std::make_unique<rafko_utilities::ThreadGroup>(
-        settings.get_max_processing_threads()));
-    rafko_net::RafkoNetworkFeature features(exec_threads);
+    rafko_utilities::WorkStealingPool thread_pool(
+        settings.get_max_processing_threads());
+    rafko_net::RafkoNetworkFeature features(thread_pool);
 
     for (const rafko_net::FeatureGroup &group :
          network.neuron_group_features()) {
@@ -249,10 +248,9 @@ TEST_CASE("Test if L1 and L2 regularization errors are added correctly to CPU "
     rafko_net::RafkoNet unregulated_network = rafko_net::RafkoNet(network);
 
     /* declare an executor */
-    std::vector<std::unique_ptr<rafko_utilities::ThreadGroup>> exec_threads;
-    exec_threads.push_back(std::make_unique<rafko_utilities::ThreadGroup>(
-        settings->get_max_processing_threads()));
-    rafko_net::RafkoNetworkFeature features(exec_threads);
+    rafko_utilities::WorkStealingPool thread_pool(
+        settings->get_max_processing_threads());
+    rafko_net::RafkoNetworkFeature features(thread_pool);
 
     /* Remove weight regularization from a copy network, and calculate the error
      * difference */
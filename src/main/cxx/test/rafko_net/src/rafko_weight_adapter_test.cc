@@ -17,6 +17,7 @@
 #include <catch2/catch_approx.hpp>
 #include <catch2/catch_test_macros.hpp>
 #include <memory>
+#include <set>
 #include <vector>
 
 #include "rafko_gym/services/rafko_weight_adapter.hpp"
@@ -69,4 +70,61 @@ TEST_CASE(
   }
 }
 
+TEST_CASE("Testing if weight adapter only updates the changed weights",
+          "[weight-adapter][weight-update]") {
+  rafko_mainframe::RafkoSettings settings =
+      rafko_mainframe::RafkoSettings()
+          .set_max_solve_threads(4)
+          .set_device_max_megabytes(0.0005);
+  std::unique_ptr<rafko_net::RafkoNet> net(rafko_net::RafkoNetBuilder(settings)
+                                               .input_size(5)
+                                               .expected_input_range((5.0))
+                                               .create_layers({8, 6, 4, 2}));
+  std::unique_ptr<rafko_net::Solution> solution =
+      std::unique_ptr<rafko_net::Solution>(
+          rafko_net::SolutionBuilder(settings).build(*net));
+  rafko_gym::RafkoWeightAdapter weight_adapter(*net, *solution, settings);
+  REQUIRE(1 < solution->partial_solutions_size());
+
+  /* The first update covers every weight */
+  std::uint32_t weight_table_size = 0u;
+  std::uint32_t reported_size = 0u;
+  for (const rafko_net::PartialSolution &partial :
+       solution->partial_solutions())
+    weight_table_size += partial.weight_table_size();
+  for (const rafko_gym::WeightTableRange &range :
+       weight_adapter.update_solution_with_weights())
+    reported_size += range.size;
+  REQUIRE(weight_table_size == reported_size);
+  REQUIRE(0u == weight_adapter.update_solution_with_weights().size());
+
+  /* Changed weights are reported in every partial they are used in */
+  srand(time(nullptr));
+  for (std::uint32_t variant = 0; variant < 10; ++variant) {
+    std::set<std::pair<std::uint32_t, std::uint32_t>> expected_slots;
+    for (std::uint32_t changed = 0; changed < (variant + 1u); ++changed) {
+      std::uint32_t weight_index = rand() % (net->weight_table_size());
+      net->set_weight_table(weight_index, net->weight_table(weight_index) +
+                                              (1.0 + (rand() % 10)));
+      for (const std::pair<std::uint32_t, std::uint32_t> &slot :
+           weight_adapter.get_weight_slots_for(weight_index))
+        expected_slots.insert(slot);
+    }
+    std::set<std::pair<std::uint32_t, std::uint32_t>> reported_slots;
+    for (const rafko_gym::WeightTableRange &range :
+         weight_adapter.update_solution_with_weights()) {
+      std::uint32_t global_start = 0u;
+      for (std::uint32_t partial_index = 0u;
+           partial_index < range.partial_index; ++partial_index)
+        global_start += solution->partial_solutions(partial_index)
+                            .weight_table_size();
+      REQUIRE(global_start + range.start == range.global_start);
+      for (std::uint32_t index = 0u; index < range.size; ++index)
+        reported_slots.insert({range.partial_index, range.start + index});
+    }
+    REQUIRE(expected_slots == reported_slots);
+    rafko_test::check_if_the_same(*net, *solution);
+  }
+}
+
 } /* namespace rafko_gym_test */
@@ -20,6 +20,7 @@
 #include <vector>
 
 #include "rafko_gym/services/rafko_weight_updater.hpp"
+#include "rafko_gym/services/updater_factory.hpp"
 #include "rafko_mainframe/models/rafko_settings.hpp"
 #include "rafko_net/services/rafko_net_builder.hpp"
 #include "rafko_net/services/solution_builder.hpp"
@@ -76,4 +77,100 @@ TEST_CASE("Testing if weight updater updates weights of a solution "
   }
 }
 
+TEST_CASE("Testing if weight updaters update weights the same way when "
+          "the update is split between threads",
+          "[weight_updater][weight-update][multithread]") {
+  rafko_mainframe::RafkoSettings settings =
+      rafko_mainframe::RafkoSettings().set_learning_rate(0.01);
+  rafko_mainframe::RafkoSettings threaded_settings =
+      rafko_mainframe::RafkoSettings(settings).set_max_solve_threads(4);
+  settings.set_max_solve_threads(1);
+  std::unique_ptr<rafko_net::RafkoNet> network(
+      rafko_net::RafkoNetBuilder(settings)
+          .input_size(64)
+          .expected_input_range((1.0))
+          .create_layers({128, 128, 4}));
+  REQUIRE(16384 < network->weight_table_size());
+
+  for (rafko_gym::Weight_updaters updater_type :
+       {rafko_gym::weight_updater_default, rafko_gym::weight_updater_momentum,
+        rafko_gym::weight_updater_nesterovs, rafko_gym::weight_updater_adam,
+        rafko_gym::weight_updater_amsgrad}) {
+    rafko_net::RafkoNet threaded_network(*network);
+    rafko_net::RafkoNet serial_network(*network);
+    std::unique_ptr<rafko_gym::RafkoWeightUpdater> threaded_updater =
+        rafko_gym::UpdaterFactory::build_weight_updater(
+            threaded_network, updater_type, threaded_settings);
+    std::unique_ptr<rafko_gym::RafkoWeightUpdater> serial_updater =
+        rafko_gym::UpdaterFactory::build_weight_updater(
+            serial_network, updater_type, settings);
+    for (std::uint32_t variant = 0; variant < 5; ++variant) {
+      std::vector<double> gradients(network->weight_table_size());
+      std::generate(gradients.begin(), gradients.end(), []() {
+        return static_cast<double>(rand() % 100) / (100.0) - (0.5);
+      });
+      if (threaded_updater->is_finished())
+        threaded_updater->start();
+      if (serial_updater->is_finished())
+        serial_updater->start();
+      threaded_updater->iterate(gradients);
+      serial_updater->iterate(gradients);
+      REQUIRE(threaded_updater->is_finished() ==
+              serial_updater->is_finished());
+      for (std::int32_t i = 0; i < network->weight_table_size(); ++i) {
+        REQUIRE(threaded_network.weight_table(i) ==
+                serial_network.weight_table(i));
+        REQUIRE(threaded_updater->get_current_velocity(i) ==
+                serial_updater->get_current_velocity(i));
+      }
+    }
+  }
+}
+
+TEST_CASE("Testing if Adam weight updater follows its formula",
+          "[weight_updater][weight-update][adam]") {
+  rafko_mainframe::RafkoSettings settings =
+      rafko_mainframe::RafkoSettings().set_learning_rate(0.01);
+  std::unique_ptr<rafko_net::RafkoNet> network(
+      rafko_net::RafkoNetBuilder(settings)
+          .input_size(5)
+          .expected_input_range((5.0))
+          .create_layers({2, 4, 3}));
+  std::unique_ptr<rafko_gym::RafkoWeightUpdater> weight_updater =
+      rafko_gym::UpdaterFactory::build_weight_updater(
+          *network, rafko_gym::weight_updater_adam, settings);
+  std::vector<double> mean(network->weight_table_size(), (0.0));
+  std::vector<double> variance(network->weight_table_size(), (0.0));
+  for (std::uint32_t iteration = 1; iteration <= 10; ++iteration) {
+    std::vector<double> gradients(network->weight_table_size());
+    std::generate(gradients.begin(), gradients.end(), []() {
+      return static_cast<double>(rand() % 100) / (100.0) - (0.5);
+    });
+    std::vector<double> weight_references(network->weight_table_size());
+    for (std::int32_t i = 0; i < network->weight_table_size(); ++i) {
+      mean[i] = (settings.get_beta() * mean[i]) +
+                ((1.0 - settings.get_beta()) * gradients[i]);
+      variance[i] =
+          (settings.get_beta_2() * variance[i]) +
+          ((1.0 - settings.get_beta_2()) * std::pow(gradients[i], 2.0));
+      weight_references[i] =
+          network->weight_table(i) -
+          ((settings.get_learning_rate() /
+            (std::sqrt(variance[i] / (1.0 - std::pow(settings.get_beta(),
+                                                     iteration))) +
+             settings.get_epsilon())) *
+           (mean[i] / (1.0 - std::pow(settings.get_beta_2(), iteration))));
+    }
+
+    if (weight_updater->is_finished())
+      weight_updater->start();
+    weight_updater->iterate(gradients);
+
+    for (std::int32_t i = 0; i < network->weight_table_size(); ++i) {
+      REQUIRE(Catch::Approx(weight_references[i]).epsilon(0.00000000000001) ==
+              network->weight_table(i));
+    }
+  }
+}
+
 } /* namespace rafko_gym_test */
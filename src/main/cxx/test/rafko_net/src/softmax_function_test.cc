@@ -30,6 +30,7 @@
 #include "rafko_protocol/solution.pb.h"
 #include "rafko_utilities/models/data_ringbuffer.hpp"
 #include "rafko_utilities/services/thread_group.hpp"
+#include "rafko_utilities/services/work_stealing_pool.hpp"
 
 #include "test/test_utility.hpp"
 
@@ -69,10 +70,9 @@ void check_softmax_values(std::vector<double> &neuron_data,
   REQUIRE(Catch::Approx(manual_sum).epsilon((0.00000000000001)) == (1.0));
 
   /* Calculate through the network */
-  std::vector<std::unique_ptr<rafko_utilities::ThreadGroup>> exec_threads;
-  exec_threads.push_back(std::make_unique<rafko_utilities::ThreadGroup>(
-      threads.get_number_of_threads()));
-  rafko_net::RafkoNetworkFeature features(exec_threads);
+  rafko_utilities::WorkStealingPool thread_pool(
+      threads.get_number_of_threads());
+  rafko_net::RafkoNetworkFeature features(thread_pool);
   features.execute_solution_relevant(mockup, settings, neuron_data);
 
   /* Check if sum equals to 1 */
@@ -15,18 +15,23 @@
  *    <https://github.com/davids91/rafko/blob/master/LICENSE>
  */
 
+#include <algorithm>
 #include <catch2/catch_approx.hpp>
 #include <catch2/catch_test_macros.hpp>
+#include <cmath>
 #include <memory>
 #include <numeric>
+#include <optional>
 #include <vector>
 
+#include "rafko_gym/models/rafko_dataset_implementation.hpp"
 #include "rafko_mainframe/models/rafko_settings.hpp"
 #include "rafko_net/models/spike_function.hpp"
 #include "rafko_net/models/transfer_function.hpp"
 #include "rafko_net/services/partial_solution_solver.hpp"
 #include "rafko_net/services/rafko_net_builder.hpp"
 #include "rafko_net/services/solution_builder.hpp"
+#include "rafko_net/services/solution_quantizer.hpp"
 #include "rafko_net/services/solution_solver.hpp"
 #include "rafko_net/services/synapse_iterator.hpp"
 #include "rafko_protocol/rafko_net.pb.h"
@@ -664,6 +669,709 @@ TEST_CASE("Solution Solver memory test", "[solve][memory]") {
   }
 }
 
+TEST_CASE("Solution Solver batch solve test", "[solve][memory][batch]") {
+  google::protobuf::Arena arena;
+  constexpr std::uint32_t input_size = 3u;
+  constexpr std::uint32_t batch_size = 5u;
+  constexpr std::uint32_t sequence_size = 4u;
+  rafko_mainframe::RafkoSettings settings = rafko_mainframe::RafkoSettings()
+                                                .set_arena_ptr(&arena)
+                                                .set_max_processing_threads(2u)
+                                                .set_device_max_megabytes(0.02);
+  rafko_net::RafkoNet &net =
+      *rafko_test::generate_random_net_with_softmax_features_and_recurrence(
+          input_size, settings);
+  rafko_net::Solution *solution =
+      rafko_net::SolutionBuilder(settings).build(net);
+  std::shared_ptr<rafko_net::SolutionSolver> solver =
+      std::make_unique<rafko_net::SolutionSolver>(solution, settings);
+
+  /* Solve every sample one by one, then as a batch */
+  std::vector<std::vector<double>> batch_inputs(sequence_size);
+  std::vector<std::vector<std::vector<double>>> expected_outputs(
+      batch_size, std::vector<std::vector<double>>(sequence_size));
+  for (std::uint32_t step = 0u; step < sequence_size; ++step) {
+    for (std::uint32_t sample = 0u; sample < (batch_size * input_size);
+         ++sample)
+      batch_inputs[step].push_back(static_cast<double>(rand() % 100) / 10.0);
+  }
+  for (std::uint32_t sample = 0u; sample < batch_size; ++sample) {
+    for (std::uint32_t step = 0u; step < sequence_size; ++step) {
+      rafko_utilities::ConstVectorSubrange<> output = solver->solve(
+          {batch_inputs[step].begin() + (sample * input_size),
+           batch_inputs[step].begin() + ((sample + 1u) * input_size)},
+          (0u == step), 1u /*thread_index*/);
+      expected_outputs[sample][step] = {output.begin(), output.end()};
+    }
+  }
+
+  std::vector<double> batch_outputs;
+  for (std::uint32_t step = 0u; step < sequence_size; ++step) {
+    solver->solve_batch(batch_inputs[step], batch_size, batch_outputs,
+                        (0u == step), 0u /*thread_index*/);
+    REQUIRE(batch_outputs.size() ==
+            (batch_size * solution->output_neuron_number()));
+    for (std::uint32_t sample = 0u; sample < batch_size; ++sample) {
+      for (std::uint32_t output_index = 0u;
+           output_index < solution->output_neuron_number(); ++output_index) {
+        CHECK(Catch::Approx(batch_outputs[(sample *
+                                           solution->output_neuron_number()) +
+                                          output_index])
+                  .epsilon(0.00000000000001)
+                  .margin(0.00000000000001) ==
+              expected_outputs[sample][step][output_index]);
+      }
+    }
+  }
+}
+
+/**
+ * @brief     Moves the weights of the given Neuron to the end of the weight
+ * table of the network, adding or removing the weight of its last input
+ *
+ * @param         net             The network containing the Neuron
+ * @param         neuron          The Neuron with a single weight synapse
+ * @param[in]     added_weight    The weight of a new last input, or an empty
+ * optional to remove the weight of the last input
+ */
+void move_weights(rafko_net::RafkoNet &net, rafko_net::Neuron &neuron,
+                  std::optional<double> added_weight) {
+  REQUIRE(1 == neuron.input_weights_size());
+  const rafko_net::IndexSynapseInterval weights = neuron.input_weights(0);
+  const std::uint32_t weight_start = net.weight_table_size();
+  const std::uint32_t bias_index =
+      weights.starts() + weights.interval_size() - 1u;
+  for (std::uint32_t weight_index = weights.starts();
+       weight_index < (bias_index - (added_weight.has_value() ? 0u : 1u));
+       ++weight_index)
+    net.add_weight_table(net.weight_table(weight_index));
+  if (added_weight.has_value())
+    net.add_weight_table(added_weight.value());
+  net.add_weight_table(net.weight_table(bias_index));
+  neuron.mutable_input_weights(0)->set_starts(weight_start);
+  neuron.mutable_input_weights(0)->set_interval_size(net.weight_table_size() -
+                                                     weight_start);
+}
+
+/**
+ * @brief     Inserts a Neuron into a fully connected network at the end of a
+ * layer, taking its inputs from the same Neurons the last Neuron of the layer
+ * does, and connects it to every Neuron of the next layer.
+ *
+ * @return    The changes of the network
+ */
+rafko_net::NetworkChanges insert_neuron(rafko_net::RafkoNet &net,
+                                        std::uint32_t neuron_index,
+                                        std::uint32_t next_layer_size) {
+  rafko_net::Neuron &neuron = *net.add_neuron_array();
+  neuron = net.neuron_array(neuron_index - 1u);
+  REQUIRE(1 == neuron.input_weights_size());
+  const std::uint32_t weight_start = net.weight_table_size();
+  for (std::uint32_t weight_index = 0u;
+       weight_index < neuron.input_weights(0).interval_size(); ++weight_index)
+    net.add_weight_table(
+        net.weight_table(neuron.input_weights(0).starts() + weight_index));
+  neuron.mutable_input_weights(0)->set_starts(weight_start);
+  for (std::int32_t index = net.neuron_array_size() - 1;
+       index > static_cast<std::int32_t>(neuron_index); --index)
+    net.mutable_neuron_array()->SwapElements(index, index - 1);
+
+  rafko_net::NetworkChanges changes{{}, {neuron_index}, {}};
+  for (rafko_net::Neuron &network_neuron : *net.mutable_neuron_array())
+    for (rafko_net::InputSynapseInterval &interval :
+         *network_neuron.mutable_input_indices())
+      if (interval.starts() >= static_cast<std::int32_t>(neuron_index))
+        interval.set_starts(interval.starts() + 1);
+  for (std::uint32_t index = neuron_index + 1u;
+       index <= (neuron_index + next_layer_size); ++index) {
+    /* The new input takes the weight before the bias */
+    rafko_net::Neuron &next_neuron = *net.mutable_neuron_array(index);
+    REQUIRE(1 == next_neuron.input_indices_size());
+    REQUIRE(1 == next_neuron.input_weights_size());
+    next_neuron.mutable_input_indices(0)->set_interval_size(
+        next_neuron.input_indices(0).interval_size() + 1u);
+    move_weights(net, next_neuron, 0.5);
+    changes.changed_neurons.push_back(index);
+  }
+  return changes;
+}
+
+/**
+ * @brief     Removes a Neuron inserted by @insert_neuron
+ *
+ * @return    The changes of the network
+ */
+rafko_net::NetworkChanges remove_neuron(rafko_net::RafkoNet &net,
+                                        std::uint32_t neuron_index,
+                                        std::uint32_t next_layer_size) {
+  rafko_net::NetworkChanges changes{{}, {}, {neuron_index}};
+  for (std::uint32_t index = neuron_index + 1u;
+       index <= (neuron_index + next_layer_size); ++index) {
+    rafko_net::Neuron &next_neuron = *net.mutable_neuron_array(index);
+    next_neuron.mutable_input_indices(0)->set_interval_size(
+        next_neuron.input_indices(0).interval_size() - 1u);
+    move_weights(net, next_neuron, {});
+    changes.changed_neurons.push_back(index - 1u);
+  }
+  for (std::int32_t index = neuron_index;
+       index < (net.neuron_array_size() - 1); ++index)
+    net.mutable_neuron_array()->SwapElements(index, index + 1);
+  net.mutable_neuron_array()->RemoveLast();
+  for (rafko_net::Neuron &network_neuron : *net.mutable_neuron_array())
+    for (rafko_net::InputSynapseInterval &interval :
+         *network_neuron.mutable_input_indices())
+      if (interval.starts() > static_cast<std::int32_t>(neuron_index))
+        interval.set_starts(interval.starts() - 1);
+  return changes;
+}
+
+/**
+ * @brief     Provides the indices of the partial solutions containing any of
+ * the given Neurons
+ */
+std::vector<std::uint32_t>
+partials_containing(const rafko_net::Solution &solution,
+                    const std::vector<std::uint32_t> &neurons) {
+  std::vector<std::uint32_t> result;
+  for (std::int32_t partial_index = 0;
+       partial_index < solution.partial_solutions_size(); ++partial_index) {
+    const rafko_net::IndexSynapseInterval &output =
+        solution.partial_solutions(partial_index).output_data();
+    if (std::any_of(neurons.begin(), neurons.end(),
+                    [&output](std::uint32_t neuron_index) {
+                      return (
+                          (static_cast<std::int32_t>(neuron_index) >=
+                           output.starts()) &&
+                          (neuron_index <
+                           (output.starts() + output.interval_size())));
+                    }))
+      result.push_back(partial_index);
+  }
+  return result;
+}
+
+/**
+ * @brief     Compares the outputs of the given solver to the ones of a solver
+ * built from the network from scratch
+ */
+void check_updated_solver(
+    const rafko_net::RafkoNet &net,
+    std::shared_ptr<rafko_mainframe::RafkoSettings> settings,
+    rafko_net::SolutionSolver &solver) {
+  const std::vector<double> input(net.input_data_size(), 1.0);
+  rafko_net::SolutionSolver::Factory reference_factory(net, settings);
+  std::shared_ptr<rafko_net::SolutionSolver> reference_solver =
+      reference_factory.build();
+  rafko_utilities::ConstVectorSubrange<> result =
+      solver.solve(input, true /*reset_neuron_data*/);
+  rafko_utilities::ConstVectorSubrange<> reference_result =
+      reference_solver->solve(input, true /*reset_neuron_data*/);
+  REQUIRE(result.size() == reference_result.size());
+  for (std::uint32_t output_index = 0u; output_index < result.size();
+       ++output_index)
+    CHECK(Catch::Approx(result[output_index]).epsilon(0.00000000000001) ==
+          reference_result[output_index]);
+}
+
+TEST_CASE("Solution Solver incremental update test", "[solve][update]") {
+  google::protobuf::Arena arena;
+  constexpr std::uint32_t input_size = 3u;
+  std::shared_ptr<rafko_mainframe::RafkoSettings> settings =
+      std::make_shared<rafko_mainframe::RafkoSettings>(
+          rafko_mainframe::RafkoSettings()
+              .set_arena_ptr(&arena)
+              .set_max_processing_threads(2u)
+              .set_device_max_megabytes(0.0002));
+  const std::vector<std::uint32_t> layer_sizes = {5u, 8u, 8u, 3u};
+  rafko_net::RafkoNet &net = *rafko_net::RafkoNetBuilder(*settings)
+                                  .input_size(input_size)
+                                  .expected_input_range(5.0)
+                                  .create_layers(layer_sizes);
+  rafko_net::SolutionSolver::Factory solver_factory(net, settings);
+  std::shared_ptr<rafko_net::SolutionSolver> solver = solver_factory.build();
+  rafko_net::Solution *solution =
+      rafko_net::SolutionBuilder(*settings).build(net);
+
+  /* Changing a single Neuron only re-builds the partial solution it is in */
+  const std::uint32_t changed_index = net.neuron_array_size() / 2;
+  rafko_net::Neuron &changed_neuron = *net.mutable_neuron_array(changed_index);
+  changed_neuron.set_transfer_function(
+      (rafko_net::transfer_function_sigmoid ==
+       changed_neuron.transfer_function())
+          ? rafko_net::transfer_function_tanh
+          : rafko_net::transfer_function_sigmoid);
+  rafko_net::NetworkChanges changes{{changed_index}, {}, {}};
+  std::optional<rafko_net::SolutionUpdate> solution_update =
+      rafko_net::SolutionBuilder(*settings).update(solution, net, changes);
+  REQUIRE(solution_update.has_value());
+  CHECK(partials_containing(*solution, {changed_index}) ==
+        solution_update.value().rebuilt_partials);
+  CHECK(solution_update.value().reindexed_partials.empty());
+  CHECK(solution_update.value().removed_partials.empty());
+  solver_factory.build(changes);
+  check_updated_solver(net, settings, *solver);
+
+  /* Adding a Neuron re-builds the partial it is added to and the partials
+   * reading from it, and re-indexes the partials after it */
+  const std::uint32_t partial_count = solution->partial_solutions_size();
+  const std::uint32_t added_index = layer_sizes[0] + layer_sizes[1];
+  changes = insert_neuron(net, added_index, layer_sizes[2]);
+  solution_update =
+      rafko_net::SolutionBuilder(*settings).update(solution, net, changes);
+  REQUIRE(solution_update.has_value());
+  std::vector<std::uint32_t> touched_neurons = changes.changed_neurons;
+  touched_neurons.push_back(added_index);
+  CHECK(partials_containing(*solution, touched_neurons) ==
+        solution_update.value().rebuilt_partials);
+  CHECK(solution_update.value().rebuilt_partials.size() <
+        static_cast<std::uint32_t>(solution->partial_solutions_size()));
+  std::vector<std::uint32_t> shifted_neurons(net.neuron_array_size() -
+                                             touched_neurons.size() -
+                                             added_index);
+  std::iota(shifted_neurons.begin(), shifted_neurons.end(),
+            added_index + touched_neurons.size());
+  std::vector<std::uint32_t> reindexed_partials;
+  for (std::uint32_t partial_index :
+       partials_containing(*solution, shifted_neurons))
+    if (!std::binary_search(solution_update.value().rebuilt_partials.begin(),
+                            solution_update.value().rebuilt_partials.end(),
+                            partial_index))
+      reindexed_partials.push_back(partial_index);
+  CHECK(reindexed_partials == solution_update.value().reindexed_partials);
+  CHECK(static_cast<std::int32_t>(partial_count) ==
+        solution->partial_solutions_size());
+  CHECK(net.neuron_array_size() ==
+        static_cast<std::int32_t>(solution->neuron_number()));
+  solver_factory.build(changes);
+  check_updated_solver(net, settings, *solver);
+
+  /* Removing the Neuron re-builds the partial it was in and the partials
+   * reading from it */
+  changes = remove_neuron(net, added_index, layer_sizes[2]);
+  solution_update =
+      rafko_net::SolutionBuilder(*settings).update(solution, net, changes);
+  REQUIRE(solution_update.has_value());
+  touched_neurons = changes.changed_neurons;
+  touched_neurons.push_back(added_index - 1u);
+  CHECK(partials_containing(*solution, touched_neurons) ==
+        solution_update.value().rebuilt_partials);
+  CHECK(static_cast<std::int32_t>(partial_count) ==
+        solution->partial_solutions_size());
+  solver_factory.build(changes);
+  check_updated_solver(net, settings, *solver);
+
+  /* Changing the features of the network re-builds the whole solution */
+  net.add_neuron_group_features()->set_feature(
+      rafko_net::neuron_group_feature_softmax);
+  rafko_net::IndexSynapseInterval &relevant_neurons =
+      *net.mutable_neuron_group_features(0)->add_relevant_neurons();
+  relevant_neurons.set_starts(net.neuron_array_size() -
+                              net.output_neuron_number());
+  relevant_neurons.set_interval_size(net.output_neuron_number());
+  CHECK_FALSE(rafko_net::SolutionBuilder(*settings)
+                  .update(solution, net, rafko_net::NetworkChanges())
+                  .has_value());
+  CHECK(net.neuron_group_features_size() ==
+        std::accumulate(solution->partial_solutions().begin(),
+                        solution->partial_solutions().end(), 0,
+                        [](std::int32_t sum,
+                           const rafko_net::PartialSolution &partial) {
+                          return sum + partial.solved_features_size();
+                        }));
+}
+
+TEST_CASE("Solution Solver test with shared weight storage",
+          "[solve][weight-update]") {
+  google::protobuf::Arena arena;
+  constexpr std::uint32_t input_size = 3u;
+  std::shared_ptr<rafko_mainframe::RafkoSettings> settings =
+      std::make_shared<rafko_mainframe::RafkoSettings>(
+          rafko_mainframe::RafkoSettings()
+              .set_arena_ptr(&arena)
+              .set_max_processing_threads(2u)
+              .set_device_max_megabytes(0.02));
+  std::shared_ptr<rafko_mainframe::RafkoSettings> shared_settings =
+      std::make_shared<rafko_mainframe::RafkoSettings>(
+          rafko_mainframe::RafkoSettings(*settings).set_shared_weight_storage(
+              true));
+  rafko_net::RafkoNet &net =
+      *rafko_test::generate_random_net_with_softmax_features_and_recurrence(
+          input_size, *settings);
+  rafko_net::SolutionSolver::Factory solver_factory(net, shared_settings);
+  std::shared_ptr<rafko_net::SolutionSolver> solver = solver_factory.build();
+  const std::vector<double> input(input_size, 1.0);
+
+  /* Weight changes are visible to the solver without updating the solution */
+  for (std::uint32_t variant = 0u; variant < 5u; ++variant) {
+    for (std::int32_t weight_index = 0; weight_index < net.weight_table_size();
+         ++weight_index)
+      net.set_weight_table(weight_index,
+                           static_cast<double>(rand() % 11) / 10.0);
+    std::shared_ptr<rafko_net::SolutionSolver> reference_solver =
+        rafko_net::SolutionSolver::Factory(net, settings).build();
+    rafko_utilities::ConstVectorSubrange<> result =
+        solver->solve(input, true /*reset_neuron_data*/);
+    rafko_utilities::ConstVectorSubrange<> reference_result =
+        reference_solver->solve(input, true /*reset_neuron_data*/);
+    REQUIRE(result.size() == reference_result.size());
+    for (std::uint32_t output_index = 0u; output_index < result.size();
+         ++output_index)
+      CHECK(Catch::Approx(result[output_index]).epsilon(0.00000000000001) ==
+            reference_result[output_index]);
+  }
+
+  /* The protobuf form of the solution is only updated on demand */
+  solver_factory.refresh_actual_solution_weights();
+  rafko_test::check_if_the_same(net, *solver_factory.actual_solution());
+}
+
+TEST_CASE("Solution Solver test with reduced inference precision",
+          "[solve][precision]") {
+  google::protobuf::Arena arena;
+  constexpr std::uint32_t input_size = 3u;
+  constexpr std::uint32_t sequence_size = 4u;
+  constexpr std::uint32_t batch_size = 3u;
+  std::shared_ptr<rafko_mainframe::RafkoSettings> settings =
+      std::make_shared<rafko_mainframe::RafkoSettings>(
+          rafko_mainframe::RafkoSettings()
+              .set_arena_ptr(&arena)
+              .set_max_processing_threads(2u)
+              .set_device_max_megabytes(0.02));
+  rafko_net::RafkoNet &net =
+      *rafko_test::generate_random_net_with_softmax_features_and_recurrence(
+          input_size, *settings);
+  std::vector<std::vector<std::vector<double>>> inputs(
+      batch_size, std::vector<std::vector<double>>(
+                      sequence_size, std::vector<double>(input_size)));
+  for (std::vector<std::vector<double>> &sequence : inputs)
+    for (std::vector<double> &input : sequence)
+      for (double &value : input)
+        value = static_cast<double>(rand() % 11) / 10.0;
+
+  for (rafko_net::Inference_precision precision :
+       {rafko_net::inference_precision_single_rounding,
+        rafko_net::inference_precision_mixed_rounding}) {
+    rafko_net::SolutionSolver::Factory solver_factory(
+        net, std::make_shared<rafko_mainframe::RafkoSettings>(
+                 rafko_mainframe::RafkoSettings(*settings)
+                     .set_inference_precision(precision)));
+    std::shared_ptr<rafko_net::SolutionSolver> solver = solver_factory.build();
+    for (std::uint32_t variant = 0u; variant < 3u; ++variant) {
+      /* Weight changes are visible after the factory refreshed the weights */
+      for (std::int32_t weight_index = 0;
+           weight_index < net.weight_table_size(); ++weight_index)
+        net.set_weight_table(weight_index,
+                             static_cast<double>(rand() % 11) / 10.0);
+      solver_factory.refresh_actual_solution_weights();
+      std::shared_ptr<rafko_net::SolutionSolver> reference_solver =
+          rafko_net::SolutionSolver::Factory(net, settings).build();
+
+      /* Results stay close to the ones calculated in double precision */
+      std::vector<std::vector<std::vector<double>>> expected_outputs(
+          batch_size, std::vector<std::vector<double>>(sequence_size));
+      for (std::uint32_t sample = 0u; sample < batch_size; ++sample) {
+        for (std::uint32_t step = 0u; step < sequence_size; ++step) {
+          rafko_utilities::ConstVectorSubrange<> result =
+              solver->solve(inputs[sample][step], (0u == step));
+          rafko_utilities::ConstVectorSubrange<> reference_result =
+              reference_solver->solve(inputs[sample][step], (0u == step));
+          REQUIRE(result.size() == reference_result.size());
+          for (std::uint32_t output_index = 0u; output_index < result.size();
+               ++output_index)
+            CHECK(Catch::Approx(result[output_index]).margin(0.0001) ==
+                  reference_result[output_index]);
+          expected_outputs[sample][step] = {reference_result.begin(),
+                                            reference_result.end()};
+        }
+      }
+
+      /* The same applies when solving the samples in a batch */
+      std::vector<double> batch_outputs;
+      for (std::uint32_t step = 0u; step < sequence_size; ++step) {
+        std::vector<double> batch_inputs;
+        for (std::uint32_t sample = 0u; sample < batch_size; ++sample)
+          batch_inputs.insert(batch_inputs.end(), inputs[sample][step].begin(),
+                              inputs[sample][step].end());
+        solver->solve_batch(batch_inputs, batch_size, batch_outputs,
+                            (0u == step));
+        for (std::uint32_t sample = 0u; sample < batch_size; ++sample)
+          for (std::uint32_t output_index = 0u;
+               output_index < expected_outputs[sample][step].size();
+               ++output_index)
+            CHECK(Catch::Approx(
+                      batch_outputs[(sample *
+                                     expected_outputs[sample][step].size()) +
+                                    output_index])
+                      .margin(0.0001) ==
+                  expected_outputs[sample][step][output_index]);
+      }
+    }
+  }
+}
+
+TEST_CASE("Solution Solver test with quantized inference",
+          "[solve][precision][quantized]") {
+  google::protobuf::Arena arena;
+  constexpr std::uint32_t sequence_size = 4u;
+  std::shared_ptr<rafko_mainframe::RafkoSettings> settings =
+      std::make_shared<rafko_mainframe::RafkoSettings>(
+          rafko_mainframe::RafkoSettings()
+              .set_arena_ptr(&arena)
+              .set_max_processing_threads(2u)
+              .set_device_max_megabytes(0.02));
+  rafko_mainframe::RafkoSettings quantized_settings =
+      rafko_mainframe::RafkoSettings(*settings).set_inference_precision(
+          rafko_net::inference_precision_int8);
+  rafko_net::RafkoNet &net =
+      *rafko_test::generate_random_net_with_softmax_features_and_recurrence(
+          2u /*input_size*/, *settings);
+  auto [inputs, labels] =
+      rafko_test::create_sequenced_addition_dataset(32u, sequence_size);
+  rafko_gym::RafkoDatasetImplementation calibration_set(
+      std::move(inputs), std::move(labels), sequence_size);
+  auto [validation_inputs, validation_labels] =
+      rafko_test::create_sequenced_addition_dataset(32u, sequence_size);
+  rafko_gym::RafkoDatasetImplementation data_set(
+      std::move(validation_inputs), std::move(validation_labels),
+      sequence_size);
+  rafko_net::Solution *solution =
+      rafko_net::SolutionBuilder(*settings).build(net);
+
+  /* Quantized inference needs the activation ranges to be calibrated */
+  CHECK_THROWS(rafko_net::SolutionSolver(solution, quantized_settings));
+  rafko_net::SolutionQuantizer::calibrate(*solution, calibration_set,
+                                          *settings);
+  for (const rafko_net::PartialSolution &partial :
+       solution->partial_solutions())
+    CHECK(0.0 < partial.activation_range());
+
+  rafko_net::SolutionSolver reference_solver(solution, *settings);
+  rafko_net::SolutionSolver solver(solution, quantized_settings);
+  double max_error = 0.0;
+  for (std::uint32_t sequence_index = 0u;
+       sequence_index < data_set.get_number_of_sequences(); ++sequence_index) {
+    for (std::uint32_t step = 0u; step < sequence_size; ++step) {
+      const std::vector<double> &input =
+          data_set.get_input_sample((sequence_index * sequence_size) + step);
+      rafko_utilities::ConstVectorSubrange<> result =
+          solver.solve(input, (0u == step));
+      rafko_utilities::ConstVectorSubrange<> reference_result =
+          reference_solver.solve(input, (0u == step));
+      REQUIRE(result.size() == reference_result.size());
+      for (std::uint32_t output_index = 0u; output_index < result.size();
+           ++output_index)
+        max_error = std::max(max_error, std::abs(result[output_index] -
+                                                 reference_result[output_index]));
+    }
+  }
+  CHECK(max_error < 0.1);
+}
+
+TEST_CASE("Solution Solver test with strided synapses",
+          "[solve][convolution]") {
+  google::protobuf::Arena arena;
+  rafko_mainframe::RafkoSettings settings =
+      rafko_mainframe::RafkoSettings().set_arena_ptr(&arena);
+  rafko_net::RafkoNet &strided_net =
+      *rafko_net::RafkoNetBuilder(settings)
+           .input_size(64)
+           .expected_input_range(1.0)
+           .layer_input_convolution(0u)
+           .kernel_size(2, 2)
+           .kernel_stride(2, 2)
+           .input_padding(0, 0)
+           .input_size(8, 8)
+           .output_size(4, 4)
+           .validate()
+           .layer_input_convolution(1u)
+           .kernel_size(2, 2)
+           .kernel_stride(2, 2)
+           .input_padding(0, 0)
+           .input_size(4, 4)
+           .output_size(2, 2)
+           .validate()
+           .create_layers({16, 4, 2});
+
+  /* Every kernel row is merged into one strided synapse */
+  for (std::uint32_t neuron_index = 0u; neuron_index < 20u; ++neuron_index) {
+    REQUIRE(1 == strided_net.neuron_array(neuron_index).input_indices_size());
+    REQUIRE(2u == strided_net.neuron_array(neuron_index)
+                      .input_indices(0)
+                      .interval_count());
+  }
+
+  /* Describe the same net without strides */
+  rafko_net::RafkoNet plain_net = strided_net;
+  for (rafko_net::Neuron &neuron : *plain_net.mutable_neuron_array()) {
+    google::protobuf::RepeatedPtrField<rafko_net::InputSynapseInterval>
+        plain_indices;
+    for (const rafko_net::InputSynapseInterval &strided :
+         neuron.input_indices()) {
+      for (std::uint32_t run = 0u;
+           run < rafko_net::SynapseIterator<
+                     rafko_net::InputSynapseInterval>::run_count(strided);
+           ++run) {
+        rafko_net::InputSynapseInterval &plain = *plain_indices.Add();
+        plain.set_starts(
+            rafko_net::SynapseIterator<rafko_net::InputSynapseInterval>::
+                run_start(strided, run));
+        plain.set_interval_size(strided.interval_size());
+        plain.set_reach_past_loops(strided.reach_past_loops());
+      }
+    }
+    *neuron.mutable_input_indices() = plain_indices;
+  }
+
+  /* Partial solution inputs are also compacted into strided synapses */
+  rafko_net::Solution *strided_solution =
+      rafko_net::SolutionBuilder(settings).build(strided_net);
+  bool found_strided_input = false;
+  for (const rafko_net::PartialSolution &partial :
+       strided_solution->partial_solutions()) {
+    for (const rafko_net::InputSynapseInterval &input : partial.input_data())
+      found_strided_input |= (1u < input.interval_count());
+  }
+  REQUIRE(found_strided_input);
+
+  std::shared_ptr<rafko_net::SolutionSolver> strided_solver =
+      std::make_unique<rafko_net::SolutionSolver>(strided_solution, settings);
+  for (std::uint32_t variant = 0u; variant < 10u; ++variant) {
+    std::vector<double> net_input(64u);
+    for (double &input : net_input)
+      input = static_cast<double>(rand() % 100) / 100.0;
+    rafko_utilities::ConstVectorSubrange<> neuron_data =
+        strided_solver->solve(net_input, true);
+    std::vector<double> expected_neuron_data(plain_net.neuron_array_size());
+    rafko_test::manaual_fully_connected_network_result(
+        net_input, {}, expected_neuron_data, {16, 4, 2}, plain_net);
+    REQUIRE(2u == neuron_data.size());
+    for (std::uint32_t output_index = 0u; output_index < 2u; ++output_index)
+      CHECK(
+          Catch::Approx(neuron_data[output_index]).epsilon(0.00000000000001) ==
+          expected_neuron_data[expected_neuron_data.size() - 2u +
+                               output_index]);
+  }
+}
+
+TEST_CASE("Solution Solver incremental update test with strided synapses",
+          "[solve][update][convolution]") {
+  google::protobuf::Arena arena;
+  std::shared_ptr<rafko_mainframe::RafkoSettings> settings =
+      std::make_shared<rafko_mainframe::RafkoSettings>(
+          rafko_mainframe::RafkoSettings()
+              .set_arena_ptr(&arena)
+              .set_max_processing_threads(2u)
+              .set_device_max_megabytes(0.0002));
+  rafko_net::RafkoNet &net = *rafko_net::RafkoNetBuilder(*settings)
+                                  .input_size(64)
+                                  .expected_input_range(1.0)
+                                  .layer_input_convolution(1u)
+                                  .kernel_size(2, 2)
+                                  .kernel_stride(2, 2)
+                                  .input_padding(0, 0)
+                                  .input_size(4, 4)
+                                  .output_size(2, 2)
+                                  .validate()
+                                  .create_layers({16, 4, 2});
+  rafko_net::Solution *solution =
+      rafko_net::SolutionBuilder(*settings).build(net);
+
+  /* Add a Neuron before every other one, reading the same inputs as the first
+   * Neuron, but not read by any other Neuron */
+  rafko_net::Neuron &added_neuron = *net.add_neuron_array();
+  added_neuron = net.neuron_array(0);
+  for (std::int32_t index = net.neuron_array_size() - 1; index > 0; --index)
+    net.mutable_neuron_array()->SwapElements(index, index - 1);
+  for (rafko_net::Neuron &neuron : *net.mutable_neuron_array())
+    for (rafko_net::InputSynapseInterval &interval :
+         *neuron.mutable_input_indices())
+      if (!rafko_net::SynapseIterator<>::is_index_input(interval.starts()))
+        interval.set_starts(interval.starts() + 1);
+  std::optional<rafko_net::SolutionUpdate> solution_update =
+      rafko_net::SolutionBuilder(*settings).update(
+          solution, net, rafko_net::NetworkChanges{{}, {0u}, {}});
+  REQUIRE(solution_update.has_value());
+  REQUIRE(!solution_update.value().reindexed_partials.empty());
+
+  /* The re-indexed partials keep reading every run of their strided inputs */
+  bool found_strided_input = false;
+  for (std::uint32_t partial_index :
+       solution_update.value().reindexed_partials)
+    for (const rafko_net::InputSynapseInterval &input :
+         solution->partial_solutions(partial_index).input_data())
+      found_strided_input |= (1u < input.interval_count());
+  CHECK(found_strided_input);
+  rafko_net::SolutionSolver solver(solution, *settings);
+  check_updated_solver(net, settings, solver);
+}
+
+TEST_CASE("Solution Solver test with quantized inference after an update",
+          "[solve][update][quantized]") {
+  google::protobuf::Arena arena;
+  constexpr std::uint32_t sequence_size = 4u;
+  std::shared_ptr<rafko_mainframe::RafkoSettings> settings =
+      std::make_shared<rafko_mainframe::RafkoSettings>(
+          rafko_mainframe::RafkoSettings()
+              .set_arena_ptr(&arena)
+              .set_max_processing_threads(2u)
+              .set_device_max_megabytes(0.0002));
+  std::shared_ptr<rafko_mainframe::RafkoSettings> quantized_settings =
+      std::make_shared<rafko_mainframe::RafkoSettings>(
+          rafko_mainframe::RafkoSettings(*settings).set_inference_precision(
+              rafko_net::inference_precision_int8));
+  rafko_net::RafkoNet &net = *rafko_net::RafkoNetBuilder(*settings)
+                                  .input_size(2u)
+                                  .expected_input_range(5.0)
+                                  .create_layers({5u, 8u, 3u});
+  auto [inputs, labels] =
+      rafko_test::create_sequenced_addition_dataset(32u, sequence_size);
+  rafko_gym::RafkoDatasetImplementation calibration_set(
+      std::move(inputs), std::move(labels), sequence_size);
+  rafko_net::Solution *solution =
+      rafko_net::SolutionBuilder(*settings).build(net);
+  rafko_net::SolutionQuantizer::calibrate(*solution, calibration_set,
+                                          *settings);
+
+  /* The re-built partials lose their activation ranges */
+  const std::uint32_t changed_index = net.neuron_array_size() / 2;
+  rafko_net::Neuron &changed_neuron = *net.mutable_neuron_array(changed_index);
+  changed_neuron.set_transfer_function(
+      (rafko_net::transfer_function_sigmoid ==
+       changed_neuron.transfer_function())
+          ? rafko_net::transfer_function_tanh
+          : rafko_net::transfer_function_sigmoid);
+  rafko_net::NetworkChanges changes{{changed_index}, {}, {}};
+  std::optional<rafko_net::SolutionUpdate> solution_update =
+      rafko_net::SolutionBuilder(*settings).update(solution, net, changes);
+  REQUIRE(solution_update.has_value());
+  REQUIRE(!solution_update.value().rebuilt_partials.empty());
+  CHECK(solution_update.value().rebuilt_partials ==
+        solution_update.value().uncalibrated_partials);
+  for (std::uint32_t partial_index :
+       solution_update.value().uncalibrated_partials)
+    CHECK_FALSE(0.0 <
+                solution->partial_solutions(partial_index).activation_range());
+  CHECK_THROWS(rafko_net::SolutionSolver(solution, *quantized_settings));
+  rafko_net::SolutionQuantizer::calibrate(*solution, calibration_set,
+                                          *settings);
+  CHECK_NOTHROW(rafko_net::SolutionSolver(solution, *quantized_settings));
+
+  /* A factory given a calibration set calibrates the updated solution */
+  rafko_net::SolutionSolver::Factory solver_factory(net, settings);
+  solver_factory.build();
+  changed_neuron.set_transfer_function(
+      (rafko_net::transfer_function_sigmoid ==
+       changed_neuron.transfer_function())
+          ? rafko_net::transfer_function_tanh
+          : rafko_net::transfer_function_sigmoid);
+  solver_factory.build(changes, &calibration_set);
+  for (const rafko_net::PartialSolution &partial :
+       solver_factory.actual_solution()->partial_solutions())
+    CHECK(0.0 < partial.activation_range());
+  CHECK_NOTHROW(rafko_net::SolutionSolver(solver_factory.actual_solution(),
+                                          *quantized_settings));
+}
+
 TEST_CASE("Solution Solver Neuron benchmark", "[runtime][!benchmark]") {
   google::protobuf::Arena arena;
   std::shared_ptr<rafko_mainframe::RafkoSettings> settings =
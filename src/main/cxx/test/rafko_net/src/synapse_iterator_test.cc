@@ -15,6 +15,7 @@
  *    <https://github.com/davids91/rafko/blob/master/LICENSE>
  */
 
+#include <algorithm>
 #include <catch2/catch_test_macros.hpp>
 #include <map>
 
@@ -404,4 +405,82 @@ TEST_CASE("Testing Utility functions reach_back_loops and interval_size_of of "
   }
 }
 
+TEST_CASE("Testing iteration of strided synapses", "[synapse-iteration]") {
+  for (std::uint32_t variant = 0u; variant < 10u; ++variant) {
+    /* Build the same indices as strided synapses and one by one */
+    google::protobuf::RepeatedPtrField<rafko_net::InputSynapseInterval>
+        strided_synapses;
+    google::protobuf::RepeatedPtrField<rafko_net::InputSynapseInterval>
+        plain_synapses;
+    std::int32_t next_start = rand() % 10;
+    for (std::uint32_t synapse_index = 0u; synapse_index < 5u;
+         ++synapse_index) {
+      const bool from_input = (0 == (rand() % 2));
+      rafko_net::InputSynapseInterval &strided = *strided_synapses.Add();
+      strided.set_starts(from_input ? (-1 - next_start) : next_start);
+      strided.set_interval_size(1u + rand() % 5u);
+      strided.set_interval_count(rand() % 5u);
+      strided.set_stride_size(strided.interval_size() + rand() % 5u);
+      strided.set_reach_past_loops(rand() % 3u);
+      for (std::uint32_t run = 0u; run < std::max(1u, strided.interval_count());
+           ++run) {
+        rafko_net::InputSynapseInterval &plain = *plain_synapses.Add();
+        plain.set_starts(
+            strided.starts() +
+            (from_input ? -1 : 1) *
+                static_cast<std::int32_t>(run * strided.stride_size()));
+        plain.set_interval_size(strided.interval_size());
+        plain.set_reach_past_loops(strided.reach_past_loops());
+      }
+      next_start += std::max(1u, strided.interval_count()) *
+                    strided.stride_size();
+    }
+
+    std::vector<std::int32_t> strided_indices;
+    std::vector<std::int32_t> plain_indices;
+    rafko_net::SynapseIterator<rafko_net::InputSynapseInterval>
+        strided_iterator(strided_synapses);
+    rafko_net::SynapseIterator<rafko_net::InputSynapseInterval> plain_iterator(
+        plain_synapses);
+    strided_iterator.iterate([&strided_indices](std::int32_t index) {
+      strided_indices.push_back(index);
+    });
+    plain_iterator.iterate([&plain_indices](std::int32_t index) {
+      plain_indices.push_back(index);
+    });
+    REQUIRE(strided_indices == plain_indices);
+    REQUIRE(strided_iterator.size() == plain_indices.size());
+    REQUIRE(strided_iterator.back() == plain_indices.back());
+    for (std::uint32_t index = 0u; index < plain_indices.size(); ++index) {
+      REQUIRE(strided_iterator[index] == plain_indices[index]);
+      REQUIRE(
+          strided_iterator.reach_past_loops<rafko_net::InputSynapseInterval>(
+              index) ==
+          plain_iterator.reach_past_loops<rafko_net::InputSynapseInterval>(
+              index));
+      REQUIRE(strided_iterator.contiguous_size_from(index) ==
+              plain_iterator.contiguous_size_from(index));
+    }
+
+    /* Merging the plain synapses should describe the same indices */
+    google::protobuf::RepeatedPtrField<rafko_net::InputSynapseInterval>
+        merged_synapses;
+    for (const rafko_net::InputSynapseInterval &plain : plain_synapses) {
+      if ((0 == merged_synapses.size()) ||
+          (!rafko_net::SynapseIterator<rafko_net::InputSynapseInterval>::
+               merge_interval(*merged_synapses.Mutable(
+                                  merged_synapses.size() - 1),
+                              plain)))
+        *merged_synapses.Add() = plain;
+    }
+    REQUIRE(merged_synapses.size() <= strided_synapses.size());
+    std::vector<std::int32_t> merged_indices;
+    rafko_net::SynapseIterator<rafko_net::InputSynapseInterval>::iterate(
+        merged_synapses, [&merged_indices](std::int32_t index) {
+          merged_indices.push_back(index);
+        });
+    REQUIRE(merged_indices == plain_indices);
+  }
+}
+
 } // namespace rafko_net_test
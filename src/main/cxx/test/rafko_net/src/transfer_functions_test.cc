@@ -57,6 +57,71 @@ TEST_CASE("Testing Transfer function outputs", "[neuron][transfer-function]") {
   }
 }
 
+TEST_CASE("Testing Transfer function array outputs against the scalar ones",
+          "[neuron][transfer-function][vectorized]") {
+  rafko_mainframe::RafkoSettings settings;
+  rafko_net::TransferFunction tfun(settings);
+  std::vector<double> inputs = {0.0,    -0.0,   1e-9,  -1e-9, 0.05,
+                                -0.05,  0.1,    -0.1,  0.3,   -0.35,
+                                20.0,   -20.0,  300.0, -300.0};
+  for (std::uint32_t variant = 0; variant < 500u; ++variant)
+    inputs.push_back(static_cast<double>(rand() % 20000 - 10000) / 500.0);
+  std::vector<double> input_derivatives(inputs.size());
+  for (double &d : input_derivatives)
+    d = static_cast<double>(rand() % 2000 - 1000) / 100.0;
+
+  std::vector<double> values(inputs.size());
+  std::vector<double> derivatives(inputs.size());
+  for (std::uint32_t function = 0u;
+       function < rafko_net::Transfer_functions_ARRAYSIZE; ++function) {
+    if (!rafko_net::Transfer_functions_IsValid(function) ||
+        (rafko_net::transfer_function_unknown == function) ||
+        (rafko_net::transfer_function_end == function))
+      continue;
+    const rafko_net::Transfer_functions transfer_function =
+        static_cast<rafko_net::Transfer_functions>(function);
+    tfun.get_values(transfer_function, inputs.data(), values.data(),
+                    inputs.size());
+    tfun.get_derivatives(transfer_function, inputs.data(),
+                         input_derivatives.data(), derivatives.data(),
+                         inputs.size());
+    for (std::uint32_t index = 0u; index < inputs.size(); ++index) {
+      CHECK(values[index] ==
+            Catch::Approx(tfun.get_value(transfer_function, inputs[index]))
+                .epsilon(0.000000000001)
+                .margin(0.00000000000001));
+      CHECK(derivatives[index] ==
+            Catch::Approx(tfun.get_derivative(transfer_function, inputs[index],
+                                              input_derivatives[index]))
+                .epsilon(0.000000000001)
+                .margin(0.00000000000001));
+    }
+  }
+}
+
+TEST_CASE("Testing Transfer function lookup values against the calculated ones",
+          "[neuron][transfer-function][quantized]") {
+  rafko_mainframe::RafkoSettings settings;
+  rafko_net::TransferFunction tfun(settings);
+  std::vector<double> inputs = {0.0, 8.0, -8.0, 7.99, -7.99, 20.0, -20.0};
+  for (std::uint32_t variant = 0; variant < 500u; ++variant)
+    inputs.push_back(static_cast<double>(rand() % 20000 - 10000) / 500.0);
+  for (std::uint32_t function = 0u;
+       function < rafko_net::Transfer_functions_ARRAYSIZE; ++function) {
+    if (!rafko_net::Transfer_functions_IsValid(function) ||
+        (rafko_net::transfer_function_unknown == function) ||
+        (rafko_net::transfer_function_end == function))
+      continue;
+    const rafko_net::Transfer_functions transfer_function =
+        static_cast<rafko_net::Transfer_functions>(function);
+    for (double input : inputs)
+      CHECK(tfun.get_lookup_value(transfer_function, input) ==
+            Catch::Approx(tfun.get_value(transfer_function, input))
+                .epsilon(0.001)
+                .margin(0.001));
+  }
+}
+
 TEST_CASE("Testing transfer function generators",
           "[neuron][transfer-function]") {
   rafko_mainframe::RafkoSettings settings;
@@ -19,6 +19,7 @@
 #include <vector>
 
 #include "rafko_mainframe/models/rafko_settings.hpp"
+#include "rafko_utilities/models/contiguous_ringbuffer.hpp"
 #include "rafko_utilities/models/data_ringbuffer.hpp"
 
 #include "test/test_utility.hpp"
@@ -113,4 +114,47 @@ TEST_CASE("Testing if ringbuffer past indexing logic is as expected",
   << i << "]-"; std::cout << "sequence index" << std::endl; */
 }
 
+TEST_CASE("Testing if contiguous ringbuffer indexing matches the Data "
+          "Ringbuffer",
+          "[data-handling]") {
+  const std::uint32_t sequence_number = 5;
+  const std::uint32_t buffer_size = 13;
+  rafko_utilities::DataRingbuffer<> reference(
+      sequence_number, [buffer_size](std::vector<double> &element) {
+        element = std::vector<double>(buffer_size, 0.0);
+      });
+  rafko_utilities::ContiguousRingbuffer<double> buffer(sequence_number,
+                                                       buffer_size);
+  rafko_utilities::ContiguousRingbuffer<float> float_buffer(sequence_number,
+                                                            buffer_size);
+
+  for (std::uint32_t run = 0; run < (3u * sequence_number); ++run) {
+    reference.clean_step();
+    buffer.clean_step();
+    float_buffer.clean_step();
+    for (std::uint32_t past_index = 0; past_index < sequence_number;
+         ++past_index) {
+      /* Every slot starts on a cache line */
+      REQUIRE(0u == (reinterpret_cast<std::uintptr_t>(
+                         buffer.get_slot(past_index)) %
+                     rafko_utilities::ContiguousRingbuffer<>::s_alignment));
+      REQUIRE(0u == (reinterpret_cast<std::uintptr_t>(
+                         float_buffer.get_slot(past_index)) %
+                     rafko_utilities::ContiguousRingbuffer<>::s_alignment));
+      for (std::uint32_t index = 0; index < buffer_size; ++index) {
+        REQUIRE(reference.get_element(past_index, index) ==
+                buffer.get_element(past_index, index));
+        REQUIRE(reference.get_element(past_index, index) ==
+                float_buffer.get_element(past_index, index));
+      }
+    }
+    for (std::uint32_t index = 0; index < buffer_size; ++index) {
+      const double value = static_cast<double>(rand() % 100);
+      reference.get_element(0u, index) = value;
+      buffer.get_element(0u, index) = value;
+      float_buffer.get_element(0u, index) = static_cast<float>(value);
+    }
+  }
+}
+
 } /* namespace rafko_utilities_test */
@@ -17,8 +17,14 @@
 
 #include <catch2/catch_approx.hpp>
 #include <catch2/catch_test_macros.hpp>
+#include <chrono>
 #include <memory>
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
 
+#include "rafko_utilities/services/rafko_thread_affinity.hpp"
 #include "rafko_utilities/services/thread_group.hpp"
 
 #include "test/test_utility.hpp"
@@ -219,4 +225,86 @@ TEST_CASE("Testing if ThreadGroups can be combined in a thread-safe manner",
   }
 }
 
+TEST_CASE("Testing if spin-then-park ThreadGroups execute every thread once "
+          "per call",
+          "[thread-group][multi-thread]") {
+  const std::uint32_t number_of_threads = 5;
+  rafko_utilities::ThreadGroup pool(number_of_threads,
+                                    rafko_utilities::ThreadGroup::SpinThenPark);
+  REQUIRE(rafko_utilities::ThreadGroup::SpinThenPark ==
+          pool.get_synchronization());
+  std::vector<std::uint32_t> executions(number_of_threads, 0u);
+  std::function<void(std::uint32_t)> fnc = [&](std::uint32_t thread_index) {
+    ++executions[thread_index];
+  };
+  for (std::uint32_t variant = 1u; variant <= 1000u; ++variant) {
+    pool.start_and_block(fnc);
+    if (0u == (variant % 100u)) /* let the threads fall asleep */
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    for (std::uint32_t count : executions)
+      REQUIRE(variant == count);
+  }
+}
+
+TEST_CASE("Testing if spin-then-park ThreadGroups can be combined in a "
+          "thread-safe manner",
+          "[thread-group][multi-thread]") {
+  const std::uint32_t number_of_threads = 4;
+  rafko_utilities::ThreadGroup outer_pool(
+      number_of_threads, rafko_utilities::ThreadGroup::SpinThenPark);
+  rafko_utilities::ThreadGroup inner_pool(
+      number_of_threads, rafko_utilities::ThreadGroup::SpinThenPark);
+
+  for (std::uint32_t variant = 0; variant < 10u; ++variant) {
+    std::vector<double> test_buffer(rand() % 100 + 1);
+    std::for_each(test_buffer.begin(), test_buffer.end(),
+                  [](double &element) { element = rand() % 10; });
+    double expected =
+        std::accumulate(test_buffer.begin(), test_buffer.end(), 0.0);
+    double result = 0.0;
+    std::mutex result_mutex;
+    outer_pool.start_and_block([&](std::uint32_t outer_index) {
+      inner_pool.start_and_block([&](std::uint32_t inner_index) {
+        double sum = 0.0;
+        for (std::uint32_t i = outer_index * number_of_threads + inner_index;
+             i < test_buffer.size(); i += number_of_threads * number_of_threads)
+          sum += test_buffer[i];
+        std::lock_guard<std::mutex> my_lock(result_mutex);
+        result += sum;
+      });
+    });
+    REQUIRE(Catch::Approx(expected).margin(0.00000000000001) == result);
+  }
+}
+
+#if defined(__linux__)
+TEST_CASE("Testing if the threads of a ThreadGroup run on their CPU sets",
+          "[thread-group][multi-thread]") {
+  /* with only one CPU available every thread would be on the same one */
+  const std::uint32_t number_of_threads =
+      (rafko_utilities::divide_cpus(2u).empty() ? 1u : 2u);
+  const std::vector<std::vector<std::uint32_t>> cpu_sets =
+      rafko_utilities::divide_cpus(number_of_threads);
+  REQUIRE(number_of_threads == cpu_sets.size());
+  for (rafko_utilities::ThreadGroup::synchronization_t synchronization :
+       {rafko_utilities::ThreadGroup::Blocking,
+        rafko_utilities::ThreadGroup::SpinThenPark}) {
+    rafko_utilities::ThreadGroup pool(number_of_threads, synchronization,
+                                      cpu_sets);
+    std::vector<std::vector<std::uint32_t>> used_cpu_sets(number_of_threads);
+    pool.start_and_block([&used_cpu_sets](std::uint32_t thread_index) {
+      cpu_set_t cpu_set;
+      CPU_ZERO(&cpu_set);
+      pthread_getaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpu_set);
+      for (std::uint32_t cpu = 0u; cpu < CPU_SETSIZE; ++cpu)
+        if (CPU_ISSET(cpu, &cpu_set))
+          used_cpu_sets[thread_index].push_back(cpu);
+    });
+    for (std::uint32_t thread_index = 0u; thread_index < number_of_threads;
+         ++thread_index)
+      REQUIRE(cpu_sets[thread_index] == used_cpu_sets[thread_index]);
+  }
+}
+#endif /* defined(__linux__) */
+
 } /* namespace rafko_utilities_test */
@@ -0,0 +1,147 @@
+/*! This file is part of davids91/Rafko.
+ *
+ *    Rafko is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    (at your option) any later version.
+ *
+ *    Rafko is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with Rafko.  If not, see <https://www.gnu.org/licenses/> or
+ *    <https://github.com/davids91/rafko/blob/master/LICENSE>
+ */
+
+#include <catch2/catch_test_macros.hpp>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "rafko_utilities/services/rafko_thread_affinity.hpp"
+#include "rafko_utilities/services/work_stealing_pool.hpp"
+
+#include "test/test_utility.hpp"
+
+namespace rafko_utilities_test {
+
+TEST_CASE("Testing if the work stealing pool visits every index once",
+          "[thread-group][work-stealing]") {
+  rafko_utilities::WorkStealingPool pool(4u);
+  for (std::uint32_t variant = 0; variant < 10u; ++variant) {
+    const std::uint32_t begin = rand() % 10;
+    const std::uint32_t end = begin + rand() % 500;
+    const std::uint32_t grain_size = rand() % 20;
+    std::vector<std::atomic<std::uint32_t>> visits(end);
+    for (std::atomic<std::uint32_t> &visit : visits)
+      visit.store(0u);
+
+    pool.parallel_for(
+        begin, end, [&visits](std::uint32_t index) { ++visits[index]; },
+        grain_size);
+
+    for (std::uint32_t index = 0; index < end; ++index)
+      REQUIRE(((index < begin) ? 0u : 1u) == visits[index].load());
+  }
+}
+
+TEST_CASE("Testing if work stealing parallel loops can be nested",
+          "[thread-group][work-stealing][multi-thread]") {
+  rafko_utilities::WorkStealingPool pool(3u);
+  for (std::uint32_t variant = 0; variant < 10u; ++variant) {
+    std::vector<std::vector<double>> test_buffer(
+        rand() % 20 + 1, std::vector<double>(rand() % 50 + 1));
+    double expected = 0.0;
+    for (std::vector<double> &vec : test_buffer)
+      for (double &element : vec) {
+        element = rand() % 10;
+        expected += element;
+      }
+
+    std::vector<double> partial_sums(test_buffer.size(), 0.0);
+    pool.parallel_for(0u, test_buffer.size(), [&](std::uint32_t outer_index) {
+      std::vector<double> &vec = test_buffer[outer_index];
+      std::vector<double> micro_sums(vec.size(), 0.0);
+      pool.parallel_for(0u, vec.size(), [&](std::uint32_t inner_index) {
+        micro_sums[inner_index] = vec[inner_index];
+      });
+      for (double micro_sum : micro_sums)
+        partial_sums[outer_index] += micro_sum;
+    });
+
+    double result = 0.0;
+    for (double partial_sum : partial_sums)
+      result += partial_sum;
+    REQUIRE(expected == result);
+  }
+}
+
+TEST_CASE("Testing task groups of the work stealing pool",
+          "[thread-group][work-stealing]") {
+  rafko_utilities::WorkStealingPool pool(2u);
+  std::atomic<std::uint32_t> executed = {0u};
+
+  rafko_utilities::WorkStealingPool::TaskGroup group(pool);
+  for (std::uint32_t task_index = 0; task_index < 100u; ++task_index)
+    group.spawn([&executed, &group]() {
+      ++executed;
+      group.spawn([&executed]() { ++executed; });
+    });
+  group.wait();
+  REQUIRE(200u == executed.load());
+
+  group.spawn([]() { throw std::runtime_error("Task failed!"); });
+  group.spawn([&executed]() { ++executed; });
+  REQUIRE_THROWS(group.wait());
+  REQUIRE(201u == executed.load());
+
+  /* The group stays usable after an exception */
+  group.spawn([&executed]() { ++executed; });
+  REQUIRE_NOTHROW(group.wait());
+  REQUIRE(202u == executed.load());
+}
+
+#if defined(__linux__)
+TEST_CASE("Testing if the workers of the work stealing pool run on their CPUs",
+          "[thread-group][work-stealing]") {
+  /* the last set of the CPUs, which is every CPU when there's only one */
+  std::vector<std::vector<std::uint32_t>> cpu_sets =
+      rafko_utilities::divide_cpus(2u);
+  if (cpu_sets.empty())
+    cpu_sets = rafko_utilities::divide_cpus(1u);
+  REQUIRE(!cpu_sets.empty());
+  const std::vector<std::uint32_t> &cpus = cpu_sets.back();
+  rafko_utilities::WorkStealingPool pool(2u, cpus);
+  const std::thread::id caller_id = std::this_thread::get_id();
+  std::mutex used_cpus_mutex;
+  std::vector<std::vector<std::uint32_t>> used_cpus;
+  pool.parallel_for(0u, 64u, [&](std::uint32_t) {
+    std::this_thread::sleep_for(std::chrono::microseconds(500));
+    if (caller_id == std::this_thread::get_id())
+      return;
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    pthread_getaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpu_set);
+    std::vector<std::uint32_t> worker_cpus;
+    for (std::uint32_t cpu = 0u; cpu < CPU_SETSIZE; ++cpu)
+      if (CPU_ISSET(cpu, &cpu_set))
+        worker_cpus.push_back(cpu);
+    std::lock_guard<std::mutex> lock(used_cpus_mutex);
+    used_cpus.push_back(worker_cpus);
+  });
+  REQUIRE(!used_cpus.empty());
+  for (const std::vector<std::uint32_t> &worker_cpus : used_cpus)
+    REQUIRE(cpus == worker_cpus);
+}
+#endif /* defined(__linux__) */
+
+} /* namespace rafko_utilities_test */
@@ -682,7 +682,7 @@ rafko_net::RafkoNet *generate_random_net_with_softmax_features_and_recurrence(
            ++layer_neuron_index)
         if (0 == (rand() % 2))
           builder.add_neuron_recurrence(layer_index, layer_neuron_index,
-                                        rand() % 5);
+                                        1u + (rand() % 4));
     if (0 == (rand() % 2)) /* Add boltzmann knot feature by chance */
       builder.add_feature_to_layer(
           layer_index, rafko_net::neuron_group_feature_boltzmann_knot);